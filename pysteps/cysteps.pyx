@@ -38,3 +38,4 @@ include "cysteps_model.pyx"
 include "cysteps_geom.pyx"
 include "cysteps_solver.pyx"
 include "cysteps_rng.pyx"
+include "cysteps_tetopsplit.pyx"
@@ -768,6 +768,10 @@ cdef class _py_ElementType:
     ELEM_TET = steps_tetmesh.ELEM_TET
     ELEM_UNDEFINED = steps_tetmesh.ELEM_UNDEFINED
 
+cdef class _py_PartitionMethod:
+    PARTITION_GRAPH = steps_tetmesh.PARTITION_GRAPH
+    PARTITION_SFC = steps_tetmesh.PARTITION_SFC
+
 cdef class _py_ROISet:
     cdef readonly ElementType type
     cdef readonly std.vector[index_t] indices
@@ -826,6 +830,100 @@ cdef class _py_Tetmesh(_py_Geom):
         """
         self._ptr = new Tetmesh( verts, tets, tris )
 
+    def saveBinary(self, str pathname):
+        """
+        Save the mesh in the STEPS binary mesh format, including the precomputed
+        adjacency, volumes, areas and barycenters, the compartments and patches
+        and the ROIs. Membranes and diffusion boundaries are not saved.
+
+        Syntax::
+
+            saveBinary(pathname)
+
+        Arguments:
+        string pathname
+
+        Return:
+        None
+
+        """
+        self.ptrx().saveBinary(to_std_string(pathname))
+
+    @staticmethod
+    def loadBinary(str pathname):
+        """
+        Create a Tetmesh from a file written by saveBinary(). The file is
+        memory-mapped and its tables are used as stored, without recomputing
+        any adjacency.
+
+        Syntax::
+
+            mesh = steps.geom.Tetmesh.loadBinary(pathname)
+
+        Arguments:
+        string pathname
+
+        Return:
+        steps.geom.Tetmesh
+
+        """
+        return _py_Tetmesh.from_ptr(Tetmesh.loadBinary(to_std_string(pathname)))
+
+    def partition(self, uint nparts, int method=PARTITION_GRAPH, std.vector[double] tet_weights=[]):
+        """
+        Partition the tetrahedrons over nparts hosts of the parallel TetOpSplit
+        solver. The two tetrahedrons of every patch triangle are kept on the host
+        of the triangle. The result is deterministic, so that every process can
+        compute the partition itself.
+
+        Syntax::
+
+            tet_hosts, tri_hosts, stats = partition(nparts, method, tet_weights)
+
+        Arguments:
+        uint nparts
+        int method (default = steps.geom.PARTITION_GRAPH)
+        list<float> tet_weights (default = [], i.e. 1 for tets in a compartment, 0 otherwise)
+
+        Return:
+        list<uint>, dict<index_t, uint>, dict
+
+        The statistics dictionary holds the weight ('host_loads') and the number of
+        adjacent tetrahedrons of other hosts ('host_halo_tets') of each host, the
+        area of the faces between hosts ('cut_area') and the ratio of the largest
+        to the mean host weight ('imbalance').
+
+        """
+        cdef TetPartition part = self.ptrx().partition(nparts, <PartitionMethod> method, tet_weights)
+        tri_hosts = {}
+        for item in part.tri_hosts:
+            tri_hosts[item.first.get()] = item.second
+        stats = {'host_loads': part.host_loads,
+                 'host_halo_tets': part.host_halo_tets,
+                 'cut_area': part.cut_area,
+                 'imbalance': part.imbalance}
+        return part.tet_hosts, tri_hosts, stats
+
+    def getKProcTetWeights(self, _py_Model model):
+        """
+        Return the number of kprocs of each tetrahedron in a simulation of the
+        given model: the reactions and diffusion rules of its compartment, plus the
+        surface kprocs of the patch triangles on its faces. Meant as tet_weights
+        of partition().
+
+        Syntax::
+
+            getKProcTetWeights(model)
+
+        Arguments:
+        steps.model.Model model
+
+        Return:
+        list<float>
+
+        """
+        return self.ptrx().getKProcTetWeights(model.ptr())
+
     def getAllComps(self, ):
         """
         Returns a list of references to all steps.geom.TmComp compartment objects in the
@@ -1333,6 +1431,27 @@ cdef class _py_Tetmesh(_py_Geom):
         """
         return self.ptrx().findTetByPoint(p).get()
 
+    def findTetsByPointsNP(self, double[:, :] point_coords, index_t[:] tets):
+        """
+        Find the tetrahedrons which encompass a list of points, in parallel.
+        Points outside the mesh get UNKNOWN_TET.
+
+        Syntax::
+
+            findTetsByPointsNP(point_coords, tets)
+
+        Arguments:
+        numpy.array<float, shape = (n, 3)> point_coords
+        numpy.array<index_t, length = n> tets
+
+        Return:
+        None
+
+        """
+        if (point_coords.strides[0] != 24 or point_coords.strides[1] != 8):
+            raise Exception("Wrong memory layout for point_coords, np array should be [pts,3] and row major")
+        self.ptrx().findTetsByPointsNP(&point_coords[0][0], point_coords.shape[0], &tets[0], tets.shape[0])
+
     def getBoundMin(self, ):
         """
         Returns the minimal Cartesian coordinate of the rectangular bounding box of the mesh.
@@ -2447,6 +2566,24 @@ cdef class _py_Tetmesh(_py_Geom):
             raise Exception("Wrong memory layout for point_coords, np array should be [pts,3] and row major")
         return self.ptrx().intersect(&point_coords[0][0], point_coords.shape[0], sampling)
 
+    def intersectIndependentSegments(self, double[:, :] point_coords, int sampling=-1):
+        """
+        Computes the intersection of independent line segments with the current mesh, in parallel
+
+        Args:
+            points: A 2-D numpy array (/memview), where each row contains the start and end
+                    point coordinates of a segment (6 values)
+            int sampling: not specified or sampling < 1 --> use deterministic method
+                          sampling > 0 --> use montecarlo method with sampling points
+
+        Returns:
+            A list where each position contains the list of intersected tets (and respective
+            intersection ratio) of each line segment.
+        """
+        if (point_coords.strides[0] != 48 or point_coords.strides[1] != 8):
+            raise Exception("Wrong memory layout for point_coords, np array should be [segs,6] and row major")
+        return self.ptrx().intersectIndependentSegments(&point_coords[0][0], point_coords.shape[0], sampling)
+
     @staticmethod
     cdef _py_Tetmesh from_ptr(Tetmesh *ptr):
         if (ptr == NULL):
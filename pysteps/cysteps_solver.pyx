@@ -1244,6 +1244,61 @@ cdef class _py_Tetexact(_py_API):
         """
         self.ptrx().saveMembOpt(to_std_string(opt_file_name))
 
+    def setNThreads(self, uint nthreads, uint ndomains=0):
+        """
+        Split the mesh into ndomains sub-domains (one per thread by default)
+        and simulate them on nthreads OpenMP threads. Every sub-domain runs
+        its own exact SSA with its own random number stream; molecules that
+        diffuse between sub-domains arrive at the time of the event, so the
+        simulation stays exact. Results depend on the number of sub-domains
+        but not on the number of threads. A single sub-domain, the default,
+        is the serial solver. Not available with the EField calculation.
+
+        Syntax::
+
+            setNThreads(nthreads, ndomains)
+
+        Arguments:
+        int nthreads
+        int ndomains (default = nthreads)
+
+        Return:
+            None
+        """
+        self.ptrx().setNThreads(nthreads, ndomains)
+
+    def getNThreads(self):
+        """
+        Return the number of threads.
+
+        Syntax::
+
+            getNThreads()
+
+        Arguments:
+        None
+
+        Return:
+            int
+        """
+        return self.ptrx().getNThreads()
+
+    def getNDomains(self):
+        """
+        Return the number of sub-domains.
+
+        Syntax::
+
+            getNDomains()
+
+        Arguments:
+        None
+
+        Return:
+            int
+        """
+        return self.ptrx().getNDomains()
+
     def getTime(self, ):
         """
         Returns the current simulation time in seconds.
@@ -1389,6 +1444,24 @@ cdef class _py_Tetexact(_py_API):
         """
         self.ptrx().getBatchTetCountsNP(&indices[0], indices.shape[0], to_std_string(s), &counts[0], counts.shape[0])
 
+    def getBatchTetCountsIdxNP(self, index_t[:] indices, uint sidx, double[:] counts):
+        """
+        Get the counts of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetCountsIdxNP(indices, sidx, counts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> counts
+
+        Return:
+        None
+
+        """
+        self.ptrx().getBatchTetCountsNP(&indices[0], indices.shape[0], sidx, &counts[0], counts.shape[0])
+
     def getBatchTriCountsNP(self, index_t[:] indices, str s, double[:] counts):
         """
         Get the counts of a species s in a list of triangles.
@@ -1407,6 +1480,24 @@ cdef class _py_Tetexact(_py_API):
         """
         self.ptrx().getBatchTriCountsNP(&indices[0], indices.shape[0], to_std_string(s), &counts[0], counts.shape[0])
 
+    def getBatchTriCountsIdxNP(self, index_t[:] indices, uint sidx, double[:] counts):
+        """
+        Get the counts of the species with global index sidx in a list of triangles.
+
+        Syntax::
+            getBatchTriCountsIdxNP(indices, sidx, counts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> counts
+
+        Return:
+        None
+
+        """
+        self.ptrx().getBatchTriCountsNP(&indices[0], indices.shape[0], sidx, &counts[0], counts.shape[0])
+
 
     def getROITetCounts(self, str ROI_id, str s):
         """
@@ -2191,6 +2282,46 @@ cdef class _py_TetODE(_py_API):
         """
         self.ptrx().setMaxNumSteps(maxn)
 
+    def setStiff(self, bool stiff, str linsolver="spgmr"):
+        """
+        Select the integration scheme of CVODE.
+        By default CVODE uses the Adams method with functional iteration.
+        Stiff models, e.g. with fast buffering reactions, are better
+        integrated with the BDF method and Newton iteration, whose linear
+        systems are solved with a preconditioned Krylov method.
+
+        Syntax::
+
+            setStiff(stiff, linsolver)
+
+        Arguments:
+        bool stiff
+        string linsolver: "spgmr" (default), "spbcg" or "sptfqmr"
+
+        Return:
+        None
+
+        """
+        self.ptrx().setStiff(stiff, to_std_string(linsolver))
+
+    def getNumSteps(self):
+        """
+        Returns the number of internal CVODE steps taken since the solver
+        was created.
+
+        Syntax::
+
+            getNumSteps()
+
+        Arguments:
+        None
+
+        Return:
+        int
+
+        """
+        return self.ptrx().getNumSteps()
+
 
     @staticmethod
     cdef _py_TetODE from_ptr(TetODE *ptr):
@@ -2220,6 +2351,7 @@ cdef class _py_API(_py__base):
     EF_DEFAULT   = steps_solver.EF_DEFAULT
     EF_DV_BDSYS  = steps_solver.EF_DV_BDSYS
     EF_DV_PETSC  = steps_solver.EF_DV_PETSC
+    EF_DV_CG     = steps_solver.EF_DV_CG
 
     cdef API *ptr(self):
         return <API*> self._ptr
@@ -2229,6 +2361,188 @@ cdef class _py_API(_py__base):
         self.model = m
         self.geom = g
 
+    def setAsyncCheckpoint(self, bool b):
+        """
+        Set whether checkpoint files are written in the background.
+
+        In asynchronous mode, checkpoint() returns once the state of the
+        solver has been copied in memory, and the file is written by a
+        background thread while the simulation goes on. Call
+        waitCheckpoint() to make sure the file is complete, e.g. before
+        the script exits.
+
+        Syntax::
+
+            setAsyncCheckpoint(b)
+
+        Arguments:
+        bool b
+
+        Return:
+        None
+
+        """
+        self.ptr().setAsyncCheckpoint(b)
+
+    def getAsyncCheckpoint(self, ):
+        """
+        Returns whether checkpoint files are written in the background.
+
+        Syntax::
+
+            getAsyncCheckpoint()
+
+        Arguments:
+        None
+
+        Return:
+        bool
+
+        """
+        return self.ptr().getAsyncCheckpoint()
+
+    def waitCheckpoint(self, ):
+        """
+        Wait until the checkpoint file being written in the background, if
+        any, is complete. Raises an error if it could not be written.
+
+        Syntax::
+
+            waitCheckpoint()
+
+        Arguments:
+        None
+
+        Return:
+        None
+
+        """
+        self.ptr().waitCheckpoint()
+
+    def getSpecIdx(self, str s):
+        """
+        Returns the global index of species with identifier string spec, to be
+        used with the index based accessors (e.g. getTetCountIdx).
+
+        Syntax::
+
+            getSpecIdx(spec)
+
+        Arguments:
+        string spec
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getSpecIdx(to_std_string(s))
+
+    def getCompIdx(self, str c):
+        """
+        Returns the global index of compartment with identifier string comp.
+
+        Syntax::
+
+            getCompIdx(comp)
+
+        Arguments:
+        string comp
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getCompIdx(to_std_string(c))
+
+    def getPatchIdx(self, str p):
+        """
+        Returns the global index of patch with identifier string pat.
+
+        Syntax::
+
+            getPatchIdx(pat)
+
+        Arguments:
+        string pat
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getPatchIdx(to_std_string(p))
+
+    def getReacIdx(self, str r):
+        """
+        Returns the global index of reaction with identifier string reac, to be
+        used with the index based batch accessors.
+
+        Syntax::
+
+            getReacIdx(reac)
+
+        Arguments:
+        string reac
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getReacIdx(to_std_string(r))
+
+    def getSReacIdx(self, str sr):
+        """
+        Returns the global index of surface reaction with identifier string sreac, to be
+        used with the index based batch accessors.
+
+        Syntax::
+
+            getSReacIdx(sreac)
+
+        Arguments:
+        string sreac
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getSReacIdx(to_std_string(sr))
+
+    def getDiffIdx(self, str d):
+        """
+        Returns the global index of diffusion rule with identifier string diff, to be
+        used with the index based batch accessors.
+
+        Syntax::
+
+            getDiffIdx(diff)
+
+        Arguments:
+        string diff
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getDiffIdx(to_std_string(d))
+
+    def getSurfDiffIdx(self, str sd):
+        """
+        Returns the global index of surface diffusion rule with identifier string sdiff, to be
+        used with the index based batch accessors.
+
+        Syntax::
+
+            getSurfDiffIdx(sdiff)
+
+        Arguments:
+        string sdiff
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getSurfDiffIdx(to_std_string(sd))
+
     def getCompVol(self, str c):
         """
         Returns the volume of compartment with identifier string comp (in m^3).
@@ -2286,6 +2600,25 @@ cdef class _py_API(_py__base):
         """
         return self.ptr().getCompCount(to_std_string(c), to_std_string(s))
 
+    def getCompCountIdx(self, uint cidx, uint sidx):
+        """
+        Returns the number of molecules of species with global index sidx
+        in compartment with global index cidx.
+
+        Syntax::
+
+            getCompCountIdx(cidx, sidx)
+
+        Arguments:
+        uint cidx
+        uint sidx
+
+        Return:
+        float
+
+        """
+        return self.ptr().getCompCount(cidx, sidx)
+
     def setCompCount(self, str c, str s, double n):
         """
         Set the number of molecules of a species with identifier string spec 
@@ -2823,6 +3156,25 @@ cdef class _py_API(_py__base):
         """
         return self.ptr().getTetCount(tidx, to_std_string(s))
 
+    def getTetCountIdx(self, index_t tidx, uint sidx):
+        """
+        Returns the number of molecules of species with global index sidx
+        in the tetrahedral element with index idx.
+
+        Syntax::
+
+            getTetCountIdx(idx, sidx)
+
+        Arguments:
+        index_t idx
+        uint sidx
+
+        Return:
+        float
+
+        """
+        return self.ptr().getTetCount(tidx, sidx)
+
     def setTetCount(self, index_t tidx, str s, double n):
         """
         Sets the number of molecules of species with identifier string spec in 
@@ -3347,6 +3699,25 @@ cdef class _py_API(_py__base):
         """
         return self.ptr().getPatchCount(to_std_string(p), to_std_string(s))
 
+    def getPatchCountIdx(self, uint pidx, uint sidx):
+        """
+        Returns the number of molecules of species with global index sidx
+        in patch with global index pidx.
+
+        Syntax::
+
+            getPatchCountIdx(pidx, sidx)
+
+        Arguments:
+        uint pidx
+        uint sidx
+
+        Return:
+        float
+
+        """
+        return self.ptr().getPatchCount(pidx, sidx)
+
     def setPatchCount(self, str p, str s, double n):
         """
         Sets the number of molecules of species with identifier string spec in patch 
@@ -3897,15 +4268,34 @@ cdef class _py_API(_py__base):
         """
         return self.ptr().getTriCount(tidx, to_std_string(s))
 
-    def setTriCount(self, index_t tidx, str s, double n):
+    def getTriCountIdx(self, index_t tidx, uint sidx):
         """
-        Sets the number of molecules of species with identifier string spec in 
-        triangular element with index idx to n. 
+        Returns the number of molecules of species with global index sidx
+        in the triangular element with index idx.
 
         Syntax::
-            
-            setTriCount(idx, spec, n)
-            
+
+            getTriCountIdx(idx, sidx)
+
+        Arguments:
+        index_t idx
+        uint sidx
+
+        Return:
+        float
+
+        """
+        return self.ptr().getTriCount(tidx, sidx)
+
+    def setTriCount(self, index_t tidx, str s, double n):
+        """
+        Sets the number of molecules of species with identifier string spec in 
+        triangular element with index idx to n. 
+
+        Syntax::
+            
+            setTriCount(idx, spec, n)
+            
         Arguments:
         index_t idx
         string spec
@@ -4733,13 +5123,891 @@ cdef class _py_API(_py__base):
         """
         return self.ptr().getPatchSpecName(p_idx, s_idx)
 
+    def getBatchTetCountsIdxNP(self, index_t[:] indices, uint sidx, double[:] counts):
+        """
+        Get the counts of the species with global index sidx in a list of tetrahedrons.
 
-    @staticmethod
-    cdef _py_API from_ptr(API *ptr):
-        cdef _py_API obj = _py_API.__new__(_py_API )
-        obj._ptr = ptr
-        return obj
+        Syntax::
+            getBatchTetCountsIdxNP(indices, sidx, counts)
 
-    @staticmethod
-    cdef _py_API from_ref(const API &ref):
-        return _py_API.from_ptr(<API*>&ref)
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> counts
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetCountsNP(&indices[0], indices.shape[0], sidx, &counts[0], counts.shape[0])
+
+    def setBatchTetCountsIdxNP(self, index_t[:] indices, uint sidx, double[:] counts):
+        """
+        Set the counts of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            setBatchTetCountsIdxNP(indices, sidx, counts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> counts
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTetCountsNP(&indices[0], indices.shape[0], sidx, &counts[0], counts.shape[0])
+
+    def getBatchTetAmountsIdxNP(self, index_t[:] indices, uint sidx, double[:] amounts):
+        """
+        Get the amounts (in mols) of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetAmountsIdxNP(indices, sidx, amounts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> amounts
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetAmountsNP(&indices[0], indices.shape[0], sidx, &amounts[0], amounts.shape[0])
+
+    def setBatchTetAmountsIdxNP(self, index_t[:] indices, uint sidx, double[:] amounts):
+        """
+        Set the amounts (in mols) of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            setBatchTetAmountsIdxNP(indices, sidx, amounts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> amounts
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTetAmountsNP(&indices[0], indices.shape[0], sidx, &amounts[0], amounts.shape[0])
+
+    def getBatchTetConcsIdxNP(self, index_t[:] indices, uint sidx, double[:] concs):
+        """
+        Get the concentrations (in molar units) of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetConcsIdxNP(indices, sidx, concs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> concs
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetConcsNP(&indices[0], indices.shape[0], sidx, &concs[0], concs.shape[0])
+
+    def setBatchTetConcsIdxNP(self, index_t[:] indices, uint sidx, double[:] concs):
+        """
+        Set the concentrations (in molar units) of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            setBatchTetConcsIdxNP(indices, sidx, concs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> concs
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTetConcsNP(&indices[0], indices.shape[0], sidx, &concs[0], concs.shape[0])
+
+    def getBatchTetClampedIdxNP(self, index_t[:] indices, uint sidx, unsigned char[:] clamped):
+        """
+        Get the clamped flags (0 or 1) of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetClampedIdxNP(indices, sidx, clamped)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<unsigned char, length = len(indices)> clamped
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetClampedNP(&indices[0], indices.shape[0], sidx, &clamped[0], clamped.shape[0])
+
+    def setBatchTetClampedIdxNP(self, index_t[:] indices, uint sidx, unsigned char[:] clamped):
+        """
+        Set the clamped flags (0 or 1) of the species with global index sidx in a list of tetrahedrons.
+
+        Syntax::
+            setBatchTetClampedIdxNP(indices, sidx, clamped)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<unsigned char, length = len(indices)> clamped
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTetClampedNP(&indices[0], indices.shape[0], sidx, &clamped[0], clamped.shape[0])
+
+    def getBatchTetReacKsIdxNP(self, index_t[:] indices, uint ridx, double[:] kfs):
+        """
+        Get the rate constants of the reaction with global index ridx in a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetReacKsIdxNP(indices, ridx, kfs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint ridx
+        numpy.array<double, length = len(indices)> kfs
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetReacKsNP(&indices[0], indices.shape[0], ridx, &kfs[0], kfs.shape[0])
+
+    def setBatchTetReacKsIdxNP(self, index_t[:] indices, uint ridx, double[:] kfs):
+        """
+        Set the rate constants of the reaction with global index ridx in a list of tetrahedrons.
+
+        Syntax::
+            setBatchTetReacKsIdxNP(indices, ridx, kfs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint ridx
+        numpy.array<double, length = len(indices)> kfs
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTetReacKsNP(&indices[0], indices.shape[0], ridx, &kfs[0], kfs.shape[0])
+
+    def getBatchTetReacExtentsIdxNP(self, index_t[:] indices, uint ridx, unsigned long long[:] extents):
+        """
+        Get the extents of the reaction with global index ridx in a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetReacExtentsIdxNP(indices, ridx, extents)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint ridx
+        numpy.array<unsigned long long, length = len(indices)> extents
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetReacExtentsNP(&indices[0], indices.shape[0], ridx, &extents[0], extents.shape[0])
+
+    def getBatchTetDiffDsIdxNP(self, index_t[:] indices, uint didx, double[:] dcsts):
+        """
+        Get the diffusion constants of the diffusion rule with global index didx in a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetDiffDsIdxNP(indices, didx, dcsts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint didx
+        numpy.array<double, length = len(indices)> dcsts
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetDiffDsNP(&indices[0], indices.shape[0], didx, &dcsts[0], dcsts.shape[0])
+
+    def setBatchTetDiffDsIdxNP(self, index_t[:] indices, uint didx, double[:] dcsts):
+        """
+        Set the diffusion constants, in all directions, of the diffusion rule with global index didx in a list of tetrahedrons.
+
+        Syntax::
+            setBatchTetDiffDsIdxNP(indices, didx, dcsts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint didx
+        numpy.array<double, length = len(indices)> dcsts
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTetDiffDsNP(&indices[0], indices.shape[0], didx, &dcsts[0], dcsts.shape[0])
+
+    def getBatchTetVsNP(self, index_t[:] indices, double[:] vs):
+        """
+        Get the potentials (in volts) of a list of tetrahedrons.
+
+        Syntax::
+            getBatchTetVsNP(indices, vs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> vs
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTetVsNP(&indices[0], indices.shape[0], &vs[0], vs.shape[0])
+
+    def setBatchTetVsNP(self, index_t[:] indices, double[:] vs):
+        """
+        Set the potentials (in volts) of a list of tetrahedrons.
+
+        Syntax::
+            setBatchTetVsNP(indices, vs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> vs
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTetVsNP(&indices[0], indices.shape[0], &vs[0], vs.shape[0])
+
+    def setBatchTriCountsIdxNP(self, index_t[:] indices, uint sidx, double[:] counts):
+        """
+        Set the counts of the species with global index sidx in a list of triangles.
+
+        Syntax::
+            setBatchTriCountsIdxNP(indices, sidx, counts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> counts
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTriCountsNP(&indices[0], indices.shape[0], sidx, &counts[0], counts.shape[0])
+
+    def getBatchTriAmountsIdxNP(self, index_t[:] indices, uint sidx, double[:] amounts):
+        """
+        Get the amounts (in mols) of the species with global index sidx in a list of triangles.
+
+        Syntax::
+            getBatchTriAmountsIdxNP(indices, sidx, amounts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> amounts
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriAmountsNP(&indices[0], indices.shape[0], sidx, &amounts[0], amounts.shape[0])
+
+    def setBatchTriAmountsIdxNP(self, index_t[:] indices, uint sidx, double[:] amounts):
+        """
+        Set the amounts (in mols) of the species with global index sidx in a list of triangles.
+
+        Syntax::
+            setBatchTriAmountsIdxNP(indices, sidx, amounts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<double, length = len(indices)> amounts
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTriAmountsNP(&indices[0], indices.shape[0], sidx, &amounts[0], amounts.shape[0])
+
+    def getBatchTriClampedIdxNP(self, index_t[:] indices, uint sidx, unsigned char[:] clamped):
+        """
+        Get the clamped flags (0 or 1) of the species with global index sidx in a list of triangles.
+
+        Syntax::
+            getBatchTriClampedIdxNP(indices, sidx, clamped)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<unsigned char, length = len(indices)> clamped
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriClampedNP(&indices[0], indices.shape[0], sidx, &clamped[0], clamped.shape[0])
+
+    def setBatchTriClampedIdxNP(self, index_t[:] indices, uint sidx, unsigned char[:] clamped):
+        """
+        Set the clamped flags (0 or 1) of the species with global index sidx in a list of triangles.
+
+        Syntax::
+            setBatchTriClampedIdxNP(indices, sidx, clamped)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint sidx
+        numpy.array<unsigned char, length = len(indices)> clamped
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTriClampedNP(&indices[0], indices.shape[0], sidx, &clamped[0], clamped.shape[0])
+
+    def getBatchTriSReacKsIdxNP(self, index_t[:] indices, uint ridx, double[:] kfs):
+        """
+        Get the rate constants of the surface reaction with global index ridx in a list of triangles.
+
+        Syntax::
+            getBatchTriSReacKsIdxNP(indices, ridx, kfs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint ridx
+        numpy.array<double, length = len(indices)> kfs
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriSReacKsNP(&indices[0], indices.shape[0], ridx, &kfs[0], kfs.shape[0])
+
+    def setBatchTriSReacKsIdxNP(self, index_t[:] indices, uint ridx, double[:] kfs):
+        """
+        Set the rate constants of the surface reaction with global index ridx in a list of triangles.
+
+        Syntax::
+            setBatchTriSReacKsIdxNP(indices, ridx, kfs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint ridx
+        numpy.array<double, length = len(indices)> kfs
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTriSReacKsNP(&indices[0], indices.shape[0], ridx, &kfs[0], kfs.shape[0])
+
+    def getBatchTriSReacExtentsIdxNP(self, index_t[:] indices, uint ridx, unsigned long long[:] extents):
+        """
+        Get the extents of the surface reaction with global index ridx in a list of triangles.
+
+        Syntax::
+            getBatchTriSReacExtentsIdxNP(indices, ridx, extents)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint ridx
+        numpy.array<unsigned long long, length = len(indices)> extents
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriSReacExtentsNP(&indices[0], indices.shape[0], ridx, &extents[0], extents.shape[0])
+
+    def getBatchTriSDiffDsIdxNP(self, index_t[:] indices, uint didx, double[:] dcsts):
+        """
+        Get the diffusion constants of the surface diffusion rule with global index didx in a list of triangles.
+
+        Syntax::
+            getBatchTriSDiffDsIdxNP(indices, didx, dcsts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint didx
+        numpy.array<double, length = len(indices)> dcsts
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriSDiffDsNP(&indices[0], indices.shape[0], didx, &dcsts[0], dcsts.shape[0])
+
+    def setBatchTriSDiffDsIdxNP(self, index_t[:] indices, uint didx, double[:] dcsts):
+        """
+        Set the diffusion constants, in all directions, of the surface diffusion rule with global index didx in a list of triangles.
+
+        Syntax::
+            setBatchTriSDiffDsIdxNP(indices, didx, dcsts)
+
+        Arguments:
+        numpy.array<index_t> indices
+        uint didx
+        numpy.array<double, length = len(indices)> dcsts
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTriSDiffDsNP(&indices[0], indices.shape[0], didx, &dcsts[0], dcsts.shape[0])
+
+    def getBatchTriVsNP(self, index_t[:] indices, double[:] vs):
+        """
+        Get the potentials (in volts) of a list of triangles.
+
+        Syntax::
+            getBatchTriVsNP(indices, vs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> vs
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriVsNP(&indices[0], indices.shape[0], &vs[0], vs.shape[0])
+
+    def setBatchTriVsNP(self, index_t[:] indices, double[:] vs):
+        """
+        Set the potentials (in volts) of a list of triangles.
+
+        Syntax::
+            setBatchTriVsNP(indices, vs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> vs
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchTriVsNP(&indices[0], indices.shape[0], &vs[0], vs.shape[0])
+
+    def getBatchTriTotalOhmicIsNP(self, index_t[:] indices, double[:] currents):
+        """
+        Get the ohmic currents (in amps) of a list of triangles, summed over all ohmic currents of each triangle.
+
+        Syntax::
+            getBatchTriTotalOhmicIsNP(indices, currents)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> currents
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriTotalOhmicIsNP(&indices[0], indices.shape[0], &currents[0], currents.shape[0])
+
+    def getBatchTriTotalGHKIsNP(self, index_t[:] indices, double[:] currents):
+        """
+        Get the GHK currents (in amps) of a list of triangles, summed over all GHK currents of each triangle.
+
+        Syntax::
+            getBatchTriTotalGHKIsNP(indices, currents)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> currents
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchTriTotalGHKIsNP(&indices[0], indices.shape[0], &currents[0], currents.shape[0])
+
+    def getBatchVertVsNP(self, index_t[:] indices, double[:] vs):
+        """
+        Get the potentials (in volts) of a list of vertices.
+
+        Syntax::
+            getBatchVertVsNP(indices, vs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> vs
+
+        Return:
+        None
+
+        """
+        self.ptr().getBatchVertVsNP(&indices[0], indices.shape[0], &vs[0], vs.shape[0])
+
+    def setBatchVertVsNP(self, index_t[:] indices, double[:] vs):
+        """
+        Set the potentials (in volts) of a list of vertices.
+
+        Syntax::
+            setBatchVertVsNP(indices, vs)
+
+        Arguments:
+        numpy.array<index_t> indices
+        numpy.array<double, length = len(indices)> vs
+
+        Return:
+        None
+
+        """
+        self.ptr().setBatchVertVsNP(&indices[0], indices.shape[0], &vs[0], vs.shape[0])
+
+
+    @staticmethod
+    cdef _py_API from_ptr(API *ptr):
+        cdef _py_API obj = _py_API.__new__(_py_API )
+        obj._ptr = ptr
+        return obj
+
+    @staticmethod
+    cdef _py_API from_ref(const API &ref):
+        return _py_API.from_ptr(<API*>&ref)
+
+
+# ======================================================================================================================
+# Python bindings to steps::solver::Recorder
+# ======================================================================================================================
+
+cdef class _py_Recorder(_py__base):
+    "Python wrapper class for Recorder"
+# ----------------------------------------------------------------------------------------------------------------------
+    # Keeps the solver alive while the recorder refers to it
+    cdef readonly _py_API solver
+
+    #Constants
+    COMP   = steps_solver.REC_COMP
+    PATCH  = steps_solver.REC_PATCH
+    TET    = steps_solver.REC_TET
+    TRI    = steps_solver.REC_TRI
+    VERT   = steps_solver.REC_VERT
+    COUNT  = steps_solver.REC_COUNT
+    CONC   = steps_solver.REC_CONC
+    EXTENT = steps_solver.REC_EXTENT
+    V      = steps_solver.REC_V
+
+    cdef Recorder *ptr(self):
+        return <Recorder*> self._ptr
+
+    def __init__(self, _py_API sim):
+        """
+        Construction::
+
+            rec = steps.solver.Recorder(sim)
+
+        Create a time-series recorder for solver sim. Probes are sampled in
+        C++ while the recorder runs the solver, without calling back into Python.
+
+        Arguments:
+        steps.solver.API sim
+
+        """
+        if sim == None:
+            raise TypeError('The solver object is empty.')
+        self._ptr = new Recorder(sim.ptr())
+        self.solver = sim
+
+    def __dealloc__(self):
+        cdef Recorder *rec = self.ptr()
+        del rec
+
+    def addProbe(self, int element, std.vector[index_t] indices, int quantity, str name=""):
+        """
+        Add a probe and return its index. Its values occupy len(indices)
+        consecutive columns of each row, starting at getProbeOffset(probe).
+
+        Syntax::
+
+            addProbe(element, indices, quantity, name)
+
+        Arguments:
+        int element (Recorder.COMP, PATCH, TET, TRI or VERT)
+        list<index_t> indices (compartment or patch indices for COMP and PATCH)
+        int quantity (Recorder.COUNT, CONC, EXTENT or V)
+        string name (species, or reaction / surface reaction for EXTENT)
+
+        Return:
+        uint
+
+        """
+        return self.ptr().addProbe(<RecElement> element, indices, <RecQuantity> quantity, to_std_string(name))
+
+    def countProbes(self):
+        """
+        Returns the number of probes.
+
+        Syntax::
+
+            countProbes()
+
+        Arguments:
+        None
+
+        Return:
+        uint
+
+        """
+        return self.ptr().countProbes()
+
+    def countColumns(self):
+        """
+        Returns the number of values in a row.
+
+        Syntax::
+
+            countColumns()
+
+        Arguments:
+        None
+
+        Return:
+        uint
+
+        """
+        return self.ptr().countColumns()
+
+    def getProbeOffset(self, uint p):
+        """
+        Returns the first column of probe p in a row.
+
+        Syntax::
+
+            getProbeOffset(p)
+
+        Arguments:
+        uint p
+
+        Return:
+        uint
+
+        """
+        return self.ptr().getProbeOffset(p)
+
+    def setSampleDT(self, double dt):
+        """
+        Sample every dt, starting from the current simulation time.
+
+        Syntax::
+
+            setSampleDT(dt)
+
+        Arguments:
+        float dt
+
+        Return:
+        None
+
+        """
+        self.ptr().setSampleDT(dt)
+
+    def setSamplePoints(self, std.vector[double] tpnts):
+        """
+        Sample at the given time points, in increasing order.
+
+        Syntax::
+
+            setSamplePoints(tpnts)
+
+        Arguments:
+        list<float> tpnts
+
+        Return:
+        None
+
+        """
+        self.ptr().setSamplePoints(tpnts)
+
+    def openStream(self, str file_name):
+        """
+        Write rows to a binary file instead of keeping them in memory.
+
+        Syntax::
+
+            openStream(file_name)
+
+        Arguments:
+        string file_name
+
+        Return:
+        None
+
+        """
+        self.ptr().openStream(to_std_string(file_name))
+
+    def closeStream(self):
+        """
+        Flush and close the stream file, if any.
+
+        Syntax::
+
+            closeStream()
+
+        Arguments:
+        None
+
+        Return:
+        None
+
+        """
+        self.ptr().closeStream()
+
+    def run(self, double endtime):
+        """
+        Run the solver until endtime, sampling at every due sample point.
+
+        Syntax::
+
+            run(endtime)
+
+        Arguments:
+        float endtime
+
+        Return:
+        None
+
+        """
+        self.ptr().run(endtime)
+
+    def advance(self, double adv):
+        """
+        Advance the solver by adv, sampling at every due sample point.
+
+        Syntax::
+
+            advance(adv)
+
+        Arguments:
+        float adv
+
+        Return:
+        None
+
+        """
+        self.ptr().advance(adv)
+
+    def sample(self):
+        """
+        Record a row at the current simulation time.
+
+        Syntax::
+
+            sample()
+
+        Arguments:
+        None
+
+        Return:
+        None
+
+        """
+        self.ptr().sample()
+
+    def countSamples(self):
+        """
+        Returns the number of rows kept in memory.
+
+        Syntax::
+
+            countSamples()
+
+        Arguments:
+        None
+
+        Return:
+        uint
+
+        """
+        return self.ptr().countSamples()
+
+    def getTimes(self):
+        """
+        Returns the times of the rows kept in memory.
+
+        Syntax::
+
+            getTimes()
+
+        Arguments:
+        None
+
+        Return:
+        list<float>
+
+        """
+        return self.ptr().getTimes()
+
+    def getDataNP(self, double[:, :] data):
+        """
+        Copy the rows kept in memory to data.
+
+        Syntax::
+
+            getDataNP(data)
+
+        Arguments:
+        numpy.array<double, shape = (countSamples(), countColumns())> data
+
+        Return:
+        None
+
+        """
+        if data.shape[0] == 0 or data.shape[1] == 0:
+            self.ptr().getDataNP(NULL, data.shape[0] * data.shape[1])
+            return
+        if data.strides[1] != sizeof(double) or data.strides[0] != data.shape[1] * sizeof(double):
+            raise ValueError("data must be a C-contiguous array.")
+        self.ptr().getDataNP(&data[0, 0], data.shape[0] * data.shape[1])
+
+    def reserve(self, size_t nrows):
+        """
+        Reserve memory for nrows rows.
+
+        Syntax::
+
+            reserve(nrows)
+
+        Arguments:
+        uint nrows
+
+        Return:
+        None
+
+        """
+        self.ptr().reserve(nrows)
+
+    def clear(self):
+        """
+        Drop all rows kept in memory.
+
+        Syntax::
+
+            clear()
+
+        Arguments:
+        None
+
+        Return:
+        None
+
+        """
+        self.ptr().clear()
@@ -181,6 +181,8 @@ ELEM_VERTEX     = stepslib._py_ElementType.ELEM_VERTEX
 ELEM_TRI        = stepslib._py_ElementType.ELEM_TRI
 ELEM_TET        = stepslib._py_ElementType.ELEM_TET
 ELEM_UNDEFINED  = stepslib._py_ElementType.ELEM_UNDEFINED
+PARTITION_GRAPH = stepslib._py_PartitionMethod.PARTITION_GRAPH
+PARTITION_SFC   = stepslib._py_PartitionMethod.PARTITION_SFC
 UNKNOWN_TET     = stepslib.UNKNOWN_TET
 UNKNOWN_TRI     = stepslib.UNKNOWN_TRI
 INDEX_NUM_BYTES = stepslib.INDEX_NUM_BYTES
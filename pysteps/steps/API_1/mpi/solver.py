@@ -47,6 +47,7 @@ EF_NONE = stepslib._py_API.EF_NONE
 EF_DEFAULT = stepslib._py_API.EF_DEFAULT
 EF_DV_BDSYS = stepslib._py_API.EF_DV_BDSYS
 EF_DV_PETSC  = stepslib._py_API.EF_DV_PETSC
+EF_DV_CG     = stepslib._py_API.EF_DV_CG
 
 # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
 # Tetrahedral Direct SSA
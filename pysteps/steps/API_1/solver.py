@@ -31,6 +31,7 @@ EF_NONE = stepslib._py_API.EF_NONE
 EF_DEFAULT = stepslib._py_API.EF_DEFAULT
 EF_DV_BDSYS = stepslib._py_API.EF_DV_BDSYS
 EF_DV_PETSC  = stepslib._py_API.EF_DV_PETSC
+EF_DV_CG     = stepslib._py_API.EF_DV_CG
 
 
 # --------------------------------------------------------------------
@@ -276,3 +277,50 @@ class TetODE(stepslib._py_TetODE, _Base_Solver):
         and their indices in the solver.
         """
         return self._getIndexMapping()
+
+
+# The MPI build provides TetOpSplit in steps.mpi.solver, whose import initializes MPI.
+if not hasattr(stepslib, 'mpiInit'):
+    class TetOpSplit(stepslib._py_TetOpSplitP, _Base_Solver):
+        """
+        Construction::
+    
+            sim = steps.solver.TetOpSplit(model, geom, rng, calcMembPot = 0)
+    
+        Create a spatial stochastic solver based on operator splitting, that is that reaction events are partitioned and diffusion is approximated.
+        Without MPI the whole mesh is simulated by this process; call setNThreads(nthreads, ndomains) to split it into sub-domains simulated on several threads.
+        If voltage is to be simulated, argument calcMemPot=1 will set to the default solver. calcMembPot=0 means voltage will not be simulated. 
+    
+        Arguments:
+        steps.model.Model model
+        steps.geom.Geom geom
+        steps.rng.RNG rng
+        int calcMemPot (default=0)
+    
+        """
+        def run(self, end_time, cp_interval = 0.0, prefix = ""):
+            """
+            Run the simulation until <end_time>,
+            automatically checkpoint at each <cp_interval>.
+            Prefix can be added using prefix=<prefix_string>.
+            """
+            self._advance_checkpoint_run(end_time, cp_interval, prefix, 'tetopsplit')
+        
+        def advance(self, advance_time, cp_interval = 0.0, prefix = ""):
+            """
+            Advance the simulation for <advance_time>,
+            automatically checkpoint at each <cp_interval>.
+            Prefix can be added using prefix=<prefix_string>.
+            """
+            end_time = self.getTime() + advance_time
+            self._advance_checkpoint_run(end_time, cp_interval, prefix, 'tetopsplit')
+    
+        def getIndexMapping(self):
+            """
+            Get a mapping between compartments/patches/species
+            and their indices in the solver.
+            """
+            return self._getIndexMapping()
+
+
+Recorder = stepslib._py_Recorder
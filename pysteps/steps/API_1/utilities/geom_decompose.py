@@ -29,6 +29,7 @@ import warnings
 
 from steps.API_1.geom import UNKNOWN_TET
 from steps.API_1.geom import INDEX_DTYPE
+from steps.API_1.geom import PARTITION_GRAPH
 
 ################################################################################
 
@@ -126,6 +127,31 @@ def linearPartition(mesh, partition_info):
 
 ################################################################################
 
+def graphPartition(mesh, nhosts, model = None, method = PARTITION_GRAPH):
+    """
+    Partition the mesh with the native partitioner of the Tetmesh: multilevel
+    bisection of the tetrahedron graph, weighted by face areas, or a space-filling
+    curve fallback (method = steps.geom.PARTITION_SFC). Patch triangles are
+    assigned together with both their tetrahedrons, so no rearrangement as in
+    partitionTris is needed.
+    
+    Parameters:
+        * mesh                STEPS Tetmesh object
+        * nhosts              Number of hosts
+        * model               Optional STEPS Model object; if given, tetrahedrons are
+                              weighted by their number of kprocs in this model
+        * method              steps.geom.PARTITION_GRAPH (default) or steps.geom.PARTITION_SFC
+    
+    Return:
+        Tetrahedron partition list, triangle partition dictionary for parallel
+        TetOpsplit solver, and a dictionary of partition statistics
+        (host_loads, host_halo_tets, cut_area, imbalance)
+    """
+    weights = [] if model is None else mesh.getKProcTetWeights(model)
+    return mesh.partition(nhosts, method, weights)
+
+################################################################################
+
 # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
 
 ################################################################################
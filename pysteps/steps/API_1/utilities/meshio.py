@@ -1696,3 +1696,50 @@ def loadMesh(pathname, scale=1, strict=False):
 
     assert(info == '</tetmesh>')
     return (mesh,comps_out,patches_out)
+
+#############################################################################################
+
+def loadMeshBinary(pathname):
+    """
+    Load a mesh in STEPS from a binary mesh file written by
+    steps.geom.Tetmesh.saveBinary (or convertMeshToBinary).
+
+    PARAMETERS:
+
+    * pathname: the path of the binary mesh file.
+
+    RETURNS: A tuple (mesh, comps, patches)
+
+    * mesh
+      The STEPS Tetmesh object (steps.geom.Tetmesh)
+    * comps
+      A list of any compartment objects (steps.geom.TmComp) from the file
+    * patches
+      A list of any patches objects (steps.geom.TmPatch) from the file
+    """
+    mesh = stetmesh.Tetmesh.loadBinary(pathname)
+    return (mesh, mesh.getAllComps(), mesh.getAllPatches())
+
+#############################################################################################
+
+def convertMeshToBinary(pathname, binpath=None, scale=1):
+    """
+    Convert a mesh saved by saveMesh to the STEPS binary mesh format.
+
+    PARAMETERS:
+
+    * pathname: the root of the path of the XML mesh file,
+      e.g. with 'meshes/spine1' this function will read /meshes/spine1.xml
+
+    * binpath: path of the binary file to write, pathname + '.stepsmesh'
+      if not given.
+
+    * scale: optionally rescale the mesh on loading by given factor.
+
+    RETURNS: The path of the binary file.
+    """
+    if binpath is None:
+        binpath = pathname + '.stepsmesh'
+    mesh = loadMesh(pathname, scale)[0]
+    mesh.saveBinary(binpath)
+    return binpath
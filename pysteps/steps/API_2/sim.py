@@ -819,6 +819,9 @@ class MPI:
     EF_DV_PETSC = stepslib._py_API.EF_DV_PETSC
     """Possible value for the calcMembPot parameter of solvers that implement EField.
     Means that parallel PETSc EField solver should be used."""
+    EF_DV_CG = stepslib._py_API.EF_DV_CG
+    """Possible value for the calcMembPot parameter of solvers that implement EField.
+    Means that the built-in distributed conjugate gradient EField solver should be used."""
 
     _rank = None
     _nhosts = None
@@ -1142,7 +1145,7 @@ class Simulation(nutils.NamedObject, nutils.StepsWrapperObject):
             for rs in self._resultSelectors:
                 rs._toDB(dbh)
 
-    def autoCheckpoint(self, period, prefix='', onlyLast=False):
+    def autoCheckpoint(self, period, prefix='', onlyLast=False, asynchronous=False):
         """Activates automatic checkpointing
 
         After this method has been called, all subsequent calls to :py:func:`step` or
@@ -1158,6 +1161,10 @@ class Simulation(nutils.NamedObject, nutils.StepsWrapperObject):
         :type prefix: str
         :param onlyLast: If True, remove previous checkpoints when a new chekpoint is being saved.
         :type onlyLast: bool
+        :param asynchronous: If True, checkpoint files are written in the background while the
+            simulation goes on (see :py:func:`waitCheckpoint`). This also applies to
+            :py:func:`checkpoint`.
+        :type asynchronous: bool
         """
         if not isinstance(period, numbers.Number) and period is not None:
             raise TypeError(f'Expected a number or None, got {period} instead.')
@@ -1165,6 +1172,7 @@ class Simulation(nutils.NamedObject, nutils.StepsWrapperObject):
             raise TypeError(f'Expected a string for prefix parameter, got {prefix} instead.')
         if period is not None and period <= 0:
             raise ValueError(f'The auto checkpoint period needs to be strictly positive, got {period}.')
+        self.stepsSolver.setAsyncCheckpoint(asynchronous)
         self._checkpointer.setup(self.Time, period, prefix, onlyLast)
         if self._nextSave is not None:
             self._initNextSave()
@@ -1372,6 +1380,14 @@ class Simulation(nutils.NamedObject, nutils.StepsWrapperObject):
         """
         self.stepsSolver.checkpoint(fname)
 
+    def waitCheckpoint(self):
+        """Wait until the checkpoint file being written in the background, if any, is complete
+
+        Only needed when checkpoints are written asynchronously (see :py:func:`autoCheckpoint`),
+        for example to make sure that the last checkpoint is on disk before the script exits.
+        """
+        self.stepsSolver.waitCheckpoint()
+
     def restore(self, fname):
         """Restore the simulation state to a previously saved checkpoint
 
@@ -182,6 +182,7 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver::API":
         EF_DEFAULT
         EF_DV_BDSYS
         EF_DV_PETSC
+        EF_DV_CG
 
 
 # ======================================================================================================================
@@ -217,9 +218,20 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         #double getTemp() except +
         #double getA0() except +
         #uint getNSteps() except +
+        void setAsyncCheckpoint(bool) except +
+        bool getAsyncCheckpoint() except +
+        void waitCheckpoint() except +
+        uint getSpecIdx(std.string) except +
+        uint getCompIdx(std.string) except +
+        uint getPatchIdx(std.string) except +
+        uint getReacIdx(std.string) except +
+        uint getSReacIdx(std.string) except +
+        uint getDiffIdx(std.string) except +
+        uint getSurfDiffIdx(std.string) except +
         double getCompVol(std.string) except +
         void setCompVol(std.string, double) except +
         double getCompCount(std.string, std.string) except +
+        double getCompCount(uint, uint) except +
         void setCompCount(std.string, std.string, double) except +
         double getCompAmount(std.string, std.string) except +
         void setCompAmount(std.string, std.string, double) except +
@@ -244,6 +256,7 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         void setTetVol(uint, double) except +
         bool getTetSpecDefined(uint, std.string) except +
         double getTetCount(uint, std.string) except +
+        double getTetCount(uint, uint) except +
         void setTetCount(uint, std.string, double) except +
         double getTetAmount(uint, std.string) except +
         void setTetAmount(uint, std.string, double) except +
@@ -270,6 +283,7 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         double getPatchArea(std.string) except +
         void setPatchArea(std.string, double) except +
         double getPatchCount(std.string, std.string) except +
+        double getPatchCount(uint, uint) except +
         void setPatchCount(std.string, std.string, double) except +
         double getPatchAmount(std.string, std.string) except +
         void setPatchAmount(std.string, std.string, double) except +
@@ -296,6 +310,7 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         void setTriArea(uint, double) except +
         bool getTriSpecDefined(uint, std.string) except +
         double getTriCount(uint, std.string) except +
+        double getTriCount(uint, uint) except +
         void setTriCount(uint, std.string, double) except +
         double getTriAmount(uint, std.string) except +
         void setTriAmount(uint, std.string, double) except +
@@ -348,6 +363,38 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         double sumBatchTriCountsNP(uint*, int, std.string) except +
         double sumBatchTriGHKIsNP(uint*, int, std.string) except +
         double sumBatchTriOhmicIsNP(uint*, int, std.string) except +
+        void getBatchTetCountsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTetCountsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTetAmountsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTetAmountsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTetConcsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTetConcsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTetClampedNP(index_t*, int, uint, unsigned char*, int) except +
+        void setBatchTetClampedNP(index_t*, int, uint, unsigned char*, int) except +
+        void getBatchTetReacKsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTetReacKsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTetReacExtentsNP(index_t*, int, uint, unsigned long long*, int) except +
+        void getBatchTetDiffDsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTetDiffDsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTetVsNP(index_t*, int, double*, int) except +
+        void setBatchTetVsNP(index_t*, int, double*, int) except +
+        void getBatchTriCountsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTriCountsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTriAmountsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTriAmountsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTriClampedNP(index_t*, int, uint, unsigned char*, int) except +
+        void setBatchTriClampedNP(index_t*, int, uint, unsigned char*, int) except +
+        void getBatchTriSReacKsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTriSReacKsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTriSReacExtentsNP(index_t*, int, uint, unsigned long long*, int) except +
+        void getBatchTriSDiffDsNP(index_t*, int, uint, double*, int) except +
+        void setBatchTriSDiffDsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTriVsNP(index_t*, int, double*, int) except +
+        void setBatchTriVsNP(index_t*, int, double*, int) except +
+        void getBatchTriTotalOhmicIsNP(index_t*, int, double*, int) except +
+        void getBatchTriTotalGHKIsNP(index_t*, int, double*, int) except +
+        void getBatchVertVsNP(index_t*, int, double*, int) except +
+        void setBatchVertVsNP(index_t*, int, double*, int) except +
         void setDiffApplyThreshold(int) except +
         unsigned long long getReacExtent(bool) except +
         unsigned long long getDiffExtent(bool) except +
@@ -360,3 +407,40 @@ cdef extern from "steps/solver/api.hpp" namespace "steps::solver":
         double getRDTime() except +
         double getDataExchangeTime() except +
         void repartitionAndReset(std.vector[uint],std.map[uint, uint], std.vector[uint]) except +
+
+
+# ======================================================================================================================
+cdef extern from "steps/solver/recorder.hpp" namespace "steps::solver":
+# ----------------------------------------------------------------------------------------------------------------------
+    enum RecElement "steps::solver::Recorder::Element":
+        REC_COMP "steps::solver::Recorder::COMP"
+        REC_PATCH "steps::solver::Recorder::PATCH"
+        REC_TET "steps::solver::Recorder::TET"
+        REC_TRI "steps::solver::Recorder::TRI"
+        REC_VERT "steps::solver::Recorder::VERT"
+
+    enum RecQuantity "steps::solver::Recorder::Quantity":
+        REC_COUNT "steps::solver::Recorder::COUNT"
+        REC_CONC "steps::solver::Recorder::CONC"
+        REC_EXTENT "steps::solver::Recorder::EXTENT"
+        REC_V "steps::solver::Recorder::V"
+
+    ###### Cybinding for Recorder ######
+    cdef cppclass Recorder:
+        Recorder(API*)
+        uint addProbe(RecElement, std.vector[index_t], RecQuantity, std.string) except +
+        uint countProbes()
+        uint countColumns()
+        uint getProbeOffset(uint) except +
+        void setSampleDT(double) except +
+        void setSamplePoints(std.vector[double]) except +
+        void openStream(std.string) except +
+        void closeStream() except +
+        void run(double) except +
+        void advance(double) except +
+        void sample() except +
+        size_t countSamples()
+        std.vector[double] getTimes()
+        void getDataNP(double*, size_t) except +
+        void reserve(size_t) except +
+        void clear()
@@ -168,6 +168,8 @@ cdef extern from "steps/tetexact/tetexact.hpp" namespace "steps::tetexact":
         std.vector[double] getBatchTriCounts(std.vector[index_t], std.string) except +
         void getBatchTetCountsNP(index_t*, int, std.string, double*, int) except +
         void getBatchTriCountsNP(index_t*, int, std.string, double*, int) except +
+        void getBatchTetCountsNP(index_t*, int, uint, double*, int) except +
+        void getBatchTriCountsNP(index_t*, int, uint, double*, int) except +
         std.vector[double] getROITetCounts(std.string, std.string) except +
         std.vector[double] getROITriCounts(std.string, std.string) except +
         void getROITetCountsNP(std.string, std.string, double*, int) except +
@@ -195,3 +197,6 @@ cdef extern from "steps/tetexact/tetexact.hpp" namespace "steps::tetexact":
         unsigned long long getROIDiffExtent(std.string, std.string) except +
         void resetROIDiffExtent(std.string, std.string) except +
         void saveMembOpt(std.string) except +
+        void setNThreads(uint, uint) except +
+        uint getNThreads()
+        uint getNDomains()
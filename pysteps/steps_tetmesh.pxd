@@ -10,6 +10,7 @@ from libcpp cimport bool
 from steps_common cimport *
 cimport std
 cimport steps_wm
+cimport steps_model
 cimport steps
 from steps_common cimport *
 
@@ -130,11 +131,29 @@ cdef extern from "steps/geom/tetmesh.hpp" namespace "steps::tetmesh":
         ROISet()
         ROISet(ElementType, std.set[steps.index_t])
 
+    cdef enum PartitionMethod:
+        PARTITION_GRAPH
+        PARTITION_SFC
+
+    ###### Cybinding for TetPartition ######
+    cdef cppclass TetPartition:
+        std.vector[uint] tet_hosts
+        std.map[steps.triangle_id_t, uint] tri_hosts
+        std.vector[double] host_loads
+        std.vector[steps.index_t] host_halo_tets
+        double cut_area
+        double imbalance
+
     ###### Cybinding for Tetmesh ######
     cdef cppclass Tetmesh:
         # All but a few functions can throw excepts- implement for all but the countXXXs functions
         Tetmesh(std.vector[double], std.vector[steps.index_t], std.vector[steps.index_t]) except +
         Tetmesh(std.vector[double], std.vector[steps.index_t], std.vector[double], std.vector[double], std.vector[steps.index_t], std.vector[steps.index_t], std.vector[double], std.vector[double], std.vector[steps.index_t], std.vector[steps.index_t]) except +
+        void saveBinary(std.string) except +
+        @staticmethod
+        Tetmesh* loadBinary(std.string) except +
+        TetPartition partition(uint, PartitionMethod, std.vector[double]) except +
+        std.vector[double] getKProcTetWeights(steps_model.Model*) except +
         std.vector[double] getVertex(steps.index_t) except +
         steps.index_t countVertices()
         std.vector[steps.index_t] getBar(steps.index_t) except +
@@ -163,6 +182,7 @@ cdef extern from "steps/geom/tetmesh.hpp" namespace "steps::tetmesh":
         std.vector[steps.index_t] getTetTriNeighb(steps.index_t) except +
         std.vector[steps.index_t] getTetTetNeighb(steps.index_t) except +
         steps.tetrahedron_id_t findTetByPoint(std.vector[double]) except +
+        void findTetsByPointsNP(const double*, int, steps.index_t*, int) except +
         std.vector[double] getBoundMin() except +
         std.vector[double] getBoundMax() except +
         double getMeshVolume() except +
@@ -226,3 +246,4 @@ cdef extern from "steps/geom/tetmesh.hpp" namespace "steps::tetmesh":
         void setBarTris(steps.index_t bidx, steps.index_t itriidx, steps.index_t otriidx) except +
         std.vector[std.vector[std.pair[steps.index_t, double]]] intersect(const double*, int) except+
         std.vector[std.vector[std.pair[steps.index_t, double]]] intersect(const double*, int, int) except+
+        std.vector[std.vector[std.pair[steps.index_t, double]]] intersectIndependentSegments(const double*, int, int) except+
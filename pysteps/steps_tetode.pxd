@@ -98,3 +98,5 @@ cdef extern from "steps/tetode/tetode.hpp" namespace "steps::tetode":
         void setMembRes(std.string, double, double) except +
         void setTolerances(double, double) except +
         void setMaxNumSteps(uint) except +
+        void setStiff(bool, std.string) except +
+        unsigned long long getNumSteps() except +
@@ -91,7 +91,7 @@ template<typename T>
 void checkpoint(std::ostream &istr, std::vector<T> &v, bool with_size = true) {
   if (with_size) {
     auto size = v.size();
-    istr.write(reinterpret_cast<char *>(size), sizeof(decltype(size)));
+    istr.write(reinterpret_cast<char *>(&size), sizeof(decltype(size)));
   }
   istr.write(reinterpret_cast<char *>(v.data()), sizeof(T) * v.size());
 }
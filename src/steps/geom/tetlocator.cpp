@@ -0,0 +1,139 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+// STL headers
+#include <algorithm>
+#include <cmath>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+#include "steps/geom/tetlocator.hpp"
+
+// logging
+#include "easylogging++.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetmesh {
+
+using steps::math::point3d;
+using steps::math::bounding_box;
+
+////////////////////////////////////////////////////////////////////////////////
+
+TetLocator::TetLocator(std::vector<point3d> const & verts,
+                       std::vector<tet_verts> const & tets,
+                       bounding_box const & bbox)
+: pDims{{1, 1, 1}}
+{
+    if (bbox.empty() || tets.empty()) {
+        pCellOffsets.assign(2, 0);
+        return;
+    }
+
+    // Pad the box so that points accepted by the tolerant inside test
+    // on the mesh border still fall in the grid.
+    point3d ext = bbox.max() - bbox.min();
+    double pad = 1.0e-9 * std::max({ext[0], ext[1], ext[2]});
+    point3d lo = bbox.min() - point3d(pad, pad, pad);
+    point3d hi = bbox.max() + point3d(pad, pad, pad);
+    pBBox = bounding_box(lo, hi);
+    pOrigin = lo;
+    ext = hi - lo;
+
+    // Cubic cells, about one per tetrahedron.
+    double ntets = static_cast<double>(tets.size());
+    double h = std::cbrt(ext[0] * ext[1] * ext[2] / ntets);
+    for (uint k = 0; k < 3; ++k) {
+        double n = h > 0.0 ? std::ceil(ext[k] / h) : 1.0;
+        pDims[k] = static_cast<std::size_t>(std::max(1.0, std::min(n, ntets)));
+        pInvSize[k] = static_cast<double>(pDims[k]) / ext[k];
+    }
+    std::size_t ncells = pDims[0] * pDims[1] * pDims[2];
+
+    // Cell ranges of each tetrahedron's bounding box; computed twice (count
+    // then fill) instead of stored, to keep the peak memory low.
+    auto tet_range = [&](tet_verts const & tv, std::array<std::size_t, 3> & c0, std::array<std::size_t, 3> & c1) {
+        bounding_box tb;
+        for (auto v : tv) tb.insert(verts[v.get()]);
+        for (uint k = 0; k < 3; ++k) {
+            c0[k] = _cellCoord(tb.min()[k] - pad, k);
+            c1[k] = _cellCoord(tb.max()[k] + pad, k);
+        }
+    };
+
+    pCellOffsets.assign(ncells + 1, 0);
+    std::array<std::size_t, 3> c0, c1;
+    for (auto const & tv : tets) {
+        tet_range(tv, c0, c1);
+        for (auto k = c0[2]; k <= c1[2]; ++k)
+            for (auto j = c0[1]; j <= c1[1]; ++j)
+                for (auto i = c0[0]; i <= c1[0]; ++i)
+                    ++pCellOffsets[_cellIdx(i, j, k) + 1];
+    }
+    for (std::size_t c = 0; c < ncells; ++c) pCellOffsets[c + 1] += pCellOffsets[c];
+
+    pTets.resize(pCellOffsets.back());
+    std::vector<std::size_t> fill(pCellOffsets.begin(), pCellOffsets.end() - 1);
+    for (std::size_t t = 0; t < tets.size(); ++t) {
+        tet_range(tets[t], c0, c1);
+        for (auto k = c0[2]; k <= c1[2]; ++k)
+            for (auto j = c0[1]; j <= c1[1]; ++j)
+                for (auto i = c0[0]; i <= c1[0]; ++i)
+                    pTets[fill[_cellIdx(i, j, k)]++] = tetrahedron_id_t(static_cast<index_t>(t));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t TetLocator::_cellCoord(double x, uint k) const noexcept
+{
+    double c = std::floor((x - pOrigin[k]) * pInvSize[k]);
+    if (!(c > 0.0)) return 0;
+    return std::min(static_cast<std::size_t>(c), pDims[k] - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::pair<const tetrahedron_id_t *, const tetrahedron_id_t *>
+TetLocator::candidates(point3d const & p) const
+{
+    if (pTets.empty() || !pBBox.contains(p)) {
+        return {nullptr, nullptr};
+    }
+    std::size_t c = _cellIdx(_cellCoord(p[0], 0), _cellCoord(p[1], 1), _cellCoord(p[2], 2));
+    const tetrahedron_id_t * base = pTets.data();
+    return {base + pCellOffsets[c], base + pCellOffsets[c + 1]};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // namespace tetmesh
+} // namespace steps
+
+// END
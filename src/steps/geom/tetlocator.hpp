@@ -0,0 +1,106 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_TETMESH_TETLOCATOR_HPP
+#define STEPS_TETMESH_TETLOCATOR_HPP 1
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/geom/fwd.hpp"
+#include "steps/math/bbox.hpp"
+#include "steps/math/point.hpp"
+
+// STL headers
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+ namespace steps {
+ namespace tetmesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Uniform grid over the bounding box of a mesh, used to locate the
+/// tetrahedron that contains a point.
+///
+/// Each cell keeps the indices of the tetrahedrons whose bounding box
+/// overlaps it, in increasing order, packed in a single array (CSR layout).
+/// The grid has about as many cells as the mesh has tetrahedrons, so a
+/// query only tests a handful of candidates instead of the whole mesh.
+///
+/// The locator only stores indices; point-in-tetrahedron tests are left to
+/// the caller. It is immutable once built, so queries may run concurrently.
+class TetLocator
+{
+public:
+
+    typedef std::array<vertex_id_t, 4> tet_verts;
+
+    /// Build the grid for tetrahedrons tets over vertices verts, with
+    /// bounding box bbox.
+    TetLocator(std::vector<steps::math::point3d> const & verts,
+               std::vector<tet_verts> const & tets,
+               steps::math::bounding_box const & bbox);
+
+    /// Return the range of candidate tetrahedrons for point p, in
+    /// increasing index order. Empty if p lies outside the grid.
+    std::pair<const tetrahedron_id_t *, const tetrahedron_id_t *>
+    candidates(steps::math::point3d const & p) const;
+
+    /// Number of cells along each axis.
+    std::array<std::size_t, 3> const & dims() const noexcept
+    { return pDims; }
+
+private:
+
+    /// Cell coordinate of x along axis k, clamped to the grid.
+    std::size_t _cellCoord(double x, uint k) const noexcept;
+
+    inline std::size_t _cellIdx(std::size_t i, std::size_t j, std::size_t k) const noexcept
+    { return (k * pDims[1] + j) * pDims[0] + i; }
+
+    steps::math::point3d                pOrigin;
+    steps::math::point3d                pInvSize;
+    std::array<std::size_t, 3>          pDims;
+    steps::math::bounding_box           pBBox;
+
+    /// Offset of each cell in pTets; pCellOffsets.back() == pTets.size().
+    std::vector<std::size_t>            pCellOffsets;
+    std::vector<tetrahedron_id_t>       pTets;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // namespace tetmesh
+} // namespace steps
+
+#endif
+
+// STEPS_TETMESH_TETLOCATOR_HPP
+// END
@@ -47,6 +47,7 @@
 #include "steps/math/triangle.hpp"
 
 #include "steps/geom/memb.hpp"
+#include "steps/geom/tetlocator.hpp"
 #include "steps/geom/tetmesh.hpp"
 
 #include "steps/util/checkid.hpp"
@@ -859,10 +860,13 @@ tetrahedron_id_t Tetmesh::findTetByPoint(point3d const &p) const
         return UNKNOWN_TET;
     }
 
-    for (auto tidx = 0u; tidx < pTetsN; ++tidx) {
-        const tet_verts& v = pTets[tidx];
+    // Candidates come in increasing index order, so the first tetrahedron
+    // found is the same as with a scan of the whole mesh.
+    auto cands = _getTetLocator().candidates(p);
+    for (auto t = cands.first; t != cands.second; ++t) {
+        const tet_verts& v = pTets[t->get()];
         if (steps::math::tet_inside(pVerts[v[0].get()], pVerts[v[1].get()], pVerts[v[2].get()], pVerts[v[3].get()], p)) {
-            return tidx;
+            return *t;
         }
     }
 
@@ -871,6 +875,37 @@ tetrahedron_id_t Tetmesh::findTetByPoint(point3d const &p) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Tetmesh::findTetsByPointsNP(const double *points, int n_points, index_t *tets, int output_size) const
+{
+    if (n_points != output_size)
+    {
+        std::ostringstream os;
+        os << "Error: output array (tets) size should be the same as the number of points.\n";
+        ArgErrLog(os.str());
+    }
+
+    // Build the grid before entering the parallel region.
+    _getTetLocator();
+
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n_points; ++i) {
+        point3d x{points[i*3], points[i*3+1], points[i*3+2]};
+        tets[i] = findTetByPoint(x).get();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TetLocator const & Tetmesh::_getTetLocator() const
+{
+    std::call_once(pTetLocatorFlag, [this]() {
+        pTetLocator.reset(new TetLocator(pVerts, pTets, pBBox));
+    });
+    return *pTetLocator;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 std::vector<double> Tetmesh::getBoundMin() const
 {
     return as_vector(pBBox.min());
@@ -2003,6 +2038,7 @@ Tetmesh::intersectMontecarlo(const point3d &p_start,
 
     tetrahedron_id_t cur_tet = (tet_start == UNKNOWN_TET) ? findTetByPoint(p_start) : tet_start;
     if(cur_tet == UNKNOWN_TET) {
+        #pragma omp critical(steps_general_log)
         CLOG(WARNING, "general_log") << "Initial point is not in the mesh.\n";
         return segment_intersects;
     }
@@ -2064,6 +2100,7 @@ Tetmesh::intersectMontecarlo(const point3d &p_start,
 
         // FAIL
         if (cur_tet == UNKNOWN_TET) {
+            #pragma omp critical(steps_general_log)
             CLOG(WARNING, "general_log") << "Could not find sample point.\n";
             continue;
         }
@@ -2091,6 +2128,7 @@ Tetmesh::intersectDeterministic(const point3d &p_start,
 
     tetrahedron_id_t cur_tet = (tet_start == UNKNOWN_TET) ? findTetByPoint(p_start) : tet_start;
     if(cur_tet==UNKNOWN_TET) {
+        #pragma omp critical(steps_general_log)
         CLOG(WARNING, "general_log") << "Initial point is not in the mesh.\n";
         return segment_intersects;
     }
@@ -2152,6 +2190,7 @@ Tetmesh::intersectDeterministic(const point3d &p_start,
             // We tried all neighbors already, give up
             if (neighbs_id >= tet_neighbors.size())
             {
+                #pragma omp critical(steps_general_log)
                 CLOG(WARNING, "general_log") << "Could not find endpoint.\n";
                 return segment_intersects;
             }
@@ -2164,6 +2203,7 @@ Tetmesh::intersectDeterministic(const point3d &p_start,
 
         // Otherwise,  == UNKNOWN_TET then the segment finishes outside the mesh
         if (next_tet == UNKNOWN_TET) {
+            #pragma omp critical(steps_general_log)
             CLOG(WARNING, "general_log") << "Endpoint is outside mesh.\n";
             return segment_intersects;
         }
@@ -2213,6 +2253,32 @@ Tetmesh::intersect(const double *points, int n_points, int sampling) const
     return intersecs;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<Tetmesh::intersection_list_t>
+Tetmesh::intersectIndependentSegments(const double *points, int n_segments, int sampling) const
+{
+    std::vector<Tetmesh::intersection_list_t> intersecs(n_segments > 0 ? n_segments : 0);
+
+    // Build the grid before entering the parallel region.
+    _getTetLocator();
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (int i = 0; i < n_segments; ++i) {
+        const double *seg = points + i*6;
+        point3d start_p(seg[0], seg[1], seg[2]);
+        point3d end_p(seg[3], seg[4], seg[5]);
+        std::vector<std::pair<tetrahedron_id_t, double>> isecs;
+        if (sampling > 0)
+            isecs = intersectMontecarlo(start_p, end_p, UNKNOWN_TET, sampling);
+        else
+            isecs = intersectDeterministic(start_p, end_p, UNKNOWN_TET);
+        // We reinterpret cast since the types are equivallent but not auto convertible
+        intersecs[i] = std::move(*reinterpret_cast<Tetmesh::intersection_list_t*>(&isecs));
+    }
+    return intersecs;
+}
+
 
 } // namespace tetmesh
 } // namespace steps
@@ -40,10 +40,13 @@
 #include "steps/geom/memb.hpp"
 #include "steps/geom/diffboundary.hpp"
 #include "steps/geom/sdiffboundary.hpp"
+#include "steps/geom/tetpartition.hpp"
 
 // STL headers
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -58,6 +61,7 @@ class TmPatch;
 class TmComp;
 class Memb;
 class DiffBoundary;
+class TetLocator;
 class SDiffBoundary;
 
 // FIXME TCL: use proper storage according to type of element
@@ -185,6 +189,52 @@ public:
     /// Destructor
     virtual ~Tetmesh();
 
+    ////////////////////////////////////////////////////////////////////////
+    // BINARY MESH FILES
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Save the mesh in the STEPS binary mesh format.
+    ///
+    /// Besides the vertices, triangles and tetrahedrons, the file stores
+    /// all precomputed data (bars, adjacency, volumes, areas, normals and
+    /// barycenters), the compartments and patches with their volume and
+    /// surface system ids, and the ROIs. Membranes and diffusion
+    /// boundaries are not saved.
+    ///
+    /// \param pathname Path of the file to write.
+    void saveBinary(std::string const & pathname) const;
+
+    /// Create a mesh from a file written by saveBinary().
+    ///
+    /// The file is memory-mapped and its tables are copied as they are;
+    /// no adjacency is recomputed. The compartments and patches stored
+    /// in the file are recreated and owned by the returned mesh.
+    ///
+    /// \param pathname Path of the file to read.
+    /// \return Pointer to the new mesh, owned by the caller.
+    static Tetmesh * loadBinary(std::string const & pathname);
+
+    ////////////////////////////////////////////////////////////////////////
+    // PARTITIONING
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Partition the tetrahedrons over nparts hosts of the parallel
+    /// TetOpSplit solver; see partitionMesh().
+    ///
+    /// \param nparts Number of hosts.
+    /// \param method Graph bisection or space-filling curve.
+    /// \param tet_weights Cost of each tetrahedron, or empty.
+    /// \return Tetrahedron and patch triangle hosts, and partition statistics.
+    TetPartition partition(uint nparts, PartitionMethod method = PARTITION_GRAPH,
+                           std::vector<double> const & tet_weights = {}) const;
+
+    /// Number of kprocs of each tetrahedron in a simulation of model,
+    /// to be used as weights by partition().
+    ///
+    /// \param model Model of the simulation.
+    /// \return Weight of each tetrahedron.
+    std::vector<double> getKProcTetWeights(steps::model::Model * model) const;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS (EXPOSED TO PYTHON): VERTICES
     ////////////////////////////////////////////////////////////////////////
@@ -439,6 +489,14 @@ public:
 
     tetrahedron_id_t findTetByPoint(point3d const &p) const;
 
+    /// Find the tetrahedrons which encompass a list of points, in parallel.
+    /// \param points Coordinates of the points, 3 per point.
+    /// \param n_points Number of points.
+    /// \param tets Output: for each point, the index of the tetrahedron
+    ///             found as with findTetByPoint, or UNKNOWN_TET.
+    /// \param output_size Size of tets, must be n_points.
+    void findTetsByPointsNP(const double *points, int n_points, index_t *tets, int output_size) const;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS (EXPOSED TO PYTHON): MESH
     ////////////////////////////////////////////////////////////////////////
@@ -489,6 +547,17 @@ public:
     std::vector<intersection_list_t>
     intersect(const double *points, int n_points, int sampling = -1) const;
 
+    /// Computes the percentage of intersection of independent segments with
+    /// the mesh tets, in parallel.
+    ///
+    /// \param points Coordinates of the start and end point of each segment,
+    ///               6 per segment.
+    /// \param n_segments Number of segments.
+    /// \param sampling Monte-carlo samples per segment; deterministic if < 1.
+    /// \return A vector of vectors (for each segment) containing pairs <tet, intersection ratio>
+    std::vector<intersection_list_t>
+    intersectIndependentSegments(const double *points, int n_segments, int sampling = -1) const;
+
 
     ////////////////////////////////////////////////////////////////////////
     // Batch Data Access
@@ -887,9 +956,15 @@ public:
     static const tet_tets UNKNOWN_TET_NEIGHBORS;
 
 private:
+    /// Empty mesh, filled in by loadBinary().
+    Tetmesh() = default;
+
     /// Build pBars, pBarsN, pTri_bars from pTris.
     void buildBarData();
 
+    /// Return the point location grid, building it on first use.
+    TetLocator const & _getTetLocator() const;
+
     ///////////////////////// DATA: VERTICES ///////////////////////////////
     ///
     /// The total number of vertices in the mesh
@@ -956,6 +1031,10 @@ private:
     /// Information about the minimal and maximal boundary values
     steps::math::bounding_box           pBBox;
 
+    /// Grid for point location, built lazily by _getTetLocator().
+    mutable std::unique_ptr<TetLocator> pTetLocator;
+    mutable std::once_flag              pTetLocatorFlag;
+
     ////////////////////////////////////////////////////////////////////////
 
     // List of contained membranes. Members of this class because they
@@ -0,0 +1,499 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+// STL headers.
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// POSIX headers.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+#include "steps/geom/tetlocator.hpp"
+#include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tmcomp.hpp"
+#include "steps/geom/tmpatch.hpp"
+
+// logging
+#include "easylogging++.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Layout of a binary mesh file, version 1. All integers and floating point
+/// values are stored in the byte order of the writing machine, which is
+/// checked on loading.
+///
+///     header              MeshFileHeader
+///     vertices            nverts x 3 double
+///     bars                nbars x 2 index
+///     triangles           ntris x 3 index
+///     tri bars            ntris x 3 index
+///     tri areas           ntris double
+///     tri barycenters     ntris x 3 double
+///     tri normals         ntris x 3 double
+///     tri tet neighbours  ntris x 2 index
+///     tetrahedrons        ntets x 4 index
+///     tet volumes         ntets double
+///     tet barycenters     ntets x 3 double
+///     tet tri neighbours  ntets x 4 index
+///     tet tet neighbours  ntets x 4 index
+///     compartments        ncomps records
+///     patches             npatches records
+///     ROIs                nrois records
+///
+/// Each table starts on an 8-byte boundary. Records are made of strings
+/// (uint64 length then characters), string lists and index lists (uint64
+/// size then items), without padding.
+///
+///     compartment:  id, volume systems, tets
+///     patch:        id, surface systems, inner comp id, outer comp id
+///                   (empty if none), tris
+///     ROI:          id, uint32 element type, indices
+
+namespace steps {
+namespace tetmesh {
+
+namespace {
+
+const char MESH_FILE_MAGIC[8] = {'S', 'T', 'E', 'P', 'S', 'M', 'S', 'H'};
+const std::uint32_t MESH_FILE_VERSION = 1;
+const std::uint32_t MESH_FILE_ENDIAN = 0x01020304;
+
+struct MeshFileHeader {
+    char            magic[8];
+    std::uint32_t   version;
+    std::uint32_t   endian;
+    std::uint32_t   index_bytes;
+    std::uint32_t   reserved;
+    std::uint64_t   nverts;
+    std::uint64_t   nbars;
+    std::uint64_t   ntris;
+    std::uint64_t   ntets;
+    std::uint64_t   ncomps;
+    std::uint64_t   npatches;
+    std::uint64_t   nrois;
+};
+
+static_assert(sizeof(MeshFileHeader) % 8 == 0, "Unexpected padding in mesh file header");
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Tables are copied as raw memory; make sure that is meaningful.
+template <typename T, typename V>
+struct is_packed_table:
+    std::integral_constant<bool,
+        std::is_trivially_copyable<T>::value
+        && sizeof(T) % sizeof(V) == 0> {};
+
+static_assert(is_packed_table<Tetmesh::point3d, double>::value, "point3d is not a packed table");
+static_assert(is_packed_table<Tetmesh::tet_verts, index_t>::value, "tet_verts is not a packed table");
+static_assert(is_packed_table<Tetmesh::tri_verts, index_t>::value, "tri_verts is not a packed table");
+static_assert(is_packed_table<Tetmesh::bar_verts, index_t>::value, "bar_verts is not a packed table");
+static_assert(is_packed_table<Tetmesh::tri_bars, index_t>::value, "tri_bars is not a packed table");
+static_assert(is_packed_table<Tetmesh::tri_tets, index_t>::value, "tri_tets is not a packed table");
+static_assert(is_packed_table<Tetmesh::tet_tris, index_t>::value, "tet_tris is not a packed table");
+static_assert(is_packed_table<Tetmesh::tet_tets, index_t>::value, "tet_tets is not a packed table");
+static_assert(sizeof(triangle_id_t) == sizeof(index_t), "Unexpected size of triangle_id_t");
+
+////////////////////////////////////////////////////////////////////////////////
+
+class MeshFileWriter {
+public:
+    explicit MeshFileWriter(std::string const & pathname)
+    : pPathname(pathname)
+    , pOut(pathname, std::ios::binary | std::ios::trunc)
+    {
+        if (!pOut) {
+            ArgErrLog("Unable to open '" + pathname + "' for writing.");
+        }
+    }
+
+    void write(const void * data, std::size_t nbytes) {
+        pOut.write(static_cast<const char *>(data), static_cast<std::streamsize>(nbytes));
+        pPos += nbytes;
+        if (!pOut) {
+            ArgErrLog("Error while writing '" + pPathname + "'.");
+        }
+    }
+
+    template <typename T>
+    void value(T const & v) {
+        write(&v, sizeof(T));
+    }
+
+    template <typename T>
+    void table(std::vector<T> const & v) {
+        static const char zeros[8] = {0};
+        write(zeros, (8 - pPos % 8) % 8);
+        write(v.data(), v.size() * sizeof(T));
+    }
+
+    void string(std::string const & s) {
+        value<std::uint64_t>(s.size());
+        write(s.data(), s.size());
+    }
+
+    template <typename C>
+    void strings(C const & c) {
+        value<std::uint64_t>(c.size());
+        for (auto const & s: c) {
+            string(s);
+        }
+    }
+
+    template <typename T>
+    void indices(std::vector<T> const & v) {
+        value<std::uint64_t>(v.size());
+        write(v.data(), v.size() * sizeof(T));
+    }
+
+    void close() {
+        pOut.close();
+        if (!pOut) {
+            ArgErrLog("Error while closing '" + pPathname + "'.");
+        }
+    }
+
+private:
+    std::string     pPathname;
+    std::ofstream   pOut;
+    std::size_t     pPos{0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Read-only private mapping of a whole file.
+class MappedFile {
+public:
+    explicit MappedFile(std::string const & pathname)
+    : pPathname(pathname)
+    {
+        int fd = ::open(pathname.c_str(), O_RDONLY);
+        if (fd < 0) {
+            ArgErrLog("Unable to open '" + pathname + "' for reading.");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            ArgErrLog("Unable to stat '" + pathname + "'.");
+        }
+        pSize = static_cast<std::size_t>(st.st_size);
+        if (pSize != 0) {
+            void * addr = ::mmap(nullptr, pSize, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                ArgErrLog("Unable to map '" + pathname + "' in memory.");
+            }
+            pData = static_cast<const char *>(addr);
+#ifdef MADV_SEQUENTIAL
+            ::madvise(addr, pSize, MADV_SEQUENTIAL);
+#endif
+        }
+        ::close(fd);
+    }
+
+    MappedFile(MappedFile const &) = delete;
+    MappedFile & operator=(MappedFile const &) = delete;
+
+    ~MappedFile() {
+        if (pData != nullptr) {
+            ::munmap(const_cast<char *>(pData), pSize);
+        }
+    }
+
+    void read(void * dst, std::size_t nbytes) {
+        if (nbytes > pSize - pPos) {
+            ArgErrLog("Binary mesh file '" + pPathname + "' is truncated.");
+        }
+        if (nbytes != 0) {
+            std::memcpy(dst, pData + pPos, nbytes);
+        }
+        pPos += nbytes;
+    }
+
+    template <typename T>
+    T value() {
+        T v;
+        read(&v, sizeof(T));
+        return v;
+    }
+
+    /// Size of a count read from the file, rejecting counts that cannot
+    /// fit in the rest of the file.
+    std::size_t count(std::size_t item_bytes) {
+        auto n = value<std::uint64_t>();
+        if (item_bytes != 0 && n > (pSize - pPos) / item_bytes) {
+            ArgErrLog("Binary mesh file '" + pPathname + "' is truncated.");
+        }
+        return n;
+    }
+
+    template <typename T>
+    void table(std::vector<T> & v, std::size_t n) {
+        std::size_t pad = (8 - pPos % 8) % 8;
+        if (pad > pSize - pPos) {
+            ArgErrLog("Binary mesh file '" + pPathname + "' is truncated.");
+        }
+        pPos += pad;
+        if (n > (pSize - pPos) / sizeof(T)) {
+            ArgErrLog("Binary mesh file '" + pPathname + "' is truncated.");
+        }
+        v.resize(n);
+        read(v.data(), n * sizeof(T));
+    }
+
+    std::string string() {
+        std::string s(count(1), '\0');
+        read(&s[0], s.size());
+        return s;
+    }
+
+    std::vector<std::string> strings() {
+        std::vector<std::string> v(count(sizeof(std::uint64_t)));
+        for (auto & s: v) {
+            s = string();
+        }
+        return v;
+    }
+
+    std::vector<index_t> indices() {
+        std::vector<index_t> v(count(sizeof(index_t)));
+        read(v.data(), v.size() * sizeof(index_t));
+        return v;
+    }
+
+private:
+    std::string     pPathname;
+    const char *    pData{nullptr};
+    std::size_t     pSize{0};
+    std::size_t     pPos{0};
+};
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetmesh::saveBinary(std::string const & pathname) const
+{
+    std::vector<TmComp *> comps;
+    for (uint c = 0; c < _countComps(); ++c) {
+        auto tmcomp = dynamic_cast<TmComp *>(_getComp(c));
+        if (tmcomp == nullptr) {
+            ArgErrLog("Compartment '" + _getComp(c)->getID() + "' is not a TmComp and cannot be saved in a binary mesh file.");
+        }
+        comps.push_back(tmcomp);
+    }
+    std::vector<TmPatch *> patches;
+    for (uint p = 0; p < _countPatches(); ++p) {
+        auto tmpatch = dynamic_cast<TmPatch *>(_getPatch(p));
+        if (tmpatch == nullptr) {
+            ArgErrLog("Patch '" + _getPatch(p)->getID() + "' is not a TmPatch and cannot be saved in a binary mesh file.");
+        }
+        patches.push_back(tmpatch);
+    }
+
+    MeshFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MESH_FILE_MAGIC, sizeof(header.magic));
+    header.version = MESH_FILE_VERSION;
+    header.endian = MESH_FILE_ENDIAN;
+    header.index_bytes = sizeof(index_t);
+    header.nverts = pVertsN;
+    header.nbars = pBarsN;
+    header.ntris = pTrisN;
+    header.ntets = pTetsN;
+    header.ncomps = comps.size();
+    header.npatches = patches.size();
+    header.nrois = rois.size();
+
+    MeshFileWriter out(pathname);
+    out.value(header);
+
+    out.table(pVerts);
+    out.table(pBars);
+    out.table(pTris);
+    out.table(pTri_bars);
+    out.table(pTri_areas);
+    out.table(pTri_barycs);
+    out.table(pTri_norms);
+    out.table(pTri_tet_neighbours);
+    out.table(pTets);
+    out.table(pTet_vols);
+    out.table(pTet_barycenters);
+    out.table(pTet_tri_neighbours);
+    out.table(pTet_tet_neighbours);
+
+    for (auto comp: comps) {
+        out.string(comp->getID());
+        out.strings(comp->getVolsys());
+        out.indices(comp->_getAllTetIndices());
+    }
+
+    for (auto patch: patches) {
+        out.string(patch->getID());
+        out.strings(patch->getSurfsys());
+        out.string(patch->getIComp() != nullptr ? patch->getIComp()->getID() : std::string());
+        out.string(patch->getOComp() != nullptr ? patch->getOComp()->getID() : std::string());
+        out.indices(patch->_getAllTriIndices());
+    }
+
+    for (auto const & roi: rois.tets_roi) {
+        out.string(roi.first);
+        out.value<std::uint32_t>(ELEM_TET);
+        out.indices(roi.second);
+    }
+    for (auto const & roi: rois.tris_roi) {
+        out.string(roi.first);
+        out.value<std::uint32_t>(ELEM_TRI);
+        out.indices(roi.second);
+    }
+    for (auto const & roi: rois.vertices_roi) {
+        out.string(roi.first);
+        out.value<std::uint32_t>(ELEM_VERTEX);
+        out.indices(roi.second);
+    }
+
+    out.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Tetmesh * Tetmesh::loadBinary(std::string const & pathname)
+{
+    MappedFile in(pathname);
+
+    auto header = in.value<MeshFileHeader>();
+    if (std::memcmp(header.magic, MESH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        ArgErrLog("'" + pathname + "' is not a STEPS binary mesh file.");
+    }
+    if (header.version != MESH_FILE_VERSION) {
+        ArgErrLog("Unsupported version " + std::to_string(header.version) + " of binary mesh file '" + pathname + "'.");
+    }
+    if (header.endian != MESH_FILE_ENDIAN) {
+        ArgErrLog("Binary mesh file '" + pathname + "' was written on a machine of different byte order.");
+    }
+    if (header.index_bytes != sizeof(index_t)) {
+        ArgErrLog("Binary mesh file '" + pathname + "' uses " + std::to_string(header.index_bytes)
+                  + "-byte indices, this build of STEPS uses " + std::to_string(sizeof(index_t)) + "-byte indices.");
+    }
+    if (header.nverts == 0 || header.ntets == 0) {
+        ArgErrLog("Binary mesh file '" + pathname + "' has no vertices or tetrahedrons.");
+    }
+
+    std::unique_ptr<Tetmesh> mesh(new Tetmesh());
+    Tetmesh & m = *mesh;
+
+    m.pVertsN = header.nverts;
+    m.pBarsN = header.nbars;
+    m.pTrisN = header.ntris;
+    m.pTetsN = header.ntets;
+
+    in.table(m.pVerts, header.nverts);
+    in.table(m.pBars, header.nbars);
+    in.table(m.pTris, header.ntris);
+    in.table(m.pTri_bars, header.ntris);
+    in.table(m.pTri_areas, header.ntris);
+    in.table(m.pTri_barycs, header.ntris);
+    in.table(m.pTri_norms, header.ntris);
+    in.table(m.pTri_tet_neighbours, header.ntris);
+    in.table(m.pTets, header.ntets);
+    in.table(m.pTet_vols, header.ntets);
+    in.table(m.pTet_barycenters, header.ntets);
+    in.table(m.pTet_tri_neighbours, header.ntets);
+    in.table(m.pTet_tet_neighbours, header.ntets);
+
+    for (auto const & v: m.pVerts) {
+        m.pBBox.insert(v);
+    }
+
+    m.pBar_sdiffboundaries.assign(m.pBarsN, nullptr);
+    m.pBar_tri_neighbours.assign(m.pBarsN, bar_tris{{UNKNOWN_TRI, UNKNOWN_TRI}});
+    m.pTri_patches.assign(m.pTrisN, nullptr);
+    m.pTri_diffboundaries.assign(m.pTrisN, nullptr);
+    m.pTet_comps.assign(m.pTetsN, nullptr);
+
+    // Compartments and patches register themselves with the mesh, which
+    // then owns them.
+    for (std::uint64_t c = 0; c < header.ncomps; ++c) {
+        auto id = in.string();
+        auto volsys = in.strings();
+        auto tets = in.indices();
+        auto comp = new TmComp(id, &m, tets);
+        for (auto const & vsys: volsys) {
+            comp->addVolsys(vsys);
+        }
+    }
+
+    for (std::uint64_t p = 0; p < header.npatches; ++p) {
+        auto id = in.string();
+        auto surfsys = in.strings();
+        auto icomp_id = in.string();
+        auto ocomp_id = in.string();
+        auto tris = in.indices();
+        auto icomp = icomp_id.empty() ? nullptr : m.getComp(icomp_id);
+        auto ocomp = ocomp_id.empty() ? nullptr : m.getComp(ocomp_id);
+        auto patch = new TmPatch(id, &m, tris, icomp, ocomp);
+        for (auto const & ssys: surfsys) {
+            patch->addSurfsys(ssys);
+        }
+    }
+
+    for (std::uint64_t r = 0; r < header.nrois; ++r) {
+        auto id = in.string();
+        auto type = in.value<std::uint32_t>();
+        auto idx = in.indices();
+        switch (type) {
+        case ELEM_TET:
+            m.rois.insert<ROI_TET>(id, ROITypeTraits<ROI_TET>::data_type(idx.begin(), idx.end()));
+            break;
+        case ELEM_TRI:
+            m.rois.insert<ROI_TRI>(id, ROITypeTraits<ROI_TRI>::data_type(idx.begin(), idx.end()));
+            break;
+        case ELEM_VERTEX:
+            m.rois.insert<ROI_VERTEX>(id, ROITypeTraits<ROI_VERTEX>::data_type(idx.begin(), idx.end()));
+            break;
+        default:
+            ArgErrLog("Unknown element type of ROI '" + id + "' in binary mesh file '" + pathname + "'.");
+        }
+    }
+
+    return mesh.release();
+}
+
+} // namespace tetmesh
+} // namespace steps
+
+// END
@@ -0,0 +1,719 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+// STL headers
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <utility>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+#include "steps/geom/tetpartition.hpp"
+#include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tmcomp.hpp"
+#include "steps/geom/tmpatch.hpp"
+#include "steps/model/model.hpp"
+#include "steps/model/surfsys.hpp"
+
+// logging
+#include "easylogging++.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetmesh {
+
+using steps::math::point3d;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Undirected weighted graph in compressed row storage.
+struct Graph
+{
+    std::vector<index_t>                xadj{0};
+    std::vector<index_t>                adjncy;
+    std::vector<double>                 adjwgt;
+    std::vector<double>                 vwgt;
+
+    inline index_t size() const noexcept
+    { return static_cast<index_t>(vwgt.size()); }
+
+    inline double totalWeight() const noexcept
+    { return std::accumulate(vwgt.begin(), vwgt.end(), 0.0); }
+};
+
+// Stop coarsening below this many vertices.
+const index_t COARSEN_TO = 64;
+
+// Allowed excess of a side over its target weight.
+const double BALANCE_TOL = 0.03;
+
+// Refinement passes per level.
+const uint REFINE_PASSES = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Graph of the vertices v with side[v] == s, and the vertices of g they
+/// stand for.
+Graph _induced(Graph const & g, std::vector<char> const & side, char s,
+               std::vector<index_t> & vmap)
+{
+    std::vector<index_t> local(g.size(), UNKNOWN_TET.get());
+    vmap.clear();
+    for (index_t v = 0; v < g.size(); ++v) {
+        if (side[v] == s) {
+            local[v] = static_cast<index_t>(vmap.size());
+            vmap.push_back(v);
+        }
+    }
+
+    Graph sub;
+    sub.vwgt.reserve(vmap.size());
+    sub.xadj.reserve(vmap.size() + 1);
+    for (auto v: vmap) {
+        sub.vwgt.push_back(g.vwgt[v]);
+        for (auto e = g.xadj[v]; e < g.xadj[v + 1]; ++e) {
+            auto u = g.adjncy[e];
+            if (side[u] != s) continue;
+            sub.adjncy.push_back(local[u]);
+            sub.adjwgt.push_back(g.adjwgt[e]);
+        }
+        sub.xadj.push_back(static_cast<index_t>(sub.adjncy.size()));
+    }
+    return sub;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Collapse a heavy-edge matching of g. cmap receives the coarse vertex of
+/// every vertex of g.
+Graph _coarsen(Graph const & g, std::vector<index_t> & cmap, std::mt19937 & rng)
+{
+    const index_t n = g.size();
+    const index_t unmatched = UNKNOWN_TET.get();
+
+    std::vector<index_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<index_t> match(n, unmatched);
+    cmap.assign(n, unmatched);
+    index_t nc = 0;
+    for (auto v: order) {
+        if (match[v] != unmatched) continue;
+        index_t best = v;
+        double bestw = -1.0;
+        for (auto e = g.xadj[v]; e < g.xadj[v + 1]; ++e) {
+            auto u = g.adjncy[e];
+            if (match[u] == unmatched && g.adjwgt[e] > bestw) {
+                best = u;
+                bestw = g.adjwgt[e];
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+        cmap[v] = nc;
+        cmap[best] = nc;
+        ++nc;
+    }
+
+    Graph c;
+    c.vwgt.assign(nc, 0.0);
+    for (index_t v = 0; v < n; ++v) {
+        c.vwgt[cmap[v]] += g.vwgt[v];
+    }
+
+    // Members of each coarse vertex, to visit them in coarse order.
+    std::vector<index_t> first(nc + 1, 0);
+    for (index_t v = 0; v < n; ++v) {
+        ++first[cmap[v] + 1];
+    }
+    std::partial_sum(first.begin(), first.end(), first.begin());
+    std::vector<index_t> members(n);
+    std::vector<index_t> fill(first.begin(), first.end() - 1);
+    for (index_t v = 0; v < n; ++v) {
+        members[fill[cmap[v]]++] = v;
+    }
+
+    std::vector<index_t> slot(nc, unmatched);
+    c.xadj.reserve(nc + 1);
+    for (index_t cv = 0; cv < nc; ++cv) {
+        auto row = static_cast<index_t>(c.adjncy.size());
+        for (auto m = first[cv]; m < first[cv + 1]; ++m) {
+            auto v = members[m];
+            for (auto e = g.xadj[v]; e < g.xadj[v + 1]; ++e) {
+                auto cu = cmap[g.adjncy[e]];
+                if (cu == cv) continue;
+                if (slot[cu] == unmatched || slot[cu] < row) {
+                    slot[cu] = static_cast<index_t>(c.adjncy.size());
+                    c.adjncy.push_back(cu);
+                    c.adjwgt.push_back(g.adjwgt[e]);
+                }
+                else {
+                    c.adjwgt[slot[cu]] += g.adjwgt[e];
+                }
+            }
+        }
+        c.xadj.push_back(static_cast<index_t>(c.adjncy.size()));
+    }
+    return c;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Last vertex reached by a breadth-first search from start within its
+/// connected component. Unreached vertices are left untouched in dist.
+index_t _bfsFarthest(Graph const & g, index_t start, std::vector<index_t> & dist)
+{
+    const index_t unseen = UNKNOWN_TET.get();
+    std::vector<index_t> queue{start};
+    dist[start] = 0;
+    index_t last = start;
+    for (std::size_t q = 0; q < queue.size(); ++q) {
+        auto v = queue[q];
+        last = v;
+        for (auto e = g.xadj[v]; e < g.xadj[v + 1]; ++e) {
+            auto u = g.adjncy[e];
+            if (dist[u] == unseen) {
+                dist[u] = dist[v] + 1;
+                queue.push_back(u);
+            }
+        }
+    }
+    for (auto v: queue) {
+        dist[v] = unseen;
+    }
+    return last;
+}
+
+/// Grow side 0 breadth-first from a pseudo-peripheral vertex until it holds
+/// target0 of the weight. Disconnected components are started in turn.
+void _growBisection(Graph const & g, double target0, std::vector<char> & side)
+{
+    const index_t n = g.size();
+    const index_t unseen = UNKNOWN_TET.get();
+    side.assign(n, 1);
+    if (n == 0) return;
+
+    std::vector<index_t> dist(n, unseen);
+    std::vector<char> queued(n, 0);
+    std::vector<index_t> queue;
+    double w0 = 0.0;
+    index_t next_seed = 0;
+
+    while (w0 < target0) {
+        while (next_seed < n && queued[next_seed]) ++next_seed;
+        if (next_seed == n) break;
+
+        auto seed = _bfsFarthest(g, _bfsFarthest(g, next_seed, dist), dist);
+        queue.assign(1, seed);
+        queued[seed] = 1;
+        bool full = false;
+        for (std::size_t q = 0; q < queue.size(); ++q) {
+            auto v = queue[q];
+            // Stop short rather than overshoot by more than half the vertex.
+            if (w0 >= target0 || (w0 > 0.0 && w0 + 0.5 * g.vwgt[v] > target0)) {
+                full = true;
+                break;
+            }
+            side[v] = 0;
+            w0 += g.vwgt[v];
+            for (auto e = g.xadj[v]; e < g.xadj[v + 1]; ++e) {
+                auto u = g.adjncy[e];
+                if (!queued[u]) {
+                    queued[u] = 1;
+                    queue.push_back(u);
+                }
+            }
+        }
+        // Otherwise the component is exhausted: start the next one.
+        if (full) break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Greedy boundary refinement of a bisection: move vertices that reduce the
+/// cut without breaking the balance, then move the cheapest vertices out of
+/// an overweight side.
+void _refineBisection(Graph const & g, double target0, std::vector<char> & side)
+{
+    const index_t n = g.size();
+    const double total = g.totalWeight();
+    const double ub[2] = {target0 * (1.0 + BALANCE_TOL),
+                          (total - target0) * (1.0 + BALANCE_TOL)};
+
+    double w[2] = {0.0, 0.0};
+    for (index_t v = 0; v < n; ++v) {
+        w[static_cast<int>(side[v])] += g.vwgt[v];
+    }
+
+    // Cut reduction obtained by moving v to the other side.
+    auto gain = [&](index_t v) {
+        double gv = 0.0;
+        for (auto e = g.xadj[v]; e < g.xadj[v + 1]; ++e) {
+            gv += (side[g.adjncy[e]] == side[v]) ? -g.adjwgt[e] : g.adjwgt[e];
+        }
+        return gv;
+    };
+
+    auto isBoundary = [&](index_t v) {
+        for (auto e = g.xadj[v]; e < g.xadj[v + 1]; ++e) {
+            if (side[g.adjncy[e]] != side[v]) return true;
+        }
+        return false;
+    };
+
+    std::vector<std::pair<double, index_t>> cands;
+    for (uint pass = 0; pass < REFINE_PASSES; ++pass) {
+        cands.clear();
+        for (index_t v = 0; v < n; ++v) {
+            if (isBoundary(v)) cands.emplace_back(-gain(v), v);
+        }
+        std::sort(cands.begin(), cands.end());
+
+        uint moved = 0;
+        for (auto const & c: cands) {
+            auto v = c.second;
+            int from = side[v];
+            int to = 1 - from;
+            double gv = gain(v);
+            bool fits = w[to] + g.vwgt[v] <= ub[to];
+            bool balances = w[from] > ub[from] && w[to] + g.vwgt[v] < w[from];
+            if ((gv > 0.0 && fits) || (gv >= 0.0 && balances)) {
+                side[v] = static_cast<char>(to);
+                w[from] -= g.vwgt[v];
+                w[to] += g.vwgt[v];
+                ++moved;
+            }
+        }
+
+        // Restore the balance at the lowest cost.
+        for (int from = 0; from < 2; ++from) {
+            int to = 1 - from;
+            if (w[from] <= ub[from]) continue;
+            cands.clear();
+            for (index_t v = 0; v < n; ++v) {
+                if (side[v] == from && g.vwgt[v] > 0.0 && isBoundary(v)) {
+                    cands.emplace_back(-gain(v), v);
+                }
+            }
+            std::sort(cands.begin(), cands.end());
+            for (auto const & c: cands) {
+                if (w[from] <= ub[from]) break;
+                auto v = c.second;
+                if (w[to] + g.vwgt[v] >= w[from]) continue;
+                side[v] = static_cast<char>(to);
+                w[from] -= g.vwgt[v];
+                w[to] += g.vwgt[v];
+                ++moved;
+            }
+        }
+
+        if (moved == 0) break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Multilevel bisection of g, side 0 receiving target0 of the weight.
+void _bisect(Graph const & g, double target0, std::vector<char> & side,
+             std::mt19937 & rng)
+{
+    if (g.size() <= COARSEN_TO) {
+        _growBisection(g, target0, side);
+        _refineBisection(g, target0, side);
+        return;
+    }
+
+    std::vector<index_t> cmap;
+    Graph coarse = _coarsen(g, cmap, rng);
+    if (coarse.size() * 20 > g.size() * 19) {
+        // Matching stalled (e.g. a star-like graph): partition this level.
+        _growBisection(g, target0, side);
+        _refineBisection(g, target0, side);
+        return;
+    }
+
+    std::vector<char> cside;
+    _bisect(coarse, target0, cside, rng);
+
+    side.resize(g.size());
+    for (index_t v = 0; v < g.size(); ++v) {
+        side[v] = cside[cmap[v]];
+    }
+    _refineBisection(g, target0, side);
+}
+
+/// Recursive bisection of g into k parts numbered from first; vmap gives
+/// the vertex of the original graph of every vertex of g.
+void _partitionRecursive(Graph const & g, std::vector<index_t> const & vmap,
+                         uint k, uint first, std::vector<uint> & part,
+                         std::mt19937 & rng)
+{
+    if (k == 1 || g.size() == 0) {
+        for (auto v: vmap) {
+            part[v] = first;
+        }
+        return;
+    }
+
+    uint k0 = k / 2;
+    double total = g.totalWeight();
+    double target0 = (total > 0.0 ? total : static_cast<double>(g.size()))
+                     * static_cast<double>(k0) / static_cast<double>(k);
+
+    std::vector<char> side;
+    if (total > 0.0) {
+        _bisect(g, target0, side, rng);
+    }
+    else {
+        Graph unit = g;
+        std::fill(unit.vwgt.begin(), unit.vwgt.end(), 1.0);
+        _bisect(unit, target0, side, rng);
+    }
+
+    for (char s = 0; s < 2; ++s) {
+        std::vector<index_t> lmap;
+        Graph sub = _induced(g, side, s, lmap);
+        for (auto & v: lmap) {
+            v = vmap[v];
+        }
+        if (s == 0) {
+            _partitionRecursive(sub, lmap, k0, first, part, rng);
+        }
+        else {
+            _partitionRecursive(sub, lmap, k - k0, first + k0, part, rng);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Interleave the low 21 bits of x, y and z.
+std::uint64_t _mortonCode(std::uint64_t x, std::uint64_t y, std::uint64_t z)
+{
+    auto spread = [](std::uint64_t a) {
+        a &= 0x1fffff;
+        a = (a | a << 32) & 0x1f00000000ffffULL;
+        a = (a | a << 16) & 0x1f0000ff0000ffULL;
+        a = (a | a << 8) & 0x100f00f00f00f00fULL;
+        a = (a | a << 4) & 0x10c30c30c30c30c3ULL;
+        a = (a | a << 2) & 0x1249249249249249ULL;
+        return a;
+    };
+    return spread(x) | spread(y) << 1 | spread(z) << 2;
+}
+
+/// Cut the Morton order of the group centers into k chunks of equal weight.
+void _partitionSFC(std::vector<point3d> const & centers, std::vector<double> const & vwgt,
+                   uint k, std::vector<uint> & part)
+{
+    const index_t n = static_cast<index_t>(centers.size());
+    part.assign(n, 0);
+    if (n == 0) return;
+
+    point3d lo = centers[0];
+    point3d hi = centers[0];
+    for (auto const & c: centers) {
+        for (uint d = 0; d < 3; ++d) {
+            lo[d] = std::min(lo[d], c[d]);
+            hi[d] = std::max(hi[d], c[d]);
+        }
+    }
+    double extent = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2]});
+    double scale = extent > 0.0 ? static_cast<double>(0x1fffff) / extent : 0.0;
+
+    std::vector<std::pair<std::uint64_t, index_t>> keys(n);
+    for (index_t v = 0; v < n; ++v) {
+        auto const & c = centers[v];
+        keys[v] = {_mortonCode(static_cast<std::uint64_t>((c[0] - lo[0]) * scale),
+                               static_cast<std::uint64_t>((c[1] - lo[1]) * scale),
+                               static_cast<std::uint64_t>((c[2] - lo[2]) * scale)), v};
+    }
+    std::sort(keys.begin(), keys.end());
+
+    double total = std::accumulate(vwgt.begin(), vwgt.end(), 0.0);
+    bool unit = !(total > 0.0);
+    if (unit) total = static_cast<double>(n);
+
+    double acc = 0.0;
+    for (auto const & key: keys) {
+        double w = unit ? 1.0 : vwgt[key.second];
+        // Part of the midpoint of the vertex along the cumulated weight.
+        auto p = static_cast<uint>((acc + 0.5 * w) * k / total);
+        part[key.second] = std::min(p, k - 1);
+        acc += w;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+index_t _findRoot(std::vector<index_t> & parent, index_t v)
+{
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+TetPartition partitionMesh(Tetmesh const & mesh, uint nparts,
+                           PartitionMethod method,
+                           std::vector<double> const & tet_weights)
+{
+    const auto ntets = static_cast<index_t>(mesh.countTets());
+    const auto ntris = mesh.countTris();
+
+    if (nparts == 0) {
+        ArgErrLog("Number of partitions must be positive.");
+    }
+    if (!tet_weights.empty() && tet_weights.size() != ntets) {
+        std::ostringstream os;
+        os << "Expected " << ntets << " tetrahedron weights, got " << tet_weights.size() << ".";
+        ArgErrLog(os.str());
+    }
+
+    std::vector<double> weights(tet_weights);
+    if (weights.empty()) {
+        weights.resize(ntets);
+        for (index_t t = 0; t < ntets; ++t) {
+            weights[t] = mesh.getTetComp(t) != nullptr ? 1.0 : 0.0;
+        }
+    }
+    for (auto w: weights) {
+        if (w < 0.0) {
+            ArgErrLog("Tetrahedron weights must be non-negative.");
+        }
+    }
+
+    // The tets on both sides of a patch triangle must live on the host of
+    // the triangle: merge them into one vertex of the graph.
+    std::vector<index_t> group(ntets);
+    std::iota(group.begin(), group.end(), 0);
+    for (index_t tri = 0; tri < ntris; ++tri) {
+        if (mesh.getTriPatch(tri) == nullptr) continue;
+        auto tets = mesh._getTriTetNeighb(tri);
+        if (tets[0] == UNKNOWN_TET || tets[1] == UNKNOWN_TET) continue;
+        auto r0 = _findRoot(group, tets[0].get());
+        auto r1 = _findRoot(group, tets[1].get());
+        if (r0 != r1) group[std::max(r0, r1)] = std::min(r0, r1);
+    }
+
+    std::vector<index_t> gid(ntets, UNKNOWN_TET.get());
+    index_t ngroups = 0;
+    for (index_t t = 0; t < ntets; ++t) {
+        auto r = _findRoot(group, t);
+        if (gid[r] == UNKNOWN_TET.get()) gid[r] = ngroups++;
+        gid[t] = gid[r];
+    }
+
+    std::vector<double> gwgt(ngroups, 0.0);
+    std::vector<point3d> gcenter(ngroups, point3d{0.0, 0.0, 0.0});
+    std::vector<index_t> gsize(ngroups, 0);
+    for (index_t t = 0; t < ntets; ++t) {
+        auto g = gid[t];
+        gwgt[g] += weights[t];
+        gcenter[g] += mesh._getTetBarycenter(t);
+        ++gsize[g];
+    }
+    for (index_t g = 0; g < ngroups; ++g) {
+        gcenter[g] /= static_cast<double>(gsize[g]);
+    }
+
+    std::vector<uint> gpart;
+    if (method == PARTITION_SFC) {
+        _partitionSFC(gcenter, gwgt, nparts, gpart);
+    }
+    else if (method == PARTITION_GRAPH) {
+        // Face adjacency between groups, weighted by the shared area.
+        std::vector<std::vector<std::pair<index_t, double>>> adj(ngroups);
+        for (index_t t = 0; t < ntets; ++t) {
+            auto tets = mesh._getTetTetNeighb(t);
+            auto tris = mesh._getTetTriNeighb(t);
+            for (uint f = 0; f < 4; ++f) {
+                if (tets[f] == UNKNOWN_TET) continue;
+                auto g0 = gid[t];
+                auto g1 = gid[tets[f].get()];
+                if (g0 == g1) continue;
+                adj[g0].emplace_back(g1, mesh.getTriArea(tris[f]));
+            }
+        }
+
+        Graph graph;
+        graph.vwgt = gwgt;
+        graph.xadj.reserve(ngroups + 1);
+        for (auto & row: adj) {
+            std::sort(row.begin(), row.end());
+            for (std::size_t i = 0; i < row.size(); ++i) {
+                if (i > 0 && row[i].first == row[i - 1].first) {
+                    graph.adjwgt.back() += row[i].second;
+                }
+                else {
+                    graph.adjncy.push_back(row[i].first);
+                    graph.adjwgt.push_back(row[i].second);
+                }
+            }
+            graph.xadj.push_back(static_cast<index_t>(graph.adjncy.size()));
+            std::vector<std::pair<index_t, double>>().swap(row);
+        }
+
+        std::vector<index_t> vmap(ngroups);
+        std::iota(vmap.begin(), vmap.end(), 0);
+        gpart.assign(ngroups, 0);
+        // Fixed seed: every process must compute the same partition.
+        std::mt19937 rng(5489u);
+        _partitionRecursive(graph, vmap, nparts, 0, gpart, rng);
+    }
+    else {
+        ArgErrLog("Unknown partition method.");
+    }
+
+    TetPartition result;
+    result.tet_hosts.resize(ntets);
+    result.host_loads.assign(nparts, 0.0);
+    for (index_t t = 0; t < ntets; ++t) {
+        auto h = gpart[gid[t]];
+        result.tet_hosts[t] = h;
+        result.host_loads[h] += weights[t];
+    }
+
+    for (index_t tri = 0; tri < ntris; ++tri) {
+        if (mesh.getTriPatch(tri) == nullptr) continue;
+        auto tets = mesh._getTriTetNeighb(tri);
+        auto t = tets[0] != UNKNOWN_TET ? tets[0] : tets[1];
+        result.tri_hosts[triangle_id_t(tri)] = result.tet_hosts[t.get()];
+    }
+
+    // Halo: distinct foreign tets adjacent to each host.
+    std::vector<std::pair<uint, index_t>> halo;
+    for (index_t t = 0; t < ntets; ++t) {
+        auto h = result.tet_hosts[t];
+        auto tets = mesh._getTetTetNeighb(t);
+        auto tris = mesh._getTetTriNeighb(t);
+        for (uint f = 0; f < 4; ++f) {
+            if (tets[f] == UNKNOWN_TET) continue;
+            auto nb = tets[f].get();
+            if (result.tet_hosts[nb] == h) continue;
+            halo.emplace_back(h, nb);
+            // Each cut face is seen from both sides.
+            result.cut_area += 0.5 * mesh.getTriArea(tris[f]);
+        }
+    }
+    std::sort(halo.begin(), halo.end());
+    halo.erase(std::unique(halo.begin(), halo.end()), halo.end());
+    result.host_halo_tets.assign(nparts, 0);
+    for (auto const & p: halo) {
+        ++result.host_halo_tets[p.first];
+    }
+
+    double total = std::accumulate(result.host_loads.begin(), result.host_loads.end(), 0.0);
+    double maxload = *std::max_element(result.host_loads.begin(), result.host_loads.end());
+    result.imbalance = total > 0.0 ? maxload * nparts / total : 1.0;
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<double> kprocTetWeights(Tetmesh const & mesh, steps::model::Model * model)
+{
+    if (model == nullptr) {
+        ArgErrLog("Model is not defined.");
+    }
+
+    const auto ntets = static_cast<index_t>(mesh.countTets());
+    const auto ntris = mesh.countTris();
+    std::vector<double> weights(ntets, 0.0);
+
+    std::map<TmComp*, double> comp_kprocs;
+    for (index_t t = 0; t < ntets; ++t) {
+        auto comp = mesh.getTetComp(t);
+        if (comp == nullptr) continue;
+        auto c = comp_kprocs.find(comp);
+        if (c == comp_kprocs.end()) {
+            double n = comp->getAllReacs(model).size() + comp->getAllDiffs(model).size();
+            c = comp_kprocs.emplace(comp, n).first;
+        }
+        weights[t] = c->second;
+    }
+
+    std::map<TmPatch*, double> patch_kprocs;
+    for (index_t tri = 0; tri < ntris; ++tri) {
+        auto patch = mesh.getTriPatch(tri);
+        if (patch == nullptr) continue;
+        auto p = patch_kprocs.find(patch);
+        if (p == patch_kprocs.end()) {
+            double n = 0.0;
+            for (auto const & ssys_id: patch->getSurfsys()) {
+                auto ssys = model->getSurfsys(ssys_id);
+                n += ssys->_countSReacs() + ssys->_countDiffs()
+                     + ssys->_countVDepTrans() + ssys->_countVDepSReacs()
+                     + ssys->_countGHKcurrs();
+            }
+            p = patch_kprocs.emplace(patch, n).first;
+        }
+        // Both neighbours end up on the host of the triangle; charge the
+        // inner one.
+        auto tets = mesh._getTriTetNeighb(tri);
+        auto t = tets[0] != UNKNOWN_TET ? tets[0] : tets[1];
+        weights[t.get()] += p->second;
+    }
+
+    return weights;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TetPartition Tetmesh::partition(uint nparts, PartitionMethod method,
+                                std::vector<double> const & tet_weights) const
+{
+    return partitionMesh(*this, nparts, method, tet_weights);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<double> Tetmesh::getKProcTetWeights(steps::model::Model * model) const
+{
+    return kprocTetWeights(*this, model);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // namespace tetmesh
+} // namespace steps
+
+// END
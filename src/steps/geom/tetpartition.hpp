@@ -0,0 +1,104 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_TETMESH_TETPARTITION_HPP
+#define STEPS_TETMESH_TETPARTITION_HPP 1
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/geom/fwd.hpp"
+
+// STL headers
+#include <map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace model {
+class Model;
+}
+
+namespace tetmesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+enum PartitionMethod {
+    /// Multilevel recursive graph bisection of the tetrahedron adjacency graph.
+    PARTITION_GRAPH,
+    /// Equal-weight chunks along a Morton curve through the tet barycenters.
+    PARTITION_SFC
+};
+
+/// Host tables for the parallel TetOpSplit solver and the predicted cost
+/// of the partition.
+struct TetPartition
+{
+    /// Host of each tetrahedron.
+    std::vector<uint>                   tet_hosts;
+    /// Host of each patch triangle.
+    std::map<triangle_id_t, uint>       tri_hosts;
+
+    /// Sum of the tetrahedron weights of each host.
+    std::vector<double>                 host_loads;
+    /// Number of tetrahedrons of other hosts adjacent to each host, i.e.
+    /// the halo it has to exchange with.
+    std::vector<index_t>                host_halo_tets;
+    /// Total area of the faces between tetrahedrons of different hosts.
+    double                              cut_area{0.0};
+    /// Largest host load over the mean host load.
+    double                              imbalance{1.0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Partition the tetrahedrons of mesh over nparts hosts.
+///
+/// Tetrahedrons are weighted by tet_weights, or by 1 if they belong to a
+/// compartment and 0 otherwise if tet_weights is empty. Faces are weighted
+/// by their area. The two tetrahedrons of every patch triangle are kept
+/// together, and the triangle is assigned to their host.
+///
+/// The result only depends on the arguments, so that every process of a
+/// parallel simulation computes the same tables.
+TetPartition partitionMesh(Tetmesh const & mesh, uint nparts,
+                           PartitionMethod method = PARTITION_GRAPH,
+                           std::vector<double> const & tet_weights = {});
+
+/// Number of kprocs of each tetrahedron: reactions and diffusion rules of
+/// its compartment, plus the surface kprocs of the patch triangles on its
+/// faces. Meant as tet_weights of partitionMesh().
+std::vector<double> kprocTetWeights(Tetmesh const & mesh, steps::model::Model * model);
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // namespace tetmesh
+} // namespace steps
+
+#endif
+
+// STEPS_TETMESH_TETPARTITION_HPP
+// END
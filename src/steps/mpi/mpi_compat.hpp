@@ -0,0 +1,239 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+// Rationale:
+// TetOpSplitP distributes the mesh over MPI processes, and splits the part
+// of each process into sub-domains run by OpenMP threads. On a workstation
+// the thread level alone is enough, so the solver is also built without
+// MPI. In that case this header provides the subset of the MPI interface
+// used by the solver for a single process: collectives copy the local
+// contribution, and point-to-point messages cannot happen since a process
+// never communicates with itself.
+
+#ifndef STEPS_MPI_MPICOMPAT_HPP
+#define STEPS_MPI_MPICOMPAT_HPP 1
+
+#ifdef USE_MPI
+
+#include <mpi.h>
+
+#else
+
+// STL headers.
+#include <chrono>
+#include <cstring>
+
+// STEPS headers.
+#include "steps/error.hpp"
+
+// logging
+#include <easylogging++.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+typedef int MPI_Comm;
+typedef int MPI_Op;
+typedef int MPI_Request;
+
+/// A datatype is the size of one element, in bytes.
+typedef int MPI_Datatype;
+
+struct MPI_Status
+{
+    int MPI_SOURCE;
+    int MPI_TAG;
+    int MPI_ERROR;
+    int count;
+};
+
+#define MPI_SUCCESS                 0
+#define MPI_UNDEFINED               (-32766)
+
+#define MPI_COMM_WORLD              0
+#define MPI_REQUEST_NULL            0
+#define MPI_STATUSES_IGNORE         static_cast<MPI_Status *>(nullptr)
+#define MPI_IN_PLACE                static_cast<void *>(nullptr)
+
+#define MPI_SUM                     1
+#define MPI_MAX                     2
+#define MPI_LAND                    3
+
+#define MPI_DATATYPE_NULL           0
+#define MPI_BYTE                    1
+#define MPI_CHAR                    static_cast<int>(sizeof(char))
+#define MPI_C_BOOL                  static_cast<int>(sizeof(bool))
+#define MPI_SHORT                   static_cast<int>(sizeof(short))
+#define MPI_INT                     static_cast<int>(sizeof(int))
+#define MPI_UNSIGNED                static_cast<int>(sizeof(unsigned))
+#define MPI_UNSIGNED_LONG           static_cast<int>(sizeof(unsigned long))
+#define MPI_UNSIGNED_LONG_LONG      static_cast<int>(sizeof(unsigned long long))
+#define MPI_DOUBLE                  static_cast<int>(sizeof(double))
+#define MPI_LONG_DOUBLE             static_cast<int>(sizeof(long double))
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace mpi {
+
+inline void copy_local(const void * sendbuf, void * recvbuf, int count, MPI_Datatype type)
+{
+    if (sendbuf == MPI_IN_PLACE || sendbuf == recvbuf || count == 0) return;
+    std::memcpy(recvbuf, sendbuf, static_cast<std::size_t>(count) * static_cast<std::size_t>(type));
+}
+
+[[noreturn]] inline void no_peer()
+{
+    ProgErrLog("Point-to-point communication requested in a single process run.");
+}
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Environment
+
+inline int MPI_Initialized(int * flag) { *flag = 1; return MPI_SUCCESS; }
+inline int MPI_Finalized(int * flag) { *flag = 0; return MPI_SUCCESS; }
+inline int MPI_Comm_rank(MPI_Comm, int * rank) { *rank = 0; return MPI_SUCCESS; }
+inline int MPI_Comm_size(MPI_Comm, int * size) { *size = 1; return MPI_SUCCESS; }
+
+inline double MPI_Wtime()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Collectives
+
+inline int MPI_Barrier(MPI_Comm) { return MPI_SUCCESS; }
+
+inline int MPI_Bcast(void *, int, MPI_Datatype, int root, MPI_Comm)
+{
+    if (root != 0) {
+        ProgErrLog("Broadcast from a rank other than 0 in a single process run.");
+    }
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Allreduce(const void * sendbuf, void * recvbuf, int count,
+                         MPI_Datatype type, MPI_Op, MPI_Comm)
+{
+    steps::mpi::copy_local(sendbuf, recvbuf, count, type);
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Allgather(const void * sendbuf, int sendcount, MPI_Datatype sendtype,
+                         void * recvbuf, int, MPI_Datatype, MPI_Comm)
+{
+    steps::mpi::copy_local(sendbuf, recvbuf, sendcount, sendtype);
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Allgatherv(const void * sendbuf, int sendcount, MPI_Datatype sendtype,
+                          void * recvbuf, const int *, const int * displs,
+                          MPI_Datatype recvtype, MPI_Comm)
+{
+    if (sendbuf == MPI_IN_PLACE) return MPI_SUCCESS;
+    steps::mpi::copy_local(sendbuf, static_cast<char *>(recvbuf) + displs[0] * recvtype,
+                           sendcount, sendtype);
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Alltoall(const void * sendbuf, int sendcount, MPI_Datatype sendtype,
+                        void * recvbuf, int, MPI_Datatype, MPI_Comm)
+{
+    steps::mpi::copy_local(sendbuf, recvbuf, sendcount, sendtype);
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Alltoallv(const void * sendbuf, const int * sendcounts, const int * sdispls,
+                         MPI_Datatype sendtype, void * recvbuf, const int *,
+                         const int * rdispls, MPI_Datatype recvtype, MPI_Comm)
+{
+    steps::mpi::copy_local(static_cast<const char *>(sendbuf) + sdispls[0] * sendtype,
+                           static_cast<char *>(recvbuf) + rdispls[0] * recvtype,
+                           sendcounts[0], sendtype);
+    return MPI_SUCCESS;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Point-to-point
+//
+// A single process has no neighbour, so requests are only ever null.
+
+inline int MPI_Isend(const void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *)
+{
+    steps::mpi::no_peer();
+}
+
+inline int MPI_Irecv(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *)
+{
+    steps::mpi::no_peer();
+}
+
+inline int MPI_Recv_init(void *, int, MPI_Datatype, int, int, MPI_Comm, MPI_Request *)
+{
+    steps::mpi::no_peer();
+}
+
+inline int MPI_Startall(int count, MPI_Request *)
+{
+    if (count != 0) steps::mpi::no_peer();
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Waitall(int count, MPI_Request * requests, MPI_Status *)
+{
+    for (int r = 0; r < count; ++r) {
+        if (requests[r] != MPI_REQUEST_NULL) steps::mpi::no_peer();
+    }
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Waitany(int, MPI_Request *, int * index, MPI_Status *)
+{
+    *index = MPI_UNDEFINED;
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Request_free(MPI_Request * request)
+{
+    *request = MPI_REQUEST_NULL;
+    return MPI_SUCCESS;
+}
+
+inline int MPI_Get_count(const MPI_Status * status, MPI_Datatype, int * count)
+{
+    *count = status->count;
+    return MPI_SUCCESS;
+}
+
+#endif // USE_MPI
+
+#endif // STEPS_MPI_MPICOMPAT_HPP
+
+// END
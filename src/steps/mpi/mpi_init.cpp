@@ -42,7 +42,9 @@ namespace mpi {
             MPI_Initialized(&flag);
             if (!flag) {
                 internally_initialized = true;
-                MPI_Init(NULL, NULL);
+                // TetOpSplitP only makes MPI calls from the main thread.
+                int provided;
+                MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &provided);
             }
         }
 
@@ -31,8 +31,6 @@
 #include <sstream>
 #include <vector>
 
-#include <mpi.h>
-
 // STEPS headers.
 #include "steps/common.h"
 #include "steps/error.hpp"
@@ -44,8 +42,6 @@
 #include "steps/solver/compdef.hpp"
 #include "steps/solver/diffdef.hpp"
 
-#include <mpi.h>
-
 // logging
 #include "easylogging++.h"
 ////////////////////////////////////////////////////////////////////////////////
@@ -126,12 +122,14 @@ smtos::Diff::Diff(ssolver::Diffdef * ddef, smtos::Tet * tet)
 			    pNdirections+=1;
        	    }
         }
+
+        _updateSplitChances();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Diff::checkpoint(std::fstream & cp_file)
+void smtos::Diff::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -158,7 +156,7 @@ void smtos::Diff::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Diff::restore(std::fstream & cp_file)
+void smtos::Diff::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -179,6 +177,7 @@ void smtos::Diff::restore(std::fstream & cp_file)
     cp_file.read(reinterpret_cast<char*>(pDiffBndDirection.data()), sizeof(bool) * 4);
     cp_file.read(reinterpret_cast<char*>(pNeighbCompLidx.data()), sizeof(ssolver::lidxT) * 4);
     cp_file.read(reinterpret_cast<char*>(pNonCDFSelector.data()), sizeof(double) * 4);
+    _updateSplitChances();
     cp_file.read(reinterpret_cast<char*>(&crData.recorded), sizeof(bool));
     cp_file.read(reinterpret_cast<char*>(&crData.pow), sizeof(int));
     cp_file.read(reinterpret_cast<char*>(&crData.pos), sizeof(unsigned));
@@ -208,8 +207,8 @@ void smtos::Diff::setupDeps()
     std::set<uint> remote;
     std::set<uint> remote_all;
     
-    std::set<smtos::KProc*> local;
-    std::set<smtos::KProc*> local_all;
+    smtos::KProcPSet local;
+    smtos::KProcPSet local_all;
 
     uint nkprocs = pTet->countKProcs();
 
@@ -256,7 +255,7 @@ void smtos::Diff::setupDeps()
         }
 
         // Copy local dependencies.
-        std::set<KProc*> local2(local.begin(), local.end());
+        KProcPSet local2(local.begin(), local.end());
         std::set<uint> remote2;
 
         // Find the ones 'locally' in the next tet.
@@ -466,6 +465,8 @@ void smtos::Diff::setDcst(double dcst)
 			    pNdirections+=1;
        	    }
         }
+
+        _updateSplitChances();
     }
 }
 
@@ -542,6 +543,8 @@ void smtos::Diff::setDirectionDcst(int direction, double dcst)
 			    pNdirections+=1;
        	    }
         }
+
+        _updateSplitChances();
     }
 }
 
@@ -561,6 +564,19 @@ double smtos::Diff::rate(steps::mpi::tetopsplit::TetOpSplitP * /*solver*/)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::Diff::_updateSplitChances()
+{
+    double sump = 0.0;
+    for (uint i = 0; i + 1 < pNdirections; ++i)
+    {
+        uint direction = pDirections[i];
+        pSplitChance[i] = pNonCDFSelector[direction] / (1.0 - sump);
+        sump += pNonCDFSelector[direction];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 int smtos::Diff::apply(const rng::RNGptr &rng)
 {
 
@@ -629,12 +645,7 @@ int smtos::Diff::apply(const rng::RNGptr &rng, uint nmolcs)
     for (uint i=0; i< pNdirections-1; ++i)
     {
 		uint direction = pDirections[i];
-        double chance=0.0;
-
-        double sump = 0.0;
-        for (uint j=0; j<i; ++j) sump +=pNonCDFSelector[pDirections[j]];
-
-        chance = pNonCDFSelector[direction]/(1.0-sump);
+        double chance = pSplitChance[i];
 
         unsigned int max_molcs= nmolcs-molcs_moved;
 
@@ -75,10 +75,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file) override;
+    void checkpoint(std::iostream & cp_file) override;
 
     /// restore data
-    void restore(std::fstream & cp_file) override;
+    void restore(std::iostream & cp_file) override;
 
     ////////////////////////////////////////////////////////////////////////
     // VIRTUAL INTERFACE METHODS
@@ -176,6 +176,13 @@ private:
     std::vector<uint> 					pDirections;
     uint								pNdirections{};
 
+    // Conditional probability of each direction in pDirections but the
+    // last, given that the molecule did not take the previous ones. Used
+    // to split a batch of molecules with a chain of binomials.
+    std::array<double, 4>   pSplitChance{0.0, 0.0, 0.0, 0.0};
+
+    void _updateSplitChances();
+
     uint                                lidxTet;
 
 
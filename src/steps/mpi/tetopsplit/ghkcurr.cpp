@@ -70,7 +70,7 @@ smtos::GHKcurr::GHKcurr(ssolver::GHKcurrdef * ghkdef, smtos::Tri * tri)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::GHKcurr::checkpoint(std::fstream & cp_file)
+void smtos::GHKcurr::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -84,7 +84,7 @@ void smtos::GHKcurr::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::GHKcurr::restore(std::fstream & cp_file)
+void smtos::GHKcurr::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -114,7 +114,7 @@ void smtos::GHKcurr::reset()
 void smtos::GHKcurr::setupDeps()
 {
     AssertLog(pTri->getInHost());
-    std::set<smtos::KProc*> local;
+    smtos::KProcPSet local;
 
     // The only concentration changes for a GHK current event are in the outer
     // and inner volume. The flux can involve movement of ion from either
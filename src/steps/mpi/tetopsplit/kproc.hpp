@@ -47,6 +47,7 @@
 #include "steps/common.h"
 #include "steps/solver/types.hpp"
 #include "steps/rng/rng.hpp"
+#include "steps/util/epoch_dedup.hpp"
 //#include "tetopsplit.hpp"
 
 // TetOpSplitP CR header
@@ -74,10 +75,6 @@ typedef std::vector<KProcP>             KProcPVec;
 typedef KProcPVec::iterator             KProcPVecI;
 typedef KProcPVec::const_iterator       KProcPVecCI;
 
-typedef std::set<KProcP>                KProcPSet;
-typedef KProcPSet::iterator             KProcPSetI;
-typedef KProcPSet::const_iterator       KProcPSetCI;
-
 ////////////////////////////////////////////////////////////////////////////////
 
 enum TYPE {KP_REAC, KP_SREAC, KP_DIFF, KP_SDIFF, KP_GHK, KP_VDEPSREAC, KP_VDEPTRANS};
@@ -98,10 +95,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    virtual void checkpoint(std::fstream & cp_file) = 0;
+    virtual void checkpoint(std::iostream & cp_file) = 0;
 
     /// restore data
-    virtual void restore(std::fstream & cp_file) = 0;
+    virtual void restore(std::iostream & cp_file) = 0;
 
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS
@@ -126,6 +123,19 @@ public:
 
     void setSchedIDX(uint idx) noexcept
     { pSchedIDX = idx; }
+
+    /// Stamps used by steps::util::epoch_dedup when collecting kprocs, one
+    /// per collection that can be live at the same time.
+    steps::util::dedup_epoch_t & dedupEpoch(unsigned slot) noexcept
+    { return pDedupEpochs[slot]; }
+
+    /// Sub-domain of the process the kproc is simulated in; see
+    /// TetOpSplitP::setNThreads().
+    uint getDomain() const noexcept
+    { return pDomain; }
+
+    void setDomain(uint domain) noexcept
+    { pDomain = domain; }
     
     uint getType() const noexcept { return type; }
 
@@ -229,11 +239,29 @@ protected:
     
     uint                                 type;
 
+    steps::util::dedup_epoch_t          pDedupEpochs[2]{0, 0};
+
+    uint                                pDomain{0};
+
     ////////////////////////////////////////////////////////////////////////
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Orders kprocs by schedule index rather than by address, so that the
+/// dependency lists built from a set are the same in every solver instance.
+struct KProcSchedLess
+{
+    bool operator()(KProc const * a, KProc const * b) const noexcept
+    { return a->schedIDX() < b->schedIDX(); }
+};
+
+typedef std::set<KProcP, KProcSchedLess> KProcPSet;
+typedef KProcPSet::iterator             KProcPSetI;
+typedef KProcPSet::const_iterator       KProcPSetCI;
+
+////////////////////////////////////////////////////////////////////////////////
+
 }
 }
 }
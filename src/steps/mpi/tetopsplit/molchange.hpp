@@ -0,0 +1,266 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_MPI_TETOPSPLIT_MOLCHANGE_HPP
+#define STEPS_MPI_TETOPSPLIT_MOLCHANGE_HPP 1
+
+// STL headers.
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+
+// logging
+#include <easylogging++.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace mpi {
+namespace tetopsplit {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Largest encoded size of a 32-bit unsigned varint.
+constexpr uint MOLCHANGE_MAX_VARINT = 5;
+
+/// Write v as a little-endian base-128 varint; returns the end of the
+/// written bytes.
+inline std::uint8_t * putVarint(std::uint8_t * out, uint v) noexcept
+{
+    while (v >= 0x80) {
+        *out++ = static_cast<std::uint8_t>(v | 0x80);
+        v >>= 7;
+    }
+    *out++ = static_cast<std::uint8_t>(v);
+    return out;
+}
+
+/// Read a varint written by putVarint from [in, end); returns the end of
+/// the bytes read.
+inline const std::uint8_t * getVarint(const std::uint8_t * in, const std::uint8_t * end, uint & v)
+{
+    v = 0;
+    for (uint shift = 0; shift < 7 * MOLCHANGE_MAX_VARINT; shift += 7) {
+        if (in == end) break;
+        std::uint8_t b = *in++;
+        v |= static_cast<uint>(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) return in;
+    }
+    ProgErrLog("Malformed molecule change message.\n");
+    return end;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Molecule changes made by diffusion to the mirror elements hosted by one
+/// neighbouring process during an operator-split iteration, and their
+/// compact wire format.
+///
+/// Mirror elements are numbered by slots agreed with the neighbour at
+/// setup, so a message never carries the element type or global index.
+/// Every species of every mirror has a fixed location in a dense count
+/// array; changes accumulate there and are encoded, grouped by element in
+/// increasing slot order, as
+///
+///     varint(slot delta) varint(#species) { varint(lidx delta) varint(count) }
+///
+/// Slot deltas are relative to the previous element of the message and
+/// lidx deltas to the previous species of the element, both from 0.
+///
+class MolChangeBuffer
+{
+
+public:
+
+    /// Set up for mirror elements with elem_nspecs[s] species in slot s.
+    void setup(std::vector<uint> const & elem_nspecs)
+    {
+        uint nslots = elem_nspecs.size();
+        pBase.resize(nslots + 1);
+        pBase[0] = 0;
+        for (uint s = 0; s < nslots; s++) pBase[s + 1] = pBase[s] + elem_nspecs[s];
+
+        pSlotOf.resize(pBase[nslots]);
+        for (uint s = 0; s < nslots; s++) {
+            std::fill(pSlotOf.begin() + pBase[s], pSlotOf.begin() + pBase[s + 1], s);
+        }
+        pCounts.assign(pBase[nslots], 0);
+        pTouched.clear();
+        pTouched.reserve(nslots);
+        pSlotTouched.assign(nslots, 0);
+
+        // header of every element plus one record per species
+        pWire.resize(std::max<std::size_t>(
+            2 * MOLCHANGE_MAX_VARINT * (nslots + pBase[nslots]), 1));
+        pWireSize = 0;
+        pRecords = 0;
+    }
+
+    /// Location of species 0 of the mirror in slot s; species lidx is
+    /// at base(s) + lidx.
+    inline uint base(uint s) const noexcept
+    { return pBase[s]; }
+
+    /// Add change molecules at location loc.
+    inline void add(uint loc, uint change)
+    {
+        AssertLog(loc < pCounts.size());
+        uint s = pSlotOf[loc];
+        if (pSlotTouched[s] == 0) {
+            pSlotTouched[s] = 1;
+            pTouched.push_back(s);
+        }
+        pCounts[loc] += change;
+    }
+
+    /// Add the changes accumulated in other, a buffer with the same setup,
+    /// and clear them there.
+    void absorb(MolChangeBuffer & other)
+    {
+        AssertLog(other.pCounts.size() == pCounts.size());
+        for (uint s : other.pTouched) {
+            other.pSlotTouched[s] = 0;
+            if (pSlotTouched[s] == 0) {
+                pSlotTouched[s] = 1;
+                pTouched.push_back(s);
+            }
+            for (uint loc = pBase[s]; loc < pBase[s + 1]; loc++) {
+                pCounts[loc] += other.pCounts[loc];
+                other.pCounts[loc] = 0;
+            }
+        }
+        other.pTouched.clear();
+    }
+
+    /// Upper bound of the size of an encoded message.
+    inline std::size_t capacity() const noexcept
+    { return pWire.size(); }
+
+    /// Encode the accumulated changes and clear them.
+    void encode()
+    {
+        std::sort(pTouched.begin(), pTouched.end());
+
+        std::uint8_t * out = pWire.data();
+        uint records = 0;
+        uint prev_slot = 0;
+        for (uint s : pTouched) {
+            pSlotTouched[s] = 0;
+
+            uint b = pBase[s];
+            uint e = pBase[s + 1];
+            uint nchanged = 0;
+            for (uint loc = b; loc < e; loc++) {
+                if (pCounts[loc] != 0) nchanged++;
+            }
+
+            out = putVarint(out, s - prev_slot);
+            out = putVarint(out, nchanged);
+            prev_slot = s;
+
+            uint prev_lidx = 0;
+            for (uint loc = b; loc < e; loc++) {
+                uint count = pCounts[loc];
+                if (count == 0) continue;
+                out = putVarint(out, loc - b - prev_lidx);
+                out = putVarint(out, count);
+                prev_lidx = loc - b;
+                pCounts[loc] = 0;
+            }
+            records += nchanged;
+        }
+        pTouched.clear();
+
+        pWireSize = out - pWire.data();
+        pRecords = records;
+    }
+
+    /// Encoded message of the last encode().
+    inline const std::uint8_t * data() const noexcept
+    { return pWire.data(); }
+
+    inline std::size_t size() const noexcept
+    { return pWireSize; }
+
+    /// Number of (element, species) records in the last encoded message.
+    inline uint records() const noexcept
+    { return pRecords; }
+
+private:
+
+    std::vector<uint>                   pBase;
+    std::vector<uint>                   pSlotOf;
+    std::vector<uint>                   pCounts;
+    std::vector<uint>                   pTouched;
+    std::vector<char>                   pSlotTouched;
+
+    std::vector<std::uint8_t>           pWire;
+    std::size_t                         pWireSize{0};
+    uint                                pRecords{0};
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Decode a message encoded by MolChangeBuffer, calling apply(slot, lidx,
+/// count) for every record.
+template <typename F>
+void decodeMolChanges(const std::uint8_t * data, std::size_t size, F && apply)
+{
+    const std::uint8_t * in = data;
+    const std::uint8_t * end = data + size;
+    uint slot = 0;
+    while (in != end) {
+        uint delta, nchanged;
+        in = getVarint(in, end, delta);
+        in = getVarint(in, end, nchanged);
+        slot += delta;
+
+        uint lidx = 0;
+        for (uint c = 0; c < nchanged; c++) {
+            uint count;
+            in = getVarint(in, end, delta);
+            in = getVarint(in, end, count);
+            lidx += delta;
+            apply(slot, lidx, count);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+}
+
+#endif // STEPS_MPI_TETOPSPLIT_MOLCHANGE_HPP
+
+// END
@@ -94,7 +94,7 @@ smtos::Reac::~Reac()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Reac::checkpoint(std::fstream & cp_file)
+void smtos::Reac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -110,7 +110,7 @@ void smtos::Reac::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Reac::restore(std::fstream & cp_file)
+void smtos::Reac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -165,7 +165,7 @@ void smtos::Reac::setKcst(double k)
 void smtos::Reac::setupDeps()
 {
     AssertLog(pTet->getInHost());
-    std::set<smtos::KProc*> updset;
+    smtos::KProcPSet updset;
 
     // Search in local tetrahedron.
     uint nkprocs = pTet->countKProcs();
@@ -225,51 +225,10 @@ double smtos::Reac::rate(smtos::TetOpSplitP * /*solver*/)
 
     if (inactive()) return 0.0;
 
-    // Prefetch some variables.
+    // Compute combinatorial part from the compiled reactant list.
     ssolver::Compdef * cdef = pTet->compdef();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(pReacdef->gidx()));
-    uint * cnt_vec = pTet->pools();
-
-    // Compute combinatorial part.
-    double h_mu = 1.0;
-    for (uint pool = 0; pool < nspecs; ++pool)
-    {
-        uint lhs = lhs_vec[pool];
-        if (lhs == 0) { continue;
-        }
-        uint cnt = cnt_vec[pool];
-        if (lhs > cnt)	  
-        {	
-            h_mu = 0.0;	
-            break;
-        }	      
-        switch (lhs)
-        {
-            case 4:	
-            {	
-                h_mu *= static_cast<double>(cnt - 3);	
-            }	
-            case 3:	
-            {	
-                h_mu *= static_cast<double>(cnt - 2);	
-            }	
-            case 2:	
-            {	
-                h_mu *= static_cast<double>(cnt - 1);	
-            }	
-            case 1:	
-            {	
-                h_mu *= static_cast<double>(cnt);	
-                break;	
-            }	
-            default:	
-            {	
-                AssertLog(0);	
-                return 0.0;	
-            }	
-        }
-    }
+    auto const& prog = cdef->reac_prog(cdef->reacG2L(pReacdef->gidx()));
+    double h_mu = prog.h(pTet->pools());
 
     // Multiply with scaled reaction constant.
     return h_mu * pCcst;
@@ -281,18 +240,15 @@ void smtos::Reac::apply(const rng::RNGptr &/*rng*/, double /*dt*/, double /*simt
 {
     uint * local = pTet->pools();
     ssolver::Compdef * cdef = pTet->compdef();
-    uint l_ridx = cdef->reacG2L(pReacdef->gidx());
-    int * upd_vec = cdef->reac_upd_bgn(l_ridx);
-    uint nspecs = cdef->countSpecs();
-    for (uint i = 0; i < nspecs; ++i)
+    auto const& prog = cdef->reac_prog(cdef->reacG2L(pReacdef->gidx()));
+    for (auto const& t : prog.upd())
     {
-        if (pTet->clamped(i) == true) {
+        if (pTet->clamped(t.lidx) == true) {
             continue;
         }
-        int j = upd_vec[i];
-        int nc = static_cast<int>(local[i]) + j;
+        int nc = static_cast<int>(local[t.lidx]) + t.upd;
         AssertLog(nc >= 0);
-        pTet->setCount(i, static_cast<uint>(nc), period);
+        pTet->setCount(t.lidx, static_cast<uint>(nc), period);
     }
 
     rExtent++;
@@ -114,12 +114,14 @@ smtos::SDiff::SDiff(ssolver::Diffdef * sdef, smtos::Tri * tri)
 			    pNdirections+=1;
        	    }
         }
+
+        _updateSplitChances();
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::SDiff::checkpoint(std::fstream & cp_file)
+void smtos::SDiff::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -149,7 +151,7 @@ void smtos::SDiff::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::SDiff::restore(std::fstream & cp_file)
+void smtos::SDiff::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -168,6 +170,7 @@ void smtos::SDiff::restore(std::fstream & cp_file)
     cp_file.read(reinterpret_cast<char*>(&pDcst), sizeof(double));
 
     cp_file.read(reinterpret_cast<char*>(pNonCDFSelector.data()), sizeof(double) * 3);
+    _updateSplitChances();
     cp_file.read(reinterpret_cast<char*>(pSDiffBndActive.data()), sizeof(bool) * 3);
     cp_file.read(reinterpret_cast<char*>(pSDiffBndDirection.data()), sizeof(bool) * 3);
     cp_file.read(reinterpret_cast<char*>(pNeighbPatchLidx.data()), sizeof(ssolver::lidxT) * 3);
@@ -200,8 +203,8 @@ void smtos::SDiff::setupDeps()
     std::set<uint> remote;
     std::set<uint> remote_all;
     
-    std::set<smtos::KProc*> local;
-    std::set<smtos::KProc*> local_all;
+    smtos::KProcPSet local;
+    smtos::KProcPSet local_all;
     
     uint nkprocs = pTri->countKProcs();
     for (uint sk = 0; sk < nkprocs; sk++)
@@ -266,7 +269,7 @@ void smtos::SDiff::setupDeps()
         }
         
         // Copy local dependencies.
-        std::set<smtos::KProc*> local2(local.begin(), local.end());
+        smtos::KProcPSet local2(local.begin(), local.end());
         std::set<uint> remote2;
 
         // Find the ones 'locally' in the next tri.
@@ -459,6 +462,8 @@ void smtos::SDiff::setDcst(double dcst)
 			    pNdirections+=1;
        	    }
         }
+
+        _updateSplitChances();
     }
 }
 
@@ -531,6 +536,8 @@ void smtos::SDiff::setDirectionDcst(int direction, double dcst)
 			    pNdirections+=1;
        	    }
         }
+
+        _updateSplitChances();
     }
 }
 
@@ -557,6 +564,19 @@ double smtos::SDiff::getScaledDcst(steps::mpi::tetopsplit::TetOpSplitP * /*solve
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void smtos::SDiff::_updateSplitChances()
+{
+    double sump = 0.0;
+    for (uint i = 0; i + 1 < pNdirections; ++i)
+    {
+        uint direction = pDirections[i];
+        pSplitChance[i] = pNonCDFSelector[direction] / (1.0 - sump);
+        sump += pNonCDFSelector[direction];
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 int smtos::SDiff::apply(const rng::RNGptr &rng)
 {
     //uint lidxTet = this->lidxTet;
@@ -628,12 +648,7 @@ int smtos::SDiff::apply(const rng::RNGptr &rng, uint nmolcs)
     for (uint i=0; i< pNdirections-1; ++i)
     {
 		uint direction = pDirections[i];
-        double chance=0.0;
-
-        double sump = 0.0;
-        for (uint j=0; j<i; ++j) sump +=pNonCDFSelector[pDirections[j]];
-
-        chance = pNonCDFSelector[direction]/(1.0-sump);
+        double chance = pSplitChance[i];
 
         unsigned int max_molcs= nmolcs-molcs_moved;
 
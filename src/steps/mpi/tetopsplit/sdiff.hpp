@@ -73,10 +73,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file) override;
+    void checkpoint(std::iostream & cp_file) override;
 
     /// restore data
-    void restore(std::fstream & cp_file) override;
+    void restore(std::iostream & cp_file) override;
 
     ////////////////////////////////////////////////////////////////////////
     // VIRTUAL INTERFACE METHODS
@@ -163,6 +163,13 @@ private:
     std::vector<uint> 					pDirections;
     uint				 				pNdirections{0};
 
+    // Conditional probability of each direction in pDirections but the
+    // last, given that the molecule did not take the previous ones. Used
+    // to split a batch of molecules with a chain of binomials.
+    std::array<double, 3>   pSplitChance{0.0, 0.0, 0.0};
+
+    void _updateSplitChances();
+
     // A flag to see if the species can move between compartments
     std::array<bool, 3>     pSDiffBndActive{false, false, false};
 
@@ -128,7 +128,7 @@ smtos::SReac::SReac(ssolver::SReacdef * srdef, smtos::Tri * tri)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::SReac::checkpoint(std::fstream & cp_file)
+void smtos::SReac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -145,7 +145,7 @@ void smtos::SReac::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::SReac::restore(std::fstream & cp_file)
+void smtos::SReac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -266,7 +266,7 @@ void smtos::SReac::setupDeps()
     WmVol * itet = pTri->iTet();
     WmVol * otet = pTri->oTet();
 
-    std::set<smtos::KProc*> updset;
+    smtos::KProcPSet updset;
     uint nkprocs = pTri->countKProcs();
 
     // check if sk KProc in pTri depends on spec in pTri
@@ -404,128 +404,16 @@ double smtos::SReac::rate(steps::mpi::tetopsplit::TetOpSplitP * /*solver*/)
         ssolver::Patchdef * pdef = pTri->patchdef();
         uint lidx = pdef->sreacG2L(pSReacdef->gidx());
 
-        double h_mu = 1.0;
-
-        uint * lhs_s_vec = pdef->sreac_lhs_S_bgn(lidx);
-        uint * cnt_s_vec = pTri->pools();
-        uint nspecs_s = pdef->countSpecs();
-        for (uint s = 0; s < nspecs_s; ++s)
-        {
-            uint lhs = lhs_s_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_s_vec[s];
-            if (lhs > cnt)
-            {
-                return 0.0;
-            }
-            switch (lhs)
-            {
-                case 4:
-                {
-                    h_mu *= static_cast<double>(cnt - 3);
-                }
-                case 3:
-                {
-                    h_mu *= static_cast<double>(cnt - 2);
-                }
-                case 2:
-                {
-                    h_mu *= static_cast<double>(cnt - 1);
-                }
-                case 1:
-                {
-                    h_mu *= static_cast<double>(cnt);
-                    break;
-                }
-                default:
-                {
-                    AssertLog(false);
-                }
-            }
-        }
+        double h_mu = pdef->sreac_prog_S(lidx).h(pTri->pools());
+        if (h_mu == 0.0) return 0.0;
 
         if (pSReacdef->inside())
         {
-            uint * lhs_i_vec = pdef->sreac_lhs_I_bgn(lidx);
-            uint * cnt_i_vec = pTri->iTet()->pools();
-            uint nspecs_i = pdef->countSpecs_I();
-            for (uint s = 0; s < nspecs_i; ++s)
-            {
-                uint lhs = lhs_i_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_i_vec[s];
-                if (lhs > cnt)
-                {
-                    return 0.0;
-                }
-                switch (lhs)
-                {
-                    case 4:
-                    {
-                        h_mu *= static_cast<double>(cnt - 3);
-                    }
-                    case 3:
-                    {
-                        h_mu *= static_cast<double>(cnt - 2);
-                    }
-                    case 2:
-                    {
-                        h_mu *= static_cast<double>(cnt - 1);
-                    }
-                    case 1:
-                    {
-                        h_mu *= static_cast<double>(cnt);
-                        break;
-                    }
-                    default:
-                    {
-                        AssertLog(false);
-                    }
-                }
-            }
+            h_mu *= pdef->sreac_prog_I(lidx).h(pTri->iTet()->pools());
         }
         else if (pSReacdef->outside())
         {
-            uint * lhs_o_vec = pdef->sreac_lhs_O_bgn(lidx);
-            uint * cnt_o_vec = pTri->oTet()->pools();
-            uint nspecs_o = pdef->countSpecs_O();
-            for (uint s = 0; s < nspecs_o; ++s)
-            {
-                uint lhs = lhs_o_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_o_vec[s];
-                if (lhs > cnt)
-                {
-                    return 0.0;
-                }
-                switch (lhs)
-                {
-                    case 4:
-                    {
-                        h_mu *= static_cast<double>(cnt - 3);
-                    }
-                    case 3:
-                    {
-                        h_mu *= static_cast<double>(cnt - 2);
-                    }
-                    case 2:
-                    {
-                        h_mu *= static_cast<double>(cnt - 1);
-                    }
-                    case 1:
-                    {
-                        h_mu *= static_cast<double>(cnt);
-                        break;
-                    }
-                    default:
-                    {
-                        AssertLog(false);
-                    }
-                }
-            }
+            h_mu *= pdef->sreac_prog_O(lidx).h(pTri->oTet()->pools());
         }
 
         return h_mu * pCcst;
@@ -539,7 +427,6 @@ void smtos::SReac::apply(const rng::RNGptr &/*rng*/, double dt, double simtime,
     uint lidx = pdef->sreacG2L(pSReacdef->gidx());
 
     // Update triangle pools.
-    int * upd_s_vec = pdef->sreac_upd_S_bgn(lidx);
     uint * cnt_s_vec = pTri->pools();
 
     // First tell the triangles of any channel states relating to ohmic currents
@@ -560,32 +447,27 @@ void smtos::SReac::apply(const rng::RNGptr &/*rng*/, double dt, double simtime,
 		pTri->setOCchange(oc, cs_lidx, dt, simtime);
 	}
 
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const& t : pdef->sreac_prog_S(lidx).upd())
     {
-        if (pTri->clamped(s)) { continue;
+        if (pTri->clamped(t.lidx)) { continue;
 }
-        int upd = upd_s_vec[s];
-        int nc = static_cast<int>(cnt_s_vec[s]) + upd;
+        int nc = static_cast<int>(cnt_s_vec[t.lidx]) + t.upd;
         AssertLog(nc >= 0);
-        pTri->setCount(s, static_cast<uint>(nc), period);
+        pTri->setCount(t.lidx, static_cast<uint>(nc), period);
     }
 
     // Update inner tet pools.
     smtos::WmVol * itet = pTri->iTet();
     if (itet != nullptr)
     {
-        int * upd_i_vec = pdef->sreac_upd_I_bgn(lidx);
         uint * cnt_i_vec = itet->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const& t : pdef->sreac_prog_I(lidx).upd())
         {
-            if (itet->clamped(s)) { continue;
+            if (itet->clamped(t.lidx)) { continue;
 }
-            int upd = upd_i_vec[s];
-            int nc = static_cast<int>(cnt_i_vec[s]) + upd;
+            int nc = static_cast<int>(cnt_i_vec[t.lidx]) + t.upd;
             AssertLog(nc >= 0);
-            itet->setCount(s, static_cast<uint>(nc), period);
+            itet->setCount(t.lidx, static_cast<uint>(nc), period);
         }
     }
 
@@ -593,17 +475,14 @@ void smtos::SReac::apply(const rng::RNGptr &/*rng*/, double dt, double simtime,
     smtos::WmVol * otet = pTri->oTet();
     if (otet != nullptr)
     {
-        int * upd_o_vec = pdef->sreac_upd_O_bgn(lidx);
         uint * cnt_o_vec = otet->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const& t : pdef->sreac_prog_O(lidx).upd())
         {
-            if (otet->clamped(s)) { continue;
+            if (otet->clamped(t.lidx)) { continue;
 }
-            int upd = upd_o_vec[s];
-            int nc = static_cast<int>(cnt_o_vec[s]) + upd;
+            int nc = static_cast<int>(cnt_o_vec[t.lidx]) + t.upd;
             AssertLog(nc >= 0);
-            otet->setCount(s, static_cast<uint>(nc), period);
+            otet->setCount(t.lidx, static_cast<uint>(nc), period);
         }
     }
 
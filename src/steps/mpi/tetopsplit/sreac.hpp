@@ -75,10 +75,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file) override;
+    void checkpoint(std::iostream & cp_file) override;
 
     /// restore data
-    void restore(std::fstream & cp_file) override;
+    void restore(std::iostream & cp_file) override;
 
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS
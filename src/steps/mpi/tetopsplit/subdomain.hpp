@@ -0,0 +1,158 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_MPI_TETOPSPLIT_SUBDOMAIN_HPP
+#define STEPS_MPI_TETOPSPLIT_SUBDOMAIN_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/mpi/tetopsplit/crstruct.hpp"
+#include "steps/mpi/tetopsplit/kproc.hpp"
+#include "steps/mpi/tetopsplit/molchange.hpp"
+#include "steps/rng/rng.hpp"
+#include "steps/util/epoch_dedup.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace mpi {
+namespace tetopsplit {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Molecules moved by diffusion into an element of another sub-domain of
+/// the same process.
+struct DomainChange
+{
+    /// SUB_TET or SUB_TRI, and the global index of the element.
+    uint                                type;
+    uint                                idx;
+    uint                                lidx;
+    uint                                count;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Part of the elements hosted by a process, simulated by one task of
+/// every operator-split iteration of TetOpSplitP.
+///
+/// A sub-domain owns the CR SSA groups of its kprocs and its own random
+/// stream, so that the SSA and diffusion of different sub-domains can run
+/// on different threads. Elements only change the pools of elements of
+/// other sub-domains by diffusion; these changes are recorded in changes
+/// and applied by the owner of the element once every sub-domain is done
+/// with diffusion. Changes to the mirrors of other processes are kept per
+/// sub-domain in sendBuffers and merged before they are sent.
+///
+struct SubDomain
+{
+    SubDomain() = default;
+    SubDomain(SubDomain const &) = delete;
+    SubDomain & operator=(SubDomain const &) = delete;
+
+    ~SubDomain()
+    { clearGroups(); }
+
+    void clearGroups()
+    {
+        for (auto& g: nGroups) {
+            g->free_indices();
+            delete g;
+        }
+        nGroups.clear();
+        for (auto& g: pGroups) {
+            g->free_indices();
+            delete g;
+        }
+        pGroups.clear();
+        a0 = 0.0;
+    }
+
+    // Position in the sub-domains of the solver.
+    uint                                index{0};
+    steps::rng::RNGptr                  rng;
+
+    // CR SSA groups and total propensity of the kprocs of the sub-domain.
+    std::vector<CRGroup*>               nGroups;
+    std::vector<CRGroup*>               pGroups;
+    double                              a0{0.0};
+
+    // Diffusion rules of the sub-domain: pDiffs[diffBegin, diffEnd) of the
+    // solver, where [diffBegin, diffBoundary) may move molecules to
+    // another process. Likewise for the surface diffusion rules.
+    uint                                diffBegin{0};
+    uint                                diffBoundary{0};
+    uint                                diffEnd{0};
+    uint                                sdiffBegin{0};
+    uint                                sdiffBoundary{0};
+    uint                                sdiffEnd{0};
+
+    // Structure-of-arrays scratch space of a diffusion sweep, one entry
+    // per rule with a non-zero rate.
+    std::vector<uint>                   sweepPos;
+    std::vector<double>                 sweepRate;
+    std::vector<double>                 sweepDcst;
+    std::vector<double>                 sweepOcc;
+    std::vector<double>                 sweepLastUpd;
+    std::vector<double>                 sweepT1;
+    std::vector<double>                 sweepN;
+    std::vector<double>                 sweepUnf;
+
+    // KProcs applied by the SSA, and the diffusion rules applied with
+    // their directions, in the current iteration. The applied kprocs are
+    // still read after updKProcs has been filled, so they use their own
+    // stamps.
+    steps::util::epoch_dedup<KProc, 1>  appliedSSAKProcs;
+    std::vector<KProc*>                 appliedDiffs;
+    std::vector<int>                    appliedDirections;
+    // Scratch collection of the kprocs to update after pool changes.
+    steps::util::epoch_dedup<KProc>     updKProcs;
+
+    // Changes to the elements of every sub-domain, by destination.
+    std::vector<std::vector<DomainChange> > changes;
+    // Changes to the mirrors hosted by every neighbouring process; only
+    // used with more than one sub-domain.
+    std::vector<MolChangeBuffer>        sendBuffers;
+
+    // Simulation time of the SSA, and counters of the current iteration.
+    double                              time{0.0};
+    uint                                nsteps{0};
+    unsigned long long                  reacExtent{0};
+    unsigned long long                  diffExtent{0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+}
+
+#endif // STEPS_MPI_TETOPSPLIT_SUBDOMAIN_HPP
+
+// END
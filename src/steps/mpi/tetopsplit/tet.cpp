@@ -121,7 +121,7 @@ smtos::Tet::~Tet()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Tet::checkpoint(std::fstream & cp_file)
+void smtos::Tet::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(pDiffBndDirection), sizeof(bool) * 4);
     WmVol::checkpoint(cp_file);
@@ -129,7 +129,7 @@ void smtos::Tet::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Tet::restore(std::fstream & cp_file)
+void smtos::Tet::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(pDiffBndDirection), sizeof(bool) * 4);
     WmVol::restore(cp_file);
@@ -232,7 +232,13 @@ void smtos::Tet::setupKProcs(smtos::TetOpSplitP * tex)
 void smtos::Tet::setupDeps()
 {
     super_type::setupDeps();
+    setupSpecUpdKProcs();
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
+void smtos::Tet::setupSpecUpdKProcs()
+{
     bool has_remote_neighbors = false;
     const uint nspecs = compdef()->countSpecs();
     for (uint i = 0; i < 4; ++i)
@@ -241,7 +247,7 @@ void smtos::Tet::setupDeps()
         smtos::Tet * next = nextTet(i);
         if (next == nullptr) { continue;
 }
-        if (next->getHost() != getHost()) {
+        if (next->getHost() != getHost() || next->getDomain() != getDomain()) {
             has_remote_neighbors = true;
             break;
         }
@@ -376,7 +382,7 @@ void smtos::Tet::incCount(uint lidx, int inc, double period, bool local_change)
 	
     
     // remote change caused by diffusion
-    if (hostRank != myRank && !local_change)
+    if ((hostRank != myRank || pSol->isForeignDomain(pDomain)) && !local_change)
     {
         if (inc <= 0) {
             std::ostringstream os;
@@ -385,7 +391,12 @@ void smtos::Tet::incCount(uint lidx, int inc, double period, bool local_change)
             ProgErrLog(os.str());
         }
         
-        bufferLocations[lidx] = pSol->registerRemoteMoleculeChange(hostRank, bufferLocations[lidx], SUB_TET, pIdx.get(), lidx, inc);
+        if (hostRank != myRank) {
+            pSol->registerRemoteMoleculeChange(hostRank, bufferLocations[lidx], inc);
+        }
+        else {
+            pSol->registerDomainChange(pDomain, smtos::SUB_TET, pIdx.get(), lidx, inc);
+        }
         // does not need to check sync
     }
     // local change
@@ -442,10 +453,11 @@ void smtos::Tet::repartition(smtos::TetOpSplitP * tex, int rank, int host_rank)
 }
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Tet::setupBufferLocations()
+void smtos::Tet::setupBufferLocations(uint base)
 {
     uint nspecs = pCompdef->countSpecs();
-    bufferLocations.assign(nspecs, std::numeric_limits<uint>::max());
+    bufferLocations.resize(nspecs);
+    for (uint lidx = 0; lidx < nspecs; lidx++) bufferLocations[lidx] = base + lidx;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -103,10 +103,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file) override;
+    void checkpoint(std::iostream & cp_file) override;
 
     /// restore data
-    void restore(std::fstream & cp_file) override;
+    void restore(std::iostream & cp_file) override;
 
     ////////////////////////////////////////////////////////////////////////
     // SETUP
@@ -181,6 +181,10 @@ public:
     /////////////////////////// Dependency ////////////////////////////////
     // setup dependence for KProcs in this subvolume
     void setupDeps() override;
+
+    // collect, per species, the kprocs to update after a change of its count
+    // by another host or sub-domain
+    void setupSpecUpdKProcs();
     
     // check if kp_lidx in this vol depends on spec_gidx in WMVol kp_container
     virtual bool KProcDepSpecTet(uint kp_lidx, WmVol* kp_container, uint spec_gidx) override;
@@ -206,7 +210,9 @@ public:
 
     ////////////////////////////////////////////////////////////
     void repartition(smtos::TetOpSplitP * tex, int rank, int host_rank) override;
-    void setupBufferLocations();
+    /// Store the changes of species lidx of this mirror at location
+    /// base + lidx of the solver buffer for its host.
+    void setupBufferLocations(uint base);
 
     using super_type = smtos::WmVol;
 
@@ -241,7 +247,7 @@ private:
     /// Structure to store time since last update, used to calculate occupancy
     double 							  *	pLastUpdate;
     
-    /// location of where the change of this species is stored in  the solver buffer
+    /// location of where the change of this species is stored in the solver buffer
     std::vector<uint>                   bufferLocations;
     // local kprocs update list when spec is changed
     std::vector<std::vector<smtos::KProc *>> localSpecUpdKProcs;
@@ -30,19 +30,18 @@
 #include <cassert>
 #include <climits>
 #include <cmath>
+#include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
-#include <climits>
+#include <limits>
 #include <map>
 #include <numeric>
 #include <queue>
 #include <sstream>
 #include <vector>
 
-#include <mpi.h>
-
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -51,9 +50,11 @@
 #include "steps/common.h"
 #include "steps/error.hpp"
 #include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tetpartition.hpp"
 #include "steps/math/constants.hpp"
 #include "steps/math/point.hpp"
 #include "steps/mpi/mpi_common.hpp"
+#include "steps/mpi/mpi_compat.hpp"
 #include "steps/mpi/tetopsplit/comp.hpp"
 #include "steps/mpi/tetopsplit/diff.hpp"
 #include "steps/mpi/tetopsplit/diffboundary.hpp"
@@ -64,6 +65,7 @@
 #include "steps/mpi/tetopsplit/sdiff.hpp"
 #include "steps/mpi/tetopsplit/sdiffboundary.hpp"
 #include "steps/mpi/tetopsplit/sreac.hpp"
+#include "steps/mpi/tetopsplit/subdomain.hpp"
 #include "steps/mpi/tetopsplit/tet.hpp"
 #include "steps/mpi/tetopsplit/tetopsplit.hpp"
 #include "steps/mpi/tetopsplit/tri.hpp"
@@ -79,6 +81,7 @@
 #include "steps/solver/patchdef.hpp"
 #include "steps/solver/reacdef.hpp"
 #include "steps/solver/sdiffboundarydef.hpp"
+#include "steps/solver/specdef.hpp"
 #include "steps/solver/sreacdef.hpp"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/types.hpp"
@@ -86,10 +89,12 @@
 #include "steps/solver/vdeptransdef.hpp"
 
 #include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
 #include "steps/solver/efield/efield.hpp"
 #ifdef USE_PETSC
 #include "steps/solver/efield/dVsolver_petsc.hpp"
 #endif
+#include "steps/rng/create.hpp"
 #include "steps/util/collections.hpp"
 #include "steps/util/distribute.hpp"
 
@@ -143,6 +148,7 @@ TetOpSplitP::TetOpSplitP(steps::model::Model *m,
 
     MPI_Comm_size(MPI_COMM_WORLD, &nHosts);
 
+    pDomains.emplace_back(new SubDomain);
 
     // All initialization code now in _setup() to allow EField solver to be
     // derived and create EField local objects within the constructor
@@ -161,14 +167,6 @@ TetOpSplitP::~TetOpSplitP()
     for (auto& wvol: pWmVols) delete wvol;
     for (auto& t: pTets) delete t;
     for (auto& t: pTris) delete t;
-    for (auto& g: nGroups) {
-        g->free_indices();
-        delete g;
-    }
-    for (auto& g: pGroups) {
-        g->free_indices();
-        delete g;
-    }
 
     if (efflag())
     {
@@ -177,24 +175,586 @@ TetOpSplitP::~TetOpSplitP()
         delete[] pEFTet_GtoL;
         delete[] pEFTri_LtoG;
     }
+
+    int mpi_finalized = 0;
+    MPI_Finalized(&mpi_finalized);
+    if (!mpi_finalized) {
+        _completeRemoteSends();
+        _freeRemoteBuffers();
+    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::checkpoint(std::string const & /*file_name*/)
+namespace {
+
+// Per-type dispatch of the SSA hot loop: the qualified calls bypass the
+// vtable, and the switch lets the compiler use a jump table.
+inline double kprocRate(KProc * kp, TetOpSplitP * solver)
 {
-    std::ostringstream os;
-    os << "This function has not been implemented!";
-    NotImplErrLog(os.str());
+    switch (kp->getType()) {
+        case KP_REAC:       return static_cast<Reac*>(kp)->Reac::rate(solver);
+        case KP_SREAC:      return static_cast<SReac*>(kp)->SReac::rate(solver);
+        case KP_DIFF:       return static_cast<Diff*>(kp)->Diff::rate(solver);
+        case KP_SDIFF:      return static_cast<SDiff*>(kp)->SDiff::rate(solver);
+        case KP_GHK:        return static_cast<GHKcurr*>(kp)->GHKcurr::rate(solver);
+        case KP_VDEPSREAC:  return static_cast<VDepSReac*>(kp)->VDepSReac::rate(solver);
+        default:            return kp->rate(solver);
+    }
+}
+
+inline void kprocApply(KProc * kp, const rng::RNGptr & rng, double dt, double simtime, double period)
+{
+    switch (kp->getType()) {
+        case KP_REAC:       static_cast<Reac*>(kp)->Reac::apply(rng, dt, simtime, period); break;
+        case KP_SREAC:      static_cast<SReac*>(kp)->SReac::apply(rng, dt, simtime, period); break;
+        case KP_GHK:        static_cast<GHKcurr*>(kp)->GHKcurr::apply(rng, dt, simtime, period); break;
+        case KP_VDEPSREAC:  static_cast<VDepSReac*>(kp)->VDepSReac::apply(rng, dt, simtime, period); break;
+        default:            kp->apply(rng, dt, simtime, period); break;
+    }
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Identifies the manifest and the host files of a TetOpSplitP checkpoint.
+const char cpMagic[8] = {'S', 'T', 'E', 'P', 'S', 'O', 'S', 'P'};
+const uint cpVersion = 1;
+
+template <typename T>
+inline void cpWrite(std::ostream & os, T const & v)
+{
+    os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+inline void cpRead(std::istream & is, T & v)
+{
+    is.read(reinterpret_cast<char*>(&v), sizeof(T));
+}
+
+void cpWriteHeader(std::ostream & os)
+{
+    os.write(cpMagic, sizeof(cpMagic));
+    cpWrite(os, cpVersion);
+}
+
+// Return an error message if is does not start with a checkpoint header.
+std::string cpReadHeader(std::istream & is, std::string const & file_name)
+{
+    char magic[sizeof(cpMagic)];
+    uint version = 0;
+    is.read(magic, sizeof(magic));
+    cpRead(is, version);
+    if (!is || !std::equal(magic, magic + sizeof(magic), cpMagic) || version != cpVersion) {
+        std::ostringstream os;
+        os << "File " << file_name << " is not a checkpoint of the parallel TetOpSplit solver.";
+        return os.str();
+    }
+    return std::string();
+}
+
+// Name of the file holding the elements checkpointed by host.
+std::string cpHostFile(std::string const & file_name, int host)
+{
+    return file_name + "." + std::to_string(host);
+}
+
+// Write the state of the hosted elements of elems and of their kprocs, each
+// record prefixed by the index of the element and the size of its data so
+// that restore() on other hosts can skip it.
+template <typename Elem>
+void cpWriteElems(std::ostream & os, std::vector<Elem*> const & elems)
+{
+    uint n = 0;
+    for (auto const& e : elems) {
+        if (e != nullptr && e->getInHost()) n++;
+    }
+    cpWrite(os, n);
+
+    std::stringstream data;
+    for (uint idx = 0; idx < elems.size(); idx++) {
+        Elem * e = elems[idx];
+        if (e == nullptr || !e->getInHost()) continue;
+        data.str(std::string());
+        e->checkpoint(data);
+        for (auto const& kp : e->kprocs()) kp->checkpoint(data);
+        auto buf = data.str();
+        std::uint64_t size = buf.size();
+        cpWrite(os, idx);
+        cpWrite(os, size);
+        os.write(buf.data(), buf.size());
+    }
+}
+
+// Restore the elements of elems hosted here from the records written by
+// cpWriteElems(), and flag them in restored. Return an error message if the
+// records could not be read.
+template <typename Elem>
+std::string cpReadElems(std::istream & is, std::vector<Elem*> const & elems,
+                        std::vector<char> & restored, std::string const & file_name)
+{
+    uint n = 0;
+    cpRead(is, n);
+    std::string buf;
+    for (uint r = 0; r < n && is; r++) {
+        uint idx = 0;
+        std::uint64_t size = 0;
+        cpRead(is, idx);
+        cpRead(is, size);
+        if (!is || idx >= elems.size()) break;
+
+        Elem * e = elems[idx];
+        if (e == nullptr || !e->getInHost()) {
+            is.seekg(static_cast<std::streamoff>(size), std::ios_base::cur);
+            continue;
+        }
+        buf.resize(size);
+        is.read(&buf[0], static_cast<std::streamsize>(size));
+        std::stringstream data(buf);
+        e->restore(data);
+        for (auto const& kp : e->kprocs()) kp->restore(data);
+        if (!data || data.peek() != std::char_traits<char>::eof()) {
+            std::ostringstream os;
+            os << "Inconsistent element data in checkpoint file " << file_name << ".";
+            return os.str();
+        }
+        restored[idx] = 1;
+    }
+    if (!is) {
+        std::ostringstream os;
+        os << "Checkpoint file " << file_name << " is truncated or corrupted.";
+        return os.str();
+    }
+    return std::string();
+}
+
+// Write the sizes and partial sums of the CR SSA groups of dom. Together
+// with the CR data of the kprocs, they allow to rebuild the groups as they
+// were, so that a restored run selects the same kprocs.
+void cpWriteGroups(std::ostream & os, std::vector<CRGroup*> const & groups)
+{
+    uint n = static_cast<uint>(groups.size());
+    cpWrite(os, n);
+    for (auto const& g : groups) {
+        cpWrite(os, g->size);
+        cpWrite(os, g->sum);
+    }
+}
+
+void cpReadGroups(std::istream & is, std::vector<std::pair<unsigned, double> > & groups)
+{
+    uint n = 0;
+    cpRead(is, n);
+    groups.resize(is ? n : 0);
+    for (auto& g : groups) {
+        cpRead(is, g.first);
+        cpRead(is, g.second);
+    }
+}
+
+// Throw on every process if restoring failed on any of them; error is empty
+// if it did not fail here. Checkpoints are restored collectively, so that a
+// process throwing alone would leave the others waiting.
+void cpCheckRestored(std::string const & error, std::string const & file_name)
+{
+    int local_ok = error.empty() ? 1 : 0;
+    int all_ok = 0;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!all_ok) {
+        if (!error.empty()) ArgErrLog(error);
+        std::ostringstream os;
+        os << "Unable to restore checkpoint " << file_name << " on another process.";
+        ArgErrLog(os.str());
+    }
+}
+
+// Throw on every process if the file could not be opened on any of them.
+void cpCheckOpen(bool ok, std::string const & file_name)
+{
+    int local_ok = ok ? 1 : 0;
+    int all_ok = 0;
+    MPI_Allreduce(&local_ok, &all_ok, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (!all_ok) {
+        std::ostringstream os;
+        os << "Unable to open checkpoint file " << file_name;
+        if (!ok) os << ".";
+        else os << " on another process.";
+        ArgErrLog(os.str());
+    }
+}
+
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::restore(std::string const & /*file_name*/)
+void TetOpSplitP::checkpoint(std::string const & file_name)
 {
-    std::ostringstream os;
-    os << "This function has not been implemented!";
-    NotImplErrLog(os.str());
+    if (myRank == 0) {
+        CLOG(INFO, "general_log") << "Checkpoint to " << file_name << "...";
+    }
+
+    // Every process writes the elements it hosts, and its random streams.
+    std::string host_file = cpHostFile(file_name, myRank);
+    std::fstream cp_file(host_file.c_str(),
+                         std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    cpCheckOpen(cp_file.good(), host_file);
+
+    cpWriteHeader(cp_file);
+    cpWrite(cp_file, myRank);
+    cpWrite(cp_file, nHosts);
+
+    std::vector<uint> rng_state;
+    rng()->saveState(rng_state);
+    steps::checkpoint(cp_file, rng_state);
+    uint ndomains = static_cast<uint>(pDomains.size());
+    cpWrite(cp_file, ndomains);
+    if (ndomains > 1) {
+        for (auto const& dom : pDomains) {
+            dom->rng->saveState(rng_state);
+            steps::checkpoint(cp_file, rng_state);
+        }
+    }
+    for (auto const& dom : pDomains) {
+        cpWriteGroups(cp_file, dom->nGroups);
+        cpWriteGroups(cp_file, dom->pGroups);
+    }
+
+    cpWriteElems(cp_file, pTets);
+    cpWriteElems(cp_file, pTris);
+    cpWriteElems(cp_file, pWmVols);
+    cp_file.close();
+
+    // The extents and step counts are kept per process.
+    std::vector<unsigned long long> reac_extents(nHosts), diff_extents(nHosts);
+    MPI_Allgather(&reacExtent, 1, MPI_UNSIGNED_LONG_LONG, reac_extents.data(), 1, MPI_UNSIGNED_LONG_LONG, MPI_COMM_WORLD);
+    MPI_Allgather(&diffExtent, 1, MPI_UNSIGNED_LONG_LONG, diff_extents.data(), 1, MPI_UNSIGNED_LONG_LONG, MPI_COMM_WORLD);
+    std::vector<uint> nsteps(nHosts);
+    uint my_nsteps = statedef().nsteps();
+    MPI_Allgather(&my_nsteps, 1, MPI_UNSIGNED, nsteps.data(), 1, MPI_UNSIGNED, MPI_COMM_WORLD);
+
+    // The manifest holds the partition the element files were written
+    // with and the state shared by all processes.
+    bool ok = true;
+    if (myRank == 0) {
+        std::fstream manifest(file_name.c_str(),
+                              std::fstream::out | std::fstream::binary | std::fstream::trunc);
+        ok = manifest.good();
+        if (ok) {
+            cpWriteHeader(manifest);
+            cpWrite(manifest, nHosts);
+            cpWrite(manifest, ndomains);
+
+            uint ntets = static_cast<uint>(pTets.size());
+            uint ntris = static_cast<uint>(pTris.size());
+            uint nwmvols = static_cast<uint>(pWmVols.size());
+            cpWrite(manifest, ntets);
+            cpWrite(manifest, ntris);
+            cpWrite(manifest, nwmvols);
+            steps::checkpoint(manifest, tetHosts);
+            uint ntrihosts = static_cast<uint>(triHosts.size());
+            cpWrite(manifest, ntrihosts);
+            for (auto const& th : triHosts) {
+                cpWrite(manifest, static_cast<uint>(th.first.get()));
+                cpWrite(manifest, th.second);
+            }
+            steps::checkpoint(manifest, wmHosts);
+            steps::checkpoint(manifest, reac_extents);
+            steps::checkpoint(manifest, diff_extents);
+            steps::checkpoint(manifest, nsteps);
+            cpWrite(manifest, nIteration);
+            cpWrite(manifest, pNextRebalance);
+
+            statedef().checkpoint(manifest);
+
+            if (efflag()) {
+                // The potential is up to date on every process after run().
+                cpWrite(manifest, pTemp);
+                cpWrite(manifest, pEFDT);
+                pEField->checkpoint(manifest);
+                std::vector<double> potential(pEFNVerts);
+                for (uint v = 0; v < pEFNVerts; v++) {
+                    potential[v] = pEField->getVertV(vertex_id_t(v));
+                }
+                steps::checkpoint(manifest, potential);
+            }
+            ok = manifest.good();
+        }
+    }
+    cpCheckOpen(ok, file_name);
+
+    if (myRank == 0) {
+        CLOG(INFO, "general_log") << "complete.\n";
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::setAsyncCheckpoint(bool async)
+{
+    if (async) {
+        std::ostringstream os;
+        os << "Asynchronous checkpoints are not available for this solver!";
+        NotImplErrLog(os.str());
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::restore(std::string const & file_name)
+{
+    std::fstream manifest(file_name.c_str(), std::fstream::in | std::fstream::binary);
+    cpCheckOpen(manifest.good(), file_name);
+    cpCheckRestored(cpReadHeader(manifest, file_name), file_name);
+
+    int cp_nhosts = 0;
+    uint cp_ndomains = 0;
+    uint ntets = 0, ntris = 0, nwmvols = 0;
+    cpRead(manifest, cp_nhosts);
+    cpRead(manifest, cp_ndomains);
+    cpRead(manifest, ntets);
+    cpRead(manifest, ntris);
+    cpRead(manifest, nwmvols);
+    std::string error;
+    if (!manifest || ntets != pTets.size() || ntris != pTris.size() || nwmvols != pWmVols.size()) {
+        std::ostringstream os;
+        os << "Checkpoint " << file_name << " was written for a different mesh or geometry.";
+        error = os.str();
+    }
+    cpCheckRestored(error, file_name);
+
+    std::vector<uint> cp_tet_hosts, cp_wm_hosts;
+    steps::restore(manifest, cp_tet_hosts);
+    uint ntrihosts = 0;
+    cpRead(manifest, ntrihosts);
+    std::vector<uint> cp_tri_hosts(ntris, std::numeric_limits<uint>::max());
+    for (uint t = 0; t < ntrihosts && manifest; t++) {
+        uint tri = 0, host = 0;
+        cpRead(manifest, tri);
+        cpRead(manifest, host);
+        if (tri < ntris) cp_tri_hosts[tri] = host;
+    }
+    steps::restore(manifest, cp_wm_hosts);
+    std::vector<unsigned long long> reac_extents, diff_extents;
+    steps::restore(manifest, reac_extents);
+    steps::restore(manifest, diff_extents);
+    std::vector<uint> nsteps;
+    steps::restore(manifest, nsteps);
+    cpRead(manifest, nIteration);
+    cpRead(manifest, pNextRebalance);
+
+    statedef().restore(manifest);
+
+    if (efflag()) {
+        cpRead(manifest, pTemp);
+        cpRead(manifest, pEFDT);
+        pEField->restore(manifest);
+        std::vector<double> potential;
+        steps::restore(manifest, potential);
+        if (potential.size() != pEFNVerts) {
+            std::ostringstream os;
+            os << "Checkpoint " << file_name << " has no membrane potential for this mesh.";
+            error = os.str();
+        }
+        else {
+            for (uint v = 0; v < pEFNVerts; v++) {
+                pEField->setVertV(vertex_id_t(v), potential[v]);
+            }
+            _refreshEFTrisV();
+        }
+    }
+    if (error.empty() && (!manifest || reac_extents.size() != static_cast<uint>(cp_nhosts)
+                          || diff_extents.size() != static_cast<uint>(cp_nhosts)
+                          || nsteps.size() != static_cast<uint>(cp_nhosts))) {
+        std::ostringstream os;
+        os << "Checkpoint file " << file_name << " is truncated or corrupted.";
+        error = os.str();
+    }
+    manifest.close();
+    cpCheckRestored(error, file_name);
+
+    // Only read the files of the processes that hosted elements hosted
+    // here now; with an unchanged partition, this is our own file.
+    bool same_hosts = (cp_nhosts == nHosts);
+    std::vector<char> read_host(cp_nhosts, 0);
+    if (same_hosts) read_host[myRank] = 1;
+    for (uint t = 0; t < ntets; t++) {
+        if (pTets[t] != nullptr && pTets[t]->getInHost() && cp_tet_hosts[t] < static_cast<uint>(cp_nhosts)) {
+            read_host[cp_tet_hosts[t]] = 1;
+        }
+    }
+    for (uint t = 0; t < ntris; t++) {
+        if (pTris[t] != nullptr && pTris[t]->getInHost() && cp_tri_hosts[t] < static_cast<uint>(cp_nhosts)) {
+            read_host[cp_tri_hosts[t]] = 1;
+        }
+    }
+    for (uint w = 0; w < nwmvols; w++) {
+        if (pWmVols[w] != nullptr && pWmVols[w]->getInHost() && cp_wm_hosts[w] < static_cast<uint>(cp_nhosts)) {
+            read_host[cp_wm_hosts[w]] = 1;
+        }
+    }
+
+    // With the same partition and sub-domains, the CR groups are rebuilt
+    // exactly; otherwise they are recomputed from the restored state.
+    bool same_partition = same_hosts && cp_ndomains == pDomains.size()
+                          && cp_tet_hosts == tetHosts && cp_wm_hosts == wmHosts;
+    for (uint t = 0; t < ntris && same_partition; t++) {
+        auto th = triHosts.find(triangle_id_t(t));
+        uint host = th == triHosts.end() ? std::numeric_limits<uint>::max() : th->second;
+        same_partition = (host == cp_tri_hosts[t]);
+    }
+    std::vector<std::vector<std::pair<unsigned, double> > > cp_ngroups(pDomains.size()), cp_pgroups(pDomains.size());
+
+    std::vector<char> tet_restored(ntets, 0), tri_restored(ntris, 0), wmv_restored(nwmvols, 0);
+    std::vector<uint> rng_state;
+    for (int h = 0; h < cp_nhosts && error.empty(); h++) {
+        if (!read_host[h]) continue;
+        std::string host_file = cpHostFile(file_name, h);
+        std::fstream cp_file(host_file.c_str(), std::fstream::in | std::fstream::binary);
+        if (!cp_file.good()) {
+            std::ostringstream os;
+            os << "Unable to open checkpoint file " << host_file << ".";
+            error = os.str();
+            break;
+        }
+        error = cpReadHeader(cp_file, host_file);
+        if (!error.empty()) break;
+        int host = -1, nhosts = 0;
+        cpRead(cp_file, host);
+        cpRead(cp_file, nhosts);
+        if (host != h || nhosts != cp_nhosts) {
+            std::ostringstream os;
+            os << "Checkpoint file " << host_file << " does not belong to checkpoint " << file_name << ".";
+            error = os.str();
+            break;
+        }
+
+        // The random streams are only restored when the processes and
+        // sub-domains are the same as when checkpointing.
+        bool own_streams = same_hosts && h == myRank;
+        uint ndomains = 0;
+        try {
+            steps::restore(cp_file, rng_state);
+            if (own_streams) rng()->restoreState(rng_state);
+            cpRead(cp_file, ndomains);
+            if (ndomains > 1) {
+                for (uint d = 0; d < ndomains && cp_file; d++) {
+                    steps::restore(cp_file, rng_state);
+                    if (own_streams && ndomains == pDomains.size()) pDomains[d]->rng->restoreState(rng_state);
+                }
+            }
+        }
+        catch (steps::Err const & e) {
+            error = e.getMsg();
+            break;
+        }
+        if (own_streams && same_partition && cp_file && ndomains != pDomains.size()) {
+            std::ostringstream os;
+            os << "Checkpoint file " << host_file << " is truncated or corrupted.";
+            error = os.str();
+            break;
+        }
+        std::vector<std::pair<unsigned, double> > groups;
+        for (uint d = 0; d < ndomains && cp_file; d++) {
+            cpReadGroups(cp_file, groups);
+            if (own_streams && same_partition) cp_ngroups[d] = groups;
+            cpReadGroups(cp_file, groups);
+            if (own_streams && same_partition) cp_pgroups[d] = groups;
+        }
+
+        error = cpReadElems(cp_file, pTets, tet_restored, host_file);
+        if (error.empty()) error = cpReadElems(cp_file, pTris, tri_restored, host_file);
+        if (error.empty()) error = cpReadElems(cp_file, pWmVols, wmv_restored, host_file);
+    }
+
+    bool complete = true;
+    for (uint t = 0; t < ntets; t++) {
+        if (pTets[t] != nullptr && pTets[t]->getInHost() && !tet_restored[t]) complete = false;
+    }
+    for (uint t = 0; t < ntris; t++) {
+        if (pTris[t] != nullptr && pTris[t]->getInHost() && !tri_restored[t]) complete = false;
+    }
+    for (uint w = 0; w < nwmvols; w++) {
+        if (pWmVols[w] != nullptr && pWmVols[w]->getInHost() && !wmv_restored[w]) complete = false;
+    }
+    if (error.empty() && !complete) {
+        std::ostringstream os;
+        os << "Checkpoint " << file_name << " does not contain all the elements hosted by process " << myRank << ".";
+        error = os.str();
+    }
+    cpCheckRestored(error, file_name);
+
+    if (same_hosts) {
+        reacExtent = reac_extents[myRank];
+        diffExtent = diff_extents[myRank];
+        statedef().setNSteps(nsteps[myRank]);
+    }
+    else {
+        // Keep the totals on the first process.
+        reacExtent = myRank == 0 ? std::accumulate(reac_extents.begin(), reac_extents.end(), 0ULL) : 0;
+        diffExtent = myRank == 0 ? std::accumulate(diff_extents.begin(), diff_extents.end(), 0ULL) : 0;
+        statedef().setNSteps(myRank == 0 ? std::accumulate(nsteps.begin(), nsteps.end(), 0U) : 0);
+        if (myRank == 0) {
+            CLOG(WARNING, "general_log") << "Checkpoint " << file_name << " was written by "
+                                         << cp_nhosts << " processes: random streams are not restored.\n";
+        }
+    }
+    if (same_hosts && !pDomains.empty() && cp_ndomains != pDomains.size() && myRank == 0 && cp_ndomains > 1) {
+        CLOG(WARNING, "general_log") << "Checkpoint " << file_name << " was written with "
+                                     << cp_ndomains << " sub-domains: their random streams are not restored.\n";
+    }
+
+    // The CR data restored above refer to the groups at checkpoint time.
+    if (same_partition) {
+        for (uint d = 0; d < pDomains.size(); d++) {
+            SubDomain & dom = *pDomains[d];
+            dom.clearGroups();
+            _extendNGroups(dom, cp_ngroups[d].size());
+            _extendPGroups(dom, cp_pgroups[d].size());
+            for (uint g = 0; g < cp_ngroups[d].size(); g++) {
+                _restoreGroup(dom.nGroups[g], cp_ngroups[d][g]);
+            }
+            for (uint g = 0; g < cp_pgroups[d].size(); g++) {
+                _restoreGroup(dom.pGroups[g], cp_pgroups[d][g]);
+            }
+        }
+        for (auto const& kp : pKProcs) {
+            if (kp == nullptr || !kp->crData.recorded
+                || kp->getType() == KP_DIFF || kp->getType() == KP_SDIFF) continue;
+            SubDomain & dom = *pDomains[kp->getDomain()];
+            int pow = kp->crData.pow;
+            bool valid = pow >= 0 ? static_cast<uint>(pow) < dom.pGroups.size()
+                                  : static_cast<uint>(-pow) < dom.nGroups.size();
+            if (valid) {
+                CRGroup * group = _getGroup(dom, pow);
+                valid = kp->crData.pos < group->size;
+                if (valid) group->indices[kp->crData.pos] = kp;
+            }
+            if (!valid) {
+                std::ostringstream os;
+                os << "Checkpoint " << file_name << " has inconsistent SSA data.";
+                error = os.str();
+                break;
+            }
+        }
+    }
+    cpCheckRestored(error, file_name);
+    if (same_partition) {
+        _updateSum();
+    }
+    else {
+        for (auto const& kp : pKProcs) {
+            if (kp != nullptr) kp->crData = CRKProcData();
+        }
+        for (auto& dom : pDomains) dom->clearGroups();
+        _updateLocal();
+    }
+    // Diffusion constants may have been restored.
+    recomputeUpdPeriod = true;
+    MPI_Barrier(MPI_COMM_WORLD);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -236,6 +796,8 @@ void TetOpSplitP::_setup()
         ArgErrLog("Geometry description to steps::solver::Tetexact solver "
                 "constructor is not a valid steps::tetmesh::Tetmesh object.");
 
+    if (nHosts == 1) _setupDefaultHosts();
+
     // First initialise the pTets, pTris vector, because
     // want tets and tris to maintain indexing from Geometry
     uint ntets = mesh()->countTets();
@@ -790,33 +1352,66 @@ void TetOpSplitP::_setup()
         if (t && t->getInHost()) t->setupDeps();
 
     // Create EField structures if EField is to be calculated
-    if (efflag()) _setupEField();
-
-    for (auto& tet : boundaryTets) {
-        tet->setupBufferLocations();
-    }
-    for (auto& tri : boundaryTris) {
-        tri->setupBufferLocations();
+    if (efflag()) {
+        _setupEField();
+        _setupVDepKProcs();
     }
+
     // just in case
     neighbHosts.erase(myRank);
     nNeighbHosts = neighbHosts.size();
 
-    // construct remote molecule change buffers
-    remoteChanges.clear();
-    for (auto& neighbor : neighbHosts) {
-        remoteChanges[neighbor] = {};
-    }
-
     nEntries = pKProcs.size();
     diffSep=pDiffs.size();
     sdiffSep=pSDiffs.size();
+
+    _setupRemoteBuffers();
+    _setupDomains();
     _updateLocal();
 
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void TetOpSplitP::_setupDefaultHosts()
+{
+    if (tetHosts.empty()) {
+        tetHosts.assign(mesh()->countTets(), 0);
+    }
+    if (wmHosts.empty()) {
+        wmHosts.assign(mesh()->_countComps(), 0);
+    }
+    if (triHosts.empty()) {
+        for (uint p = 0; p < mesh()->_countPatches(); ++p) {
+            auto *tmpatch = dynamic_cast<steps::tetmesh::TmPatch*>(mesh()->_getPatch(p));
+            if (tmpatch == nullptr) continue;
+            for (auto tri : tmpatch->_getAllTriIndices()) {
+                triHosts[tri] = 0;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_setupVDepKProcs()
+{
+    pVDepKProcs.clear();
+
+    // Tri::setupKProcs() stores the voltage-dependent kprocs last; triangles
+    // hosted by other processes have none.
+    for (auto& t: pTris) {
+        if (!t || !t->getInHost()) continue;
+        ssolver::Patchdef * pdef = t->patchdef();
+        uint nvdep = pdef->countVDepTrans() + pdef->countVDepSReacs() + pdef->countGHKcurrs();
+        auto& kprocs = t->kprocs();
+        AssertLog(nvdep <= kprocs.size());
+        pVDepKProcs.insert(pVDepKProcs.end(), kprocs.end() - nvdep, kprocs.end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void TetOpSplitP::_setupEField()
 {
     using steps::math::point3d;
@@ -837,6 +1432,9 @@ void TetOpSplitP::_setupEField()
         pEField = make_EField<dVSolverPETSC>();
         break;
 #endif
+    case EF_DV_CG:
+        // Created once the partition of the membrane is known, see below.
+        break;
     default:
         ArgErrLog("Unsupported E-Field solver.");
     }
@@ -906,6 +1504,11 @@ void TetOpSplitP::_setupEField()
         pEFVert_GtoL[vertidx.get()] = efv;
     }
 
+    // Owner rank of each EField vertex and triangle, for the distributed
+    // solver: a vertex belongs to the lowest ranked host of its tets.
+    std::vector<int> efvert_owner(pEFNVerts, INT_MAX);
+    std::vector<int> eftri_owner(pEFNTris, 0);
+
     const auto& membtets = memb->_getAllVolTetIndices();
     AssertLog(membtets.size() == neftets());
     for (uint eft=0; eft < neftets(); ++eft)
@@ -932,6 +1535,13 @@ void TetOpSplitP::_setupEField()
         pEFTets[eft2+3] = tv3;
 
         pEFTet_GtoL[tetidx.get()] = eft;
+
+        uint tet_host = tetHosts[tetidx.get()];
+        if (tet_host != UINT_MAX) {
+            for (auto tv : {tv0, tv1, tv2, tv3}) {
+                efvert_owner[tv.get()] = std::min(efvert_owner[tv.get()], static_cast<int>(tet_host));
+            }
+        }
     }
 
     const auto& membtris = memb->_getAllTriIndices();
@@ -977,6 +1587,10 @@ void TetOpSplitP::_setupEField()
         pEFTris_vec[eft] = tri_p;
 
         int tri_host = tri_p->getHost();
+        eftri_owner[eft] = tri_host;
+        for (auto tv : {tv0, tv1, tv2}) {
+            if (efvert_owner[tv.get()] == INT_MAX) efvert_owner[tv.get()] = tri_host;
+        }
         ++EFTrisI_count[tri_host];
         if (myRank == tri_host) local_eftri_indices.push_back(eft);
     }
@@ -989,6 +1603,13 @@ void TetOpSplitP::_setupEField()
     MPI_Allgatherv(local_eftri_indices.data(), static_cast<int>(local_eftri_indices.size()), MPI_STEPS_INDEX,
             EFTrisI_idx.data(), EFTrisI_count.data(), EFTrisI_offset.data(), MPI_STEPS_INDEX, MPI_COMM_WORLD);
 
+    if (pEFoption == EF_DV_CG) {
+        for (auto &o : efvert_owner) {
+            if (o == INT_MAX) o = 0;
+        }
+        pEField = make_EField<dVSolverDistCG>(MPI_COMM_WORLD, std::move(efvert_owner), std::move(eftri_owner));
+    }
+
     pEField->initMesh(pEFNVerts, &(pEFVerts.front()), pEFNTris, &(pEFTris.front()), pEFNTets, &(pEFTets.front()), memb->_getOpt_method(), memb->_getOpt_file_name(), memb->_getSearch_percent());
 
     // Triangles need to be set to some initial voltage, which they can read from the Efield pointer.
@@ -1152,19 +1773,9 @@ void TetOpSplitP::reset()
         t->reset();
     }
 
-    auto ngroups = nGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(nGroups[i]->indices);
-        delete nGroups[i];
-    }
-    nGroups.clear();
-
-    ngroups = pGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(pGroups[i]->indices);
-        delete pGroups[i];
+    for (auto& dom : pDomains) {
+        dom->clearGroups();
     }
-    pGroups.clear();
 
     pSum = 0.0;
     nSum = 0.0;
@@ -1184,6 +1795,14 @@ void TetOpSplitP::reset()
     syncTime = 0.0;
     idleTime = 0.0;
 
+    molChangeBytes = 0;
+    molChangeMessages = 0;
+    molChangeRecords = 0;
+    maxMolChangeBytes = 0;
+
+    pRebalanceEvents.clear();
+    pNextRebalance = pRebalancePeriod;
+
     efieldTime = 0.0;
     rdTime = 0.0;
     dataExchangeTime = 0.0;
@@ -1211,269 +1830,295 @@ void TetOpSplitP::run(double endtime)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::_runWithoutEField(double endtime)
-{
-    MPI_Barrier(MPI_COMM_WORLD);
+namespace {
 
-    // This is the time (in seconds) to the next diffusion update. The upper limit,
-    // so as to avoid systematic slowing of diffusion, is the inverse of the highest
-    // local single-molecule diffusion rate of occupied tets.
+// Element hosting the ligand of a volume or surface diffusion rule.
+inline Tet * diffElement(Diff * d) { return d->getTet(); }
+inline Tri * diffElement(SDiff * d) { return d->getTri(); }
 
-    // This bool tracks if the update time has been aligned to the endtime. Trying to
-    // do this by instead comparing two doubles can cause infinite loops.
+}
 
-    // decide globally
-    bool aligned = false;
+////////////////////////////////////////////////////////////////////////////////
 
-    double update_period = updPeriod;
+template <typename DiffT>
+uint TetOpSplitP::_applyDiffusionSweep(SubDomain & dom, std::vector<DiffT*> const & diffs,
+                                       uint first, uint last, double update_period)
+{
+    // The rates, occupancies and last update times read here are not
+    // modified by applying diffusions, so the number of molecules to move
+    // can be computed for all rules before any of them is applied.
 
+    uint ndiffs = last - first;
+    if (dom.sweepPos.size() < ndiffs) {
+        dom.sweepPos.resize(ndiffs);
+        dom.sweepRate.resize(ndiffs);
+        dom.sweepDcst.resize(ndiffs);
+        dom.sweepOcc.resize(ndiffs);
+        dom.sweepLastUpd.resize(ndiffs);
+        dom.sweepT1.resize(ndiffs);
+        dom.sweepN.resize(ndiffs);
+        dom.sweepUnf.resize(ndiffs);
+    }
 
-    MPI_Request* requests = nullptr;
+    // Gather the rules with a non-zero rate.
+    uint nactive = 0;
+    for (uint pos = first; pos < last; pos++)
+    {
+        DiffT* d = diffs[pos];
+        double rate = d->crData.rate;
+        if (rate == 0) continue;
 
-    // here we assume that all molecule counts have been updated so the rates are accurate
-    while (statedef().time() < endtime and not aligned) {
-        #ifdef MPI_PROFILING
-        double timing_start = MPI_Wtime();
-        #endif
+        auto * elem = diffElement(d);
+        uint lidx = d->getLigLidx();
+        dom.sweepPos[nactive] = pos;
+        // rate is the rate (scaled_dcst * population)
+        dom.sweepRate[nactive] = rate;
+        dom.sweepDcst[nactive] = d->getScaledDcst();
+        dom.sweepOcc[nactive] = elem->getPoolOccupancy(lidx);
+        dom.sweepLastUpd[nactive] = elem->getLastUpdate(lidx);
+        nactive++;
+    }
 
-        double pre_ssa_time = statedef().time();
-        // Update period may take us past the endtime- adjust if so
-        if (pre_ssa_time + updPeriod > endtime) {
-            update_period = endtime - pre_ssa_time;
-            aligned=true;
-        }
+    const double * rate = dom.sweepRate.data();
+    const double * dcst = dom.sweepDcst.data();
+    const double * occ = dom.sweepOcc.data();
+    const double * lastupd = dom.sweepLastUpd.data();
+    double * t1 = dom.sweepT1.data();
+    double * n_mean = dom.sweepN.data();
+    double * unf = dom.sweepUnf.data();
 
-        // *********************** Operator Split: SSA *********************************
+    #pragma omp simd
+    for (uint i = 0; i < nactive; i++)
+    {
+        // The number of molecules available for diffusion for this diffusion rule
+        double population = rate[i] / dcst[i];
 
-        // Run SSA for the update period
+        // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
+        // by the local mean single-molecule dwellperiod. This fraction gives the mean
+        // proportion of molecules to diffuse.
+        t1[i] = std::min(update_period * dcst[i], 1.0);
 
-        double cumulative_dt=0.0;
+        // Calculate the occupancy, that is the integrated molecules over the period (units s)
+        double occupancy = occ[i] + population * (update_period - lastupd[i]);
 
-        // Store a sequence of kprocs actually applied
-        std::set<KProc*> applied_ssa_kprocs;
-        while (true)
-        {
-            KProc * kp = _getNext();
-            if (kp == nullptr) break;
+        // occupancy/update_period gives the mean number of molecules during the period,
+        // which could be higher than those available - a source of error
+        n_mean[i] = std::min(occupancy / update_period, population);
+    }
 
-            double a0 = getA0();
-            if (a0 == 0.0) break;
+    // Uniforms for the linear treatment of the fractional part of the mean.
+    dom.rng->fillUnfIE(unf, unf + nactive);
 
-            double dt=rng()->getExp(a0);
-            if (cumulative_dt +dt > update_period  || statedef().time() + dt > endtime) break;
-            cumulative_dt += dt;
+    uint nsteps = 0;
+    for (uint i = 0; i < nactive; i++)
+    {
+        DiffT* d = diffs[dom.sweepPos[i]];
 
-            _executeStep(kp, dt, cumulative_dt);
-            reacExtent +=1;
+        // n is, correctly, a binomial, but the binomial function requires rounding to
+        // an integer.
+        double n_int = std::floor(n_mean[i]);
+        uint mean_n = static_cast<uint>(n_int);
+        if (unf[i] < n_mean[i] - n_int) mean_n++;
+        if (mean_n == 0) continue;
 
+        // Find the binomial n
+        uint nmolcs = dom.rng->getBinom(mean_n, t1[i]);
 
-            applied_ssa_kprocs.insert(kp);
+        if (nmolcs == 0) continue;
 
+        // we apply here
+        if (nmolcs > diffApplyThreshold)
+        {
+            int direction = d->apply(dom.rng, nmolcs);
+            if (dom.appliedDiffs.empty() or dom.appliedDiffs.back() != d or dom.appliedDirections.back() != direction) {
+                dom.appliedDiffs.push_back(d);
+                dom.appliedDirections.push_back(direction);
+            }
         }
+        else
+        {
+            for (uint ai = 0; ai < nmolcs; ++ai)
+            {
+                int direction = d->apply(dom.rng);
+                if (dom.appliedDiffs.empty() or dom.appliedDiffs.back() != d or dom.appliedDirections.back() != direction) {
+                    dom.appliedDiffs.push_back(d);
+                    dom.appliedDirections.push_back(direction);
+                }
+            }
+        }
+        nsteps += nmolcs;
+        dom.diffExtent += nmolcs;
+    }
 
-        // Now for each process advance to jump time and get jump randomly
-        // ****************************************************************************
-
-        // *********************** Operator Split: Diffusion ***************************
-
-        // Apply diffusion after the update period
+    return nsteps;
+}
 
-        #ifdef MPI_PROFILING
-        double timing_end = MPI_Wtime();
-        compTime += (timing_end - timing_start);
-        timing_start = MPI_Wtime();
-        #endif
+////////////////////////////////////////////////////////////////////////////////
 
-        // wait until previous loop finishes sending diffusion data
-        if (requests != nullptr) {
-            MPI_Waitall(nNeighbHosts, requests, MPI_STATUSES_IGNORE);
-            delete[] requests;
+template <typename F>
+void TetOpSplitP::_forEachDomain(F && f)
+{
+    const int ndomains = pDomains.size();
+    if (ndomains == 1) {
+        tActiveDomain = 0;
+        try {
+            f(*pDomains[0]);
         }
+        catch (...) {
+            tActiveDomain = -1;
+            throw;
+        }
+        tActiveDomain = -1;
+        return;
+    }
 
-        // create new requests for this loop
-        requests = new MPI_Request[nNeighbHosts];
+    // Exceptions may not leave the parallel region.
+    std::exception_ptr error;
 
-        for (auto& neighbor : neighbHosts) {
-            remoteChanges[neighbor].clear();
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(pNThreads)
+    for (int d = 0; d < ndomains; d++) {
+        tActiveDomain = d;
+        try {
+            f(*pDomains[d]);
         }
+        catch (...) {
+            #pragma omp critical(steps_tetopsplit_domain_error)
+            {
+                if (!error) error = std::current_exception();
+            }
+        }
+        tActiveDomain = -1;
+    }
 
-        #ifdef MPI_PROFILING
-        timing_end = MPI_Wtime();
-        idleTime += (timing_end - timing_start);
-        timing_start = MPI_Wtime();
-        #endif
-
-        // Track how many diffusion 'steps' we do, simply for bookkeeping
-        uint nsteps=0;
-
-
-        // to reduce memory cost we use directions to retrieve the update list in upd process
-        std::vector<KProc*> applied_diffs;
-        std::vector<int> directions;
+    if (error) std::rethrow_exception(error);
+}
 
-        for (uint pos = 0; pos < diffSep; pos++)
-        {
-            Diff* d = pDiffs[pos];
-            double rate = d->crData.rate;
-            if (rate == 0) continue;
-            // rate is the rate (scaled_dcst * population)
-            double scaleddcst = d->getScaledDcst();
+////////////////////////////////////////////////////////////////////////////////
 
-            // The number of molecules available for diffusion for this diffusion rule
-            double population = rate/scaleddcst;
+void TetOpSplitP::_runWithoutEField(double endtime)
+{
+    MPI_Barrier(MPI_COMM_WORLD);
 
-            // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
-            // by the local mean single-molecule dwellperiod. This fraction gives the mean
-            // proportion of molecules to diffuse.
-            double t1 = update_period * scaleddcst;
+    // This is the time (in seconds) to the next diffusion update. The upper limit,
+    // so as to avoid systematic slowing of diffusion, is the inverse of the highest
+    // local single-molecule diffusion rate of occupied tets.
 
+    // This bool tracks if the update time has been aligned to the endtime. Trying to
+    // do this by instead comparing two doubles can cause infinite loops.
 
-            if (t1>=1.0) {
-                t1=1.0;
-            }
+    // decide globally
+    bool aligned = false;
 
-            // Calculate the occupancy, that is the integrated molecules over the period (units s)
-            double occupancy = d->getTet()->getPoolOccupancy(d->getLigLidx()) + population* (update_period - d->getTet()->getLastUpdate(d->getLigLidx()) );
+    double update_period = updPeriod;
 
-            // n is, correctly, a binomial, but the binomial function requires rounding to
-            // an integer.
 
-            // occupancy/update_period gives the mean number of molecules during the period
-            double n_double = occupancy/update_period;
+    // here we assume that all molecule counts have been updated so the rates are accurate
+    while (statedef().time() < endtime and not aligned) {
+        // All processes reach the same times, so they agree on rebalancing.
+        if (pRebalancePeriod > 0.0 && statedef().time() >= pNextRebalance) {
+            rebalance(pRebalanceThreshold);
+            pNextRebalance = statedef().time() + pRebalancePeriod;
+        }
 
-            // could be higher than those available - a source of error
-            if (n_double > population) n_double = population;
+        // Receive the molecule changes of this iteration while the SSA runs.
+        if (nNeighbHosts != 0) {
+            MPI_Startall(nNeighbHosts, pRecvRequests.data());
+        }
 
-            double n_int = std::floor(n_double);
-            double n_frc = n_double - n_int;
-            uint mean_n = static_cast<uint>(n_int);
+        #ifdef MPI_PROFILING
+        double timing_start = MPI_Wtime();
+        #endif
 
-            // deal linearly with the fraction
-            if (n_frc > 0.0)
-            {
-                double rand01 = rng()->getUnfIE();
-                if (rand01 < n_frc) mean_n++;
-            }
+        double pre_ssa_time = statedef().time();
+        // Update period may take us past the endtime- adjust if so
+        if (pre_ssa_time + updPeriod > endtime) {
+            update_period = endtime - pre_ssa_time;
+            aligned=true;
+        }
 
-            // Find the binomial n
-            uint nmolcs = rng()->getBinom(mean_n, t1);
+        // Every sub-domain runs its SSA for the update period, then applies
+        // the diffusion rules that may move molecules to other hosts, so
+        // that the changes can be sent before the interior rules are applied.
+        _forEachDomain([&](SubDomain & dom) {
+            // *********************** Operator Split: SSA *********************************
 
-            if (nmolcs == 0) continue;
+            double cumulative_dt=0.0;
+            dom.time = pre_ssa_time;
 
-            // we apply here
-            if (nmolcs > diffApplyThreshold)
-            {
-                int direction = d->apply(rng(), nmolcs);
-                if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                    applied_diffs.push_back(d);
-                    directions.push_back(direction);
-                }
-            }
-            else
+            // Store a sequence of kprocs actually applied
+            dom.appliedSSAKProcs.clear();
+            while (true)
             {
-                for (uint ai = 0; ai < nmolcs; ++ai)
-                {
-                    int direction = d->apply(rng());
-                    if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                        applied_diffs.push_back(d);
-                        directions.push_back(direction);
-                    }
-                }
-
-            }
-            nsteps += nmolcs;
-            diffExtent += nmolcs;
-        }
-
-        // surface diffusion
-
-        for (uint pos = 0; pos < sdiffSep; pos++)
-        {
-            SDiff* d = pSDiffs[pos];
-            double rate = d->crData.rate;
+                KProc * kp = _getNext(dom);
+                if (kp == nullptr) break;
 
-            if (rate == 0) continue;
-            // rate is the rate (scaled_dcst * population)
-            double scaleddcst = d->getScaledDcst();
+                double a0 = dom.a0;
+                if (a0 == 0.0) break;
 
-            // The number of molecules available for diffusion for this diffusion rule
-            double population = rate/scaleddcst;
+                double dt=dom.rng->getExp(a0);
+                if (cumulative_dt +dt > update_period  || dom.time + dt > endtime) break;
+                cumulative_dt += dt;
 
-            // t1, AKA 'X', is a fractional number between 0 and 1: the update period divided
-            // by the local mean single-molecule dwellperiod. This fraction gives the mean
-            // proportion of molecules to diffuse.
-            double t1 = update_period * scaleddcst;
+                _executeStep(dom, kp, dt, cumulative_dt);
+                dom.reacExtent +=1;
 
-            if (t1>=1.0)
-            {
-                t1=1.0;
+                dom.appliedSSAKProcs.insert(kp);
             }
 
-            double occupancy = d->getTri()->getPoolOccupancy(d->getLigLidx()) + population* (update_period-  d->getTri()->getLastUpdate(d->getLigLidx()) );
+            // *********************** Operator Split: Diffusion ***************************
 
-            // n is, correctly, a binomial, but the binomial function requires rounding to
-            // an integer.
+            // to reduce memory cost we use directions to retrieve the update list in upd process
+            dom.appliedDiffs.clear();
+            dom.appliedDirections.clear();
 
-            // occupancy/update_period gives the mean number of molecules during the period
-            double n_double = occupancy/update_period;
+            dom.nsteps += _applyDiffusionSweep(dom, pDiffs, dom.diffBegin, dom.diffBoundary, update_period);
+            dom.nsteps += _applyDiffusionSweep(dom, pSDiffs, dom.sdiffBegin, dom.sdiffBoundary, update_period);
+        });
 
-            // could be higher than those available - a source of error
-            if (n_double > population) n_double = population;
+        #ifdef MPI_PROFILING
+        double timing_end = MPI_Wtime();
+        compTime += (timing_end - timing_start);
+        #endif
 
-            double n_int = std::floor(n_double);
-            double n_frc = n_double - n_int;
-            uint mean_n = static_cast<uint>(n_int);
+        _sendRemoteChanges();
 
-            // deal linearly with the fraction
-            if (n_frc > 0.0)
-            {
-                double rand01 = rng()->getUnfIE();
-                if (rand01 < n_frc) mean_n++;
-            }
+        #ifdef MPI_PROFILING
+        timing_start = MPI_Wtime();
+        #endif
 
-            // Find the binomial n
-            uint nmolcs = rng()->getBinom(mean_n, t1);
+        _forEachDomain([&](SubDomain & dom) {
+            dom.nsteps += _applyDiffusionSweep(dom, pDiffs, dom.diffBoundary, dom.diffEnd, update_period);
 
-            if (nmolcs == 0) continue;
+            // surface diffusion
+            dom.nsteps += _applyDiffusionSweep(dom, pSDiffs, dom.sdiffBoundary, dom.sdiffEnd, update_period);
+        });
 
-            // we apply here
-            if (nmolcs > diffApplyThreshold)
-            {
-                int direction = d->apply(rng(), nmolcs);
-                if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                    applied_diffs.push_back(d);
-                    directions.push_back(direction);
-                }
-            }
-            else
-            {
-                for (uint ai = 0; ai < nmolcs; ++ai)
-                {
-                    int direction = d->apply(rng());
-                    if (applied_diffs.empty() or applied_diffs.back() != d or directions.back() != direction) {
-                        applied_diffs.push_back(d);
-                        directions.push_back(direction);
-                    }
-                }
+        // Once every sub-domain is done with diffusion, apply the molecules
+        // moved between sub-domains and update the kprocs.
+        _forEachDomain([&](SubDomain & dom) {
+            _applyDomainUpdates(dom);
+
+            for (auto const& akp : dom.appliedSSAKProcs) {
+                akp->resetOccupancies();
             }
-            nsteps += nmolcs;
-            diffExtent += nmolcs;
-        }
+        });
 
         #ifdef MPI_PROFILING
         timing_end = MPI_Wtime();
         compTime += (timing_end - timing_start);
         #endif
 
-        _remoteSyncAndUpdate(requests, applied_diffs, directions);
+        _remoteSyncAndUpdate();
 
-        // *********************** Operator Split: SSA *********************************
-        #ifdef MPI_PROFILING
-        starttime = MPI_Wtime();
-        #endif
-
-        for (auto const& akp : applied_ssa_kprocs) {
-            akp->resetOccupancies();
+        // Track how many diffusion 'steps' we do, simply for bookkeeping
+        uint nsteps=0;
+        for (auto& dom : pDomains) {
+            nsteps += dom->nsteps;
+            reacExtent += dom->reacExtent;
+            diffExtent += dom->diffExtent;
+            dom->nsteps = 0;
+            dom->reacExtent = 0;
+            dom->diffExtent = 0;
         }
 
         // by the end of the ssa iteration, 
@@ -1487,16 +2132,8 @@ void TetOpSplitP::_runWithoutEField(double endtime)
         if (nsteps > 0) statedef().incNSteps(nsteps);
 
         nIteration += 1;
-
-        #ifdef MPI_PROFILING
-        timing_end = MPI_Wtime();
-        compTime += (timing_end - timing_start);
-        #endif
-    }
-    if (requests != nullptr) {
-        MPI_Waitall(nNeighbHosts, requests, MPI_STATUSES_IGNORE);
-        delete[] requests;
     }
+    _completeRemoteSends();
     MPI_Barrier(MPI_COMM_WORLD);
 
 }
@@ -1561,8 +2198,11 @@ void TetOpSplitP::_runWithEField(double endtime)
         #ifdef MPI_PROFILING
         timing_start = MPI_Wtime();
         #endif
-        MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
-                EFTrisI_permuted.data(), EFTrisI_count.data(), EFTrisI_offset.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+        // The distributed solver only needs the currents of hosted triangles.
+        if (pEFoption != EF_DV_CG) {
+            MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL,
+                    EFTrisI_permuted.data(), EFTrisI_count.data(), EFTrisI_offset.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+        }
 
         #ifdef MPI_PROFILING
         timing_end = MPI_Wtime();
@@ -1573,29 +2213,50 @@ void TetOpSplitP::_runWithEField(double endtime)
         timing_start = MPI_Wtime();
         #endif
 
-        for (uint i = 0; i < pEFNTris; i++)
+        if (pEFoption == EF_DV_CG) {
+            for (int i = i_begin; i < i_end; ++i)
                 pEField->setTriI(EFTrisI_idx[i], EFTrisI_permuted[i]);
 
-        pEField->advance(real_ef_dt);
-        _refreshEFTrisV();
+            pEField->advance(real_ef_dt);
+
+            // Potentials are up to date around hosted triangles only.
+            for (int i = i_begin; i < i_end; ++i) {
+                auto tlidx = EFTrisI_idx[i];
+                EFTrisV[tlidx.get()] = pEField->getTriV(tlidx);
+            }
+        }
+        else {
+            for (uint i = 0; i < pEFNTris; i++)
+                pEField->setTriI(EFTrisI_idx[i], EFTrisI_permuted[i]);
+
+            pEField->advance(real_ef_dt);
+            _refreshEFTrisV();
+        }
 
         #ifdef MPI_PROFILING
         timing_end = MPI_Wtime();
         efieldTime += (timing_end - timing_start);
         #endif
-        // TODO: Replace this with something that only resets voltage-dependent things
 
         #ifdef MPI_PROFILING
         timing_start = MPI_Wtime();
         #endif
 
-        _updateLocal();
+        // Only the voltage-dependent rates change with the potential.
+        _updateLocal(pVDepKProcs);
 
         #ifdef MPI_PROFILING
         timing_end = MPI_Wtime();
         rdTime += (timing_end - timing_start);
         #endif
     }
+
+    if (pEFoption == EF_DV_CG) {
+        // Gather the full potential once per advance, so that the getters
+        // stay local and all processes agree on every triangle voltage.
+        pEField->syncPotential();
+        _refreshEFTrisV();
+    }
     MPI_Barrier(MPI_COMM_WORLD);
 }
 
@@ -2849,22 +3510,22 @@ uint TetOpSplitP::addKProc(steps::mpi::tetopsplit::KProc * kp)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
+steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext(SubDomain & dom) const
 {
 
-    AssertLog(pA0 >= 0.0);
+    AssertLog(dom.a0 >= 0.0);
     // Quick check to see whether nothing is there.
-    if (pA0 == 0.0) return nullptr;
+    if (dom.a0 == 0.0) return nullptr;
 
-    double selector = pA0 * rng()->getUnfII();
+    double selector = dom.a0 * dom.rng->getUnfII();
 
     double partial_sum = 0.0;
 
-    auto n_neg_groups = nGroups.size();
-    auto n_pos_groups = pGroups.size();
+    auto n_neg_groups = dom.nGroups.size();
+    auto n_pos_groups = dom.pGroups.size();
 
     for (uint i = 0; i < n_neg_groups; i++) {
-        CRGroup* group = nGroups[i];
+        CRGroup* group = dom.nGroups[i];
         if (group->size == 0) continue;
 
         if (selector > partial_sum + group->sum) {
@@ -2874,14 +3535,14 @@ steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
         }
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * dom.rng->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = dom.rng->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * dom.rng->getUnfII();
+            random_pos = dom.rng->get() % group_size;
             random_kp = group->indices[random_pos];
         }
 
@@ -2889,7 +3550,7 @@ steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
     }
 
     for (uint i = 0; i < n_pos_groups; i++) {
-        CRGroup* group = pGroups[i];
+        CRGroup* group = dom.pGroups[i];
         if (group->size == 0) continue;
 
         if (selector > partial_sum + group->sum) {
@@ -2898,15 +3559,15 @@ steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
         }
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * dom.rng->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = dom.rng->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * dom.rng->getUnfII();
+            random_pos = dom.rng->get() % group_size;
             random_kp = group->indices[random_pos];
         }
 
@@ -2916,19 +3577,19 @@ steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
     // Precision rounding error force clean up
     // Force the search in the last non-empty group
     for (auto i = n_pos_groups - 1; i != UINT_MAX; i--) {
-        CRGroup* group = pGroups[i];
+        CRGroup* group = dom.pGroups[i];
         if (group->size == 0) continue;
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * dom.rng->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = dom.rng->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * dom.rng->getUnfII();
+            random_pos = dom.rng->get() % group_size;
             random_kp = group->indices[random_pos];
 
         }
@@ -2937,19 +3598,19 @@ steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
     }
 
     for (auto i = n_neg_groups - 1; i != UINT_MAX; i--) {
-        CRGroup* group = nGroups[i];
+        CRGroup* group = dom.nGroups[i];
         if (group->size == 0) continue;
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * dom.rng->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = dom.rng->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * dom.rng->getUnfII();
+            random_pos = dom.rng->get() % group_size;
             random_kp = group->indices[random_pos];
 
         }
@@ -2962,7 +3623,7 @@ steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
     std::ostringstream os;
 
     os << "Cannot find any suitable entry.\n";
-    os << "A0: " << std::setprecision (15) << pA0 << "\n";
+    os << "A0: " << std::setprecision (15) << dom.a0 << "\n";
     os << "Selector: " << std::setprecision (15) << selector << "\n";
     os << "Current Partial Sum: " << std::setprecision (15) << partial_sum << "\n";
 
@@ -2970,27 +3631,29 @@ steps::mpi::tetopsplit::KProc * TetOpSplitP::_getNext() const
     os << "Negative groups\n";
 
     for (uint i = 0; i < n_neg_groups; i++) {
-        os <<  i << ": " << std::setprecision (15) << nGroups[i]->sum << "\n";
+        os <<  i << ": " << std::setprecision (15) << dom.nGroups[i]->sum << "\n";
     }
     os << "Positive groups\n";
     for (uint i = 0; i < n_pos_groups; i++) {
-        os << i << ": " << std::setprecision (15) << pGroups[i]->sum << "\n";
+        os << i << ": " << std::setprecision (15) << dom.pGroups[i]->sum << "\n";
     }
     ProgErrLog(os.str());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::_executeStep(steps::mpi::tetopsplit::KProc * kp, double dt, double period)
+void TetOpSplitP::_executeStep(SubDomain & dom, steps::mpi::tetopsplit::KProc * kp, double dt, double period)
 {
-    kp->apply(rng(), dt, statedef().time(), period);
-    statedef().incTime(dt);
+    kprocApply(kp, dom.rng, dt, dom.time, period);
+    dom.time += dt;
 
     // as in 0.6.1 reaction and surface reaction only require updates of local
     // KProcs, it may change if VDepSurface reaction is added in the future
-    std::vector<KProc*> upd = kp->getLocalUpdVec();
-    _updateLocal(upd);
-    statedef().incNSteps(1);
+    for (auto& upd_kp : kp->getLocalUpdVec()) {
+        _updateElement(upd_kp);
+    }
+    _updateSum(dom);
+    dom.nsteps++;
 
 }
 
@@ -3003,25 +3666,28 @@ void TetOpSplitP::_updateSpec(steps::mpi::tetopsplit::WmVol * tet, uint spec_gid
 
     if (!tet->getInHost()) return;
 
-    std::set<KProc*> updset;
+    pUpdKProcs.clear();
 
     // Loop over tet.
     uint nkprocs = tet->countKProcs();
 
     for (uint k = 0; k < nkprocs; k++)
     {
-        if (tet->KProcDepSpecTet(k, tet, spec_gidx)) updset.insert(tet->getKProc(k));
+        KProc * kp = tet->getKProc(k);
+        if (kp != nullptr && tet->KProcDepSpecTet(k, tet, spec_gidx)) pUpdKProcs.insert(kp);
     }
 
     for (auto const& tri : tet->nexttris()) {
         if (tri == nullptr) continue;
         nkprocs = tri->countKProcs();
         for (uint sk = 0; sk < nkprocs; sk++) {
-            if (tri->KProcDepSpecTet(sk, tet, spec_gidx)) updset.insert(tri->getKProc(sk));
+            // The tri may be hosted by another process.
+            KProc * kp = tri->getKProc(sk);
+            if (kp != nullptr && tri->KProcDepSpecTet(sk, tet, spec_gidx)) pUpdKProcs.insert(kp);
         }
     }
 
-    for (auto & kp : updset) {
+    for (auto & kp : pUpdKProcs) {
         _updateElement(kp);
     }
 }
@@ -3035,15 +3701,16 @@ void TetOpSplitP::_updateSpec(steps::mpi::tetopsplit::Tri * tri, uint spec_gidx)
 
     if (!tri->getInHost()) return;
 
-    std::set<KProc*> updset;
+    pUpdKProcs.clear();
 
     uint nkprocs = tri->countKProcs();
 
     for (uint sk = 0; sk < nkprocs; sk++)
     {
-        if (tri->KProcDepSpecTri(sk, tri, spec_gidx)) updset.insert(tri->getKProc(sk));
+        KProc * kp = tri->getKProc(sk);
+        if (kp != nullptr && tri->KProcDepSpecTri(sk, tri, spec_gidx)) pUpdKProcs.insert(kp);
     }
-    for (auto & kp : updset) {
+    for (auto & kp : pUpdKProcs) {
         _updateElement(kp);
     }
 
@@ -5359,34 +6026,34 @@ void TetOpSplitP::_updateLocal() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-CRGroup* TetOpSplitP::_getGroup(int pow) {
+CRGroup* TetOpSplitP::_getGroup(SubDomain & dom, int pow) {
     if (pow >= 0) {
-        return pGroups[pow];
+        return dom.pGroups[pow];
     }
     else {
-        return nGroups[-pow];
+        return dom.nGroups[-pow];
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::_extendPGroups(uint new_size) {
-    auto curr_size = pGroups.size();
+void TetOpSplitP::_extendPGroups(SubDomain & dom, uint new_size) {
+    auto curr_size = dom.pGroups.size();
 
     while (curr_size < new_size) {
-        pGroups.push_back(new CRGroup(curr_size));
+        dom.pGroups.push_back(new CRGroup(curr_size));
         curr_size ++;
     }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::_extendNGroups(uint new_size) {
+void TetOpSplitP::_extendNGroups(SubDomain & dom, uint new_size) {
 
-    uint curr_size = nGroups.size();
+    uint curr_size = dom.nGroups.size();
 
     while (curr_size < new_size) {
-        nGroups.push_back(new CRGroup(-curr_size));
+        dom.nGroups.push_back(new CRGroup(-curr_size));
         curr_size ++;
     }
 }
@@ -5404,18 +6071,39 @@ void TetOpSplitP::_extendGroup(CRGroup* group, uint size) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void TetOpSplitP::_restoreGroup(CRGroup* group, std::pair<unsigned, double> const & size_sum) {
+    if (group->capacity < size_sum.first) {
+        _extendGroup(group, size_sum.first - group->capacity);
+    }
+    group->size = size_sum.first;
+    group->sum = size_sum.second;
+    std::fill(group->indices, group->indices + group->size, nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void TetOpSplitP::_updateSum() {
     pA0 = 0.0;
+    for (auto& dom : pDomains) {
+        _updateSum(*dom);
+        pA0 += dom->a0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_updateSum(SubDomain & dom) {
+    dom.a0 = 0.0;
 
-    auto n_neg_groups = nGroups.size();
-    auto n_pos_groups = pGroups.size();
+    auto n_neg_groups = dom.nGroups.size();
+    auto n_pos_groups = dom.pGroups.size();
 
     for (uint i = 0; i < n_neg_groups; i++) {
-        pA0 += nGroups[i]->sum;
+        dom.a0 += dom.nGroups[i]->sum;
     }
 
     for (uint i = 0; i < n_pos_groups; i++) {
-        pA0 += pGroups[i]->sum;
+        dom.a0 += dom.pGroups[i]->sum;
     }
 }
 
@@ -5426,12 +6114,13 @@ void TetOpSplitP::_updateElement(KProc* kp)
 {
 
     if (kp->getType() == KP_DIFF || kp->getType() == KP_SDIFF) {
-        kp->crData.rate = kp->rate(this);
+        kp->crData.rate = kprocRate(kp, this);
         return;
     }
 
-    double new_rate = kp->rate(this);
+    double new_rate = kprocRate(kp, this);
 
+    SubDomain & dom = *pDomains[kp->getDomain()];
     CRKProcData & data = kp->crData;
     double old_rate = data.rate;
 
@@ -5450,7 +6139,7 @@ void TetOpSplitP::_updateElement(KProc* kp)
 
         if (old_pow == new_pow && data.recorded) {
 
-            CRGroup* old_group = _getGroup(old_pow);
+            CRGroup* old_group = _getGroup(dom, old_pow);
 
             old_group->sum += (new_rate - old_rate);
         }
@@ -5462,7 +6151,7 @@ void TetOpSplitP::_updateElement(KProc* kp)
             if (data.recorded) {
 
                 // remove old
-                CRGroup* old_group = _getGroup(old_pow);
+                CRGroup* old_group = _getGroup(dom, old_pow);
                 (old_group->size) --;
 
                 if (old_group->size == 0) old_group->sum = 0.0;
@@ -5476,11 +6165,11 @@ void TetOpSplitP::_updateElement(KProc* kp)
             }
 
             // add new
-            if (pGroups.size() <= static_cast<unsigned>(new_pow)) {
-                _extendPGroups(new_pow + 1);
+            if (dom.pGroups.size() <= static_cast<unsigned>(new_pow)) {
+                _extendPGroups(dom, new_pow + 1);
             }
 
-            CRGroup* new_group = pGroups[new_pow];
+            CRGroup* new_group = dom.pGroups[new_pow];
 
             AssertLog(new_group != nullptr);
             if (new_group->size == new_group->capacity) _extendGroup(new_group);
@@ -5502,7 +6191,7 @@ void TetOpSplitP::_updateElement(KProc* kp)
 
         if (old_pow == new_pow && data.recorded) {
 
-            CRGroup* old_group = _getGroup(old_pow);
+            CRGroup* old_group = _getGroup(dom, old_pow);
 
             old_group->sum += (new_rate - old_rate);
         }
@@ -5511,7 +6200,7 @@ void TetOpSplitP::_updateElement(KProc* kp)
             data.pow = new_pow;
 
             if (data.recorded) {
-                CRGroup* old_group = _getGroup(old_pow);
+                CRGroup* old_group = _getGroup(dom, old_pow);
                 (old_group->size) --;
 
                 if (old_group->size == 0) old_group->sum = 0.0;
@@ -5526,11 +6215,11 @@ void TetOpSplitP::_updateElement(KProc* kp)
 
             // add new
 
-            if (nGroups.size() <= static_cast<uint>(-new_pow)) {
-              _extendNGroups(-new_pow + 1);
+            if (dom.nGroups.size() <= static_cast<uint>(-new_pow)) {
+              _extendNGroups(dom, -new_pow + 1);
             }
 
-            CRGroup* new_group = nGroups[-new_pow];
+            CRGroup* new_group = dom.nGroups[-new_pow];
 
             if (new_group->size == new_group->capacity) _extendGroup(new_group);
             uint pos = new_group->size;
@@ -5547,7 +6236,7 @@ void TetOpSplitP::_updateElement(KProc* kp)
 
         if (data.recorded) {
 
-            CRGroup* old_group = _getGroup(data.pow);
+            CRGroup* old_group = _getGroup(dom, data.pow);
 
             // remove old
             old_group->size --;
@@ -5625,6 +6314,20 @@ void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
                                       std::string const &s,
                                       double *counts,
                                       size_t output_size) const
+{
+    // the following may throw exception if string is unknown
+    uint sidx = statedef().getSpecIdx(s);
+
+    TetOpSplitP::getBatchTetCountsNP(indices, input_size, sidx, counts, output_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
+                                      size_t input_size,
+                                      uint sgidx,
+                                      double *counts,
+                                      size_t output_size) const
 {
     if (input_size != output_size)
     {
@@ -5639,7 +6342,12 @@ void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
     std::ostringstream spec_undefined;
     std::vector<double> local_counts(input_size, 0.0);
 
-    uint sgidx = statedef().getSpecIdx(s);
+    if (sgidx >= statedef().countSpecs())
+    {
+        std::ostringstream os;
+        os << "Species index out of range.";
+        ArgErrLog(os.str());
+    }
 
     for (uint t = 0; t < input_size; t++) {
         uint tidx = indices[t];
@@ -5679,7 +6387,7 @@ void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
     }
 
     if (has_spec_warning) {
-        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following tetrahedrons, fill in zeros at target positions:\n";
+        CLOG(WARNING, "general_log") << "Species " << statedef().specdef(sgidx)->name() << " has not been defined in the following tetrahedrons, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
     MPI_Allreduce(local_counts.data(), counts, input_size, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
@@ -5690,6 +6398,20 @@ void TetOpSplitP::getBatchTetCountsNP(const index_t *indices,
 void TetOpSplitP::getBatchTriCountsNP(const index_t *indices,
                                       size_t input_size,
                                       std::string const &s,
+                                      double *counts,
+                                      size_t output_size) const
+{
+    // the following may throw exception if string is unknown
+    uint sidx = statedef().getSpecIdx(s);
+
+    TetOpSplitP::getBatchTriCountsNP(indices, input_size, sidx, counts, output_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::getBatchTriCountsNP(const index_t *indices,
+                                      size_t input_size,
+                                      uint sgidx,
                                       double * counts,
                                       size_t output_size) const
 {
@@ -5706,7 +6428,12 @@ void TetOpSplitP::getBatchTriCountsNP(const index_t *indices,
     std::ostringstream spec_undefined;
 
 
-    uint sgidx = statedef().getSpecIdx(s);
+    if (sgidx >= statedef().countSpecs())
+    {
+        std::ostringstream os;
+        os << "Species index out of range.";
+        ArgErrLog(os.str());
+    }
     std::vector<double> local_counts(input_size, 0.0);
     for (uint t = 0; t < input_size; t++) {
         uint tidx = indices[t];
@@ -5745,7 +6472,7 @@ void TetOpSplitP::getBatchTriCountsNP(const index_t *indices,
     }
 
     if (has_spec_warning) {
-        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following triangles, fill in zeros at target positions:\n";
+        CLOG(WARNING, "general_log") << "Species " << statedef().specdef(sgidx)->name() << " has not been defined in the following triangles, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
     MPI_Allreduce(local_counts.data(), counts, input_size, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
@@ -6468,87 +7195,743 @@ void TetOpSplitP::getBatchTriBatchGHKIsNP(const index_t *indices,
     MPI_Allreduce(local_counts.data(), counts, output_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
 }
 
-////////////////////////////////////////////////////////////////////////
-// ROI Data Access
-////////////////////////////////////////////////////////////////////////
-
 ////////////////////////////////////////////////////////////////////////////////
 
-std::vector<double> TetOpSplitP::getROITetCounts(const std::string& ROI_id, std::string const & s) const
+namespace {
+
+/// Tetrahedron tidx, which must be assigned to a compartment.
+Tet * batchTet(std::vector<Tet *> const & tets, index_t tidx)
 {
-    auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
-    if (roi == mesh()->rois.end<tetmesh::ROI_TET>()) {
-      ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+    if (tets[tidx] == nullptr)
+    {
+        std::ostringstream os;
+        os << "Tetrahedron " << tidx << " has not been assigned to a compartment.\n";
+        ArgErrLog(os.str());
     }
-    const auto size = roi->second.size();
-    std::vector<double> data(size);
-    getBatchTetCountsNP(reinterpret_cast<const index_t *>(roi->second.data()), size, s, &data.front(), data.size());
-    return data;
+    return tets[tidx];
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-std::vector<double> TetOpSplitP::getROITriCounts(const std::string& ROI_id, std::string const & s) const
+/// Triangle tidx, which must be assigned to a patch.
+Tri * batchTri(std::vector<Tri *> const & tris, index_t tidx)
 {
-  auto const& roi = mesh()->rois.get<tetmesh::ROI_TRI>(ROI_id);
-  if (roi == mesh()->rois.end<tetmesh::ROI_TRI>()) {
-    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
-  }
-  const auto size = roi->second.size();
-  std::vector<double> data(size);
-  getBatchTriCountsNP(reinterpret_cast<const index_t *>(roi->second.data()), roi->second.size(), s, &data.front(), data.size());
-  return data;
+    if (tris[tidx] == nullptr)
+    {
+        std::ostringstream os;
+        os << "Triangle " << tidx << " has not been assigned to a patch.\n";
+        ArgErrLog(os.str());
+    }
+    return tris[tidx];
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-void TetOpSplitP::getROITetCountsNP(const std::string& ROI_id, std::string const & s, double* counts, size_t output_size) const
+/// Local index lidx of a model object, which must be defined in the element.
+uint batchLocalIdx(uint lidx, const char * msg)
 {
-  auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
-  if (roi == mesh()->rois.end<tetmesh::ROI_TET>()) {
-    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
-  }
-  getBatchTetCountsNP(reinterpret_cast<const index_t*>(roi->second.data()), roi->second.size(), s, counts, output_size);
+    if (lidx == ssolver::LIDX_UNDEFINED)
+    {
+        std::ostringstream os;
+        os << msg;
+        ArgErrLog(os.str());
+    }
+    return lidx;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-void TetOpSplitP::getROITriCountsNP(const std::string& ROI_id, std::string const & s, double* counts, size_t output_size) const
-{
-  auto const& roi = mesh()->rois.get<tetmesh::ROI_TRI>(ROI_id);
-  if (roi == mesh()->rois.end<tetmesh::ROI_TRI>()) {
-    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
-  }
-  getBatchTriCountsNP(reinterpret_cast<const index_t *>(roi->second.data()), roi->second.size(), s, counts, output_size);
-}
+} // namespace
 
 ////////////////////////////////////////////////////////////////////////////////
 
-double TetOpSplitP::getROIVol(const std::string& ROI_id) const
+void TetOpSplitP::_getBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                                  uint oidx, double *values) const
 {
-  auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
-  if (roi == mesh()->rois.end<tetmesh::ROI_TET>()) {
-    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
-  }
-  double sum = 0.0;
-  for (const auto& tidx: roi->second) {
-      sum += pTets[tidx.get()]->vol();
-  }
-  return sum;
+    switch (q)
+    {
+        case BatchQuantity::TET_CLAMPED:
+        case BatchQuantity::TRI_CLAMPED:
+        case BatchQuantity::TET_V:
+        case BatchQuantity::TRI_V:
+        case BatchQuantity::VERT_V:
+            // replicated on all processes, no communication needed
+            API::_getBatchValues(q, indices, n, oidx, values);
+            return;
+        case BatchQuantity::TRI_OHMIC_I:
+        case BatchQuantity::TRI_GHK_I:
+            if (!efflag())
+            {
+                std::ostringstream os;
+                os << "Method not available: EField calculation not included in simulation.";
+                ArgErrLog(os.str());
+            }
+            break;
+        default:
+            break;
+    }
+
+    // Only the host of an element knows its value; the other processes
+    // contribute zeros to a single reduction.
+    std::vector<double> local_values(n, 0.0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        switch (q)
+        {
+            case BatchQuantity::TET_COUNT:
+            case BatchQuantity::TET_AMOUNT:
+            case BatchQuantity::TET_CONC:
+            {
+                Tet * tet = batchTet(pTets, idx);
+                uint lsidx = batchLocalIdx(tet->compdef()->specG2L(oidx), "Species undefined in tetrahedron.\n");
+                if (!tet->getInHost()) break;
+                double count = tet->pools()[lsidx];
+                if (q == BatchQuantity::TET_AMOUNT) count /= smath::AVOGADRO;
+                else if (q == BatchQuantity::TET_CONC) count /= 1.0e3 * tet->vol() * smath::AVOGADRO;
+                local_values[i] = count;
+                break;
+            }
+            case BatchQuantity::TET_REAC_K:
+            {
+                Tet * tet = batchTet(pTets, idx);
+                uint lridx = batchLocalIdx(tet->compdef()->reacG2L(oidx), "Reaction undefined in tetrahedron.\n");
+                if (tet->getInHost()) local_values[i] = tet->reac(lridx)->kcst();
+                break;
+            }
+            case BatchQuantity::TET_DIFF_D:
+            {
+                Tet * tet = batchTet(pTets, idx);
+                uint ldidx = batchLocalIdx(tet->compdef()->diffG2L(oidx), "Diffusion rule undefined in tetrahedron.\n");
+                if (tet->getInHost()) local_values[i] = tet->diff(ldidx)->dcst();
+                break;
+            }
+            case BatchQuantity::TRI_COUNT:
+            case BatchQuantity::TRI_AMOUNT:
+            {
+                Tri * tri = batchTri(pTris, idx);
+                uint lsidx = batchLocalIdx(tri->patchdef()->specG2L(oidx), "Species undefined in triangle.\n");
+                if (!tri->getInHost()) break;
+                double count = tri->pools()[lsidx];
+                if (q == BatchQuantity::TRI_AMOUNT) count /= smath::AVOGADRO;
+                local_values[i] = count;
+                break;
+            }
+            case BatchQuantity::TRI_SREAC_K:
+            {
+                Tri * tri = batchTri(pTris, idx);
+                uint lsridx = batchLocalIdx(tri->patchdef()->sreacG2L(oidx), "Surface reaction undefined in triangle.\n");
+                if (tri->getInHost()) local_values[i] = tri->sreac(lsridx)->kcst();
+                break;
+            }
+            case BatchQuantity::TRI_SDIFF_D:
+            {
+                Tri * tri = batchTri(pTris, idx);
+                uint ldidx = batchLocalIdx(tri->patchdef()->surfdiffG2L(oidx), "Diffusion rule undefined in triangle.\n");
+                if (tri->getInHost()) local_values[i] = tri->sdiff(ldidx)->dcst();
+                break;
+            }
+            case BatchQuantity::TRI_OHMIC_I:
+            {
+                Tri * tri = batchTri(pTris, idx);
+                auto loctidx = pEFTri_GtoL[idx];
+                if (loctidx == UNKNOWN_TRI)
+                {
+                    std::ostringstream os;
+                    os << "Triangle index " << idx << " not assigned to a membrane.";
+                    ArgErrLog(os.str());
+                }
+                if (tri->getInHost()) local_values[i] = tri->getOhmicI(EFTrisV[loctidx.get()], efdt());
+                break;
+            }
+            case BatchQuantity::TRI_GHK_I:
+            {
+                Tri * tri = batchTri(pTris, idx);
+                if (tri->getInHost()) local_values[i] = tri->getGHKI();
+                break;
+            }
+            default:
+                AssertLog(false);
+        }
+    }
+    MPI_Allreduce(local_values.data(), values, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-double TetOpSplitP::getROIArea(const std::string& ROI_id) const
+void TetOpSplitP::_setBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                                  uint oidx, const double *values)
 {
-  auto const& roi = mesh()->rois.get<tetmesh::ROI_TRI>(ROI_id);
-  if (roi == mesh()->rois.end<tetmesh::ROI_TRI>()) {
-    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
-  }
-  double sum = 0.0;
-  for (const auto& tidx: roi->second) {
-      sum += pTris[tidx.get()]->area();
-  }
+    switch (q)
+    {
+        case BatchQuantity::TET_CLAMPED:
+        case BatchQuantity::TRI_CLAMPED:
+            API::_setBatchValues(q, indices, n, oidx, values);
+            return;
+        case BatchQuantity::TET_V:
+        case BatchQuantity::TRI_V:
+        case BatchQuantity::VERT_V:
+            _setBatchVs(q, indices, n, values);
+            return;
+        default:
+            break;
+    }
+
+    // Check the whole batch before any element is set. The checks only use
+    // data replicated on all processes, so an invalid batch throws on every
+    // process and leaves the state unchanged everywhere.
+    std::vector<uint> lidxs(n);
+    std::vector<double> counts;
+    bool is_count = q == BatchQuantity::TET_COUNT || q == BatchQuantity::TET_AMOUNT
+        || q == BatchQuantity::TET_CONC || q == BatchQuantity::TRI_COUNT
+        || q == BatchQuantity::TRI_AMOUNT;
+    if (is_count) counts.assign(values, values + n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        switch (q)
+        {
+            case BatchQuantity::TET_COUNT:
+            case BatchQuantity::TET_AMOUNT:
+            case BatchQuantity::TET_CONC:
+            {
+                Tet * tet = batchTet(pTets, idx);
+                lidxs[i] = batchLocalIdx(tet->compdef()->specG2L(oidx), "Species undefined in tetrahedron.\n");
+                if (q == BatchQuantity::TET_AMOUNT) counts[i] *= smath::AVOGADRO;
+                else if (q == BatchQuantity::TET_CONC) counts[i] *= 1.0e3 * tet->vol() * smath::AVOGADRO;
+                break;
+            }
+            case BatchQuantity::TET_REAC_K:
+                lidxs[i] = batchLocalIdx(batchTet(pTets, idx)->compdef()->reacG2L(oidx), "Reaction undefined in tetrahedron.\n");
+                break;
+            case BatchQuantity::TET_DIFF_D:
+                lidxs[i] = batchLocalIdx(batchTet(pTets, idx)->compdef()->diffG2L(oidx), "Diffusion rule undefined in tetrahedron.\n");
+                break;
+            case BatchQuantity::TRI_COUNT:
+            case BatchQuantity::TRI_AMOUNT:
+            {
+                Tri * tri = batchTri(pTris, idx);
+                lidxs[i] = batchLocalIdx(tri->patchdef()->specG2L(oidx), "Species undefined in triangle.\n");
+                if (q == BatchQuantity::TRI_AMOUNT) counts[i] *= smath::AVOGADRO;
+                break;
+            }
+            case BatchQuantity::TRI_SREAC_K:
+                lidxs[i] = batchLocalIdx(batchTri(pTris, idx)->patchdef()->sreacG2L(oidx), "Surface reaction undefined in triangle.\n");
+                break;
+            case BatchQuantity::TRI_SDIFF_D:
+                lidxs[i] = batchLocalIdx(batchTri(pTris, idx)->patchdef()->surfdiffG2L(oidx), "Diffusion rule undefined in triangle.\n");
+                break;
+            default:
+                AssertLog(false);
+        }
+        if (is_count && counts[i] > UINT_MAX)
+        {
+            std::ostringstream os;
+            os << "Can't set count greater than maximum unsigned integer (";
+            os << UINT_MAX << ").\n";
+            ArgErrLog(os.str());
+        }
+    }
+
+    // Convert a number of molecules to a count, rounding the fraction
+    // stochastically as the element setters do.
+    auto toCount = [this](double count) {
+        double n_int = std::floor(count);
+        double n_frc = count - n_int;
+        uint c = static_cast<uint>(n_int);
+        if (n_frc > 0.0 && rng()->getUnfIE() < n_frc) c++;
+        return c;
+    };
+
+    // Only the host of an element updates it; the propensity sum is updated
+    // once for the batch.
+    if (q == BatchQuantity::TET_DIFF_D || q == BatchQuantity::TRI_SDIFF_D)
+        recomputeUpdPeriod = true;
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        uint lidx = lidxs[i];
+        switch (q)
+        {
+            case BatchQuantity::TET_COUNT:
+            case BatchQuantity::TET_AMOUNT:
+            case BatchQuantity::TET_CONC:
+            {
+                Tet * tet = pTets[idx];
+                if (!tet->getInHost()) break;
+                tet->setCount(lidx, toCount(counts[i]));
+                _updateSpec(tet, oidx);
+                break;
+            }
+            case BatchQuantity::TET_REAC_K:
+            {
+                Tet * tet = pTets[idx];
+                if (!tet->getInHost()) break;
+                tet->reac(lidx)->setKcst(values[i]);
+                _updateElement(tet->reac(lidx));
+                break;
+            }
+            case BatchQuantity::TET_DIFF_D:
+            {
+                Tet * tet = pTets[idx];
+                if (!tet->getInHost()) break;
+                tet->diff(lidx)->setDcst(values[i]);
+                _updateElement(tet->diff(lidx));
+                break;
+            }
+            case BatchQuantity::TRI_COUNT:
+            case BatchQuantity::TRI_AMOUNT:
+            {
+                Tri * tri = pTris[idx];
+                if (!tri->getInHost()) break;
+                tri->setCount(lidx, toCount(counts[i]));
+                _updateSpec(tri, oidx);
+                break;
+            }
+            case BatchQuantity::TRI_SREAC_K:
+            {
+                Tri * tri = pTris[idx];
+                if (!tri->getInHost()) break;
+                tri->sreac(lidx)->setKcst(values[i]);
+                _updateElement(tri->sreac(lidx));
+                break;
+            }
+            case BatchQuantity::TRI_SDIFF_D:
+            {
+                Tri * tri = pTris[idx];
+                if (!tri->getInHost()) break;
+                tri->sdiff(lidx)->setDcst(values[i]);
+                _updateElement(tri->sdiff(lidx));
+                break;
+            }
+            default:
+                AssertLog(false);
+        }
+    }
+    _updateSum();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_setBatchVs(BatchQuantity q, const index_t *indices, size_t n, const double *vs)
+{
+    if (!efflag())
+    {
+        std::ostringstream os;
+        os << "Method not available: EField calculation not included in simulation.";
+        ArgErrLog(os.str());
+    }
+
+    // Check the whole batch before any potential is set.
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        if (q == BatchQuantity::TET_V)
+        {
+            if (pEFTet_GtoL[idx] == UNKNOWN_TET)
+            {
+                std::ostringstream os;
+                os << "Tetrahedron index " << idx << " not assigned to a conduction volume.";
+                ArgErrLog(os.str());
+            }
+        }
+        else if (q == BatchQuantity::TRI_V)
+        {
+            if (pEFTri_GtoL[idx] == UNKNOWN_TRI)
+            {
+                std::ostringstream os;
+                os << "Triangle index " << idx << " not assigned to a membrane.";
+                ArgErrLog(os.str());
+            }
+        }
+        else
+        {
+            if (pEFVert_GtoL[idx] == UNKNOWN_VER)
+            {
+                std::ostringstream os;
+                os << "Vertex index " << idx << " not assigned to a conduction volume or membrane.";
+                ArgErrLog(os.str());
+            }
+        }
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        if (q == BatchQuantity::TET_V)
+        {
+            pEField->setTetV(pEFTet_GtoL[idx], vs[i]);
+        }
+        else if (q == BatchQuantity::TRI_V)
+        {
+            auto loctidx = pEFTri_GtoL[idx];
+            EFTrisV[loctidx.get()] = vs[i];
+            pEField->setTriV(loctidx, vs[i]);
+        }
+        else
+        {
+            pEField->setVertV(pEFVert_GtoL[idx], vs[i]);
+        }
+    }
+
+    // separate structure to store the EField triangle voltage, needs refreshing.
+    if (q != BatchQuantity::TRI_V) _refreshEFTrisV();
+
+    // Voltage-dependent reactions may have changed, once for the batch
+    _updateLocal();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_getBatchExtents(BatchQuantity q, const index_t *indices, size_t n,
+                                   uint ridx, unsigned long long *extents) const
+{
+    std::vector<unsigned long long> local_extents(n, 0);
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        if (q == BatchQuantity::TET_REAC_EXTENT)
+        {
+            Tet * tet = batchTet(pTets, idx);
+            uint lridx = batchLocalIdx(tet->compdef()->reacG2L(ridx), "Reaction undefined in tetrahedron.\n");
+            if (tet->getInHost()) local_extents[i] = tet->reac(lridx)->getExtent();
+        }
+        else
+        {
+            Tri * tri = batchTri(pTris, idx);
+            uint lsridx = batchLocalIdx(tri->patchdef()->sreacG2L(ridx), "Surface reaction undefined in triangle.\n");
+            if (tri->getInHost()) local_extents[i] = tri->sreac(lsridx)->getExtent();
+        }
+    }
+    MPI_Allreduce(local_extents.data(), extents, n, MPI_UNSIGNED_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+}
+
+////////////////////////////////////////////////////////////////////////
+// Batched queries
+////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint TetOpSplitP::queueQuery(BatchQueryOp op, index_t idx, std::string const & s, double value)
+{
+    BatchQuery query{op, idx, 0, 0, value};
+
+    switch (op) {
+    case QUERY_GET_TET_COUNT:
+    case QUERY_SET_TET_COUNT:
+    case QUERY_GET_TET_CONC:
+    case QUERY_SET_TET_CONC:
+    case QUERY_GET_TET_REACK:
+    case QUERY_SET_TET_REACK:
+    {
+        if (idx >= pTets.size())
+        {
+            std::ostringstream os;
+            os << "Error (Index Overbound): There is no tetrahedron with index " << idx << ".\n";
+            ArgErrLog(os.str());
+        }
+        Tet * tet = pTets[idx];
+        if (tet == nullptr)
+        {
+            std::ostringstream os;
+            os << "Tetrahedron " << idx << " has not been assigned to a compartment.\n";
+            ArgErrLog(os.str());
+        }
+        if (op == QUERY_GET_TET_REACK || op == QUERY_SET_TET_REACK) {
+            // the following may throw exception if string is unknown
+            query.gidx = statedef().getReacIdx(s);
+            query.lidx = tet->compdef()->reacG2L(query.gidx);
+            if (query.lidx == ssolver::LIDX_UNDEFINED)
+            {
+                std::ostringstream os;
+                os << "Reaction undefined in tetrahedron.\n";
+                ArgErrLog(os.str());
+            }
+        }
+        else {
+            query.gidx = statedef().getSpecIdx(s);
+            query.lidx = tet->compdef()->specG2L(query.gidx);
+            if (query.lidx == ssolver::LIDX_UNDEFINED)
+            {
+                std::ostringstream os;
+                os << "Species undefined in tetrahedron.\n";
+                ArgErrLog(os.str());
+            }
+        }
+        if (op == QUERY_SET_TET_CONC) {
+            // from now on a count
+            query.value = value * (1.0e3 * tet->vol() * steps::math::AVOGADRO);
+        }
+        break;
+    }
+    case QUERY_GET_TRI_COUNT:
+    case QUERY_SET_TRI_COUNT:
+    case QUERY_GET_TRI_SREACK:
+    case QUERY_SET_TRI_SREACK:
+    case QUERY_GET_TRI_V:
+    {
+        if (idx >= pTris.size())
+        {
+            std::ostringstream os;
+            os << "Error (Index Overbound): There is no triangle with index " << idx << ".\n";
+            ArgErrLog(os.str());
+        }
+        Tri * tri = pTris[idx];
+        if (tri == nullptr)
+        {
+            std::ostringstream os;
+            os << "Triangle " << idx << " has not been assigned to a patch.\n";
+            ArgErrLog(os.str());
+        }
+        if (op == QUERY_GET_TRI_V) {
+            if (!efflag())
+            {
+                std::ostringstream os;
+                os << "Method not available: EField calculation not included in simulation.";
+                ArgErrLog(os.str());
+            }
+            if (pEFTri_GtoL[idx] == UNKNOWN_TRI)
+            {
+                std::ostringstream os;
+                os << "Triangle index " << idx << " not assigned to a membrane.";
+                ArgErrLog(os.str());
+            }
+            query.lidx = pEFTri_GtoL[idx].get();
+        }
+        else if (op == QUERY_GET_TRI_SREACK || op == QUERY_SET_TRI_SREACK) {
+            query.gidx = statedef().getSReacIdx(s);
+            query.lidx = tri->patchdef()->sreacG2L(query.gidx);
+            if (query.lidx == ssolver::LIDX_UNDEFINED)
+            {
+                std::ostringstream os;
+                os << "Surface reaction undefined in triangle.\n";
+                ArgErrLog(os.str());
+            }
+        }
+        else {
+            query.gidx = statedef().getSpecIdx(s);
+            query.lidx = tri->patchdef()->specG2L(query.gidx);
+            if (query.lidx == ssolver::LIDX_UNDEFINED)
+            {
+                std::ostringstream os;
+                os << "Species undefined in triangle.\n";
+                ArgErrLog(os.str());
+            }
+        }
+        break;
+    }
+    default:
+        ArgErrLog("Unknown query operation.");
+    }
+
+    if (query.value < 0.0)
+    {
+        std::ostringstream os;
+        os << "Negative value " << query.value << " in query on element " << idx << ".\n";
+        ArgErrLog(os.str());
+    }
+    if ((op == QUERY_SET_TET_COUNT || op == QUERY_SET_TET_CONC || op == QUERY_SET_TRI_COUNT)
+        && query.value > UINT_MAX)
+    {
+        std::ostringstream os;
+        os << "Can't set count greater than maximum unsigned integer (";
+        os << UINT_MAX << ").\n";
+        ArgErrLog(os.str());
+    }
+
+    pQueries.push_back(query);
+    return pQueries.size() - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<double> TetOpSplitP::runQueries()
+{
+    std::vector<double> results(pQueries.size(), 0.0);
+    runQueriesNP(results.data(), results.size());
+    return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::runQueriesNP(double * results, size_t output_size)
+{
+    if (output_size != pQueries.size())
+    {
+        std::ostringstream os;
+        os << "Error: output array (results) size should be the same as the number of queued queries.\n";
+        ArgErrLog(os.str());
+    }
+
+    // Stochastic rounding of a count being set, as in _setTetCount().
+    auto round_count = [this](double n) {
+        double n_int = std::floor(n);
+        auto count = static_cast<uint>(n_int);
+        if (n - n_int > 0.0 && rng()->getUnfIE() < n - n_int) count++;
+        return count;
+    };
+
+    bool updated = false;
+    for (size_t q = 0; q < output_size; ++q) {
+        auto const& query = pQueries[q];
+        results[q] = 0.0;
+
+        switch (query.op) {
+        case QUERY_GET_TET_COUNT:
+        case QUERY_GET_TET_CONC:
+        {
+            Tet * tet = pTets[query.idx];
+            if (!tet->getInHost()) break;
+            double count = tet->pools()[query.lidx];
+            results[q] = query.op == QUERY_GET_TET_COUNT ? count
+                : count / (1.0e3 * tet->vol() * steps::math::AVOGADRO);
+            break;
+        }
+        case QUERY_SET_TET_COUNT:
+        case QUERY_SET_TET_CONC:
+        {
+            Tet * tet = pTets[query.idx];
+            if (!tet->getInHost()) break;
+            tet->setCount(query.lidx, round_count(query.value));
+            _updateSpec(tet, query.gidx);
+            updated = true;
+            break;
+        }
+        case QUERY_GET_TET_REACK:
+        {
+            Tet * tet = pTets[query.idx];
+            if (tet->getInHost()) results[q] = tet->reac(query.lidx)->kcst();
+            break;
+        }
+        case QUERY_SET_TET_REACK:
+        {
+            Tet * tet = pTets[query.idx];
+            if (!tet->getInHost()) break;
+            tet->reac(query.lidx)->setKcst(query.value);
+            _updateElement(tet->reac(query.lidx));
+            updated = true;
+            break;
+        }
+        case QUERY_GET_TRI_COUNT:
+        {
+            Tri * tri = pTris[query.idx];
+            if (tri->getInHost()) results[q] = tri->pools()[query.lidx];
+            break;
+        }
+        case QUERY_SET_TRI_COUNT:
+        {
+            Tri * tri = pTris[query.idx];
+            if (!tri->getInHost()) break;
+            tri->setCount(query.lidx, round_count(query.value));
+            _updateSpec(tri, query.gidx);
+            updated = true;
+            break;
+        }
+        case QUERY_GET_TRI_SREACK:
+        {
+            Tri * tri = pTris[query.idx];
+            if (tri->getInHost()) results[q] = tri->sreac(query.lidx)->kcst();
+            break;
+        }
+        case QUERY_SET_TRI_SREACK:
+        {
+            Tri * tri = pTris[query.idx];
+            if (!tri->getInHost()) break;
+            tri->sreac(query.lidx)->setKcst(query.value);
+            _updateElement(tri->sreac(query.lidx));
+            updated = true;
+            break;
+        }
+        case QUERY_GET_TRI_V:
+        {
+            // Up to date on the host of the triangle with every EField solver.
+            if (pTris[query.idx]->getInHost()) results[q] = EFTrisV[query.lidx];
+            break;
+        }
+        }
+    }
+    pQueries.clear();
+
+    if (updated) _updateSum();
+
+    MPI_Allreduce(MPI_IN_PLACE, results, output_size, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+}
+
+////////////////////////////////////////////////////////////////////////
+// ROI Data Access
+////////////////////////////////////////////////////////////////////////
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<double> TetOpSplitP::getROITetCounts(const std::string& ROI_id, std::string const & s) const
+{
+    auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
+    if (roi == mesh()->rois.end<tetmesh::ROI_TET>()) {
+      ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+    }
+    const auto size = roi->second.size();
+    std::vector<double> data(size);
+    getBatchTetCountsNP(reinterpret_cast<const index_t *>(roi->second.data()), size, s, &data.front(), data.size());
+    return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<double> TetOpSplitP::getROITriCounts(const std::string& ROI_id, std::string const & s) const
+{
+  auto const& roi = mesh()->rois.get<tetmesh::ROI_TRI>(ROI_id);
+  if (roi == mesh()->rois.end<tetmesh::ROI_TRI>()) {
+    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+  }
+  const auto size = roi->second.size();
+  std::vector<double> data(size);
+  getBatchTriCountsNP(reinterpret_cast<const index_t *>(roi->second.data()), roi->second.size(), s, &data.front(), data.size());
+  return data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::getROITetCountsNP(const std::string& ROI_id, std::string const & s, double* counts, size_t output_size) const
+{
+  auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
+  if (roi == mesh()->rois.end<tetmesh::ROI_TET>()) {
+    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+  }
+  getBatchTetCountsNP(reinterpret_cast<const index_t*>(roi->second.data()), roi->second.size(), s, counts, output_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::getROITriCountsNP(const std::string& ROI_id, std::string const & s, double* counts, size_t output_size) const
+{
+  auto const& roi = mesh()->rois.get<tetmesh::ROI_TRI>(ROI_id);
+  if (roi == mesh()->rois.end<tetmesh::ROI_TRI>()) {
+    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+  }
+  getBatchTriCountsNP(reinterpret_cast<const index_t *>(roi->second.data()), roi->second.size(), s, counts, output_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double TetOpSplitP::getROIVol(const std::string& ROI_id) const
+{
+  auto const& roi = mesh()->rois.get<tetmesh::ROI_TET>(ROI_id);
+  if (roi == mesh()->rois.end<tetmesh::ROI_TET>()) {
+    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+  }
+  double sum = 0.0;
+  for (const auto& tidx: roi->second) {
+      sum += pTets[tidx.get()]->vol();
+  }
+  return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double TetOpSplitP::getROIArea(const std::string& ROI_id) const
+{
+  auto const& roi = mesh()->rois.get<tetmesh::ROI_TRI>(ROI_id);
+  if (roi == mesh()->rois.end<tetmesh::ROI_TRI>()) {
+    ArgErrLog("ROI check fail, please make sure the ROI stores correct elements.");
+  }
+  double sum = 0.0;
+  for (const auto& tidx: roi->second) {
+      sum += pTris[tidx.get()]->area();
+  }
   return sum;
 }
 
@@ -7925,242 +9308,582 @@ uint TetOpSplitP::getTetHostRank(uint tidx)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-uint TetOpSplitP::getTriHostRank(uint tidx)
+uint TetOpSplitP::getTriHostRank(uint tidx)
+{
+    return triHosts[tidx];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint TetOpSplitP::getWMVolHostRank(uint idx)
+{
+    return wmHosts[idx];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_updateLocal(uint* upd_entries, uint buffer_size) {
+    for (uint i = 0; i < buffer_size; i++) {
+        if (pKProcs[upd_entries[i]] != nullptr)
+        {
+            _updateElement(pKProcs[upd_entries[i]]);
+        }
+    }
+
+    _updateSum();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::addDiff(Diff* diff)
+{
+    diff->crData.pos = pDiffs.size();
+    pDiffs.push_back(diff);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_updateDiff(Diff* diff)
+{
+    double new_rate = diff->rate(this);
+
+    diff->crData.rate = new_rate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::addSDiff(SDiff* sdiff)
+{
+    sdiff->crData.pos = pSDiffs.size();
+    pSDiffs.push_back(sdiff);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_updateSDiff(SDiff* sdiff)
+{
+    double new_rate = sdiff->rate(this);
+
+    sdiff->crData.rate = new_rate;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::addNeighHost(int host)
+{
+    neighbHosts.insert(host);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::registerBoundaryTet(Tet* tet)
+{
+    boundaryTets.insert(tet);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::registerBoundaryTri(Tri* tri)
+{
+    boundaryTris.insert(tri);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::registerRemoteMoleculeChange(int svol_host, uint loc, uint change)
+{
+    uint n = pNeighbIndex[svol_host];
+    if (tActiveDomain >= 0 && pDomains.size() > 1) {
+        pDomains[tActiveDomain]->sendBuffers[n].add(loc, change);
+    }
+    else {
+        pSendBuffers[n].add(loc, change);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Whether a diffusion rule may move molecules to an element hosted by
+// another process.
+inline bool crossesHosts(Diff * d)
+{
+    Tet * tet = d->getTet();
+    for (uint i = 0; i < 4; ++i) {
+        Tet * next = tet->nextTet(i);
+        if (next != nullptr && next->getHost() != tet->getHost()) return true;
+    }
+    return false;
+}
+
+inline bool crossesHosts(SDiff * d)
+{
+    Tri * tri = d->getTri();
+    for (uint i = 0; i < 3; ++i) {
+        Tri * next = tri->nextTri(i);
+        if (next != nullptr && next->getHost() != tri->getHost()) return true;
+    }
+    return false;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_setupRemoteBuffers()
+{
+    pNeighbRanks.assign(neighbHosts.begin(), neighbHosts.end());
+    pNeighbIndex.assign(nHosts, std::numeric_limits<uint>::max());
+    for (uint n = 0; n < nNeighbHosts; n++) pNeighbIndex[pNeighbRanks[n]] = n;
+
+    // (type, idx) pairs of the mirrors hosted by each neighbour; sorted
+    // below, their order gives the slots of the molecule change messages.
+    std::vector<std::vector<uint> > send_slots(nNeighbHosts);
+    for (auto& tet : boundaryTets) {
+        auto & slots = send_slots[pNeighbIndex[tet->getHost()]];
+        slots.push_back(SUB_TET);
+        slots.push_back(tet->idx().get());
+    }
+    for (auto& tri : boundaryTris) {
+        auto & slots = send_slots[pNeighbIndex[tri->getHost()]];
+        slots.push_back(SUB_TRI);
+        slots.push_back(tri->idx().get());
+    }
+
+    pSendBuffers.resize(nNeighbHosts);
+    std::vector<uint> send_info(2 * nHosts, 0);
+    for (uint n = 0; n < nNeighbHosts; n++) {
+        auto & slots = send_slots[n];
+        uint nslots = slots.size() / 2;
+        std::vector<std::pair<uint, uint> > sorted(nslots);
+        for (uint s = 0; s < nslots; s++) sorted[s] = {slots[2 * s], slots[2 * s + 1]};
+        std::sort(sorted.begin(), sorted.end());
+
+        std::vector<uint> elem_nspecs(nslots);
+        for (uint s = 0; s < nslots; s++) {
+            slots[2 * s] = sorted[s].first;
+            slots[2 * s + 1] = sorted[s].second;
+            if (sorted[s].first == SUB_TET) {
+                elem_nspecs[s] = pTets[sorted[s].second]->compdef()->countSpecs();
+            } else {
+                elem_nspecs[s] = pTris[sorted[s].second]->patchdef()->countSpecs();
+            }
+        }
+        MolChangeBuffer & buffer = pSendBuffers[n];
+        buffer.setup(elem_nspecs);
+        for (uint s = 0; s < nslots; s++) {
+            if (sorted[s].first == SUB_TET) {
+                pTets[sorted[s].second]->setupBufferLocations(buffer.base(s));
+            } else {
+                pTris[sorted[s].second]->setupBufferLocations(buffer.base(s));
+            }
+        }
+
+        int neighbor = pNeighbRanks[n];
+        send_info[2 * neighbor] = nslots;
+        send_info[2 * neighbor + 1] = buffer.capacity();
+    }
+
+    std::vector<uint> recv_info(2 * nHosts, 0);
+    MPI_Alltoall(send_info.data(), 2, MPI_UNSIGNED, recv_info.data(), 2, MPI_UNSIGNED, MPI_COMM_WORLD);
+
+    // Agree on the slots with every neighbour.
+    pRecvSlots.resize(nNeighbHosts);
+    std::vector<MPI_Request> slot_requests(2 * nNeighbHosts);
+    for (uint n = 0; n < nNeighbHosts; n++) {
+        int neighbor = pNeighbRanks[n];
+        pRecvSlots[n].resize(2 * recv_info[2 * neighbor]);
+        MPI_Irecv(pRecvSlots[n].data(), pRecvSlots[n].size(), MPI_UNSIGNED, neighbor,
+                  OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &(slot_requests[2 * n]));
+        MPI_Isend(send_slots[n].data(), send_slots[n].size(), MPI_UNSIGNED, neighbor,
+                  OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &(slot_requests[2 * n + 1]));
+    }
+    MPI_Waitall(slot_requests.size(), slot_requests.data(), MPI_STATUSES_IGNORE);
+
+    pSendRequests.assign(nNeighbHosts, MPI_REQUEST_NULL);
+    pRecvRequests.assign(nNeighbHosts, MPI_REQUEST_NULL);
+    pRecvBuffers.resize(nNeighbHosts);
+    for (uint n = 0; n < nNeighbHosts; n++) {
+        int neighbor = pNeighbRanks[n];
+        uint capacity = recv_info[2 * neighbor + 1];
+        // keep at least one element so that data() is valid
+        pRecvBuffers[n].resize(std::max(capacity, 1u));
+        MPI_Recv_init(pRecvBuffers[n].data(), capacity, MPI_BYTE, neighbor,
+                      OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &(pRecvRequests[n]));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_freeRemoteBuffers()
+{
+    for (auto& req : pRecvRequests) {
+        if (req != MPI_REQUEST_NULL) MPI_Request_free(&req);
+    }
+    pRecvRequests.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_completeRemoteSends()
 {
-    return triHosts[tidx];
+    if (pSendRequests.empty()) return;
+
+    #ifdef MPI_PROFILING
+    double timing_start = MPI_Wtime();
+    #endif
+
+    MPI_Waitall(pSendRequests.size(), pSendRequests.data(), MPI_STATUSES_IGNORE);
+
+    #ifdef MPI_PROFILING
+    idleTime += (MPI_Wtime() - timing_start);
+    #endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-uint TetOpSplitP::getWMVolHostRank(uint idx)
+void TetOpSplitP::_sendRemoteChanges()
 {
-    return wmHosts[idx];
-}
+    #ifdef MPI_PROFILING
+    double timing_start = MPI_Wtime();
+    #endif
 
-////////////////////////////////////////////////////////////////////////////////
+    // The wire buffers are reused: the last messages must be gone.
+    _completeRemoteSends();
 
-void TetOpSplitP::_updateLocal(uint* upd_entries, uint buffer_size) {
-    for (uint i = 0; i < buffer_size; i++) {
-        if (pKProcs[upd_entries[i]] != nullptr)
-        {
-            _updateElement(pKProcs[upd_entries[i]]);
+    for (uint n = 0; n < nNeighbHosts; n++) {
+        MolChangeBuffer & buffer = pSendBuffers[n];
+        if (pDomains.size() > 1) {
+            for (auto& dom : pDomains) buffer.absorb(dom->sendBuffers[n]);
         }
+        buffer.encode();
+        MPI_Isend(buffer.data(), buffer.size(), MPI_BYTE, pNeighbRanks[n], OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &(pSendRequests[n]));
+
+        molChangeBytes += buffer.size();
+        molChangeRecords += buffer.records();
+        maxMolChangeBytes = std::max<unsigned long long>(maxMolChangeBytes, buffer.size());
     }
+    molChangeMessages += nNeighbHosts;
 
-    _updateSum();
+    #ifdef MPI_PROFILING
+    syncTime += (MPI_Wtime() - timing_start);
+    #endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::addDiff(Diff* diff)
+void TetOpSplitP::_remoteSyncAndUpdate()
 {
-    diff->crData.pos = pDiffs.size();
-    pDiffs.push_back(diff);
-}
+    #ifdef MPI_PROFILING
+    double timing_start, timing_end;
+    #endif
 
-////////////////////////////////////////////////////////////////////////////////
+    pUpdKProcs.clear();
+    for (uint r = 0; r < nNeighbHosts; r++) {
+        #ifdef MPI_PROFILING
+        timing_start = MPI_Wtime();
+        #endif
 
-void TetOpSplitP::_updateDiff(Diff* diff)
-{
-    double new_rate = diff->rate(this);
+        int n = MPI_UNDEFINED;
+        MPI_Status status;
+        MPI_Waitany(nNeighbHosts, pRecvRequests.data(), &n, &status);
+        AssertLog(n != MPI_UNDEFINED);
 
-    diff->crData.rate = new_rate;
-}
+        #ifdef MPI_PROFILING
+        timing_end = MPI_Wtime();
+        idleTime += (timing_end - timing_start);
+        timing_start = MPI_Wtime();
+        #endif
 
-////////////////////////////////////////////////////////////////////////////////
+        int change_size = 0;
+        MPI_Get_count(&status, MPI_BYTE, &change_size);
+        std::vector<uint> const & slots = pRecvSlots[n];
 
-void TetOpSplitP::addSDiff(SDiff* sdiff)
-{
-    sdiff->crData.pos = pSDiffs.size();
-    pSDiffs.push_back(sdiff);
-}
+        // apply changes
+        decodeMolChanges(pRecvBuffers[n].data(), change_size,
+            [&](uint slot, uint slidx, uint value) {
+                AssertLog(2 * slot + 1 < slots.size());
+                uint idx = slots[2 * slot + 1];
+                if (slots[2 * slot] == SUB_TET) {
+                    pTets[idx]->incCount(slidx, value);
+                    std::vector<KProc*> const & remote_upd = pTets[idx]->getSpecUpdKProcs(slidx);
+                    pUpdKProcs.insert(remote_upd.begin(), remote_upd.end());
+                }
+                else {
+                    pTris[idx]->incCount(slidx, value);
+                    std::vector<KProc*> const & remote_upd = pTris[idx]->getSpecUpdKProcs(slidx);
+                    pUpdKProcs.insert(remote_upd.begin(), remote_upd.end());
+                }
+            });
 
-////////////////////////////////////////////////////////////////////////////////
+        #ifdef MPI_PROFILING
+        timing_end = MPI_Wtime();
+        syncTime += (timing_end - timing_start);
+        #endif
+    }
 
-void TetOpSplitP::_updateSDiff(SDiff* sdiff)
-{
-    double new_rate = sdiff->rate(this);
+    // Messages arrive in any order, but the SSA groups depend on the order
+    // of the updates: update the kprocs by index to keep runs reproducible.
+    pRemoteUpdKProcs.assign(pUpdKProcs.begin(), pUpdKProcs.end());
+    std::sort(pRemoteUpdKProcs.begin(), pRemoteUpdKProcs.end(),
+              [](KProc * a, KProc * b) { return a->schedIDX() < b->schedIDX(); });
+    for (auto & upd_kp : pRemoteUpdKProcs) {
+        _updateElement(upd_kp);
+    }
 
-    sdiff->crData.rate = new_rate;
+    _updateSum();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::addNeighHost(int host)
+namespace {
+
+// Stable sort of diffs[0, ndiffs) by sub-domain, with the rules crossing
+// hosts first within every sub-domain.
+template <typename DiffT>
+void orderDomainDiffs(std::vector<DiffT*> & diffs, uint ndiffs)
 {
-    neighbHosts.insert(host);
+    std::stable_sort(diffs.begin(), diffs.begin() + ndiffs, [](DiffT * a, DiffT * b) {
+        uint da = diffElement(a)->getDomain();
+        uint db = diffElement(b)->getDomain();
+        if (da != db) return da < db;
+        return crossesHosts(a) && !crossesHosts(b);
+    });
+    for (uint pos = 0; pos < ndiffs; pos++) {
+        diffs[pos]->crData.pos = pos;
+    }
 }
 
-////////////////////////////////////////////////////////////////////////////////
-
-void TetOpSplitP::registerBoundaryTet(Tet* tet)
+// Range [begin, boundary, end) of the rules of sub-domain d in diffs
+// ordered by orderDomainDiffs, starting the search at begin.
+template <typename DiffT>
+void domainDiffRange(std::vector<DiffT*> const & diffs, uint ndiffs, uint d,
+                     uint & begin, uint & boundary, uint & end)
 {
-    boundaryTets.insert(tet);
+    while (begin < ndiffs && diffElement(diffs[begin])->getDomain() < d) begin++;
+    boundary = begin;
+    while (boundary < ndiffs && diffElement(diffs[boundary])->getDomain() == d
+           && crossesHosts(diffs[boundary])) boundary++;
+    end = boundary;
+    while (end < ndiffs && diffElement(diffs[end])->getDomain() == d) end++;
+}
+
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP::registerBoundaryTri(Tri* tri)
-{
-    boundaryTris.insert(tri);
-}
+thread_local int TetOpSplitP::tActiveDomain = -1;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-uint TetOpSplitP::registerRemoteMoleculeChange(int svol_host,
-                                               uint loc,
-                                               SubVolType svol_type,
-                                               unsigned long idx,
-                                               uint slidx,
-                                               uint change)
+void TetOpSplitP::setNThreads(uint nthreads, uint ndomains)
 {
-    uint new_loc = remoteChanges[svol_host].size();
+    if (nthreads == 0) {
+        ArgErrLog("Number of threads must be positive.");
+    }
+    if (ndomains == 0) ndomains = nthreads;
 
-    if (new_loc == 0 || new_loc - 4 < loc) {
-        remoteChanges[svol_host].push_back(svol_type);
-        remoteChanges[svol_host].push_back(idx);
-        remoteChanges[svol_host].push_back(slidx);
-        remoteChanges[svol_host].push_back(change);
+    #ifndef _OPENMP
+    if (nthreads > 1) {
+        CLOG(WARNING, "general_log") << "STEPS was built without OpenMP: sub-domains run on a single thread.\n";
     }
-    else {
-        uint stored_type = remoteChanges[svol_host][loc];
-        uint stored_idx = remoteChanges[svol_host][loc + 1];
-        uint stored_slidx = remoteChanges[svol_host][loc + 2];
+    #endif
 
-        if (stored_type == svol_type && stored_idx ==idx && stored_slidx == slidx) {
-            remoteChanges[svol_host][loc + 3] += change;
-            new_loc = loc;
-        }
-        else {
-            remoteChanges[svol_host].push_back(svol_type);
-            remoteChanges[svol_host].push_back(idx);
-            remoteChanges[svol_host].push_back(slidx);
-            remoteChanges[svol_host].push_back(change);
-        }
+    pNThreads = nthreads;
+    if (ndomains == pDomains.size()) return;
+
+    pDomains.clear();
+    for (uint d = 0; d < ndomains; d++) {
+        pDomains.emplace_back(new SubDomain);
     }
-    return new_loc;
+    _setupDomains();
+    _updateLocal();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void TetOpSplitP:: _remoteSyncAndUpdate(void* requests, std::vector<KProc*> & applied_diffs, std::vector<int> & directions)
+void TetOpSplitP::_setupDomains()
 {
+    const uint ndomains = pDomains.size();
+    const uint ntets = pTets.size();
 
-    #ifdef MPI_PROFILING
-    double timing_start = MPI_Wtime();
-    #endif
-
-    auto requestsPtr = static_cast<MPI_Request*>(requests);
-
-    uint request_count = 0;
-    for (auto& dest : neighbHosts) {
-        MPI_Isend(remoteChanges[dest].data(), remoteChanges[dest].size(), MPI_UNSIGNED, dest, OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &(requestsPtr[request_count]));
-        request_count ++;
+    // The SSA groups are rebuilt from scratch by _updateLocal().
+    for (auto& kp : pKProcs) {
+        if (kp != nullptr) kp->crData = CRKProcData();
     }
 
-    MPI_Status status;
-    std::set<KProc*> upd_kprocs;
-
-    std::set<int> await_neighbors(neighbHosts);
-
-    #ifdef MPI_PROFILING
-    double timing_end = MPI_Wtime();
-    syncTime += (timing_end - timing_start);
-    #endif
+    // Sub-domain of every hosted tet.
+    std::vector<uint> tet_domain(ntets, 0);
+    bool has_tets = std::any_of(pTets.begin(), pTets.end(),
+                                [](Tet * t) { return t != nullptr && t->getInHost(); });
+    if (ndomains > 1 && has_tets) {
+        auto weights = steps::tetmesh::kprocTetWeights(*pMesh, model());
+        for (uint t = 0; t < ntets; t++) {
+            bool hosted = pTets[t] != nullptr && pTets[t]->getInHost();
+            weights[t] = hosted ? 1.0 + weights[t] : 0.0;
+        }
+        auto partition = steps::tetmesh::partitionMesh(*pMesh, ndomains, steps::tetmesh::PARTITION_GRAPH, weights);
+        tet_domain.swap(partition.tet_hosts);
 
-    while (!await_neighbors.empty()) {
-        #ifdef MPI_PROFILING
-        timing_start = MPI_Wtime();
-        #endif
-        int flag = 0;
-        int data_source = 0;
-        for (auto& neighbor : await_neighbors) {
-            MPI_Iprobe(neighbor, OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, &flag, &status);
-            if (flag) {
-                data_source = neighbor;
-                break;
+        // The partition keeps the tets on both sides of a patch triangle
+        // together. Triangles next to a well-mixed volume, and the tets
+        // connected to them through triangles, go to sub-domain 0 with the
+        // volume; node ntets stands for the well-mixed volumes.
+        std::vector<uint> root(ntets + 1);
+        std::iota(root.begin(), root.end(), 0);
+        auto find = [&root](uint v) {
+            while (root[v] != v) {
+                root[v] = root[root[v]];
+                v = root[v];
+            }
+            return v;
+        };
+        for (auto& tri : pTris) {
+            if (tri == nullptr || !tri->getInHost()) continue;
+            uint sides[2];
+            uint nsides = 0;
+            for (WmVol * v : {tri->iTet(), tri->oTet()}) {
+                if (v == nullptr) continue;
+                uint t = v->idx().get();
+                sides[nsides++] = (t < ntets && pTets[t] == v) ? t : ntets;
             }
+            if (nsides == 2) root[find(sides[0])] = find(sides[1]);
         }
-        #ifdef MPI_PROFILING
-        timing_end = MPI_Wtime();
-        idleTime += (timing_end - timing_start);
-        #endif
-        if (!flag) continue;
+        uint wm_root = find(ntets);
+        for (uint t = 0; t < ntets; t++) {
+            if (find(t) == wm_root) tet_domain[t] = 0;
+        }
+    }
 
-        #ifdef MPI_PROFILING
-        starttime = MPI_Wtime();
-        #endif
-        // receive data
-        int change_size = 0;
-        MPI_Get_count(&status, MPI_UNSIGNED, &change_size);
-        std::vector<uint> changes(change_size);
-        MPI_Recv(changes.data(), change_size, MPI_UNSIGNED, status.MPI_SOURCE, OPSPLIT_MOLECULE_CHANGE, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    for (auto& tet : pTets) {
+        if (tet == nullptr || !tet->getInHost()) continue;
+        uint d = tet_domain[tet->idx().get()];
+        tet->setDomain(d);
+        for (auto& kp : tet->kprocs()) kp->setDomain(d);
+    }
+    for (auto& wmv : pWmVols) {
+        if (wmv == nullptr || !wmv->getInHost()) continue;
+        wmv->setDomain(0);
+        for (auto& kp : wmv->kprocs()) kp->setDomain(0);
+    }
+    for (auto& tri : pTris) {
+        if (tri == nullptr || !tri->getInHost()) continue;
+        WmVol * v = tri->iTet() != nullptr ? tri->iTet() : tri->oTet();
+        uint d = v != nullptr ? v->getDomain() : 0;
+        tri->setDomain(d);
+        for (auto& kp : tri->kprocs()) kp->setDomain(d);
+    }
 
+    // Pools changed by another sub-domain now need their dependent kprocs.
+    for (auto& tet : pTets) {
+        if (tet != nullptr && tet->getInHost()) tet->setupSpecUpdKProcs();
+    }
+    for (auto& tri : pTris) {
+        if (tri != nullptr && tri->getInHost()) tri->setupSpecUpdKProcs();
+    }
 
-        // apply changes
-        uint nchanges = change_size / 4;
-        for (uint c = 0; c < nchanges; c++) {
-            uint type = changes[c * 4];
-            uint idx = changes[c * 4 + 1];
-            uint slidx = changes[c * 4 + 2];
-            uint value = changes[c * 4 + 3];
+    orderDomainDiffs(pDiffs, diffSep);
+    orderDomainDiffs(pSDiffs, sdiffSep);
 
+    uint diff_begin = 0;
+    uint sdiff_begin = 0;
+    for (uint d = 0; d < ndomains; d++) {
+        SubDomain & dom = *pDomains[d];
+        dom.index = d;
+        dom.clearGroups();
 
-            if (type == SUB_WM) {
-                pWmVols[idx]->incCount(slidx, value);
-            }
-            if (type == SUB_TET) {
-                pTets[idx]->incCount(slidx, value);
-                std::vector<KProc*> const & remote_upd = pTets[idx]->getSpecUpdKProcs(slidx);
-                upd_kprocs.insert(remote_upd.begin(), remote_upd.end());
-            }
-            if (type == SUB_TRI) {
-                pTris[idx]->incCount(slidx, value);
-                std::vector<KProc*> const & remote_upd = pTris[idx]->getSpecUpdKProcs(slidx);
-                upd_kprocs.insert(remote_upd.begin(), remote_upd.end());
-            }
+        domainDiffRange(pDiffs, diffSep, d, diff_begin, dom.diffBoundary, dom.diffEnd);
+        dom.diffBegin = diff_begin;
+        diff_begin = dom.diffEnd;
+        domainDiffRange(pSDiffs, sdiffSep, d, sdiff_begin, dom.sdiffBoundary, dom.sdiffEnd);
+        dom.sdiffBegin = sdiff_begin;
+        sdiff_begin = dom.sdiffEnd;
+
+        // A single sub-domain draws from the solver RNG, as without threads.
+        if (ndomains == 1) {
+            dom.rng = rng();
+        }
+        else {
+            dom.rng = steps::rng::create_mt19937(512);
+            dom.rng->initialize(rng()->get());
         }
 
-        await_neighbors.erase(data_source);
-        #ifdef MPI_PROFILING
-        timing_end = MPI_Wtime();
-        syncTime += (timing_end - timing_start);
-        #endif
+        dom.changes.assign(ndomains, std::vector<DomainChange>());
+        if (ndomains > 1) dom.sendBuffers = pSendBuffers;
+        else dom.sendBuffers.clear();
     }
+    pA0 = 0.0;
+}
 
-    #ifdef MPI_PROFILING
-    timing_start = MPI_Wtime();
-    #endif
-
+////////////////////////////////////////////////////////////////////////////////
 
-    auto napply = applied_diffs.size();
+void TetOpSplitP::_applyDomainUpdates(SubDomain & dom)
+{
+    // Local consequences of diffusion; kprocs of other sub-domains are
+    // updated by their owners, through the changes below.
+    auto napply = dom.appliedDiffs.size();
     for (uint i = 0; i < napply; i++) {
-        KProc* kp = applied_diffs[i];
-        int direction = directions[i];
+        KProc* kp = dom.appliedDiffs[i];
+        int direction = dom.appliedDirections[i];
 
         std::vector<KProc*> const & local_upd = kp->getLocalUpdVec(direction);
 
         for (auto & upd_kp : local_upd) {
-            _updateElement(upd_kp);
+            if (upd_kp->getDomain() == dom.index) _updateElement(upd_kp);
         }
     }
 
-    // update kprocs caused by remote molecule changes
-    for (auto & upd_kp : upd_kprocs) {
-        _updateElement(upd_kp);
+    // Molecules moved into the sub-domain by the others, in a fixed order.
+    dom.updKProcs.clear();
+    for (auto& src : pDomains) {
+        auto & changes = src->changes[dom.index];
+        for (auto const& c : changes) {
+            if (c.type == SUB_TET) {
+                pTets[c.idx]->incCount(c.lidx, c.count);
+                std::vector<KProc*> const & upd = pTets[c.idx]->getSpecUpdKProcs(c.lidx);
+                dom.updKProcs.insert(upd.begin(), upd.end());
+            }
+            else {
+                pTris[c.idx]->incCount(c.lidx, c.count);
+                std::vector<KProc*> const & upd = pTris[c.idx]->getSpecUpdKProcs(c.lidx);
+                dom.updKProcs.insert(upd.begin(), upd.end());
+            }
+        }
+        changes.clear();
     }
-    _updateSum();
 
-    #ifdef MPI_PROFILING
-    timing_end = MPI_Wtime();
-    compTime += (timing_end - timing_start);
-    #endif
+    for (auto & kp : dom.updKProcs) {
+        _updateElement(kp);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::registerDomainChange(uint domain, uint type, uint idx, uint lidx, uint change)
+{
+    AssertLog(tActiveDomain >= 0);
+    pDomains[tActiveDomain]->changes[domain].push_back({type, idx, lidx, change});
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void TetOpSplitP::repartitionAndReset(std::vector<uint> const &tet_hosts, std::map<uint, uint> const &tri_hosts,  std::vector<uint> const &wm_hosts)
 {
+    _repartition(tet_hosts, std::map<triangle_id_t, uint>(tri_hosts.begin(), tri_hosts.end()), wm_hosts);
+    reset();
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_repartition(std::vector<uint> const & tet_hosts,
+                               std::map<triangle_id_t, uint> const & tri_hosts,
+                               std::vector<uint> const & wm_hosts)
+{
+    _completeRemoteSends();
+    _freeRemoteBuffers();
+
     pKProcs.clear();
     pDiffs.clear();
     pSDiffs.clear();
@@ -8168,19 +9891,9 @@ void TetOpSplitP::repartitionAndReset(std::vector<uint> const &tet_hosts, std::m
     boundaryTets.clear();
     boundaryTris.clear();
 
-    auto ngroups = nGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(nGroups[i]->indices);
-        delete nGroups[i];
-    }
-    nGroups.clear();
-
-    ngroups = pGroups.size();
-    for (uint i = 0; i < ngroups; i++) {
-        free(pGroups[i]->indices);
-        delete pGroups[i];
+    for (auto& dom : pDomains) {
+        dom->clearGroups();
     }
-    pGroups.clear();
 
     tetHosts.assign(tet_hosts.begin(), tet_hosts.end());
     triHosts.clear();
@@ -8217,12 +9930,6 @@ void TetOpSplitP::repartitionAndReset(std::vector<uint> const &tet_hosts, std::m
     for (auto& t: pTris)
     if (t && t->getInHost()) t->setupDeps();
 
-    for (auto& tet : boundaryTets) {
-        tet->setupBufferLocations();
-    }
-    for (auto& tri : boundaryTris) {
-        tri->setupBufferLocations();
-    }
 
     if (efflag()) {
         std::ostringstream os;
@@ -8233,16 +9940,344 @@ void TetOpSplitP::repartitionAndReset(std::vector<uint> const &tet_hosts, std::m
     neighbHosts.erase(myRank);
     nNeighbHosts = neighbHosts.size();
 
-    // construct remote molecule change buffers
-    remoteChanges.clear();
-    for (auto neighbor : neighbHosts) {
-        remoteChanges[neighbor] = {};
-    }
-
     nEntries = pKProcs.size();
     diffSep=pDiffs.size();
     sdiffSep=pSDiffs.size();
-    reset();
+
+    _setupRemoteBuffers();
+    _setupDomains();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::setRebalancing(double period, double threshold)
+{
+    if (period < 0.0) {
+        ArgErrLog("Rebalancing period must be non-negative.");
+    }
+    if (threshold < 1.0) {
+        ArgErrLog("Rebalancing threshold must be at least 1.");
+    }
+    if (period > 0.0 && efflag()) {
+        NotImplErrLog("Dynamic rebalancing with EField is not implemented.");
+    }
+
+    pRebalancePeriod = period;
+    pRebalanceThreshold = threshold;
+    pNextRebalance = statedef().time() + period;
+
+    // Loads are measured from now on.
+    pRebalanceEvents = _tetEventCounts();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint TetOpSplitP::rebalance(double threshold)
+{
+    if (efflag()) {
+        NotImplErrLog("Dynamic rebalancing with EField is not implemented.");
+    }
+
+    // Load of a tet: one unit for being simulated at all, plus one per
+    // reaction or diffusion event since the last measurement.
+    auto ntets = pTets.size();
+    auto events = _tetEventCounts();
+    if (pRebalanceEvents.size() != ntets) {
+        pRebalanceEvents.assign(ntets, 0);
+    }
+
+    std::vector<double> local_loads(ntets, 0.0);
+    for (uint t = 0; t < ntets; ++t) {
+        if (pTets[t] == nullptr || !pTets[t]->getInHost()) continue;
+        // Extents reset by the user since the last measurement restart from 0.
+        auto since = events[t] >= pRebalanceEvents[t] ? events[t] - pRebalanceEvents[t] : events[t];
+        local_loads[t] = 1.0 + static_cast<double>(since);
+    }
+    pRebalanceEvents.swap(events);
+
+    std::vector<double> tet_loads(ntets, 0.0);
+    MPI_Allreduce(local_loads.data(), tet_loads.data(), static_cast<int>(ntets), MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+    // Tets outside of any compartment have no host.
+    std::vector<double> host_loads(nHosts, 0.0);
+    for (uint t = 0; t < ntets; ++t) {
+        if (tetHosts[t] == UINT_MAX) continue;
+        host_loads[tetHosts[t]] += tet_loads[t];
+    }
+    double total = std::accumulate(host_loads.begin(), host_loads.end(), 0.0);
+    double maxload = 0.0;
+    for (auto l : host_loads) maxload = std::max(maxload, l);
+    pLoadImbalance = total > 0.0 ? maxload * nHosts / total : 1.0;
+
+    if (pLoadImbalance <= threshold) {
+        return 0;
+    }
+
+    // Every process computes the same new tables from the same loads.
+    std::vector<uint> tet_hosts(tetHosts);
+    _diffuseTetHosts(tet_loads, tet_hosts);
+
+    uint nmoved = 0;
+    for (uint t = 0; t < ntets; ++t) {
+        if (tet_hosts[t] != tetHosts[t]) ++nmoved;
+    }
+    if (nmoved == 0) {
+        return 0;
+    }
+
+    // Patch tris follow their inner tet, which is always in a compartment.
+    std::map<triangle_id_t, uint> tri_hosts;
+    for (auto const& host : triHosts) {
+        tri_hosts[host.first] = tet_hosts[pTris[host.first.get()]->tet(0).get()];
+    }
+
+    _migrate(tet_hosts, tri_hosts);
+    pRebalanceEvents = _tetEventCounts();
+    return nmoved;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<unsigned long long> TetOpSplitP::_tetEventCounts()
+{
+    std::vector<unsigned long long> events(pTets.size(), 0);
+    for (auto const& tet : pTets) {
+        if (tet == nullptr || !tet->getInHost()) continue;
+        auto& n = events[tet->idx().get()];
+        for (auto const& kp : tet->kprocs()) {
+            n += kp->getExtent();
+        }
+    }
+
+    // Surface kprocs are charged to the inner tet, of the same host.
+    for (auto const& tri : pTris) {
+        if (tri == nullptr || !tri->getInHost()) continue;
+        auto& n = events[tri->tet(0).get()];
+        for (auto const& kp : tri->kprocs()) {
+            n += kp->getExtent();
+        }
+    }
+    return events;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Hosts are left alone once they are within this fraction of the mean load.
+static const double REBALANCE_TOL = 0.02;
+
+// Each pass moves at most one layer of tets across every host boundary.
+static const uint REBALANCE_MAX_PASSES = 64;
+
+void TetOpSplitP::_diffuseTetHosts(std::vector<double> const & tet_loads,
+                                   std::vector<uint> & tet_hosts) const
+{
+    const uint ntets = pTets.size();
+
+    // Tets on both sides of a patch tri have to stay with the tri, and
+    // therefore move together.
+    std::vector<uint> root(ntets);
+    std::iota(root.begin(), root.end(), 0);
+    auto find = [&root](uint v) {
+        while (root[v] != v) {
+            root[v] = root[root[v]];
+            v = root[v];
+        }
+        return v;
+    };
+    for (auto const& tri : pTris) {
+        if (tri == nullptr) continue;
+        const auto* tets = pMesh->_getTriTetNeighb(tri->idx());
+        if (tets[0] == UNKNOWN_TET || tets[1] == UNKNOWN_TET) continue;
+        if (tet_hosts[tets[0].get()] == UINT_MAX || tet_hosts[tets[1].get()] == UINT_MAX) continue;
+        auto r0 = find(tets[0].get());
+        auto r1 = find(tets[1].get());
+        if (r0 != r1) root[std::max(r0, r1)] = std::min(r0, r1);
+    }
+
+    // Tets of each group, contiguous in members. Tets outside of any
+    // compartment have no host and never move.
+    std::vector<uint> members;
+    members.reserve(ntets);
+    for (uint t = 0; t < ntets; ++t) {
+        root[t] = find(t);
+        if (tet_hosts[t] != UINT_MAX) members.push_back(t);
+    }
+    const uint nmembers = members.size();
+    std::stable_sort(members.begin(), members.end(),
+                     [&root](uint a, uint b) { return root[a] < root[b]; });
+    std::vector<uint> group_start;
+    std::vector<double> group_load;
+    for (uint m = 0; m < nmembers; ++m) {
+        if (m == 0 || root[members[m]] != root[members[m - 1]]) {
+            group_start.push_back(m);
+            group_load.push_back(0.0);
+        }
+        group_load.back() += tet_loads[members[m]];
+    }
+    group_start.push_back(nmembers);
+    const uint ngroups = group_load.size();
+
+    std::vector<double> host_loads(nHosts, 0.0);
+    for (auto t : members) {
+        host_loads[tet_hosts[t]] += tet_loads[t];
+    }
+    double limit = (1.0 + REBALANCE_TOL) *
+        std::accumulate(host_loads.begin(), host_loads.end(), 0.0) / nHosts;
+
+    struct Move { int score; uint group; uint dest; };
+    std::vector<Move> moves;
+    std::vector<uint> faces(nHosts, 0);
+    std::vector<uint> touched;
+
+    for (uint pass = 0; pass < REBALANCE_MAX_PASSES; ++pass) {
+        moves.clear();
+        for (uint g = 0; g < ngroups; ++g) {
+            uint host = tet_hosts[members[group_start[g]]];
+            if (host_loads[host] <= limit || group_load[g] == 0.0) continue;
+
+            // Faces shared with each host.
+            touched.clear();
+            for (uint m = group_start[g]; m < group_start[g + 1]; ++m) {
+                const auto* neighbs = pMesh->_getTetTetNeighb(members[m]);
+                for (uint i = 0; i < 4; ++i) {
+                    if (neighbs[i] == UNKNOWN_TET || pTets[neighbs[i].get()] == nullptr) continue;
+                    if (tet_hosts[neighbs[i].get()] == UINT_MAX) continue;
+                    if (root[neighbs[i].get()] == root[members[m]]) continue;
+                    uint h = tet_hosts[neighbs[i].get()];
+                    if (faces[h]++ == 0) touched.push_back(h);
+                }
+            }
+
+            // Lightest neighbouring host, preferring the one sharing most faces.
+            int dest = -1;
+            for (auto h : touched) {
+                if (h == host) continue;
+                if (dest < 0 || host_loads[h] < host_loads[dest] ||
+                    (host_loads[h] == host_loads[dest] && faces[h] > faces[dest])) {
+                    dest = h;
+                }
+            }
+            if (dest >= 0) {
+                moves.push_back({static_cast<int>(faces[dest]) - static_cast<int>(faces[host]),
+                                 g, static_cast<uint>(dest)});
+            }
+            for (auto h : touched) faces[h] = 0;
+        }
+        if (moves.empty()) break;
+
+        // Tets sticking out of their host go first.
+        std::stable_sort(moves.begin(), moves.end(),
+                         [](Move const& a, Move const& b) { return a.score > b.score; });
+
+        uint nmoved = 0;
+        for (auto const& mv : moves) {
+            uint host = tet_hosts[members[group_start[mv.group]]];
+            double w = group_load[mv.group];
+            // Only moves that even out the pair are taken, so that no load
+            // goes back and forth; an overloaded destination passes it on in
+            // the next pass.
+            if (host_loads[host] <= limit || host_loads[mv.dest] + w >= host_loads[host]) continue;
+            for (uint m = group_start[mv.group]; m < group_start[mv.group + 1]; ++m) {
+                tet_hosts[members[m]] = mv.dest;
+            }
+            host_loads[host] -= w;
+            host_loads[mv.dest] += w;
+            ++nmoved;
+        }
+        if (nmoved == 0) break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TetOpSplitP::_migrate(std::vector<uint> const & tet_hosts,
+                           std::map<triangle_id_t, uint> const & tri_hosts)
+{
+    // Pack the state of every element hosted here, by new host, in
+    // increasing element index. Well-mixed volumes keep their host.
+    std::vector<std::stringstream> packs(nHosts);
+    for (auto const& tet : pTets) {
+        if (tet == nullptr || !tet->getInHost()) continue;
+        auto& pack = packs[tet_hosts[tet->idx().get()]];
+        tet->checkpoint(pack);
+        for (auto const& kp : tet->kprocs()) kp->checkpoint(pack);
+    }
+    for (auto const& tri : pTris) {
+        if (tri == nullptr || !tri->getInHost()) continue;
+        auto& pack = packs[tri_hosts.at(tri->idx())];
+        tri->checkpoint(pack);
+        for (auto const& kp : tri->kprocs()) kp->checkpoint(pack);
+    }
+    for (auto const& wmv : pWmVols) {
+        if (wmv == nullptr || !wmv->getInHost()) continue;
+        wmv->checkpoint(packs[myRank]);
+        for (auto const& kp : wmv->kprocs()) kp->checkpoint(packs[myRank]);
+    }
+
+    std::vector<int> send_counts(nHosts), send_displs(nHosts);
+    std::vector<int> recv_counts(nHosts), recv_displs(nHosts);
+    std::string send_buf;
+    for (int h = 0; h < nHosts; ++h) {
+        auto data = packs[h].str();
+        if (send_buf.size() + data.size() > static_cast<std::size_t>(INT_MAX)) {
+            ProgErrLog("Migration data exceeds the MPI message size limit.");
+        }
+        send_displs[h] = static_cast<int>(send_buf.size());
+        send_counts[h] = static_cast<int>(data.size());
+        send_buf += data;
+    }
+    std::vector<std::stringstream>().swap(packs);
+
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    std::size_t recv_size = 0;
+    for (int h = 0; h < nHosts; ++h) {
+        recv_displs[h] = static_cast<int>(recv_size);
+        recv_size += recv_counts[h];
+    }
+    std::vector<char> recv_buf(recv_size);
+    MPI_Alltoallv(&send_buf[0], send_counts.data(), send_displs.data(), MPI_CHAR,
+                  recv_buf.data(), recv_counts.data(), recv_displs.data(), MPI_CHAR, MPI_COMM_WORLD);
+    std::string().swap(send_buf);
+
+    std::vector<uint> old_tet_hosts(tetHosts);
+    std::map<triangle_id_t, uint> old_tri_hosts(triHosts);
+    std::vector<uint> wm_hosts(wmHosts);
+    _repartition(tet_hosts, tri_hosts, wm_hosts);
+
+    // Restore from each sender in the order it packed.
+    for (int src = 0; src < nHosts; ++src) {
+        std::stringstream pack(std::string(recv_buf.data() + recv_displs[src], recv_counts[src]));
+        for (auto const& tet : pTets) {
+            if (tet == nullptr || !tet->getInHost()) continue;
+            if (old_tet_hosts[tet->idx().get()] != static_cast<uint>(src)) continue;
+            tet->restore(pack);
+            for (auto const& kp : tet->kprocs()) kp->restore(pack);
+        }
+        for (auto const& tri : pTris) {
+            if (tri == nullptr || !tri->getInHost()) continue;
+            if (old_tri_hosts[tri->idx()] != static_cast<uint>(src)) continue;
+            tri->restore(pack);
+            for (auto const& kp : tri->kprocs()) kp->restore(pack);
+        }
+        if (src == myRank) {
+            for (auto const& wmv : pWmVols) {
+                if (wmv == nullptr || !wmv->getInHost()) continue;
+                wmv->restore(pack);
+                for (auto const& kp : wmv->kprocs()) kp->restore(pack);
+            }
+        }
+        if (!pack || pack.peek() != std::char_traits<char>::eof()) {
+            std::ostringstream os;
+            os << "Inconsistent migration data received from host " << src << ".";
+            ProgErrLog(os.str());
+        }
+    }
+
+    // The CR positions restored above refer to the old groups.
+    for (auto const& kp : pKProcs) {
+        if (kp != nullptr) kp->crData = CRKProcData();
+    }
+    _updateLocal();
     MPI_Barrier(MPI_COMM_WORLD);
 }
 
@@ -44,6 +44,7 @@
 
 // STEPS headers.
 #include "steps/common.h"
+#include "steps/mpi/mpi_compat.hpp"
 #include "steps/solver/api.hpp"
 #include "steps/solver/statedef.hpp"
 #include "steps/geom/tetmesh.hpp"
@@ -56,6 +57,9 @@
 #include "steps/mpi/tetopsplit/diffboundary.hpp"
 #include "steps/mpi/tetopsplit/sdiffboundary.hpp"
 #include "steps/mpi/tetopsplit/crstruct.hpp"
+#include "steps/mpi/tetopsplit/molchange.hpp"
+#include "steps/mpi/tetopsplit/subdomain.hpp"
+#include "steps/util/epoch_dedup.hpp"
 #include "steps/solver/efield/efield.hpp"
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -88,6 +92,21 @@ extern void schedIDXSet_To_Vec(SchedIDXSet const & s, SchedIDXVec & v);
 
 enum SubVolType {SUB_WM, SUB_TET, SUB_TRI};
 
+/// Operations of a batched query, see TetOpSplitP::queueQuery().
+enum BatchQueryOp {
+    QUERY_GET_TET_COUNT,
+    QUERY_SET_TET_COUNT,
+    QUERY_GET_TET_CONC,
+    QUERY_SET_TET_CONC,
+    QUERY_GET_TET_REACK,
+    QUERY_SET_TET_REACK,
+    QUERY_GET_TRI_COUNT,
+    QUERY_SET_TRI_COUNT,
+    QUERY_GET_TRI_SREACK,
+    QUERY_SET_TRI_SREACK,
+    QUERY_GET_TRI_V
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 class TetOpSplitP: public steps::solver::API
@@ -119,8 +138,22 @@ public:
     void advance(double adv) override;
     void step() override;
 
+    /// Collective. Every process writes the elements it hosts and its
+    /// random streams to file_name.<rank>; the first process writes the
+    /// partition and the state shared by all processes to file_name.
     void checkpoint(std::string const & file_name) override;
+
+    /// Collective. Restore a checkpoint written with the same mesh, model
+    /// and geometry, possibly by a different number of processes or with a
+    /// different partition: every process only reads the files of the
+    /// processes that hosted its elements. Random streams are restored
+    /// only if the number of processes and of sub-domains are unchanged.
     void restore(std::string const & file_name) override;
+
+    /// Checkpoint files are always written synchronously, by the
+    /// collective checkpoint(); only async = false is accepted.
+    void setAsyncCheckpoint(bool async) override;
+
     ////////////////////////// ADDED FOR EFIELD ////////////////////////////
 
     void setEfieldDT(double efdt) override;
@@ -373,6 +406,17 @@ public:
     double _getVertIClamp(vertex_id_t tidx) const override;
     void _setVertIClamp(vertex_id_t tidx, double cur) override;
 
+    ////////////////////////////////////////////////////////////////////////
+    // BATCH DATA ACCESS
+    ////////////////////////////////////////////////////////////////////////
+
+    void _getBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                         uint oidx, double *values) const override;
+    void _setBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                         uint oidx, const double *values) override;
+    void _getBatchExtents(BatchQuantity q, const index_t *indices, size_t n,
+                          uint ridx, unsigned long long *extents) const override;
+
     ////////////////////////////////////////////////////////////////////////
     // SOLVER CONTROL:
     //      MEMBRANE AND VOLUME CONDUCTOR
@@ -487,19 +531,26 @@ public:
     // by constructor
     void _setup();
 
+    // on a single process, host every element whose host table is empty
+    void _setupDefaultHosts();
+
     void _runWithoutEField(double endtime);
     void _runWithEField(double endtime);
     //void _build();
     void _refreshEFTrisV();
 
+    /// Set the potentials of n tetrahedrons, triangles or vertices, and
+    /// update the voltage-dependent processes once.
+    void _setBatchVs(BatchQuantity q, const index_t *indices, size_t n, const double *vs);
+
     double _getRate(uint i) const
     { return pKProcs[i]->rate(); }
 
-    steps::mpi::tetopsplit::KProc * _getNext() const;
+    steps::mpi::tetopsplit::KProc * _getNext(SubDomain & dom) const;
 
     //void _reset();
 
-    void _executeStep(steps::mpi::tetopsplit::KProc * kp, double dt, double period = 0.0);
+    void _executeStep(SubDomain & dom, steps::mpi::tetopsplit::KProc * kp, double dt, double period = 0.0);
     void _updateSpec(steps::mpi::tetopsplit::WmVol * tet, uint spec_gidx);
 
     /// Update the kproc's of a triangle, after a species has been changed.
@@ -520,6 +571,9 @@ public:
 
     void _setupEField();
 
+    /// Collect the hosted kprocs whose rates depend on the membrane potential.
+    void _setupVDepKProcs();
+
     inline uint neftets() const noexcept
     { return pEFNTets; }
 
@@ -541,6 +595,9 @@ public:
 
     std::vector<double> getBatchTetConcs(const std::vector<index_t> &tets, std::string const &s) const;
 
+    using API::setBatchTetConcsNP;
+    using API::getBatchTetConcsNP;
+
     void getBatchTetCountsNP(const index_t *indices,
                              size_t input_size,
                              std::string const &s,
@@ -553,6 +610,18 @@ public:
                              double *counts,
                              size_t output_size) const override;
 
+    void getBatchTetCountsNP(const index_t *indices,
+                             size_t input_size,
+                             uint sidx,
+                             double *counts,
+                             size_t output_size) const override;
+
+    void getBatchTriCountsNP(const index_t *indices,
+                             size_t input_size,
+                             uint sidx,
+                             double *counts,
+                             size_t output_size) const override;
+
     void setBatchTetConcsNP(const index_t *indices,
                             size_t ntets,
                             std::string const &s,
@@ -607,6 +676,41 @@ public:
                              double *counts,
                              size_t output_size) const;
 
+    ////////////////////////////////////////////////////////////////////////
+    // Batched queries
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Queue a query on tetrahedron or triangle idx. s names the species
+    /// or the (surface) reaction the operation is about and is ignored by
+    /// QUERY_GET_TRI_V; value is only used by setters.
+    ///
+    /// Queries are checked when queued and only executed by runQueries().
+    /// As all other methods of the solver, the same queries must be queued
+    /// in the same order on every process.
+    ///
+    /// \return Position of the result of the query in runQueries().
+    uint queueQuery(BatchQueryOp op, index_t idx, std::string const & s = "", double value = 0.0);
+
+    /// Number of queued queries.
+    inline uint countQueries() const noexcept
+    { return pQueries.size(); }
+
+    /// Drop all queued queries.
+    inline void clearQueries() noexcept
+    { pQueries.clear(); }
+
+    /// Execute the queued queries in order and clear the queue.
+    ///
+    /// Each query is answered or applied by the process hosting its element
+    /// only; the results are then combined in a single sum reduction over
+    /// the queries, instead of one broadcast per element. Setters yield 0.
+    ///
+    /// \return The result of every query, in queuing order.
+    std::vector<double> runQueries();
+
+    /// NumPy version of runQueries(); output_size must be countQueries().
+    void runQueriesNP(double * results, size_t output_size);
+
     ////////////////////////////////////////////////////////////////////////
     // ROI Data Access
     ////////////////////////////////////////////////////////////////////////
@@ -674,6 +778,36 @@ public:
                      std::map<uint, uint> const &tri_hosts  = {},
                      std::vector<uint> const &wm_hosts = {});
 
+    /// Check the load balance every period seconds of simulated time during
+    /// run(), and migrate tets and patch tris between neighbouring hosts
+    /// when the busiest host carries more than threshold times the mean
+    /// load. A period of 0 disables the check.
+    void setRebalancing(double period, double threshold = 1.1);
+
+    /// Measure the load of every host since the previous measurement and,
+    /// if the imbalance exceeds threshold, migrate boundary tets (with their
+    /// pools, kproc constants and extents) from overloaded hosts to their
+    /// lighter neighbours. Collective; returns the number of migrated tets.
+    uint rebalance(double threshold = 1.1);
+
+    /// Largest over mean host load at the last measurement.
+    double getLoadImbalance() const noexcept
+    { return pLoadImbalance; }
+
+    /// Split the elements of this process into ndomains sub-domains (by
+    /// default one per thread) and simulate them on nthreads OpenMP threads
+    /// in every operator-split iteration. Each sub-domain has its own random
+    /// stream, seeded from the solver RNG, so that results depend on the
+    /// number of processes and sub-domains but not on the number of
+    /// threads. A single sub-domain, the default, reproduces the results of
+    /// the solver without threads. Local to the process.
+    void setNThreads(uint nthreads, uint ndomains = 0);
+
+    uint getNThreads() const noexcept
+    { return pNThreads; }
+    uint getNDomains() const noexcept
+    { return pDomains.size(); }
+
     double getCompTime();
     double getSyncTime();
     double getIdleTime();
@@ -681,6 +815,18 @@ public:
     double getRDTime();
     double getDataExchangeTime();
 
+    /// Bytes, messages and (element, species) records of the molecule
+    /// changes sent to neighbouring hosts by this process, and the size of
+    /// the largest message. Local; reset by reset().
+    unsigned long long getMolChangeBytes() const noexcept
+    { return molChangeBytes; }
+    unsigned long long getMolChangeMessages() const noexcept
+    { return molChangeMessages; }
+    unsigned long long getMolChangeRecords() const noexcept
+    { return molChangeRecords; }
+    unsigned long long getMaxMolChangeBytes() const noexcept
+    { return maxMolChangeBytes; }
+
     // Not currently exposed to Python:
      uint getTetHostRank(uint tidx);
      uint getTriHostRank(uint tidx);
@@ -691,12 +837,13 @@ public:
      void addNeighHost(int host);
      void registerBoundaryTet(steps::mpi::tetopsplit::Tet *tet);
      void registerBoundaryTri(steps::mpi::tetopsplit::Tri *tri);
-     uint registerRemoteMoleculeChange(int svol_host,
-                                       uint loc,
-                                       SubVolType svol_type,
-                                       unsigned long idx,
-                                       uint slidx,
-                                       uint change);
+     void registerRemoteMoleculeChange(int svol_host, uint loc, uint change);
+     void registerDomainChange(uint domain, uint type, uint idx, uint lidx, uint change);
+
+     /// Whether an element of the given sub-domain belongs to another
+     /// sub-domain than the one simulated by the calling thread.
+     bool isForeignDomain(uint domain) const noexcept
+     { return tActiveDomain >= 0 && static_cast<uint>(tActiveDomain) != domain; }
 
 private:
 
@@ -757,17 +904,31 @@ private:
     // separator for non-zero and zero propensity diffusions
     uint                                        sdiffSep{0};
 
+    ////////////////////////////////////////////////////////////////////////
+    // Batched Diffusion Sweep
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Apply the diffusion part of an operator-split iteration to the
+    /// rules diffs[first..last) of sub-domain dom and return the number of
+    /// molecules moved.
+    template <typename DiffT>
+    uint _applyDiffusionSweep(SubDomain & dom, std::vector<DiffT*> const & diffs,
+                              uint first, uint last, double update_period);
+
     ////////////////////////////////////////////////////////////////////////
     // CR SSA Kernel Data and Methods
     ////////////////////////////////////////////////////////////////////////
     uint                                        nEntries;
     double                                      pSum;
     double                                      nSum;
+    // Sum of the total propensities of all sub-domains.
     double                                      pA0{0.0};
 
     std::vector<KProc*>                         pKProcs;
-    std::vector<CRGroup*>                       nGroups;
-    std::vector<CRGroup*>                       pGroups;
+
+    // Scratch collection of the kprocs to update after a pool change,
+    // used by _updateSpec and _remoteSyncAndUpdate.
+    steps::util::epoch_dedup<KProc>             pUpdKProcs;
 
     ////////////////////////////////////////////////////////////////////////////////
 
@@ -777,11 +938,17 @@ private:
     void _updateLocal(std::vector<uint> const & upd_entries);
     void _updateLocal(uint* upd_entries, uint buffer_size);
     void _updateLocal();
-    CRGroup* _getGroup(int pow);
-    void _extendPGroups(uint new_size);
-    void _extendNGroups(uint new_size);
+    CRGroup* _getGroup(SubDomain & dom, int pow);
+    void _extendPGroups(SubDomain & dom, uint new_size);
+    void _extendNGroups(SubDomain & dom, uint new_size);
     void _extendGroup(CRGroup* group, uint size = 1024);
+    /// Set the size and partial sum of a group being restored.
+    void _restoreGroup(CRGroup* group, std::pair<unsigned, double> const & size_sum);
+    /// Recompute the total propensity of every sub-domain and of the process.
     void _updateSum();
+    /// Recompute the total propensity of dom only.
+    void _updateSum(SubDomain & dom);
+    /// Update the rate of kp in the groups of its sub-domain.
     void _updateElement(KProc* kp);
     ////////////////////////////////////////////////////////////////////////
 
@@ -813,6 +980,27 @@ private:
 
     std::vector<steps::mpi::tetopsplit::Tri *>        pEFTris_vec;
 
+    // Voltage-dependent transitions, voltage-dependent surface reactions
+    // and GHK currents of the hosted triangles: the only kprocs whose rates
+    // change when the potential is updated.
+    std::vector<KProc*>                         pVDepKProcs;
+
+    ////////////////////////////////////////////////////////////////////////
+    // Batched queries
+    ////////////////////////////////////////////////////////////////////////
+
+    struct BatchQuery
+    {
+        BatchQueryOp                            op;
+        index_t                                 idx;
+        /// Global and element-local index of the species or reaction.
+        uint                                    gidx;
+        uint                                    lidx;
+        double                                  value;
+    };
+
+    std::vector<BatchQuery>                     pQueries;
+
     std::vector<double>                         EFTrisV;
 
     // Working space for gathering distributed computed triangle currents,
@@ -869,9 +1057,99 @@ private:
     std::set<steps::mpi::tetopsplit::Tet *>     boundaryTets;
     std::set<steps::mpi::tetopsplit::Tri *>     boundaryTris;
 
-    std::map<int, std::vector<uint> >           remoteChanges;
+    ////////////////////////////////////////////////////////////////////////
+    // Diffusion Halo Exchange
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Order diffusion rules boundary first, agree with every neighbour on
+    /// the slots of the mirror elements in molecule change messages, and
+    /// set up the pre-sized, persistent receive buffers of these messages.
+    /// Collective; called whenever the neighbouring hosts change.
+    void _setupRemoteBuffers();
+
+    /// Release the persistent receive requests.
+    void _freeRemoteBuffers();
+
+    /// Wait until the molecule changes of the last iteration are sent.
+    void _completeRemoteSends();
+
+    /// Send the molecule changes of this iteration to all neighbours.
+    void _sendRemoteChanges();
+
+    /// Apply the molecule changes of the neighbours as they arrive, and
+    /// update the affected kprocs.
+    void _remoteSyncAndUpdate();
+
+    // Neighbouring hosts, in the order of the buffers and requests below,
+    // and the position of every host in pNeighbRanks.
+    std::vector<int>                            pNeighbRanks;
+    std::vector<uint>                           pNeighbIndex;
+    // Molecule changes for the mirrors hosted by each neighbour.
+    std::vector<MolChangeBuffer>                pSendBuffers;
+    std::vector<MPI_Request>                    pSendRequests;
+    std::vector<MPI_Request>                    pRecvRequests;
+    std::vector<std::vector<std::uint8_t> >     pRecvBuffers;
+    // Type and index of the element in every slot of the messages from
+    // each neighbour.
+    std::vector<std::vector<uint> >             pRecvSlots;
+    // Kprocs affected by the changes of the neighbours, by index.
+    std::vector<KProc*>                         pRemoteUpdKProcs;
+
+    ////////////////////////////////////////////////////////////////////////
+    // Thread Sub-domains
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Assign the hosted elements and their kprocs to pDomains.size()
+    /// sub-domains, order the diffusion rules by sub-domain (rules that
+    /// may move molecules to another host first within each), and set up
+    /// the per sub-domain buffers and random streams. Empties the SSA
+    /// groups: the caller has to call _updateLocal().
+    void _setupDomains();
 
-    void _remoteSyncAndUpdate(void* requests, std::vector<KProc*> & applied_diffs, std::vector<int> & directions);
+    /// Call f(dom) for every sub-domain, on pNThreads threads. The first
+    /// exception thrown by f is rethrown once all sub-domains are done.
+    template <typename F>
+    void _forEachDomain(F && f);
+
+    /// Apply the changes made by other sub-domains to the elements of dom,
+    /// and update the kprocs of dom affected by diffusion.
+    void _applyDomainUpdates(SubDomain & dom);
+
+    std::vector<std::unique_ptr<SubDomain> >    pDomains;
+    uint                                        pNThreads{1};
+
+    // Index of the sub-domain simulated by the calling thread, -1 if none.
+    static thread_local int                     tActiveDomain;
+
+    ////////////////////////////////////////////////////////////////////////
+    // Dynamic Load Balancing
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Rebuild kprocs, dependencies and communication patterns for the
+    /// given host tables. Leaves the state of the new kprocs to the caller.
+    void _repartition(std::vector<uint> const & tet_hosts,
+                      std::map<triangle_id_t, uint> const & tri_hosts,
+                      std::vector<uint> const & wm_hosts);
+
+    /// Kproc events of every hosted tet (including those of the patch tris
+    /// on its faces) so far; zero for other tets.
+    std::vector<unsigned long long> _tetEventCounts();
+
+    /// Move groups of boundary tets from overloaded hosts to lighter
+    /// neighbouring hosts, given the load of every tet.
+    void _diffuseTetHosts(std::vector<double> const & tet_loads,
+                          std::vector<uint> & tet_hosts) const;
+
+    /// Send the state of every element to its new host and repartition.
+    void _migrate(std::vector<uint> const & tet_hosts,
+                  std::map<triangle_id_t, uint> const & tri_hosts);
+
+    // Kproc events of every hosted tet at the last load measurement.
+    std::vector<unsigned long long>             pRebalanceEvents;
+    double                                      pRebalancePeriod{0.0};
+    double                                      pRebalanceThreshold{1.1};
+    double                                      pNextRebalance{0.0};
+    double                                      pLoadImbalance{1.0};
 
     //void _applyRemoteMoleculeChanges(std::vector<MPI_Request> & requests);
     //void _syncPoolCounts();
@@ -886,6 +1164,11 @@ private:
     double                                      compTime{0.0};
     double                                      syncTime{0.0};
     double                                      idleTime{0.0};
+
+    unsigned long long                          molChangeBytes{0};
+    unsigned long long                          molChangeMessages{0};
+    unsigned long long                          molChangeRecords{0};
+    unsigned long long                          maxMolChangeBytes{0};
     double                                      efieldTime{0.0};
     double                                      rdTime{0.0};
     double                                      dataExchangeTime{0.0};
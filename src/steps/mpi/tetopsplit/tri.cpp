@@ -35,8 +35,6 @@
 #include <sstream>
 #include <vector>
 
-#include <mpi.h>
-
 // STEPS headers.
 #include "steps/common.h"
 #include "steps/error.hpp"
@@ -159,7 +157,7 @@ smtos::Tri::~Tri()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Tri::checkpoint(std::fstream & cp_file)
+void smtos::Tri::checkpoint(std::iostream & cp_file)
 {
     uint nspecs = patchdef()->countSpecs();
     cp_file.write(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
@@ -182,7 +180,7 @@ void smtos::Tri::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Tri::restore(std::fstream & cp_file)
+void smtos::Tri::restore(std::iostream & cp_file)
 {
     uint nspecs = patchdef()->countSpecs();
     cp_file.read(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
@@ -329,7 +327,15 @@ void smtos::Tri::setupDeps()
     for (auto& kp : pKProcs) {
         kp->setupDeps();
     }
-    
+    setupSpecUpdKProcs();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void smtos::Tri::setupSpecUpdKProcs()
+{
+    if (myRank != hostRank) { return;
+}
     bool has_remote_neighbors = false;
     uint nspecs = patchdef()->countSpecs();
     for (uint i = 0; i < 3; ++i)
@@ -338,7 +344,7 @@ void smtos::Tri::setupDeps()
         smtos::Tri * next = nextTri(i);
         if (next == nullptr) { continue;
 }
-        if (next->getHost() != getHost()) {
+        if (next->getHost() != getHost() || next->getDomain() != getDomain()) {
             has_remote_neighbors = true;
             break;
         }
@@ -627,7 +633,7 @@ void smtos::Tri::incCount(uint lidx, int inc, double period, bool local_change)
     AssertLog(lidx < patchdef()->countSpecs());
     
 	// count changed by diffusion
-    if (hostRank != myRank && !local_change)
+    if ((hostRank != myRank || pSol->isForeignDomain(pDomain)) && !local_change)
     {
         if (inc <= 0) {
             std::ostringstream os;
@@ -635,7 +641,12 @@ void smtos::Tri::incCount(uint lidx, int inc, double period, bool local_change)
             os << "Fail because molecule change of receiving end should always be non-negative.\n";
             ProgErrLog(os.str());
         }
-        bufferLocations[lidx] = pSol->registerRemoteMoleculeChange(hostRank, bufferLocations[lidx], SUB_TRI, pIdx.get(), lidx, inc);
+        if (hostRank != myRank) {
+            pSol->registerRemoteMoleculeChange(hostRank, bufferLocations[lidx], inc);
+        }
+        else {
+            pSol->registerDomainChange(pDomain, smtos::SUB_TRI, pIdx.get(), lidx, inc);
+        }
     }
     // local change by reac or diff
     else {
@@ -929,10 +940,11 @@ void smtos::Tri::repartition(smtos::TetOpSplitP * tex, int rank, int host_rank)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::Tri::setupBufferLocations()
+void smtos::Tri::setupBufferLocations(uint base)
 {
     uint nspecs = pPatchdef->countSpecs();
-    bufferLocations.assign(nspecs, std::numeric_limits<uint>::max());
+    bufferLocations.resize(nspecs);
+    for (uint lidx = 0; lidx < nspecs; lidx++) bufferLocations[lidx] = base + lidx;
 }
 
 
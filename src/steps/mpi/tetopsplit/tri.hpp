@@ -93,10 +93,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file);
+    void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    void restore(std::fstream & cp_file);
+    void restore(std::iostream & cp_file);
 
     ////////////////////////////////////////////////////////////////////////
     // SETUP
@@ -185,6 +185,10 @@ public:
     
     // setup dependence for KProcs in this subvolume
     void setupDeps();
+
+    // collect, per species, the kprocs to update after a change of its count
+    // by another host or sub-domain
+    void setupSpecUpdKProcs();
     
     // check if kp_lidx in this vol depends on spec_gidx in WMVol kp_container
     virtual bool KProcDepSpecTet(uint kp_lidx, WmVol* kp_container, uint spec_gidx);
@@ -263,6 +267,9 @@ public:
     bool getInHost();
     void setHost(int host, int rank);
     int getHost() {return hostRank;}
+    /// Sub-domain of the host process the triangle belongs to.
+    inline uint getDomain() const noexcept { return pDomain; }
+    inline void setDomain(uint domain) noexcept { pDomain = domain; }
     void setSolver(steps::mpi::tetopsplit::TetOpSplitP* sol);
     steps::mpi::tetopsplit::TetOpSplitP* solver();
     
@@ -275,7 +282,9 @@ public:
     std::vector<smtos::KProc*> const & getSpecUpdKProcs(uint slidx);
     
     void repartition(smtos::TetOpSplitP * tex, int rank, int host_rank);
-    void setupBufferLocations();
+    /// Store the changes of species lidx of this mirror at location
+    /// base + lidx of the solver buffer for its host.
+    void setupBufferLocations(uint base);
 private:
 
     ////////////////////////////////////////////////////////////////////////
@@ -344,6 +353,7 @@ private:
     ///////////////MPI STUFFS
     int                                     hostRank;
     int                                     myRank;
+    uint                                    pDomain{0};
     steps::mpi::tetopsplit::TetOpSplitP   * pSol;
     
 	// there is no need for sync tri, because no kproc in other surface or volume depends on molecule changes
@@ -64,7 +64,7 @@ smtos::VDepTrans::VDepTrans(ssolver::VDepTransdef * vdtdef, smtos::Tri * tri)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::VDepTrans::checkpoint(std::fstream & cp_file)
+void smtos::VDepTrans::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -77,7 +77,7 @@ void smtos::VDepTrans::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::VDepTrans::restore(std::fstream & cp_file)
+void smtos::VDepTrans::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -105,7 +105,7 @@ void smtos::VDepTrans::reset()
 void smtos::VDepTrans::setupDeps()
 {
     AssertLog(pTri->getInHost());
-    std::set<smtos::KProc*> updset;
+    smtos::KProcPSet updset;
 
     auto nkprocs = pTri->countKProcs();
 
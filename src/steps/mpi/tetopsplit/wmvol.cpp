@@ -32,8 +32,6 @@
 #include <functional>
 #include <iostream>
 
-#include <mpi.h>
-
 // STEPS headers.
 #include "steps/common.h"
 #include "steps/error.hpp"
@@ -97,7 +95,7 @@ smtos::WmVol::~WmVol()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::WmVol::checkpoint(std::fstream & cp_file)
+void smtos::WmVol::checkpoint(std::iostream & cp_file)
 {
     uint nspecs = compdef()->countSpecs();
     cp_file.write(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
@@ -106,7 +104,7 @@ void smtos::WmVol::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void smtos::WmVol::restore(std::fstream & cp_file)
+void smtos::WmVol::restore(std::iostream & cp_file)
 {
     uint nspecs = compdef()->countSpecs();
     cp_file.read(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
@@ -94,10 +94,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    virtual void checkpoint(std::fstream & cp_file);
+    virtual void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    virtual void restore(std::fstream & cp_file);
+    virtual void restore(std::iostream & cp_file);
 
     ////////////////////////////////////////////////////////////////////////
     // SETUP
@@ -191,6 +191,9 @@ public:
     bool getInHost() const;
     inline int getHost() const { return hostRank; }
     void setHost(int host, int rank);
+    /// Sub-domain of the host process the subvolume belongs to.
+    inline uint getDomain() const noexcept { return pDomain; }
+    inline void setDomain(uint domain) noexcept { pDomain = domain; }
     //void addSyncHost(int host);
     void setSolver(steps::mpi::tetopsplit::TetOpSplitP* solver);
     steps::mpi::tetopsplit::TetOpSplitP* solver() const;
@@ -239,6 +242,7 @@ protected:
     ///////// MPI STUFFS ////////////////////////////////////////////////////
     int                                 myRank;
     int                                 hostRank;
+    uint                                pDomain{0};
     steps::mpi::tetopsplit::TetOpSplitP         * pSol;
     
 };
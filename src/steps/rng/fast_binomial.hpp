@@ -0,0 +1,235 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_RNG_FAST_BINOMIAL_HPP
+#define STEPS_RNG_FAST_BINOMIAL_HPP
+
+#include <algorithm>
+#include <cmath>
+
+namespace steps {
+namespace rng {
+
+// Produces random non-negative integer values distributed according to the
+// binomial probability distribution, for any number of trials t.
+//
+// Uses inversion by sequential search when the mean of the distribution is
+// small and the BTPE algorithm (Kachitvichyanukul & Schmeiser, 1988)
+// otherwise. Unlike std::binomial_distribution, all the set up is done with
+// elementary functions in the constructor and a draw consumes two uniforms
+// per (rarely repeated) acceptance step, so that the distribution is cheap
+// to construct for every draw.
+// \param t Number of trials
+// \param p Probability of single trial
+template <class IntType = int>
+class fast_binomial_distribution {
+public:
+    typedef IntType result_type;
+
+    explicit fast_binomial_distribution(IntType t = 1, double p = 0.5)
+    : t_(t), p_(p)
+    {
+        // Work with r = min(p, 1 - p) and mirror the result if needed.
+        flip_ = p_ > 0.5;
+        r_ = flip_ ? 1.0 - p_ : p_;
+        q_ = 1.0 - r_;
+        const double n = static_cast<double>(t_);
+        np_ = n * r_;
+
+        if (t_ == 0 || r_ <= 0.0) {
+            mode_ = TRIVIAL;
+        }
+        else if (np_ <= 30.0) {
+            mode_ = INVERSION;
+            qn_ = std::exp(n * std::log(q_));
+            bound_ = std::min(n, np_ + 10.0 * std::sqrt(np_ * q_ + 1.0));
+        }
+        else {
+            mode_ = BTPE;
+            fm_ = np_ + r_;
+            m_ = std::floor(fm_);
+            p1_ = std::floor(2.195 * std::sqrt(np_ * q_) - 4.6 * q_) + 0.5;
+            xm_ = m_ + 0.5;
+            xl_ = xm_ - p1_;
+            xr_ = xm_ + p1_;
+            c_ = 0.134 + 20.5 / (15.3 + m_);
+            double a = (fm_ - xl_) / (fm_ - xl_ * r_);
+            laml_ = a * (1.0 + a / 2.0);
+            a = (xr_ - fm_) / (xr_ * q_);
+            lamr_ = a * (1.0 + a / 2.0);
+            p2_ = p1_ * (1.0 + 2.0 * c_);
+            p3_ = p2_ + c_ / laml_;
+            p4_ = p3_ + c_ / lamr_;
+        }
+    }
+
+    template< class Generator >
+    result_type operator()( Generator& g ) {
+        double y = 0.0;
+        switch (mode_) {
+            case TRIVIAL:   y = 0.0; break;
+            case INVERSION: y = inversion(g); break;
+            case BTPE:      y = btpe(g); break;
+        }
+        result_type x = static_cast<result_type>(y);
+        return flip_ ? t_ - x : x;
+    }
+
+    double p() const { return p_;};
+    result_type t() const {return t_;};
+    void reset() {};
+
+    result_type min() const {return 0;};
+    result_type max() const {return t_;};
+
+private:
+    enum Mode { TRIVIAL, INVERSION, BTPE };
+
+    // Uniform on [0,1).
+    template< class Generator >
+    static double unf( Generator& g ) {
+        // limits are inclusive, we add 1 to the right one so that the result is < 1
+        const double s(static_cast<double>(g.max()) - static_cast<double>(g.min()) + 1.0);
+        return static_cast<double>(g() - g.min()) / s;
+    }
+
+    template< class Generator >
+    double inversion( Generator& g ) const {
+        double x = 0.0;
+        double px = qn_;
+        double u = unf(g);
+        while (u > px) {
+            x += 1.0;
+            if (x > bound_) {
+                // Numerical tail: restart.
+                x = 0.0;
+                px = qn_;
+                u = unf(g);
+            }
+            else {
+                u -= px;
+                px = ((static_cast<double>(t_) - x + 1.0) * r_ * px) / (x * q_);
+            }
+        }
+        return x;
+    }
+
+    template< class Generator >
+    double btpe( Generator& g ) const {
+        const double n = static_cast<double>(t_);
+        const double nrq = np_ * q_;
+        while (true) {
+            const double u = unf(g) * p4_;
+            double v = unf(g);
+            double y;
+
+            if (u <= p1_) {
+                // Triangular region: always accepted.
+                return std::floor(xm_ - p1_ * v + u);
+            }
+            if (u <= p2_) {
+                // Parallelograms.
+                const double x = xl_ + (u - p1_) / c_;
+                v = v * c_ + 1.0 - std::fabs(m_ - x + 0.5) / p1_;
+                if (v > 1.0) continue;
+                y = std::floor(x);
+            }
+            else if (u <= p3_) {
+                // Left exponential tail.
+                if (v == 0.0) continue;
+                y = std::floor(xl_ + std::log(v) / laml_);
+                if (y < 0.0) continue;
+                v = v * (u - p2_) * laml_;
+            }
+            else {
+                // Right exponential tail.
+                if (v == 0.0) continue;
+                y = std::floor(xr_ - std::log(v) / lamr_);
+                if (y > n) continue;
+                v = v * (u - p3_) * lamr_;
+            }
+
+            const double k = std::fabs(y - m_);
+            if (k <= 20.0 || k >= nrq / 2.0 - 1.0) {
+                // Explicit evaluation of f(y) / f(m).
+                const double s = r_ / q_;
+                const double a = s * (n + 1.0);
+                double f = 1.0;
+                if (m_ < y) {
+                    for (double i = m_ + 1.0; i <= y; i += 1.0) f *= (a / i - s);
+                }
+                else if (m_ > y) {
+                    for (double i = y + 1.0; i <= m_; i += 1.0) f /= (a / i - s);
+                }
+                if (v > f) continue;
+                return y;
+            }
+
+            // Squeeze using upper and lower bounds on log(f(y)).
+            const double rho = (k / nrq) * ((k * (k / 3.0 + 0.625) + 0.16666666666666666) / nrq + 0.5);
+            const double t = -k * k / (2.0 * nrq);
+            const double A = std::log(v);
+            if (A < t - rho) return y;
+            if (A > t + rho) continue;
+
+            // Final acceptance/rejection test, Stirling based.
+            const double x1 = y + 1.0;
+            const double f1 = m_ + 1.0;
+            const double z = n + 1.0 - m_;
+            const double w = n - y + 1.0;
+            if (A > (xm_ * std::log(f1 / x1) + (n - m_ + 0.5) * std::log(z / w) +
+                     (y - m_) * std::log(w * r_ / (x1 * q_)) +
+                     stirling_(f1) + stirling_(z) + stirling_(x1) + stirling_(w))) {
+                continue;
+            }
+            return y;
+        }
+    }
+
+    static double stirling_(double x) {
+        const double x2 = x * x;
+        return (13680. - (462. - (132. - (99. - 140. / x2) / x2) / x2) / x2) / x / 166320.;
+    }
+
+    IntType t_;
+    double p_;
+
+    Mode mode_{TRIVIAL};
+    bool flip_{false};
+    double r_{0.0}, q_{1.0}, np_{0.0};
+
+    // Inversion.
+    double qn_{1.0}, bound_{0.0};
+
+    // BTPE.
+    double fm_{0.0}, m_{0.0}, p1_{0.0}, xm_{0.0}, xl_{0.0}, xr_{0.0}, c_{0.0};
+    double laml_{0.0}, lamr_{0.0}, p2_{0.0}, p3_{0.0}, p4_{0.0};
+};
+
+} // namespace rng
+} // namespace steps
+
+#endif//  STEPS_RNG_FAST_BINOMIAL_HPP
@@ -25,6 +25,7 @@
  */
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <string>
@@ -35,6 +36,9 @@
 #include "steps/rng/mt19937.hpp"
 #include "steps/rng/rng.hpp"
 
+// logging
+#include "easylogging++.h"
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // STEPS library.
@@ -63,49 +67,90 @@ void MT19937::concreteInitialize(ulong seed)
 /// Fills the buffer with random numbers on [0,0xffffffff]-interval.
 void MT19937::concreteFillBuffer()
 {
-    ulong y;
-    static ulong mag01[2] = { 0x0UL, MT_MATRIX_A };
-    // mag01[x] = x * MATRIX_A  for x=0,1
-
-    for (uint *b = rBuffer; b < rEnd; ++b)
+    for (uint *b = rBuffer; b < rEnd; )
     {
         if (pStateInit >= MT_N)
         {
-            // Generate N words at one time
-            int kk;
-
             // If init_genrand() has not been called, a default
             // initial seed is used.
             if (pStateInit == MT_N + 1) { initialize(5489UL);
 }
+            _twist();
+        }
 
-            for (kk = 0; kk < MT_N - MT_M; ++kk)
-            {
-                y = (pState[kk] & MT_UPPER_MASK) | (pState[kk + 1] & MT_LOWER_MASK);
-                pState[kk] = pState[kk + MT_M] ^ (y >> 1) ^ mag01[y & 0x1UL];
-            }
-            for (; kk < MT_N - 1; ++kk)
-            {
-                y = (pState[kk] & MT_UPPER_MASK) | (pState[kk + 1] & MT_LOWER_MASK);
-                pState[kk] = pState[kk + (MT_M - MT_N)] ^
-                    (y >> 1) ^ mag01[y & 0x1UL];
-            }
-            y = (pState[MT_N - 1] & MT_UPPER_MASK) | (pState[0] & MT_LOWER_MASK);
-            pState[MT_N - 1] = pState[MT_M - 1] ^ (y >> 1) ^ mag01[y & 0x1UL];
-
-            pStateInit = 0;
+        // Temper as many words of the state as the buffer takes at once;
+        // the iterations are independent and can be vectorised.
+        uint n = std::min(static_cast<uint>(rEnd - b),
+                          static_cast<uint>(MT_N - pStateInit));
+        unsigned long const * s = pState + pStateInit;
+        #pragma omp simd
+        for (uint i = 0; i < n; ++i)
+        {
+            ulong y = s[i];
+            y ^= (y >> 11);
+            y ^= (y << 7) & 0x9d2c5680UL;
+            y ^= (y << 15) & 0xefc60000UL;
+            y ^= (y >> 18);
+            b[i] = static_cast<uint>(y);
         }
+        b += n;
+        pStateInit += n;
+    }
+}
 
-        y = pState[pStateInit++];
+////////////////////////////////////////////////////////////////////////////////
 
-        // Tempering.
-        y ^= (y >> 11);
-        y ^= (y << 7) & 0x9d2c5680UL;
-        y ^= (y << 15) & 0xefc60000UL;
-        y ^= (y >> 18);
+void MT19937::_twist()
+{
+    // Generate N words at one time. Both loops only read words updated
+    // at least MT_N - MT_M iterations earlier, or not yet updated, so that
+    // they can be vectorised; mag01[y & 1] is computed without a table
+    // lookup.
+    int kk;
+    #pragma omp simd
+    for (kk = 0; kk < MT_N - MT_M; ++kk)
+    {
+        ulong y = (pState[kk] & MT_UPPER_MASK) | (pState[kk + 1] & MT_LOWER_MASK);
+        pState[kk] = pState[kk + MT_M] ^ (y >> 1) ^ ((0UL - (y & 0x1UL)) & MT_MATRIX_A);
+    }
+    #pragma omp simd safelen(MT_N - MT_M)
+    for (kk = MT_N - MT_M; kk < MT_N - 1; ++kk)
+    {
+        ulong y = (pState[kk] & MT_UPPER_MASK) | (pState[kk + 1] & MT_LOWER_MASK);
+        pState[kk] = pState[kk + (MT_M - MT_N)] ^
+            (y >> 1) ^ ((0UL - (y & 0x1UL)) & MT_MATRIX_A);
+    }
+    ulong y = (pState[MT_N - 1] & MT_UPPER_MASK) | (pState[0] & MT_LOWER_MASK);
+    pState[MT_N - 1] = pState[MT_M - 1] ^ (y >> 1) ^ ((0UL - (y & 0x1UL)) & MT_MATRIX_A);
 
-        *b = static_cast<uint>(y);
+    pStateInit = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MT19937::concreteSaveState(std::vector<uint> & state) const
+{
+    // The state words only hold 32 significant bits.
+    for (int k = 0; k < MT_N; ++k) {
+        state.push_back(static_cast<uint>(pState[k]));
+    }
+    state.push_back(static_cast<uint>(pStateInit));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MT19937::concreteRestoreState(uint const * b, uint const * e)
+{
+    if (e - b != MT_N + 1) {
+        std::ostringstream os;
+        os << "Mersenne Twister state has " << (e - b) << " words instead of "
+           << MT_N + 1 << ".";
+        ArgErrLog(os.str());
+    }
+    for (int k = 0; k < MT_N; ++k) {
+        pState[k] = b[k];
     }
+    pStateInit = static_cast<int>(b[MT_N]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
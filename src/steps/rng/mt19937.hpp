@@ -118,8 +118,16 @@ protected:
     ///
     virtual void concreteFillBuffer();
 
+    virtual void concreteSaveState(std::vector<uint> & state) const;
+
+    virtual void concreteRestoreState(uint const * b, uint const * e);
+
 private:
 
+    /// Generate the next MT_N words of the state.
+    ///
+    void _twist();
+
     unsigned long               pState[MT_N];
     int                         pStateInit;
 
@@ -26,6 +26,7 @@
 
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <sstream>
@@ -52,6 +53,70 @@ void ctr_increment(R123::r123_type::ctr_type &ctr) {
     ctr[1] = x >> 32;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Number of Philox blocks computed side by side by philox_lanes_fill().
+constexpr uint philox_lanes = 8;
+
+constexpr uint philox_rounds = R123::r123_type::rounds;
+
+/// Fill out with the philox_lanes blocks of the counters ctr, ctr + 1, ...
+/// and advance ctr past them, as philox_lanes calls to r(ctr, key) and
+/// ctr_increment() would.
+///
+/// The rounds are applied to all the blocks at once, in structure of arrays
+/// layout, so that the compiler can vectorise the 32x32->64 bit products
+/// across blocks.
+void philox_lanes_fill(R123::r123_type::ctr_type &ctr,
+                       R123::r123_type::key_type const &key, uint *out)
+{
+    uint x0[philox_lanes], x1[philox_lanes], x2[philox_lanes], x3[philox_lanes];
+
+    uint64_t base = ctr[0] + (static_cast<uint64_t>(ctr[1]) << 32);
+    for (uint l = 0; l < philox_lanes; ++l) {
+        uint64_t c = base + l;
+        x0[l] = static_cast<uint>(c);
+        x1[l] = static_cast<uint>(c >> 32);
+        x2[l] = ctr[2];
+        x3[l] = ctr[3];
+    }
+
+    uint k0 = key[0];
+    uint k1 = key[1];
+    for (uint round = 0; round < philox_rounds; ++round) {
+        if (round > 0) {
+            k0 += PHILOX_W32_0;
+            k1 += PHILOX_W32_1;
+        }
+        #pragma omp simd
+        for (uint l = 0; l < philox_lanes; ++l) {
+            uint64_t p0 = static_cast<uint64_t>(PHILOX_M4x32_0) * x0[l];
+            uint64_t p1 = static_cast<uint64_t>(PHILOX_M4x32_1) * x2[l];
+            uint y0 = static_cast<uint>(p1 >> 32) ^ x1[l] ^ k0;
+            uint y2 = static_cast<uint>(p0 >> 32) ^ x3[l] ^ k1;
+            x0[l] = y0;
+            x1[l] = static_cast<uint>(p1);
+            x2[l] = y2;
+            x3[l] = static_cast<uint>(p0);
+        }
+    }
+
+    for (uint l = 0; l < philox_lanes; ++l) {
+        out[4 * l] = x0[l];
+        out[4 * l + 1] = x1[l];
+        out[4 * l + 2] = x2[l];
+        out[4 * l + 3] = x3[l];
+    }
+
+    base += philox_lanes;
+    ctr[0] = static_cast<uint>(base);
+    ctr[1] = static_cast<uint>(base >> 32);
+}
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 void R123::concreteInitialize(ulong seed)
 {
@@ -67,8 +132,12 @@ void R123::concreteInitialize(ulong seed)
 /// Fills the buffer with random numbers on [0,0xffffffff]-interval.
 void R123::concreteFillBuffer()
 {
-    uint* b;
-    for (b = rBuffer; b+4 <= rEnd; b+=4) {
+    uint* b = rBuffer;
+    for (; b + 4 * philox_lanes <= rEnd; b += 4 * philox_lanes) {
+        philox_lanes_fill(ctr, key, b);
+    }
+
+    for (; b+4 <= rEnd; b+=4) {
         /// Getting 4 new random numbers
         r123_type::ctr_type rn = r(ctr, key);
         ctr_increment(ctr);
@@ -92,4 +161,26 @@ void R123::concreteFillBuffer()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void R123::concreteSaveState(std::vector<uint> & state) const
+{
+    state.insert(state.end(), key.begin(), key.end());
+    state.insert(state.end(), ctr.begin(), ctr.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void R123::concreteRestoreState(uint const * b, uint const * e)
+{
+    if (static_cast<std::size_t>(e - b) != key.size() + ctr.size()) {
+        std::ostringstream os;
+        os << "Random123 state has " << (e - b) << " words instead of "
+           << key.size() + ctr.size() << ".";
+        ArgErrLog(os.str());
+    }
+    std::copy(b, b + key.size(), key.begin());
+    std::copy(b + key.size(), e, ctr.begin());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // END
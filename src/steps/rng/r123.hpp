@@ -105,6 +105,10 @@ protected:
     ///
     virtual void concreteFillBuffer();
 
+    virtual void concreteSaveState(std::vector<uint> & state) const;
+
+    virtual void concreteRestoreState(uint const * b, uint const * e);
+
 private:
 
     r123_type::key_type key;
@@ -26,6 +26,7 @@
 
 
 // Standard library & STL headers.
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -35,8 +36,10 @@
 // STEPS headers.
 #include "steps/common.h"
 #include "steps/error.hpp"
+#include "steps/math/constants.hpp"
 #include "steps/math/tools.hpp"
 #include "steps/rng/rng.hpp"
+#include "steps/rng/fast_binomial.hpp"
 #include "steps/rng/small_binomial.hpp"
 
 // logging
@@ -83,6 +86,32 @@ void RNG::initialize(ulong const & seed)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void RNG::saveState(std::vector<uint> & state) const
+{
+    // Layout: position in the buffer, the buffer, then the concrete state.
+    state.clear();
+    state.reserve(1 + rSize);
+    state.push_back(static_cast<uint>(rNext - rBuffer));
+    state.insert(state.end(), rBuffer, rBuffer + rSize);
+    concreteSaveState(state);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::restoreState(std::vector<uint> const & state)
+{
+    if (state.size() < 1 + rSize || state[0] > rSize) {
+        ArgErrLog("Random number generator state does not match the buffer size.");
+    }
+    // The concrete state is checked before anything is changed.
+    concreteRestoreState(state.data() + 1 + rSize, state.data() + state.size());
+    std::copy(state.begin() + 1, state.begin() + 1 + rSize, rBuffer);
+    rNext = rBuffer + state[0];
+    pInitialized = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 float RNG::getStdExp()
 {
     static float q[8] =
@@ -90,9 +119,11 @@ float RNG::getStdExp()
         0.6931472, 0.9333737, 0.9888778, 0.9984959,
         0.9998293, 0.9999833, 0.9999986, 0.9999999
     };
-    static long i;
-    static float sexpo, a, u, ustar, umin;
-    static float *q1 = q;
+    // Scratch values are automatic so that generators of different
+    // threads can draw concurrently.
+    long i;
+    float sexpo, a, u, ustar, umin;
+    float *q1 = q;
     a = 0.0;
     u = getUnfEE();
     goto S30;
@@ -505,10 +536,100 @@ uint RNG::getBinom(uint t, double p)
         return d(*this);
     }
 
-    std::binomial_distribution<uint> distribution(t, p);
+    fast_binomial_distribution<uint> distribution(t, p);
     return distribution(*this);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+template <typename T, typename F>
+void RNG::_fill(T * b, T * e, F f)
+{
+    while (b != e)
+    {
+        if (rNext == rEnd) { concreteFillBuffer(); rNext = rBuffer; }
+        std::size_t n = std::min(static_cast<std::size_t>(e - b),
+                                 static_cast<std::size_t>(rEnd - rNext));
+        uint const * w = rNext;
+        #pragma omp simd
+        for (std::size_t i = 0; i < n; ++i) {
+            b[i] = f(w[i]);
+        }
+        b += n;
+        rNext += n;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillUnfII(double * b, double * e)
+{
+    _fill(b, e, [](uint w) { return w * (1.0 / 4294967295.0); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillUnfIE(double * b, double * e)
+{
+    _fill(b, e, [](uint w) { return w * (1.0 / 4294967296.0); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillUnfEE(double * b, double * e)
+{
+    _fill(b, e, [](uint w) {
+        return (static_cast<double>(w) + 0.5) * (1.0 / 4294967296.0);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillExp(double lambda, double * b, double * e)
+{
+    const double mean = 1.0 / lambda;
+    _fill(b, e, [mean](uint w) {
+        return -mean * std::log((static_cast<double>(w) + 0.5) * (1.0 / 4294967296.0));
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillStdNrm(double * b, double * e)
+{
+    // Pairs of uniforms (u, v) give the pair of independent normals
+    // r cos(2 pi v), r sin(2 pi v) with r = sqrt(-2 log u).
+    fillUnfEE(b, e);
+    std::size_t npairs = static_cast<std::size_t>(e - b) / 2;
+    #pragma omp simd
+    for (std::size_t i = 0; i < npairs; ++i) {
+        double r = std::sqrt(-2.0 * std::log(b[2 * i]));
+        double a = 2.0 * smath::PI * b[2 * i + 1];
+        b[2 * i] = r * std::cos(a);
+        b[2 * i + 1] = r * std::sin(a);
+    }
+    if (b + 2 * npairs != e) {
+        double u = getUnfEE();
+        *(e - 1) = std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * smath::PI * *(e - 1));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void RNG::fillBinom(uint t, double p, uint * b, uint * e)
+{
+    uint t_small = 20;
+
+    if (t <= t_small) {
+        small_binomial_distribution<uint> d(t, p);
+        for (; b != e; ++b) *b = d(*this);
+        return;
+    }
+
+    fast_binomial_distribution<uint> distribution(t, p);
+    for (; b != e; ++b) *b = distribution(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 // END
@@ -31,6 +31,7 @@
 
 // STL headers.
 #include <memory>
+#include <vector>
 
 // STEPS headers.
 #include "steps/common.h"
@@ -61,6 +62,21 @@ public:
     /// \param seed Seed for the generator.
     void initialize(ulong const & seed);
 
+    /// Save the state of the generator, including the numbers left in its
+    /// buffer, so that restoreState() makes it draw the same sequence again.
+    ///
+    /// \param state Filled with the state; its previous content is lost.
+    void saveState(std::vector<uint> & state) const;
+
+    /// Restore a state saved by saveState() of a generator of the same type
+    /// and buffer size.
+    ///
+    /// \param state State saved by saveState().
+    ///
+    /// Throws steps::ArgErr, leaving the generator unchanged, if state
+    /// does not fit the generator.
+    void restoreState(std::vector<uint> const & state);
+
     /// Minimax inclusive range for the C++11 compatibility
     static constexpr uint min() { return 0; }
     static constexpr uint max() { return 0xffffffffu; }
@@ -127,6 +143,43 @@ public:
     ///
     uint getBinom(uint t, double p);
 
+    /// Fill [b, e) with uniform random numbers on [0,1] real interval,
+    /// the numbers successive calls to getUnfII() would return.
+    ///
+    void fillUnfII(double * b, double * e);
+
+    /// Fill [b, e) with uniform random numbers on [0,1) real interval,
+    /// the numbers successive calls to getUnfIE() would return.
+    ///
+    void fillUnfIE(double * b, double * e);
+
+    /// Fill [b, e) with uniform random numbers on (0,1) real interval,
+    /// the numbers successive calls to getUnfEE() would return.
+    ///
+    void fillUnfEE(double * b, double * e);
+
+    /// Fill [b, e) with exponentially distributed numbers of rate lambda.
+    ///
+    /// The numbers are obtained by inversion of uniforms, which vectorises,
+    /// rather than by the algorithm of getStdExp(): they have the
+    /// distribution of getExp(lambda) but are not the same numbers.
+    ///
+    void fillExp(double lambda, double * b, double * e);
+
+    /// Fill [b, e) with standard normally distributed numbers.
+    ///
+    /// The numbers are obtained by the Box-Muller transform, which
+    /// vectorises, rather than by the algorithm of getStdNrm(): they have
+    /// the same distribution but are not the same numbers.
+    ///
+    void fillStdNrm(double * b, double * e);
+
+    /// Fill [b, e) with binomially distributed numbers with parameters t
+    /// and p, the numbers successive calls to getBinom(t, p) would return.
+    /// The distribution is only set up once.
+    ///
+    void fillBinom(uint t, double p, uint * b, uint * e);
+
 protected:
 
     uint                      * rBuffer;
@@ -141,8 +194,22 @@ protected:
     ///
     virtual void concreteFillBuffer() = 0;
 
+    /// Append the state of the concrete generator to state.
+    ///
+    virtual void concreteSaveState(std::vector<uint> & state) const = 0;
+
+    /// Restore the state of the concrete generator from the words [b, e)
+    /// appended by concreteSaveState().
+    ///
+    virtual void concreteRestoreState(uint const * b, uint const * e) = 0;
+
 private:
 
+    /// Store f(w) in [b, e) for the next e - b words w of the buffer,
+    /// refilling it as needed.
+    template <typename T, typename F>
+    void _fill(T * b, T * e, F f);
+
     bool                        pInitialized;
 
 };
@@ -42,6 +42,17 @@
 #include "steps/rng/rng.hpp"
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace util {
+
+// Forward declarations
+class CheckpointQueue;
+
+}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
  namespace steps {
@@ -50,6 +61,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 // Forward declarations
+class Recorder;
 class Statedef;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -64,6 +76,9 @@ class Statedef;
 ///////////////////////////////////////////////////////////////////////////////
 class API
 {
+    // The recorder samples through the index based protected accessors.
+    friend class Recorder;
+
 public:
 
     // Constants for describing E-Field solver choices
@@ -72,6 +87,7 @@ public:
         EF_DEFAULT = 1, // must be one for API compatibility
         EF_DV_BDSYS,
         EF_DV_PETSC,
+        EF_DV_CG,
     };
 
     /// Constructor
@@ -108,6 +124,24 @@ public:
     /// restore simulator state from a file
     virtual void restore(std::string const & file_name) = 0;
 
+    /// Set whether checkpoint() writes the file in the background.
+    ///
+    /// In asynchronous mode, checkpoint() returns once the state has been
+    /// copied in memory, and the file is written by a background thread
+    /// while the simulation goes on. At most one file is written at a time:
+    /// the next checkpoint() waits for the previous file if needed.
+    ///
+    /// \param async True to write checkpoint files in the background.
+    virtual void setAsyncCheckpoint(bool async);
+
+    /// Return whether checkpoint() writes the file in the background.
+    bool getAsyncCheckpoint() const;
+
+    /// Wait until the checkpoint file being written in the background,
+    /// if any, is complete. Errors while writing it are raised here, or
+    /// by the next checkpoint() or restore().
+    void waitCheckpoint();
+
     /// Reset the solver.
     virtual void reset() = 0;
 
@@ -174,6 +208,48 @@ public:
     /// Return the number of steps.
     virtual uint getNSteps() const;
 
+    ////////////////////////////////////////////////////////////////////////
+    // SOLVER STATE ACCESS:
+    //      INDICES
+    ////////////////////////////////////////////////////////////////////////
+    // The index based accessors below take global indices resolved once
+    // with these methods, so that recording loops avoid string lookups.
+
+    /// Returns the global index of species s.
+    ///
+    /// \param s Name of the species.
+    uint getSpecIdx(std::string const & s) const;
+
+    /// Returns the global index of compartment c.
+    ///
+    /// \param c Name of the compartment.
+    uint getCompIdx(std::string const & c) const;
+
+    /// Returns the global index of patch p.
+    ///
+    /// \param p Name of the patch.
+    uint getPatchIdx(std::string const & p) const;
+
+    /// Returns the global index of reaction r.
+    ///
+    /// \param r Name of the reaction.
+    uint getReacIdx(std::string const & r) const;
+
+    /// Returns the global index of surface reaction sr.
+    ///
+    /// \param sr Name of the surface reaction.
+    uint getSReacIdx(std::string const & sr) const;
+
+    /// Returns the global index of diffusion rule d.
+    ///
+    /// \param d Name of the diffusion rule.
+    uint getDiffIdx(std::string const & d) const;
+
+    /// Returns the global index of surface diffusion rule sd.
+    ///
+    /// \param sd Name of the surface diffusion rule.
+    uint getSurfDiffIdx(std::string const & sd) const;
+
     ////////////////////////////////////////////////////////////////////////
     // SOLVER CONTROLS:
     //      COMPARTMENT
@@ -200,6 +276,12 @@ public:
     /// \param s Name of the species.
     double getCompCount(std::string const & c, std::string const & s) const;
 
+    /// Returns the number of molecules of species sidx in compartment cidx.
+    ///
+    /// \param cidx Global index of the compartment.
+    /// \param sidx Global index of the species.
+    double getCompCount(uint cidx, uint sidx) const;
+
     /// Sets the number of molecules of species s in compartment c.
     ///
     /// NOTE: in a mesh-based simulation, the total amount is equally divided
@@ -399,6 +481,12 @@ public:
     /// \param s Name of the species.
     double getTetCount(tetrahedron_id_t tidx, std::string const & s) const;
 
+    /// Returns the number of molecules of species sidx in a voxel.
+    ///
+    /// \param tidx Index of the tetrahedron.
+    /// \param sidx Global index of the species.
+    double getTetCount(tetrahedron_id_t tidx, uint sidx) const;
+
     /// Sets the number of molecules of species s in a voxel.
     ///
     /// \param tidx Index of the tetrahedron.
@@ -586,6 +674,12 @@ public:
     /// \param s Name of the species.
     double getPatchCount(std::string const & p, std::string const & s) const;
 
+    /// Returns the number of molecules of species sidx in patch pidx.
+    ///
+    /// \param pidx Global index of the patch.
+    /// \param sidx Global index of the species.
+    double getPatchCount(uint pidx, uint sidx) const;
+
     /// Sets the number of molecules of species s in patch p.
     ///
     /// NOTE: in a mesh-based simulation, the total amount is equally divided
@@ -812,6 +906,12 @@ public:
     /// \param s Name of the species.
     double getTriCount(triangle_id_t tidx, std::string const & s) const;
 
+    /// Returns the number of molecules of species sidx in a triangle.
+    ///
+    /// \param tidx Index of the triangle.
+    /// \param sidx Global index of the species.
+    double getTriCount(triangle_id_t tidx, uint sidx) const;
+
     /// Sets the number of molecules of species s in a triangle.
     ///
     /// \param tidx Index of the triangle.
@@ -1122,6 +1222,158 @@ public:
                                      std::string const &s,
                                      double *counts,
                                      size_t output_size) const;
+
+    /// Get counts of species sidx (global index) of a list of tetrahedrons
+    ///
+    /// The default implementation queries the tetrahedrons one by one.
+    virtual void getBatchTetCountsNP(const index_t *indices,
+                                     size_t input_size,
+                                     uint sidx,
+                                     double *counts,
+                                     size_t output_size) const;
+
+    /// Get counts of species sidx (global index) of a list of triangles
+    ///
+    /// The default implementation queries the triangles one by one.
+    virtual void getBatchTriCountsNP(const index_t *indices,
+                                     size_t input_size,
+                                     uint sidx,
+                                     double *counts,
+                                     size_t output_size) const;
+
+    // The batch accessors below take the global indices of the elements and
+    // of a model object (species, reaction or diffusion rule), and read the
+    // values from or write them to a caller-provided array of the same size
+    // as the index array. Parallel solvers do at most one collective
+    // operation per batch. Flags are given as 0 or 1.
+
+    /// Set counts of species sidx in a list of tetrahedrons.
+    void setBatchTetCountsNP(const index_t *indices, size_t input_size,
+                             uint sidx, const double *counts, size_t output_size);
+
+    /// Get amounts (in mols) of species sidx in a list of tetrahedrons.
+    void getBatchTetAmountsNP(const index_t *indices, size_t input_size,
+                              uint sidx, double *amounts, size_t output_size) const;
+
+    /// Set amounts (in mols) of species sidx in a list of tetrahedrons.
+    void setBatchTetAmountsNP(const index_t *indices, size_t input_size,
+                              uint sidx, const double *amounts, size_t output_size);
+
+    /// Get concentrations (in molar units) of species sidx in a list of
+    /// tetrahedrons.
+    void getBatchTetConcsNP(const index_t *indices, size_t input_size,
+                            uint sidx, double *concs, size_t output_size) const;
+
+    /// Set concentrations (in molar units) of species sidx in a list of
+    /// tetrahedrons.
+    void setBatchTetConcsNP(const index_t *indices, size_t input_size,
+                            uint sidx, const double *concs, size_t output_size);
+
+    /// Get clamped flags of species sidx in a list of tetrahedrons.
+    void getBatchTetClampedNP(const index_t *indices, size_t input_size,
+                              uint sidx, unsigned char *clamped, size_t output_size) const;
+
+    /// Set clamped flags of species sidx in a list of tetrahedrons.
+    void setBatchTetClampedNP(const index_t *indices, size_t input_size,
+                              uint sidx, const unsigned char *clamped, size_t output_size);
+
+    /// Get rate constants of reaction ridx in a list of tetrahedrons.
+    void getBatchTetReacKsNP(const index_t *indices, size_t input_size,
+                             uint ridx, double *kfs, size_t output_size) const;
+
+    /// Set rate constants of reaction ridx in a list of tetrahedrons.
+    void setBatchTetReacKsNP(const index_t *indices, size_t input_size,
+                             uint ridx, const double *kfs, size_t output_size);
+
+    /// Get extents of reaction ridx in a list of tetrahedrons.
+    void getBatchTetReacExtentsNP(const index_t *indices, size_t input_size,
+                                  uint ridx, unsigned long long *extents, size_t output_size) const;
+
+    /// Get diffusion constants of diffusion rule didx in a list of
+    /// tetrahedrons.
+    void getBatchTetDiffDsNP(const index_t *indices, size_t input_size,
+                             uint didx, double *dcsts, size_t output_size) const;
+
+    /// Set diffusion constants of diffusion rule didx in a list of
+    /// tetrahedrons, in all directions.
+    void setBatchTetDiffDsNP(const index_t *indices, size_t input_size,
+                             uint didx, const double *dcsts, size_t output_size);
+
+    /// Get potentials of a list of tetrahedrons.
+    void getBatchTetVsNP(const index_t *indices, size_t input_size,
+                         double *vs, size_t output_size) const;
+
+    /// Set potentials of a list of tetrahedrons.
+    void setBatchTetVsNP(const index_t *indices, size_t input_size,
+                         const double *vs, size_t output_size);
+
+    /// Set counts of species sidx in a list of triangles.
+    void setBatchTriCountsNP(const index_t *indices, size_t input_size,
+                             uint sidx, const double *counts, size_t output_size);
+
+    /// Get amounts (in mols) of species sidx in a list of triangles.
+    void getBatchTriAmountsNP(const index_t *indices, size_t input_size,
+                              uint sidx, double *amounts, size_t output_size) const;
+
+    /// Set amounts (in mols) of species sidx in a list of triangles.
+    void setBatchTriAmountsNP(const index_t *indices, size_t input_size,
+                              uint sidx, const double *amounts, size_t output_size);
+
+    /// Get clamped flags of species sidx in a list of triangles.
+    void getBatchTriClampedNP(const index_t *indices, size_t input_size,
+                              uint sidx, unsigned char *clamped, size_t output_size) const;
+
+    /// Set clamped flags of species sidx in a list of triangles.
+    void setBatchTriClampedNP(const index_t *indices, size_t input_size,
+                              uint sidx, const unsigned char *clamped, size_t output_size);
+
+    /// Get rate constants of surface reaction ridx in a list of triangles.
+    void getBatchTriSReacKsNP(const index_t *indices, size_t input_size,
+                              uint ridx, double *kfs, size_t output_size) const;
+
+    /// Set rate constants of surface reaction ridx in a list of triangles.
+    void setBatchTriSReacKsNP(const index_t *indices, size_t input_size,
+                              uint ridx, const double *kfs, size_t output_size);
+
+    /// Get extents of surface reaction ridx in a list of triangles.
+    void getBatchTriSReacExtentsNP(const index_t *indices, size_t input_size,
+                                   uint ridx, unsigned long long *extents, size_t output_size) const;
+
+    /// Get diffusion constants of surface diffusion rule didx in a list of
+    /// triangles.
+    void getBatchTriSDiffDsNP(const index_t *indices, size_t input_size,
+                              uint didx, double *dcsts, size_t output_size) const;
+
+    /// Set diffusion constants of surface diffusion rule didx in a list of
+    /// triangles, in all directions.
+    void setBatchTriSDiffDsNP(const index_t *indices, size_t input_size,
+                              uint didx, const double *dcsts, size_t output_size);
+
+    /// Get potentials of a list of triangles.
+    void getBatchTriVsNP(const index_t *indices, size_t input_size,
+                         double *vs, size_t output_size) const;
+
+    /// Set potentials of a list of triangles.
+    void setBatchTriVsNP(const index_t *indices, size_t input_size,
+                         const double *vs, size_t output_size);
+
+    /// Get ohmic currents of a list of triangles, summed over all ohmic
+    /// currents of each triangle.
+    void getBatchTriTotalOhmicIsNP(const index_t *indices, size_t input_size,
+                                   double *currents, size_t output_size) const;
+
+    /// Get GHK currents of a list of triangles, summed over all GHK
+    /// currents of each triangle.
+    void getBatchTriTotalGHKIsNP(const index_t *indices, size_t input_size,
+                                 double *currents, size_t output_size) const;
+
+    /// Get potentials of a list of vertices.
+    void getBatchVertVsNP(const index_t *indices, size_t input_size,
+                          double *vs, size_t output_size) const;
+
+    /// Set potentials of a list of vertices.
+    void setBatchVertVsNP(const index_t *indices, size_t input_size,
+                          const double *vs, size_t output_size);
     
 
     ////////////////////////////////////////////////////////////////////////
@@ -1174,6 +1426,37 @@ public:
     
 protected:
 
+    ////////////////////////////////////////////////////////////////////////
+    // BATCH DATA ACCESS
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Element quantities of the batch accessors.
+    enum class BatchQuantity {
+        TET_COUNT, TET_AMOUNT, TET_CONC, TET_CLAMPED, TET_REAC_K, TET_REAC_EXTENT, TET_DIFF_D, TET_V,
+        TRI_COUNT, TRI_AMOUNT, TRI_CLAMPED, TRI_SREAC_K, TRI_SREAC_EXTENT, TRI_SDIFF_D, TRI_V,
+        TRI_OHMIC_I, TRI_GHK_I,
+        VERT_V
+    };
+
+    /// Get quantity q of model object oidx (unused for potentials and
+    /// currents) for n elements. Arguments have been checked.
+    ///
+    /// The default implementation queries the elements one by one.
+    virtual void _getBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                                 uint oidx, double *values) const;
+
+    /// Set quantity q of model object oidx for n elements. Arguments have
+    /// been checked.
+    ///
+    /// The default implementation sets the elements one by one.
+    virtual void _setBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                                 uint oidx, const double *values);
+
+    /// Get extents (TET_REAC_EXTENT or TRI_SREAC_EXTENT) of reaction ridx
+    /// for n elements. Arguments have been checked.
+    virtual void _getBatchExtents(BatchQuantity q, const index_t *indices, size_t n,
+                                  uint ridx, unsigned long long *extents) const;
+
     ////////////////////////////////////////////////////////////////////////
     // SOLVER CONTROL:
     //      COMPARTMENT
@@ -1421,11 +1704,19 @@ public:
     inline steps::solver::Statedef& statedef() noexcept
     { return *pStatedef; }
 
+    /// Return the queue of checkpoint files written in the background.
+    inline steps::util::CheckpointQueue * checkpointQueue() noexcept
+    { return pCheckpointQueue; }
+
 
   ////////////////////////////////////////////////////////////////////////
 
 private:
 
+    /// Check the arguments of a batch accessor of quantity q.
+    void _checkBatch(BatchQuantity q, const index_t *indices, size_t input_size,
+                     uint oidx, size_t output_size) const;
+
     ////////////////////////////////////////////////////////////////////////
 
     steps::model::Model *               pModel;
@@ -1436,6 +1727,8 @@ private:
 
     Statedef *                          pStatedef;
 
+    steps::util::CheckpointQueue *      pCheckpointQueue;
+
     ////////////////////////////////////////////////////////////////////////
 
 };
@@ -28,10 +28,12 @@
 // STL headers.
 #include <sstream>
 #include <string>
+#include <vector>
 
 // STEPS headers.
 #include "steps/common.h"
 #include "steps/error.hpp"
+#include "steps/geom/tetmesh.hpp"
 #include "steps/solver/api.hpp"
 #include "steps/solver/compdef.hpp"
 #include "steps/solver/patchdef.hpp"
@@ -48,6 +50,26 @@ namespace solver {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/// Throw steps::ArgErr with message msg if any of the n values is negative.
+void checkNonNegative(const double * values, size_t n, const char * msg)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (values[i] < 0.0)
+        {
+            std::ostringstream os;
+            os << msg;
+            ArgErrLog(os.str());
+        }
+    }
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
 std::vector<double> API::getBatchTetCounts(const std::vector<index_t> &/* tets */, std::string const & /* s */) const
 {
     NotImplErrLog("");
@@ -84,5 +106,574 @@ void API::getBatchTriCountsNP(const index_t * /* indices */,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void API::getBatchTetCountsNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              double * counts,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_COUNT, indices, input_size, sidx, output_size);
+    _getBatchValues(BatchQuantity::TET_COUNT, indices, input_size, sidx, counts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriCountsNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              double * counts,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_COUNT, indices, input_size, sidx, output_size);
+    _getBatchValues(BatchQuantity::TRI_COUNT, indices, input_size, sidx, counts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTetCountsNP(const index_t * indices,
+                             size_t input_size,
+                             uint sidx,
+                             const double * counts,
+                             size_t output_size)
+{
+    _checkBatch(BatchQuantity::TET_COUNT, indices, input_size, sidx, output_size);
+    checkNonNegative(counts, input_size, "Number of molecules cannot be negative.");
+    _setBatchValues(BatchQuantity::TET_COUNT, indices, input_size, sidx, counts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTetAmountsNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              double * amounts,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_AMOUNT, indices, input_size, sidx, output_size);
+    _getBatchValues(BatchQuantity::TET_AMOUNT, indices, input_size, sidx, amounts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTetAmountsNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              const double * amounts,
+                              size_t output_size)
+{
+    _checkBatch(BatchQuantity::TET_AMOUNT, indices, input_size, sidx, output_size);
+    checkNonNegative(amounts, input_size, "Amount of mols cannot be negative.");
+    _setBatchValues(BatchQuantity::TET_AMOUNT, indices, input_size, sidx, amounts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTetConcsNP(const index_t * indices,
+                            size_t input_size,
+                            uint sidx,
+                            double * concs,
+                            size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_CONC, indices, input_size, sidx, output_size);
+    _getBatchValues(BatchQuantity::TET_CONC, indices, input_size, sidx, concs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTetConcsNP(const index_t * indices,
+                            size_t input_size,
+                            uint sidx,
+                            const double * concs,
+                            size_t output_size)
+{
+    _checkBatch(BatchQuantity::TET_CONC, indices, input_size, sidx, output_size);
+    checkNonNegative(concs, input_size, "Concentration cannot be negative.");
+    _setBatchValues(BatchQuantity::TET_CONC, indices, input_size, sidx, concs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTetClampedNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              unsigned char * clamped,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_CLAMPED, indices, input_size, sidx, output_size);
+    std::vector<double> flags(input_size);
+    _getBatchValues(BatchQuantity::TET_CLAMPED, indices, input_size, sidx, flags.data());
+    for (size_t i = 0; i < input_size; ++i)
+    {
+        clamped[i] = flags[i] != 0.0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTetClampedNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              const unsigned char * clamped,
+                              size_t output_size)
+{
+    _checkBatch(BatchQuantity::TET_CLAMPED, indices, input_size, sidx, output_size);
+    std::vector<double> flags(clamped, clamped + input_size);
+    _setBatchValues(BatchQuantity::TET_CLAMPED, indices, input_size, sidx, flags.data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTetReacKsNP(const index_t * indices,
+                             size_t input_size,
+                             uint ridx,
+                             double * kfs,
+                             size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_REAC_K, indices, input_size, ridx, output_size);
+    _getBatchValues(BatchQuantity::TET_REAC_K, indices, input_size, ridx, kfs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTetReacKsNP(const index_t * indices,
+                             size_t input_size,
+                             uint ridx,
+                             const double * kfs,
+                             size_t output_size)
+{
+    _checkBatch(BatchQuantity::TET_REAC_K, indices, input_size, ridx, output_size);
+    checkNonNegative(kfs, input_size, "Reaction constant cannot be negative.");
+    _setBatchValues(BatchQuantity::TET_REAC_K, indices, input_size, ridx, kfs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTetReacExtentsNP(const index_t * indices,
+                                  size_t input_size,
+                                  uint ridx,
+                                  unsigned long long * extents,
+                                  size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_REAC_EXTENT, indices, input_size, ridx, output_size);
+    _getBatchExtents(BatchQuantity::TET_REAC_EXTENT, indices, input_size, ridx, extents);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTetDiffDsNP(const index_t * indices,
+                             size_t input_size,
+                             uint didx,
+                             double * dcsts,
+                             size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_DIFF_D, indices, input_size, didx, output_size);
+    _getBatchValues(BatchQuantity::TET_DIFF_D, indices, input_size, didx, dcsts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTetDiffDsNP(const index_t * indices,
+                             size_t input_size,
+                             uint didx,
+                             const double * dcsts,
+                             size_t output_size)
+{
+    _checkBatch(BatchQuantity::TET_DIFF_D, indices, input_size, didx, output_size);
+    checkNonNegative(dcsts, input_size, "Diffusion constant cannot be negative.");
+    _setBatchValues(BatchQuantity::TET_DIFF_D, indices, input_size, didx, dcsts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTetVsNP(const index_t * indices,
+                         size_t input_size,
+                         double * vs,
+                         size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TET_V, indices, input_size, 0, output_size);
+    _getBatchValues(BatchQuantity::TET_V, indices, input_size, 0, vs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTetVsNP(const index_t * indices,
+                         size_t input_size,
+                         const double * vs,
+                         size_t output_size)
+{
+    _checkBatch(BatchQuantity::TET_V, indices, input_size, 0, output_size);
+    _setBatchValues(BatchQuantity::TET_V, indices, input_size, 0, vs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTriCountsNP(const index_t * indices,
+                             size_t input_size,
+                             uint sidx,
+                             const double * counts,
+                             size_t output_size)
+{
+    _checkBatch(BatchQuantity::TRI_COUNT, indices, input_size, sidx, output_size);
+    checkNonNegative(counts, input_size, "Number of molecules cannot be negative.");
+    _setBatchValues(BatchQuantity::TRI_COUNT, indices, input_size, sidx, counts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriAmountsNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              double * amounts,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_AMOUNT, indices, input_size, sidx, output_size);
+    _getBatchValues(BatchQuantity::TRI_AMOUNT, indices, input_size, sidx, amounts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTriAmountsNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              const double * amounts,
+                              size_t output_size)
+{
+    _checkBatch(BatchQuantity::TRI_AMOUNT, indices, input_size, sidx, output_size);
+    checkNonNegative(amounts, input_size, "Amount of mols cannot be negative.");
+    _setBatchValues(BatchQuantity::TRI_AMOUNT, indices, input_size, sidx, amounts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriClampedNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              unsigned char * clamped,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_CLAMPED, indices, input_size, sidx, output_size);
+    std::vector<double> flags(input_size);
+    _getBatchValues(BatchQuantity::TRI_CLAMPED, indices, input_size, sidx, flags.data());
+    for (size_t i = 0; i < input_size; ++i)
+    {
+        clamped[i] = flags[i] != 0.0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTriClampedNP(const index_t * indices,
+                              size_t input_size,
+                              uint sidx,
+                              const unsigned char * clamped,
+                              size_t output_size)
+{
+    _checkBatch(BatchQuantity::TRI_CLAMPED, indices, input_size, sidx, output_size);
+    std::vector<double> flags(clamped, clamped + input_size);
+    _setBatchValues(BatchQuantity::TRI_CLAMPED, indices, input_size, sidx, flags.data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriSReacKsNP(const index_t * indices,
+                              size_t input_size,
+                              uint ridx,
+                              double * kfs,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_SREAC_K, indices, input_size, ridx, output_size);
+    _getBatchValues(BatchQuantity::TRI_SREAC_K, indices, input_size, ridx, kfs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTriSReacKsNP(const index_t * indices,
+                              size_t input_size,
+                              uint ridx,
+                              const double * kfs,
+                              size_t output_size)
+{
+    _checkBatch(BatchQuantity::TRI_SREAC_K, indices, input_size, ridx, output_size);
+    checkNonNegative(kfs, input_size, "Reaction constant cannot be negative.");
+    _setBatchValues(BatchQuantity::TRI_SREAC_K, indices, input_size, ridx, kfs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriSReacExtentsNP(const index_t * indices,
+                                   size_t input_size,
+                                   uint ridx,
+                                   unsigned long long * extents,
+                                   size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_SREAC_EXTENT, indices, input_size, ridx, output_size);
+    _getBatchExtents(BatchQuantity::TRI_SREAC_EXTENT, indices, input_size, ridx, extents);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriSDiffDsNP(const index_t * indices,
+                              size_t input_size,
+                              uint didx,
+                              double * dcsts,
+                              size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_SDIFF_D, indices, input_size, didx, output_size);
+    _getBatchValues(BatchQuantity::TRI_SDIFF_D, indices, input_size, didx, dcsts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTriSDiffDsNP(const index_t * indices,
+                              size_t input_size,
+                              uint didx,
+                              const double * dcsts,
+                              size_t output_size)
+{
+    _checkBatch(BatchQuantity::TRI_SDIFF_D, indices, input_size, didx, output_size);
+    checkNonNegative(dcsts, input_size, "Diffusion constant cannot be negative.");
+    _setBatchValues(BatchQuantity::TRI_SDIFF_D, indices, input_size, didx, dcsts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriVsNP(const index_t * indices,
+                         size_t input_size,
+                         double * vs,
+                         size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_V, indices, input_size, 0, output_size);
+    _getBatchValues(BatchQuantity::TRI_V, indices, input_size, 0, vs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchTriVsNP(const index_t * indices,
+                         size_t input_size,
+                         const double * vs,
+                         size_t output_size)
+{
+    _checkBatch(BatchQuantity::TRI_V, indices, input_size, 0, output_size);
+    _setBatchValues(BatchQuantity::TRI_V, indices, input_size, 0, vs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriTotalOhmicIsNP(const index_t * indices,
+                                   size_t input_size,
+                                   double * currents,
+                                   size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_OHMIC_I, indices, input_size, 0, output_size);
+    _getBatchValues(BatchQuantity::TRI_OHMIC_I, indices, input_size, 0, currents);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchTriTotalGHKIsNP(const index_t * indices,
+                                 size_t input_size,
+                                 double * currents,
+                                 size_t output_size) const
+{
+    _checkBatch(BatchQuantity::TRI_GHK_I, indices, input_size, 0, output_size);
+    _getBatchValues(BatchQuantity::TRI_GHK_I, indices, input_size, 0, currents);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::getBatchVertVsNP(const index_t * indices,
+                          size_t input_size,
+                          double * vs,
+                          size_t output_size) const
+{
+    _checkBatch(BatchQuantity::VERT_V, indices, input_size, 0, output_size);
+    _getBatchValues(BatchQuantity::VERT_V, indices, input_size, 0, vs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setBatchVertVsNP(const index_t * indices,
+                          size_t input_size,
+                          const double * vs,
+                          size_t output_size)
+{
+    _checkBatch(BatchQuantity::VERT_V, indices, input_size, 0, output_size);
+    _setBatchValues(BatchQuantity::VERT_V, indices, input_size, 0, vs);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::_checkBatch(BatchQuantity q, const index_t * indices, size_t input_size,
+                      uint oidx, size_t output_size) const
+{
+    auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom());
+    if (mesh == nullptr)
+    {
+        std::ostringstream os;
+        os << "Method not available for this solver.";
+        NotImplErrLog(os.str());
+    }
+
+    if (input_size != output_size)
+    {
+        std::ostringstream os;
+        os << "Error: output array (values) size should be the same as input array (indices) size.\n";
+        ArgErrLog(os.str());
+    }
+
+    index_t nelems;
+    const char * elem;
+    switch (q)
+    {
+        case BatchQuantity::TRI_COUNT:
+        case BatchQuantity::TRI_AMOUNT:
+        case BatchQuantity::TRI_CLAMPED:
+        case BatchQuantity::TRI_SREAC_K:
+        case BatchQuantity::TRI_SREAC_EXTENT:
+        case BatchQuantity::TRI_SDIFF_D:
+        case BatchQuantity::TRI_V:
+        case BatchQuantity::TRI_OHMIC_I:
+        case BatchQuantity::TRI_GHK_I:
+            nelems = mesh->countTris();
+            elem = "Triangle";
+            break;
+        case BatchQuantity::VERT_V:
+            nelems = mesh->countVertices();
+            elem = "Vertex";
+            break;
+        default:
+            nelems = mesh->countTets();
+            elem = "Tetrahedron";
+    }
+    for (size_t i = 0; i < input_size; ++i)
+    {
+        if (indices[i] >= nelems)
+        {
+            std::ostringstream os;
+            os << elem << " index " << indices[i] << " out of range.";
+            ArgErrLog(os.str());
+        }
+    }
+
+    uint nobjs;
+    const char * obj;
+    switch (q)
+    {
+        case BatchQuantity::TET_COUNT:
+        case BatchQuantity::TET_AMOUNT:
+        case BatchQuantity::TET_CONC:
+        case BatchQuantity::TET_CLAMPED:
+        case BatchQuantity::TRI_COUNT:
+        case BatchQuantity::TRI_AMOUNT:
+        case BatchQuantity::TRI_CLAMPED:
+            nobjs = pStatedef->countSpecs();
+            obj = "Species";
+            break;
+        case BatchQuantity::TET_REAC_K:
+        case BatchQuantity::TET_REAC_EXTENT:
+            nobjs = pStatedef->countReacs();
+            obj = "Reaction";
+            break;
+        case BatchQuantity::TRI_SREAC_K:
+        case BatchQuantity::TRI_SREAC_EXTENT:
+            nobjs = pStatedef->countSReacs();
+            obj = "Surface reaction";
+            break;
+        case BatchQuantity::TET_DIFF_D:
+            nobjs = pStatedef->countDiffs();
+            obj = "Diffusion rule";
+            break;
+        case BatchQuantity::TRI_SDIFF_D:
+            nobjs = pStatedef->countSurfDiffs();
+            obj = "Surface diffusion rule";
+            break;
+        default:
+            // Potentials and currents are not about a model object.
+            return;
+    }
+    if (oidx >= nobjs)
+    {
+        std::ostringstream os;
+        os << obj << " index out of range.";
+        ArgErrLog(os.str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::_getBatchValues(BatchQuantity q, const index_t * indices, size_t n,
+                          uint oidx, double * values) const
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        tetrahedron_id_t tet(indices[i]);
+        triangle_id_t tri(indices[i]);
+        switch (q)
+        {
+            case BatchQuantity::TET_COUNT:   values[i] = _getTetCount(tet, oidx); break;
+            case BatchQuantity::TET_AMOUNT:  values[i] = _getTetAmount(tet, oidx); break;
+            case BatchQuantity::TET_CONC:    values[i] = _getTetConc(tet, oidx); break;
+            case BatchQuantity::TET_CLAMPED: values[i] = _getTetClamped(tet, oidx); break;
+            case BatchQuantity::TET_REAC_K:  values[i] = _getTetReacK(tet, oidx); break;
+            case BatchQuantity::TET_DIFF_D:  values[i] = _getTetDiffD(tet, oidx); break;
+            case BatchQuantity::TET_V:       values[i] = _getTetV(tet); break;
+            case BatchQuantity::TRI_COUNT:   values[i] = _getTriCount(tri, oidx); break;
+            case BatchQuantity::TRI_AMOUNT:  values[i] = _getTriAmount(tri, oidx); break;
+            case BatchQuantity::TRI_CLAMPED: values[i] = _getTriClamped(tri, oidx); break;
+            case BatchQuantity::TRI_SREAC_K: values[i] = _getTriSReacK(tri, oidx); break;
+            case BatchQuantity::TRI_SDIFF_D: values[i] = _getTriSDiffD(tri, oidx, UNKNOWN_TRI); break;
+            case BatchQuantity::TRI_V:       values[i] = _getTriV(tri); break;
+            case BatchQuantity::TRI_OHMIC_I: values[i] = _getTriOhmicI(tri); break;
+            case BatchQuantity::TRI_GHK_I:   values[i] = _getTriGHKI(tri); break;
+            case BatchQuantity::VERT_V:      values[i] = _getVertV(vertex_id_t(indices[i])); break;
+            default:
+                // Extents are read by _getBatchExtents().
+                AssertLog(false);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::_setBatchValues(BatchQuantity q, const index_t * indices, size_t n,
+                          uint oidx, const double * values)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        tetrahedron_id_t tet(indices[i]);
+        triangle_id_t tri(indices[i]);
+        switch (q)
+        {
+            case BatchQuantity::TET_COUNT:   _setTetCount(tet, oidx, values[i]); break;
+            case BatchQuantity::TET_AMOUNT:  _setTetAmount(tet, oidx, values[i]); break;
+            case BatchQuantity::TET_CONC:    _setTetConc(tet, oidx, values[i]); break;
+            case BatchQuantity::TET_CLAMPED: _setTetClamped(tet, oidx, values[i] != 0.0); break;
+            case BatchQuantity::TET_REAC_K:  _setTetReacK(tet, oidx, values[i]); break;
+            case BatchQuantity::TET_DIFF_D:  _setTetDiffD(tet, oidx, values[i]); break;
+            case BatchQuantity::TET_V:       _setTetV(tet, values[i]); break;
+            case BatchQuantity::TRI_COUNT:   _setTriCount(tri, oidx, values[i]); break;
+            case BatchQuantity::TRI_AMOUNT:  _setTriAmount(tri, oidx, values[i]); break;
+            case BatchQuantity::TRI_CLAMPED: _setTriClamped(tri, oidx, values[i] != 0.0); break;
+            case BatchQuantity::TRI_SREAC_K: _setTriSReacK(tri, oidx, values[i]); break;
+            case BatchQuantity::TRI_SDIFF_D: _setTriSDiffD(tri, oidx, values[i], UNKNOWN_TRI); break;
+            case BatchQuantity::TRI_V:       _setTriV(tri, values[i]); break;
+            case BatchQuantity::VERT_V:      _setVertV(vertex_id_t(indices[i]), values[i]); break;
+            default:
+                // Read-only quantities have no public setter.
+                AssertLog(false);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::_getBatchExtents(BatchQuantity /* q */, const index_t * /* indices */, size_t /* n */,
+                           uint /* ridx */, unsigned long long * /* extents */) const
+{
+    NotImplErrLog("");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // namespace solver
 } // namespace steps
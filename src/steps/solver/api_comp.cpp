@@ -81,6 +81,20 @@ double API::getCompCount(string const & c, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getCompCount(uint cidx, uint sidx) const
+{
+    if (cidx >= pStatedef->countComps() || sidx >= pStatedef->countSpecs())
+    {
+        std::ostringstream os;
+        os << "Compartment or species index out of range.";
+        ArgErrLog(os.str());
+    }
+
+    return _getCompCount(cidx, sidx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setCompCount(string const & c, string const & s, double n)
 {
     if (n < 0.0)
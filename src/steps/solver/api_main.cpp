@@ -37,6 +37,7 @@
 #include "steps/rng/rng.hpp"
 #include "steps/solver/api.hpp"
 #include "steps/solver/statedef.hpp"
+#include "steps/util/checkpoint.hpp"
 
 // logging
 #include "easylogging++.h"
@@ -52,6 +53,7 @@ API::API(steps::model::Model *m, steps::wm::Geom *g, const rng::RNGptr &r)
 , pGeom(g)
 , pRNG(r)
 , pStatedef(nullptr)
+, pCheckpointQueue(nullptr)
 {
     if (pModel == nullptr)
     {
@@ -104,15 +106,39 @@ API::API(steps::model::Model *m, steps::wm::Geom *g, const rng::RNGptr &r)
     // create state object, which will in turn create compdef, specdef etc
     //objects and initialise
     pStatedef = new Statedef(m, g, r);
+    pCheckpointQueue = new steps::util::CheckpointQueue;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 API::~API()
 {
+    // Waits for the checkpoint file being written, if any.
+    delete pCheckpointQueue;
     delete pStatedef;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+void API::setAsyncCheckpoint(bool async)
+{
+    pCheckpointQueue->setAsync(async);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool API::getAsyncCheckpoint() const
+{
+    return pCheckpointQueue->async();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void API::waitCheckpoint()
+{
+    pCheckpointQueue->wait();
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -200,6 +226,55 @@ uint API::getNSteps() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint API::getSpecIdx(string const & s) const
+{
+    return pStatedef->getSpecIdx(s);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getCompIdx(string const & c) const
+{
+    return pStatedef->getCompIdx(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getPatchIdx(string const & p) const
+{
+    return pStatedef->getPatchIdx(p);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getReacIdx(string const & r) const
+{
+    return pStatedef->getReacIdx(r);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getSReacIdx(string const & sr) const
+{
+    return pStatedef->getSReacIdx(sr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getDiffIdx(string const & d) const
+{
+    return pStatedef->getDiffIdx(d);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint API::getSurfDiffIdx(string const & sd) const
+{
+    return pStatedef->getSurfDiffIdx(sd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setTime(double /*time*/)
 {
     NotImplErrLog("");
@@ -80,6 +80,20 @@ double API::getPatchCount(string const & p, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getPatchCount(uint pidx, uint sidx) const
+{
+    if (pidx >= pStatedef->countPatches() || sidx >= pStatedef->countSpecs())
+    {
+        std::ostringstream os;
+        os << "Patch or species index out of range.";
+        ArgErrLog(os.str());
+    }
+
+    return _getPatchCount(pidx, sidx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setPatchCount(string const & p, string const & s, double n)
 {
     if (n < 0.0)
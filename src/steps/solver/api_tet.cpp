@@ -144,6 +144,35 @@ double API::getTetCount(tetrahedron_id_t tidx, string const & s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getTetCount(tetrahedron_id_t tidx, uint sidx) const
+{
+    if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
+    {
+        if (tidx >= static_cast<index_t>(mesh->countTets()))
+        {
+            std::ostringstream os;
+            os << "Tetrahedron index out of range.";
+            ArgErrLog(os.str());
+        }
+        if (sidx >= pStatedef->countSpecs())
+        {
+            std::ostringstream os;
+            os << "Species index out of range.";
+            ArgErrLog(os.str());
+        }
+
+        return _getTetCount(tidx, sidx);
+    }
+    else
+    {
+        std::ostringstream os;
+        os << "Method not available for this solver.";
+        NotImplErrLog("");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void API::setTetCount(tetrahedron_id_t tidx, string const & s, double n)
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
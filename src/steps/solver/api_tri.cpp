@@ -118,6 +118,36 @@ double API::getTriCount(triangle_id_t tidx, const std::string&  s) const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+double API::getTriCount(triangle_id_t tidx, uint sidx) const
+{
+    if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
+    {
+        if (tidx >= mesh->countTris())
+        {
+            std::ostringstream os;
+            os << "Triangle index out of range.";
+            ArgErrLog(os.str());
+        }
+        if (sidx >= pStatedef->countSpecs())
+        {
+            std::ostringstream os;
+            os << "Species index out of range.";
+            ArgErrLog(os.str());
+        }
+
+        return _getTriCount(tidx, sidx);
+    }
+
+    else
+    {
+        std::ostringstream os;
+        os << "Method not available for this solver.";
+        NotImplErrLog("");
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 bool API::getTriSpecDefined(triangle_id_t tidx, const std::string&  s) const
 {
     if (auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(geom()))
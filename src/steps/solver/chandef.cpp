@@ -80,7 +80,7 @@ ssolver::Chandef::~Chandef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Chandef::checkpoint(std::fstream & cp_file)
+void ssolver::Chandef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pNChanStates), sizeof(uint));
     cp_file.write(reinterpret_cast<char*>(pChanStates), sizeof(uint) * pNChanStates);
@@ -88,7 +88,7 @@ void ssolver::Chandef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Chandef::restore(std::fstream & cp_file)
+void ssolver::Chandef::restore(std::iostream & cp_file)
 {
     if (pNChanStates > 0) { delete[] pChanStates;
 }
@@ -147,7 +147,7 @@ ssolver::Compdef::~Compdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Compdef::checkpoint(std::fstream & cp_file)
+void ssolver::Compdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(pPoolCount), sizeof (double) * pSpecsN);
     cp_file.write(reinterpret_cast<char*>(pPoolFlags), sizeof (uint) * pSpecsN);
@@ -157,7 +157,7 @@ void ssolver::Compdef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Compdef::restore(std::fstream & cp_file)
+void ssolver::Compdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(pPoolCount), sizeof (double) * pSpecsN);
     cp_file.read(reinterpret_cast<char*>(pPoolFlags), sizeof (uint) * pSpecsN);
@@ -295,6 +295,11 @@ void ssolver::Compdef::setup_indices()
                 pReac_UPD_Spec[aridx] = rdef->upd(si);
             }
         }
+
+        pReac_Prog.reserve(pReacsN);
+        for (uint ri = 0; ri < pReacsN; ++ri) {
+            pReac_Prog.emplace_back(reac_lhs_bgn(ri), reac_upd_bgn(ri), pSpecsN);
+        }
     }
 
     if (pDiffsN != 0)
@@ -37,6 +37,7 @@
 #include "steps/common.h"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/api.hpp"
+#include "steps/solver/reacprogram.hpp"
 #include "steps/geom/comp.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -77,10 +78,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file);
+    void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    void restore(std::fstream & cp_file);
+    void restore(std::iostream & cp_file);
 
 
     ////////////////////////////////////////////////////////////////////////
@@ -229,6 +230,13 @@ public:
     /// \param rlidx Local index of the reaction.
     int * reac_upd_end(uint rlidx) const;
 
+    /// Return the compiled (sparse) lhs and update of reaction specified
+    /// by local index argument.
+    ///
+    /// \param rlidx Local index of the reaction.
+    inline const ReacProgram & reac_prog(uint rlidx) const noexcept
+    { return pReac_Prog[rlidx]; }
+
     /// Return the local index of species of reaction specified by
     /// local index argument.
     ///
@@ -393,6 +401,10 @@ private:
     uint                              * pReac_LHS_Spec;
     int                               * pReac_UPD_Spec;
 
+    // Sparse lhs and update of each reaction rule, compiled from the
+    // tables above.
+    std::vector<ReacProgram>            pReac_Prog;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA: DIFFUSION RULES
     ////////////////////////////////////////////////////////////////////////
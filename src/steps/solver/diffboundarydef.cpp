@@ -71,14 +71,14 @@ ssolver::DiffBoundarydef::~DiffBoundarydef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::DiffBoundarydef::checkpoint(std::fstream & /*cp_file*/)
+void ssolver::DiffBoundarydef::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::DiffBoundarydef::restore(std::fstream & /*cp_file*/)
+void ssolver::DiffBoundarydef::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
@@ -81,14 +81,14 @@ ssolver::Diffdef::~Diffdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Diffdef::checkpoint(std::fstream & cp_file)
+void ssolver::Diffdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pDcst), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Diffdef::restore(std::fstream & cp_file)
+void ssolver::Diffdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pDcst), sizeof(double));
 }
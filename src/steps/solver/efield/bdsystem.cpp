@@ -47,6 +47,12 @@ inline void swap_row(double *u,double *v,int n) {
 }
 
 void BDSystem::solve()
+{
+    factor();
+    resolve();
+}
+
+void BDSystem::factor()
 {
     constexpr double TINY = 1.0e-20;
 
@@ -129,13 +135,21 @@ void BDSystem::solve()
         ak += w;
         lk += h;
     }
+}
+
+void BDSystem::resolve()
+{
+    auto n = pN;
+    auto h = pHalfBW;
+    auto w = 2 * h + 1;
+    const double *a = pA.data(); // holds U from LU decomposition
+    const double *l = h > 0? pL.data(): nullptr;
 
     // 2. Forward substitution, b into x.
     std::copy(pb.begin(),pb.end(),px.begin());
     double *x = px.data();
     double *xk = x;
-    lk = l;
-    ak = a;
+    const double *lk = l;
     for (auto k = 0u; k < n; ++k)
     {
         auto i = pp[k];
@@ -153,7 +167,7 @@ void BDSystem::solve()
     }
 
     // 3. Backward substitution on x
-    ak = a+n*w;
+    const double *ak = a+n*w;
     xk = x+n;
   {
     for (auto k = static_cast<int>(n) - 1; k >= 0; --k)
@@ -101,7 +101,13 @@ public:
 
     void solve(); // destructive: overwrites pA
 
+    // Solve for the current b, reusing the LU decomposition computed
+    // by the last call to solve(); pA must not have been modified since.
+    void resolve();
+
 private:
+    void factor(); // LU decomposition of pA in place
+
     size_t pN,pHalfBW;
 
     BDMatrix pA; // will contain U after LU-decomposition
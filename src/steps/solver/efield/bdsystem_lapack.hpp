@@ -97,6 +97,10 @@ public:
 
     void solve(); // destructive: overwrites pA
 
+    // Solve for the current b, reusing the LU decomposition computed
+    // by the last call to solve(); pA must not have been modified since.
+    void resolve();
+
 private:
     size_t pN,pHalfBW;
 
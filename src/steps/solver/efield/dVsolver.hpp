@@ -70,7 +70,11 @@ public:
     bool getClamped(vertex_id_t i) const noexcept override { return pVertexClamp[i.get()]; }
 
     /** Set voltage clamped status for vertex i */
-    void setClamped(vertex_id_t i, bool clamped) noexcept override { pVertexClamp[i.get()] = clamped; }
+    void setClamped(vertex_id_t i, bool clamped) noexcept override {
+        if (static_cast<bool>(pVertexClamp[i.get()]) == clamped) return;
+        pVertexClamp[i.get()] = clamped;
+        pMatrixStale = true;
+    }
 
     /** Get current through triangle i */
     double getTriI(triangle_id_t i) const noexcept override { return -pTriCur[i.get()]; }
@@ -90,6 +94,9 @@ public:
     /** Get additional current injection for area associated with vertex i (pA) */
     double getVertIClamp(vertex_id_t i) const noexcept override { return pVertCurClamp[i.get()]; }
 
+    /** Force matrix reassembly and refactorization on the next advance */
+    void invalidateMatrix() noexcept override { pMatrixStale = true; }
+
 protected:
     /// Generic populate and solve
     template <typename LinSysImpl>
@@ -108,16 +115,21 @@ protected:
         typename LinSysImpl::matrix_type &A=L->A();
         typename LinSysImpl::vector_type &b=L->b();
 
+        // A only depends on capacitances, coupling constants, pGExt, dt
+        // and the clamp set: keep the previous factorization if none of
+        // these has changed.
+        bool refactor = pMatrixStale || dt != pMatrixDT;
+
         double oodt = 1.0/dt;
 
-        A.zero();
+        if (refactor) A.zero();
         for (uint i = 0; i < pNVerts; ++i) {
             VertexElement * ve = pMesh->getVertex(i);
             int ind = ve->getIDX();
 
             if (pVertexClamp[ind]) {
                 b.set(ind,0);
-                A.set(ind,ind,1.0);
+                if (refactor) A.set(ind,ind,1.0);
             }
             else {
                 double rhs = pVertCur[ind] + pGExt[ind] * (pVExt - pV[ind]);
@@ -129,14 +141,21 @@ protected:
 
                     rhs += cc * (pV[k] - pV[ind]);
                     Aii += cc;
-                    A.set(ind,k,-cc);
+                    if (refactor) A.set(ind,k,-cc);
                 }
                 b.set(ind,rhs);
-                A.set(ind,ind,Aii);
+                if (refactor) A.set(ind,ind,Aii);
             }
         }
         
-        L->solve();
+        if (refactor) {
+            L->solve();
+            pMatrixStale = false;
+            pMatrixDT = dt;
+        }
+        else {
+            L->resolve();
+        }
 
         const typename LinSysImpl::vector_type DV=L->x();
         for (uint i = 0; i < pNVerts; ++i)
@@ -181,6 +200,12 @@ protected:
 
     /// Current clamp through each vertex (adds to any triangle clamps.)
     std::vector<double>         pVertCurClamp;
+
+    /// True if the matrix must be reassembled and refactored.
+    bool                        pMatrixStale{true};
+
+    /// Time step of the current factorization.
+    double                      pMatrixDT{0.0};
 };
     
 class dVSolverBanded: public dVSolverBase {
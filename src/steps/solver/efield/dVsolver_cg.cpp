@@ -0,0 +1,395 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+// STL headers.
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <numeric>
+#include <utility>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/mpi/mpi_compat.hpp"
+#include "steps/error.hpp"
+#include "steps/solver/efield/dVsolver_cg.hpp"
+#include "steps/solver/efield/tetmesh.hpp"
+
+// logging
+#include <easylogging++.h>
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+// Message tag for ghost vertex exchanges; distinct from the TetOpSplitP tags.
+static constexpr int EFIELD_HALO_TAG = 10300;
+
+dVSolverDistCG::dVSolverDistCG(MPI_Comm comm, std::vector<int> vert_owner, std::vector<int> tri_owner):
+    pComm(comm), pVertOwner(std::move(vert_owner)), pTriOwner(std::move(tri_owner))
+{
+    MPI_Comm_rank(pComm, &pRank);
+    MPI_Comm_size(pComm, &pNProcs);
+}
+
+void dVSolverDistCG::initMesh(TetMesh *mesh) {
+    dVSolverBase::initMesh(mesh);
+
+    if (pVertOwner.size() != pNVerts || pTriOwner.size() != pNTris) {
+        ArgErrLog("Vertex or triangle partition does not match the E-Field mesh.");
+    }
+
+    // Vertex owners are given in EField vertex indices: move them to the
+    // (possibly reordered) solver indices.
+    const auto &perm = mesh->getVertexPermutation();
+    std::vector<int> owner(pNVerts);
+    for (uint i = 0; i < pNVerts; ++i) {
+        int o = pVertOwner[i];
+        if (o < 0 || o >= pNProcs) {
+            ArgErrLog("Invalid owner rank in E-Field vertex partition.");
+        }
+        owner[perm[i].get()] = o;
+    }
+    pVertOwner.swap(owner);
+
+    pOwnedVerts.clear();
+    for (uint i = 0; i < pNVerts; ++i) {
+        if (pVertOwner[i] == pRank) pOwnedVerts.push_back(i);
+    }
+
+    pLocalTris.clear();
+    for (uint t = 0; t < pNTris; ++t) {
+        if (pTriOwner[t] == pRank) pLocalTris.push_back(t);
+    }
+
+    // Ghosts: neighbours of owned vertices and vertices of hosted triangles
+    // that are owned elsewhere, grouped by owner.
+    std::map<int, std::vector<uint>> ghosts;
+    std::vector<char> is_ghost(pNVerts, 0);
+    auto add_ghost = [&](uint v) {
+        if (pVertOwner[v] == pRank || is_ghost[v]) return;
+        is_ghost[v] = 1;
+        ghosts[pVertOwner[v]].push_back(v);
+    };
+
+    for (auto i : pOwnedVerts) {
+        VertexElement *ve = pMesh->getVertex(i);
+        AssertLog(ve->getIDX() == i);
+        for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) add_ghost(ve->nbrIdx(inbr));
+    }
+    for (auto t : pLocalTris) {
+        const auto *triv = pMesh->getTriangle(t);
+        for (uint j = 0; j < 3; ++j) add_ghost(triv[j].get());
+    }
+
+    pGhostVerts.clear();
+    pRecvRanks.clear();
+    pRecvIdx.clear();
+    std::vector<int> recv_count(pNProcs, 0);
+    for (auto &g : ghosts) {
+        std::sort(g.second.begin(), g.second.end());
+        pGhostVerts.insert(pGhostVerts.end(), g.second.begin(), g.second.end());
+        recv_count[g.first] = static_cast<int>(g.second.size());
+        pRecvRanks.push_back(g.first);
+        pRecvIdx.push_back(g.second);
+    }
+
+    // Tell every owner which of its vertices we need.
+    std::vector<int> send_count(pNProcs, 0);
+    MPI_Alltoall(recv_count.data(), 1, MPI_INT, send_count.data(), 1, MPI_INT, pComm);
+
+    std::vector<int> recv_offset(pNProcs, 0), send_offset(pNProcs, 0);
+    std::partial_sum(recv_count.begin(), recv_count.end() - 1, recv_offset.begin() + 1);
+    std::partial_sum(send_count.begin(), send_count.end() - 1, send_offset.begin() + 1);
+
+    std::vector<uint> requested(pGhostVerts);
+    std::vector<uint> to_send(send_offset.back() + send_count.back());
+    MPI_Alltoallv(requested.data(), recv_count.data(), recv_offset.data(), MPI_UNSIGNED,
+                  to_send.data(), send_count.data(), send_offset.data(), MPI_UNSIGNED, pComm);
+
+    pSendRanks.clear();
+    pSendIdx.clear();
+    for (int r = 0; r < pNProcs; ++r) {
+        if (send_count[r] == 0) continue;
+        pSendRanks.push_back(r);
+        pSendIdx.emplace_back(to_send.begin() + send_offset[r],
+                              to_send.begin() + send_offset[r] + send_count[r]);
+        for (auto v : pSendIdx.back()) {
+            if (pVertOwner[v] != pRank) ProgErrLog("E-Field ghost request for a vertex not owned.");
+        }
+    }
+
+    pRecvBuf.resize(pRecvRanks.size());
+    for (uint n = 0; n < pRecvRanks.size(); ++n) pRecvBuf[n].resize(pRecvIdx[n].size());
+    pSendBuf.resize(pSendRanks.size());
+    for (uint n = 0; n < pSendRanks.size(); ++n) pSendBuf[n].resize(pSendIdx[n].size());
+    pRequests.resize(pRecvRanks.size() + pSendRanks.size());
+
+    // Layout of owned vertices over all processes, for syncPotential().
+    int nowned = static_cast<int>(pOwnedVerts.size());
+    pAllOwnedCount.assign(pNProcs, 0);
+    MPI_Allgather(&nowned, 1, MPI_INT, pAllOwnedCount.data(), 1, MPI_INT, pComm);
+    pAllOwnedOffset.assign(pNProcs, 0);
+    std::partial_sum(pAllOwnedCount.begin(), pAllOwnedCount.end() - 1, pAllOwnedOffset.begin() + 1);
+    pAllOwned.resize(pNVerts);
+    MPI_Allgatherv(pOwnedVerts.data(), nowned, MPI_UNSIGNED,
+                   pAllOwned.data(), pAllOwnedCount.data(), pAllOwnedOffset.data(), MPI_UNSIGNED, pComm);
+    pSyncBuf.resize(pNVerts);
+    pSyncLocal.resize(pOwnedVerts.size());
+
+    pX.assign(pNVerts, 0.0);
+    pB.assign(pNVerts, 0.0);
+    pR.assign(pNVerts, 0.0);
+    pZ.assign(pNVerts, 0.0);
+    pP.assign(pNVerts, 0.0);
+    pQ.assign(pNVerts, 0.0);
+
+    pVGlobalStale = false;
+}
+
+void dVSolverDistCG::_assemble(double dt) {
+    double oodt = 1.0/dt;
+
+    pRowPtr.assign(1, 0);
+    pCols.clear();
+    pVals.clear();
+    pInvDiag.clear();
+
+    for (auto i : pOwnedVerts) {
+        if (pVertexClamp[i]) {
+            pCols.push_back(i);
+            pVals.push_back(1.0);
+            pInvDiag.push_back(1.0);
+        }
+        else {
+            VertexElement *ve = pMesh->getVertex(i);
+            double Aii = ve->getCapacitance()*oodt + pGExt[i];
+
+            // Diagonal first, filled in after the loop.
+            auto diag = pVals.size();
+            pCols.push_back(i);
+            pVals.push_back(0.0);
+
+            for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
+                uint k = ve->nbrIdx(inbr);
+                double cc = ve->getCC(inbr);
+                Aii += cc;
+                // Clamped columns drop out since their update is zero; this
+                // keeps the reduced system symmetric.
+                if (pVertexClamp[k]) continue;
+                pCols.push_back(k);
+                pVals.push_back(-cc);
+            }
+            pVals[diag] = Aii;
+            pInvDiag.push_back(1.0/Aii);
+        }
+        pRowPtr.push_back(static_cast<uint>(pCols.size()));
+    }
+}
+
+void dVSolverDistCG::_matvec(const std::vector<double> &x, std::vector<double> &y) const {
+    auto nowned = pOwnedVerts.size();
+    for (uint r = 0; r < nowned; ++r) {
+        double s = 0.0;
+        for (uint e = pRowPtr[r]; e < pRowPtr[r+1]; ++e) s += pVals[e] * x[pCols[e]];
+        y[pOwnedVerts[r]] = s;
+    }
+}
+
+double dVSolverDistCG::_dot(const std::vector<double> &u, const std::vector<double> &v) const {
+    double local = 0.0;
+    for (auto i : pOwnedVerts) local += u[i] * v[i];
+    double global = 0.0;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, pComm);
+    return global;
+}
+
+void dVSolverDistCG::_haloUpdate(std::vector<double> &v) {
+    auto nrecv = pRecvRanks.size();
+    auto nsend = pSendRanks.size();
+
+    for (uint n = 0; n < nrecv; ++n) {
+        MPI_Irecv(pRecvBuf[n].data(), static_cast<int>(pRecvBuf[n].size()), MPI_DOUBLE,
+                  pRecvRanks[n], EFIELD_HALO_TAG, pComm, &pRequests[n]);
+    }
+    for (uint n = 0; n < nsend; ++n) {
+        auto &buf = pSendBuf[n];
+        const auto &idx = pSendIdx[n];
+        for (uint j = 0; j < idx.size(); ++j) buf[j] = v[idx[j]];
+        MPI_Isend(buf.data(), static_cast<int>(buf.size()), MPI_DOUBLE,
+                  pSendRanks[n], EFIELD_HALO_TAG, pComm, &pRequests[nrecv + n]);
+    }
+    MPI_Waitall(static_cast<int>(nrecv + nsend), pRequests.data(), MPI_STATUSES_IGNORE);
+
+    for (uint n = 0; n < nrecv; ++n) {
+        const auto &buf = pRecvBuf[n];
+        const auto &idx = pRecvIdx[n];
+        for (uint j = 0; j < idx.size(); ++j) v[idx[j]] = buf[j];
+    }
+}
+
+void dVSolverDistCG::_haloAccumulate(std::vector<double> &v) {
+    auto nrecv = pRecvRanks.size();
+    auto nsend = pSendRanks.size();
+
+    // Reverse direction: ghost values go back to their owners.
+    for (uint n = 0; n < nsend; ++n) {
+        MPI_Irecv(pSendBuf[n].data(), static_cast<int>(pSendBuf[n].size()), MPI_DOUBLE,
+                  pSendRanks[n], EFIELD_HALO_TAG, pComm, &pRequests[n]);
+    }
+    for (uint n = 0; n < nrecv; ++n) {
+        auto &buf = pRecvBuf[n];
+        const auto &idx = pRecvIdx[n];
+        for (uint j = 0; j < idx.size(); ++j) buf[j] = v[idx[j]];
+        MPI_Isend(buf.data(), static_cast<int>(buf.size()), MPI_DOUBLE,
+                  pRecvRanks[n], EFIELD_HALO_TAG, pComm, &pRequests[nsend + n]);
+    }
+    MPI_Waitall(static_cast<int>(nrecv + nsend), pRequests.data(), MPI_STATUSES_IGNORE);
+
+    for (uint n = 0; n < nsend; ++n) {
+        const auto &buf = pSendBuf[n];
+        const auto &idx = pSendIdx[n];
+        for (uint j = 0; j < idx.size(); ++j) v[idx[j]] += buf[j];
+    }
+}
+
+void dVSolverDistCG::advance(double dt) {
+    // Current contributions: vertex clamps on owners, triangle currents and
+    // clamps on the host of the triangle, then summed on the owners.
+    for (auto i : pOwnedVerts) pVertCur[i] = pVertCurClamp[i];
+    for (auto g : pGhostVerts) pVertCur[g] = 0.0;
+    for (auto t : pLocalTris) {
+        double c = (pTriCur[t] + pTriCurClamp[t]) / 3.0;
+        const auto *triv = pMesh->getTriangle(t);
+        pVertCur[triv[0].get()] += c;
+        pVertCur[triv[1].get()] += c;
+        pVertCur[triv[2].get()] += c;
+    }
+    _haloAccumulate(pVertCur);
+
+    if (pMatrixStale || dt != pMatrixDT) {
+        _assemble(dt);
+        pMatrixStale = false;
+        pMatrixDT = dt;
+    }
+
+    // Right-hand side on owned rows; ghost potentials are up to date.
+    for (auto i : pOwnedVerts) {
+        if (pVertexClamp[i]) {
+            pB[i] = 0.0;
+            continue;
+        }
+        VertexElement *ve = pMesh->getVertex(i);
+        double rhs = pVertCur[i] + pGExt[i] * (pVExt - pV[i]);
+        for (uint inbr = 0; inbr < ve->getNCon(); ++inbr) {
+            uint k = ve->nbrIdx(inbr);
+            rhs += ve->getCC(inbr) * (pV[k] - pV[i]);
+        }
+        pB[i] = rhs;
+    }
+
+    // Preconditioned CG from a zero initial guess.
+    uint nowned = static_cast<uint>(pOwnedVerts.size());
+    for (uint r = 0; r < nowned; ++r) {
+        uint i = pOwnedVerts[r];
+        pX[i] = 0.0;
+        pR[i] = pB[i];
+        pZ[i] = pInvDiag[r] * pR[i];
+        pP[i] = pZ[i];
+    }
+
+    double bnorm = std::sqrt(_dot(pB, pB));
+    double rz = _dot(pR, pZ);
+    uint maxiter = pMaxIter > 0 ? pMaxIter : std::max(pNVerts, 1u);
+
+    pLastIters = 0;
+    if (bnorm > 0.0) {
+        while (pLastIters < maxiter) {
+            _haloUpdate(pP);
+            _matvec(pP, pQ);
+
+            double pq = _dot(pP, pQ);
+            if (pq <= 0.0) break;
+            double alpha = rz / pq;
+
+            for (auto i : pOwnedVerts) {
+                pX[i] += alpha * pP[i];
+                pR[i] -= alpha * pQ[i];
+            }
+            ++pLastIters;
+
+            // One reduction for both the residual norm and r.z.
+            double local[2] = {0.0, 0.0};
+            for (uint r = 0; r < nowned; ++r) {
+                uint i = pOwnedVerts[r];
+                pZ[i] = pInvDiag[r] * pR[i];
+                local[0] += pR[i] * pR[i];
+                local[1] += pR[i] * pZ[i];
+            }
+            double global[2];
+            MPI_Allreduce(local, global, 2, MPI_DOUBLE, MPI_SUM, pComm);
+
+            if (std::sqrt(global[0]) <= pRTol * bnorm) break;
+
+            double beta = global[1] / rz;
+            rz = global[1];
+            for (auto i : pOwnedVerts) pP[i] = pZ[i] + beta * pP[i];
+        }
+
+        if (pLastIters == maxiter) {
+            CLOG(WARNING, "general_log") << "E-Field CG solver did not converge in " << maxiter << " iterations.\n";
+        }
+    }
+
+    for (auto i : pOwnedVerts) {
+        if (pVertexClamp[i] == false) pV[i] += pX[i];
+    }
+    _haloUpdate(pV);
+    pVGlobalStale = true;
+
+    // reset pTriCur for caller contributions
+    std::fill(pTriCur.begin(), pTriCur.end(), 0.0);
+}
+
+void dVSolverDistCG::syncPotential() {
+    if (!pVGlobalStale) return;
+
+    uint nowned = static_cast<uint>(pOwnedVerts.size());
+    for (uint r = 0; r < nowned; ++r) pSyncLocal[r] = pV[pOwnedVerts[r]];
+
+    MPI_Allgatherv(pSyncLocal.data(), static_cast<int>(nowned), MPI_DOUBLE,
+                   pSyncBuf.data(), pAllOwnedCount.data(), pAllOwnedOffset.data(), MPI_DOUBLE, pComm);
+
+    for (uint j = 0; j < pNVerts; ++j) pV[pAllOwned[j]] = pSyncBuf[j];
+    pVGlobalStale = false;
+}
+
+}  // namespace efield
+}  // namespace solver
+}  // namespace steps
+
+// END
@@ -0,0 +1,151 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_SOLVER_EFIELD_DVSOLVER_CG_HPP
+#define STEPS_SOLVER_EFIELD_DVSOLVER_CG_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/mpi/mpi_compat.hpp"
+#include "steps/solver/efield/dVsolver.hpp"
+
+namespace steps {
+namespace solver {
+namespace efield {
+
+/// Distributed voltage solver: Jacobi-preconditioned conjugate gradient.
+///
+/// Each process owns a subset of the vertex rows, given by the caller in
+/// terms of the mesh partition, and only assembles and multiplies those.
+/// Potentials of vertices that are coupled to owned rows, or that belong
+/// to triangles hosted by the process, are kept as ghosts and refreshed by
+/// point-to-point exchanges with the neighbouring processes only.
+///
+/// Triangle currents are only expected on the process that hosts the
+/// triangle; their vertex contributions are accumulated on the owners of
+/// the vertices.
+///
+/// After advance() the potential is only up to date on owned and ghost
+/// vertices. syncPotential(), which is collective, gathers the potential
+/// of every vertex on all processes.
+///
+class dVSolverDistCG: public dVSolverBase {
+public:
+    /// vert_owner: owning rank of each vertex, indexed as the vertices
+    ///             given to EField (i.e. before any reordering).
+    /// tri_owner:  hosting rank of each triangle.
+    ///
+    dVSolverDistCG(MPI_Comm comm, std::vector<int> vert_owner, std::vector<int> tri_owner);
+
+    void initMesh(TetMesh *mesh) override;
+
+    void advance(double dt) override;
+
+    void syncPotential() override;
+
+    /// Set the relative residual tolerance and the iteration limit
+    /// (0 means the number of vertices) of the CG iteration.
+    void setTolerance(double rtol, uint maxiter) noexcept {
+        pRTol = rtol;
+        pMaxIter = maxiter;
+    }
+
+    /// Number of CG iterations of the last advance().
+    uint lastIterations() const noexcept { return pLastIters; }
+
+private:
+    /// Build the CSR rows of owned vertices.
+    void _assemble(double dt);
+
+    /// y = A x on owned rows; ghosts of x must be up to date.
+    void _matvec(const std::vector<double> &x, std::vector<double> &y) const;
+
+    /// Sum over all processes of the dot product on owned rows.
+    double _dot(const std::vector<double> &u, const std::vector<double> &v) const;
+
+    /// Copy owned values to the ghosts on neighbouring processes.
+    void _haloUpdate(std::vector<double> &v);
+
+    /// Add ghost values into the owned values on neighbouring processes.
+    void _haloAccumulate(std::vector<double> &v);
+
+    MPI_Comm                    pComm;
+    int                         pRank{0};
+    int                         pNProcs{1};
+
+    /// Owning rank of each vertex, in solver vertex indices.
+    std::vector<int>            pVertOwner;
+    /// Hosting rank of each triangle.
+    std::vector<int>            pTriOwner;
+
+    std::vector<uint>           pOwnedVerts;
+    std::vector<uint>           pGhostVerts;
+    std::vector<uint>           pLocalTris;
+
+    /// Ranks we receive ghost values from, and the ghosts received.
+    std::vector<int>            pRecvRanks;
+    std::vector<std::vector<uint>> pRecvIdx;
+    /// Ranks we send owned values to, and the owned vertices sent.
+    std::vector<int>            pSendRanks;
+    std::vector<std::vector<uint>> pSendIdx;
+
+    std::vector<std::vector<double>> pRecvBuf;
+    std::vector<std::vector<double>> pSendBuf;
+    std::vector<MPI_Request>    pRequests;
+
+    /// Rows of owned vertices, in pOwnedVerts order.
+    std::vector<uint>           pRowPtr;
+    std::vector<uint>           pCols;
+    std::vector<double>         pVals;
+    std::vector<double>         pInvDiag;
+
+    /// CG work vectors, indexed by solver vertex index.
+    std::vector<double>         pX, pB, pR, pZ, pP, pQ;
+
+    /// Owned vertices of every process, for syncPotential().
+    std::vector<int>            pAllOwnedCount;
+    std::vector<int>            pAllOwnedOffset;
+    std::vector<uint>           pAllOwned;
+    std::vector<double>         pSyncBuf;
+    std::vector<double>         pSyncLocal;
+
+    /// True if non-local potentials are out of date.
+    bool                        pVGlobalStale{false};
+
+    double                      pRTol{1.0e-10};
+    uint                        pMaxIter{0};
+    uint                        pLastIters{0};
+};
+
+}}} // namespace steps::solver::efield
+
+#endif // ndef STEPS_SOLVER_EFIELD_DVSOLVER_CG_HPP
+
+// END
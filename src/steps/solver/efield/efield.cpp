@@ -130,7 +130,7 @@ sefield::EField::~EField()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::EField::checkpoint(std::fstream & cp_file)
+void sefield::EField::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pNVerts), sizeof(uint));
     cp_file.write(reinterpret_cast<char*>(&pNTris), sizeof(uint));
@@ -145,7 +145,7 @@ void sefield::EField::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::EField::restore(std::fstream & cp_file)
+void sefield::EField::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pNVerts), sizeof(uint));
     cp_file.read(reinterpret_cast<char*>(&pNTris), sizeof(uint));
@@ -157,6 +157,7 @@ void sefield::EField::restore(std::fstream & cp_file)
     cp_file.read(reinterpret_cast<char*>(&pCPerm.front()), sizeof(uint) * nCPerm);
 
     pMesh->restore(cp_file);
+    pVProp->invalidateMatrix();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -171,6 +172,7 @@ void sefield::EField::setMembCapac(uint midx, double cm)
     // specific capacitance in pF/um2.
     // Argument is in F/m^2: 1 F/m^2 = 1 pF / um^2 so no conversion needed!
     pMesh->applySurfaceCapacitance(cm);
+    pVProp->invalidateMatrix();
 }
 
 void sefield::EField::setTriCapac(triangle_id_t tidx, double cm)
@@ -185,6 +187,7 @@ void sefield::EField::setTriCapac(triangle_id_t tidx, double cm)
     // Argument is in F/m^2: 1 F/m^2 = 1 pF / um^2 so no conversion needed!
 
     pMesh->applyTriCapacitance(tidx, cm);
+    pVProp->invalidateMatrix();
 
 }
 
@@ -205,6 +208,7 @@ void sefield::EField::setMembVolRes(uint /*midx*/, double ro)
 {
     AssertLog(ro >= 0.0);
     pMesh->applyConductance(1.0/(ro*1.0e-3));
+    pVProp->invalidateMatrix();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -262,6 +266,13 @@ void sefield::EField::advance(double dt)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void sefield::EField::syncPotential()
+{
+    pVProp->syncPotential();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double sefield::EField::getVertV(vertex_id_t vidx)
 {
     // vidx argument converted to local index in Tetexact.
@@ -103,10 +103,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file);
+    void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    void restore(std::fstream & cp_file);
+    void restore(std::iostream & cp_file);
 
     // Save optimal vertex configuration
     void saveOptimal(std::string const & opt_file_name);
@@ -245,6 +245,10 @@ public:
     /// \param sec The time to advance the EField simulation (seconds)
     void    advance(double sec);
 
+    /// Make the potential of all vertices available on this process after
+    /// advance(). Collective when the voltage solver is distributed.
+    void    syncPotential();
+
     ////////////////////////////////////////////////////////////////////////
 
 private:
@@ -78,8 +78,14 @@ struct EFieldSolver {
     /** Get additional current injection for area associated with vertex i (pA) */
     virtual double getVertIClamp(vertex_id_t i) const =0;
 
+    /** Notify the solver that capacitances or coupling constants have changed in the mesh */
+    virtual void invalidateMatrix() {}
+
     /** Solve for voltage with given dt */
     virtual void advance(double dt) =0;
+
+    /** Make the potential of every vertex available on this process (collective for distributed solvers) */
+    virtual void syncPotential() {}
 };
 
 }}} // namespace steps::efield::solver
@@ -108,7 +108,7 @@ sefield::Matrix::~Matrix()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::Matrix::checkpoint(std::fstream & cp_file)
+void sefield::Matrix::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pN), sizeof(uint));
     cp_file.write(reinterpret_cast<char*>(&pSign), sizeof(int));
@@ -119,7 +119,7 @@ void sefield::Matrix::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::Matrix::restore(std::fstream & cp_file)
+void sefield::Matrix::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pN), sizeof(uint));
     cp_file.read(reinterpret_cast<char*>(&pSign), sizeof(int));
@@ -115,12 +115,6 @@ SLUSystem::SLUSystem(const sparsity_template &S, MPI_Comm mpi_comm):
 SLUSystem::~SLUSystem() = default;
 
 void SLUSystem::solve() {
-    // use copy of A...
-    SLU_NCMatrix Abis(pA);
-
-    supermatrix_nc_view slu_A(Abis);
-    std::copy(pb.begin(),pb.end(),px.begin());
-
     if (!slu->factored)
         slu->options.Fact = DOFACT;
     else if (slu->keepperm)
@@ -128,6 +122,26 @@ void SLUSystem::solve() {
     else
         slu->options.Fact = SamePattern;
 
+    _pdgssvx();
+}
+
+void SLUSystem::resolve() {
+    if (!slu->factored) {
+        solve();
+        return;
+    }
+
+    slu->options.Fact = FACTORED;
+    _pdgssvx();
+}
+
+void SLUSystem::_pdgssvx() {
+    // use copy of A...
+    SLU_NCMatrix Abis(pA);
+
+    supermatrix_nc_view slu_A(Abis);
+    std::copy(pb.begin(),pb.end(),px.begin());
+
     int info;
 
     pdgssvx_ABglobal(&slu->options, &slu_A.M, &slu->perm, px.data(), pN, 1,
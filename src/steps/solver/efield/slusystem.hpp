@@ -187,6 +187,10 @@ public:
     const vector_type &x() const { return px_view; }
 
     void solve();
+
+    // Solve for the current b, reusing the factorization computed by
+    // the last call to solve(); pA must not have been modified since.
+    void resolve();
     
     // query solver stats, error
     double berr() const { return pBerr; }
@@ -198,6 +202,9 @@ public:
     SLUSolverStats solver_stats_global() const { return SLUSolverStats(); }
 
 private:
+    // Run pdgssvx_ABglobal with the Fact option set by the caller.
+    void _pdgssvx();
+
     int pN;
     matrix_type pA;
     std::vector<double> pb, px;
@@ -197,7 +197,7 @@ sefield::TetMesh::~TetMesh()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::TetMesh::checkpoint(std::fstream & cp_file)
+void sefield::TetMesh::checkpoint(std::iostream & cp_file)
 {
     auto nelems = pElements.size();
     cp_file.write(reinterpret_cast<char*>(&nelems), sizeof(uint));
@@ -214,7 +214,7 @@ void sefield::TetMesh::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::TetMesh::restore(std::fstream & cp_file)
+void sefield::TetMesh::restore(std::iostream & cp_file)
 {
     uint nelems = 0;
     cp_file.read(reinterpret_cast<char*>(&nelems), sizeof(uint));
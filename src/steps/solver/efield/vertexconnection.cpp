@@ -63,14 +63,14 @@ sefield::VertexConnection::~VertexConnection()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::VertexConnection::checkpoint(std::fstream & cp_file)
+void sefield::VertexConnection::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pGeomCC), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::VertexConnection::restore(std::fstream & cp_file)
+void sefield::VertexConnection::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pGeomCC), sizeof(double));
 }
@@ -68,7 +68,7 @@ sefield::VertexElement::~VertexElement()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::VertexElement::checkpoint(std::fstream & cp_file)
+void sefield::VertexElement::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pSurface), sizeof(double));
     cp_file.write(reinterpret_cast<char*>(&pVolume), sizeof(double));
@@ -79,7 +79,7 @@ void sefield::VertexElement::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void sefield::VertexElement::restore(std::fstream & cp_file)
+void sefield::VertexElement::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pSurface), sizeof(double));
     cp_file.read(reinterpret_cast<char*>(&pVolume), sizeof(double));
@@ -137,7 +137,7 @@ ssolver::GHKcurrdef::~GHKcurrdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::GHKcurrdef::checkpoint(std::fstream & cp_file)
+void ssolver::GHKcurrdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pRealFlux), sizeof(bool));
     cp_file.write(reinterpret_cast<char*>(&pVirtual_oconc), sizeof(double));
@@ -148,7 +148,7 @@ void ssolver::GHKcurrdef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::GHKcurrdef::restore(std::fstream & cp_file)
+void ssolver::GHKcurrdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pRealFlux), sizeof(bool));
     cp_file.read(reinterpret_cast<char*>(&pVirtual_oconc), sizeof(double));
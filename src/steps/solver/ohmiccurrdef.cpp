@@ -84,7 +84,7 @@ ssolver::OhmicCurrdef::~OhmicCurrdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::OhmicCurrdef::checkpoint(std::fstream & cp_file)
+void ssolver::OhmicCurrdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pG), sizeof(double));
     cp_file.write(reinterpret_cast<char*>(&pERev), sizeof(double));
@@ -92,7 +92,7 @@ void ssolver::OhmicCurrdef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::OhmicCurrdef::restore(std::fstream & cp_file)
+void ssolver::OhmicCurrdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pG), sizeof(double));
     cp_file.read(reinterpret_cast<char*>(&pERev), sizeof(double));
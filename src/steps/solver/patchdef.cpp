@@ -294,7 +294,7 @@ ssolver::Patchdef::~Patchdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Patchdef::checkpoint(std::fstream & cp_file)
+void ssolver::Patchdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(pPoolCount), sizeof(double) * pSpecsN_S);
     cp_file.write(reinterpret_cast<char*>(pPoolFlags), sizeof(uint) * pSpecsN_S);
@@ -304,7 +304,7 @@ void ssolver::Patchdef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Patchdef::restore(std::fstream & cp_file)
+void ssolver::Patchdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(pPoolCount), sizeof(double) * pSpecsN_S);
     cp_file.read(reinterpret_cast<char*>(pPoolFlags), sizeof(uint) * pSpecsN_S);
@@ -757,6 +757,21 @@ void ssolver::Patchdef::setup_indices()
                 }
             }
         }
+
+        // Compile the sparse form of each surface reaction.
+        pSReac_Prog_I.reserve(pSReacsN);
+        pSReac_Prog_S.reserve(pSReacsN);
+        pSReac_Prog_O.reserve(pSReacsN);
+        for (uint ri = 0; ri < pSReacsN; ++ri)
+        {
+            pSReac_Prog_I.emplace_back(sreac_lhs_I_bgn(ri), sreac_upd_I_bgn(ri), pSpecsN_I);
+            pSReac_Prog_S.emplace_back(sreac_lhs_S_bgn(ri), sreac_upd_S_bgn(ri), pSpecsN_S);
+            if (pOuter != nullptr) {
+                pSReac_Prog_O.emplace_back(sreac_lhs_O_bgn(ri), sreac_upd_O_bgn(ri), pSpecsN_O);
+            } else {
+                pSReac_Prog_O.emplace_back();
+            }
+        }
     }
 
     // 3.5 -- DEAL WITH PATCH SURFACE-DIFFUSION
@@ -904,6 +919,21 @@ void ssolver::Patchdef::setup_indices()
                 }
             }
         }
+
+        // Compile the sparse form of each voltage-dependent surface reaction.
+        pVDepSReac_Prog_I.reserve(pVDepSReacsN);
+        pVDepSReac_Prog_S.reserve(pVDepSReacsN);
+        pVDepSReac_Prog_O.reserve(pVDepSReacsN);
+        for (uint ri = 0; ri < pVDepSReacsN; ++ri)
+        {
+            pVDepSReac_Prog_I.emplace_back(vdepsreac_lhs_I_bgn(ri), vdepsreac_upd_I_bgn(ri), pSpecsN_I);
+            pVDepSReac_Prog_S.emplace_back(vdepsreac_lhs_S_bgn(ri), vdepsreac_upd_S_bgn(ri), pSpecsN_S);
+            if (pOuter != nullptr) {
+                pVDepSReac_Prog_O.emplace_back(vdepsreac_lhs_O_bgn(ri), vdepsreac_upd_O_bgn(ri), pSpecsN_O);
+            } else {
+                pVDepSReac_Prog_O.emplace_back();
+            }
+        }
     }
     // 5 -- DEAL WITH OHMIC CURRENTS
     if (pOhmicCurrsN != 0)
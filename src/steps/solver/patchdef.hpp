@@ -43,6 +43,7 @@
 #include "steps/common.h"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/api.hpp"
+#include "steps/solver/reacprogram.hpp"
 #include "steps/geom/patch.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -88,10 +89,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file);
+    void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    void restore(std::fstream & cp_file);
+    void restore(std::iostream & cp_file);
 
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS: PATCH
@@ -276,6 +277,15 @@ public:
     int * sreac_upd_O_bgn(uint lidx) const;
     int * sreac_upd_O_end(uint lidx) const;
 
+    // Return the compiled (sparse) lhs and update of the surface, inner
+    // and outer side of surface reaction specified by local index argument.
+    inline const ReacProgram & sreac_prog_I(uint lidx) const noexcept
+    { return pSReac_Prog_I[lidx]; }
+    inline const ReacProgram & sreac_prog_S(uint lidx) const noexcept
+    { return pSReac_Prog_S[lidx]; }
+    inline const ReacProgram & sreac_prog_O(uint lidx) const noexcept
+    { return pSReac_Prog_O[lidx]; }
+
     /// Return pointer to flags on surface reactions for this patch.
     inline uint * srflags() const noexcept
     { return pSReacFlags; }
@@ -468,6 +478,16 @@ public:
     int * vdepsreac_upd_O_bgn(uint lidx) const;
     int * vdepsreac_upd_O_end(uint lidx) const;
 
+    // Return the compiled (sparse) lhs and update of the surface, inner
+    // and outer side of voltage-dependent surface reaction specified by
+    // local index argument.
+    inline const ReacProgram & vdepsreac_prog_I(uint lidx) const noexcept
+    { return pVDepSReac_Prog_I[lidx]; }
+    inline const ReacProgram & vdepsreac_prog_S(uint lidx) const noexcept
+    { return pVDepSReac_Prog_S[lidx]; }
+    inline const ReacProgram & vdepsreac_prog_O(uint lidx) const noexcept
+    { return pVDepSReac_Prog_O[lidx]; }
+
 
     ////////////////////////////////////////////////////////////////////////
     // SOLVER METHODS: SURFACE REACTIONS
@@ -589,6 +609,10 @@ private:
     int                               * pSReac_UPD_S_Spec;
     int                               * pSReac_UPD_O_Spec;
 
+    std::vector<ReacProgram>            pSReac_Prog_I;
+    std::vector<ReacProgram>            pSReac_Prog_S;
+    std::vector<ReacProgram>            pSReac_Prog_O;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA: SURFACE DIFFUSION RULES
     ////////////////////////////////////////////////////////////////////////
@@ -647,6 +671,10 @@ private:
     int                               * pVDepSReac_UPD_S_Spec;
     int                               * pVDepSReac_UPD_O_Spec;
 
+    std::vector<ReacProgram>            pVDepSReac_Prog_I;
+    std::vector<ReacProgram>            pVDepSReac_Prog_S;
+    std::vector<ReacProgram>            pVDepSReac_Prog_O;
+
     ////////////////////////////////////////////////////////////////////////
     // DATA: OHMIC CURRENTS
     ////////////////////////////////////////////////////////////////////////
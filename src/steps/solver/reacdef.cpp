@@ -109,14 +109,14 @@ ssolver::Reacdef::~Reacdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Reacdef::checkpoint(std::fstream & cp_file)
+void ssolver::Reacdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pKcst), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Reacdef::restore(std::fstream & cp_file)
+void ssolver::Reacdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pKcst), sizeof(double));
 }
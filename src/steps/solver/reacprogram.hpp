@@ -0,0 +1,167 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_SOLVER_REACPROGRAM_HPP
+#define STEPS_SOLVER_REACPROGRAM_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+
+// logging
+#include <easylogging++.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace solver {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// One reactant of a compiled reaction: the local index of the species in
+/// the pool array of the element and the order of the reaction in it.
+struct ReacLHSTerm
+{
+    uint                                lidx;
+    uint                                order;
+};
+
+/// One stoichiometry change of a compiled reaction.
+struct ReacUPDTerm
+{
+    uint                                lidx;
+    int                                 upd;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Number of distinct ordered combinations of Order molecules out of cnt,
+/// i.e. cnt * (cnt - 1) * ... * (cnt - Order + 1). The caller guarantees
+/// that cnt >= Order.
+///
+template <uint Order>
+inline double reac_h_term(uint cnt) noexcept
+{
+    return static_cast<double>(cnt - (Order - 1)) * reac_h_term<Order - 1>(cnt);
+}
+
+template <>
+inline double reac_h_term<0>(uint /*cnt*/) noexcept
+{
+    return 1.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Sparse, compiled form of the left-hand side and update vector of a
+/// reaction rule over one pool array (a compartment, or the surface, inner
+/// or outer side of a patch).
+///
+/// Compdef and Patchdef store their lhs/upd tables densely, one entry per
+/// local species, while most reactions only involve one to three species.
+/// The program keeps only the non-zero entries, so that the propensity and
+/// the update of a reaction cost O(number of reactants) instead of
+/// O(number of species in the compartment).
+///
+class ReacProgram
+{
+
+public:
+
+    ReacProgram() = default;
+
+    /// Compile from the dense lhs and upd tables of a reaction, each of
+    /// size nspecs. Either table may be a null pointer.
+    ///
+    ReacProgram(const uint * lhs, const int * upd, uint nspecs)
+    {
+        for (uint s = 0; s < nspecs; ++s)
+        {
+            if (lhs != nullptr && lhs[s] != 0) {
+                AssertLog(lhs[s] <= 4);
+                pLHS.push_back({s, lhs[s]});
+            }
+            if (upd != nullptr && upd[s] != 0) {
+                pUPD.push_back({s, upd[s]});
+            }
+        }
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+
+    inline const std::vector<ReacLHSTerm> & lhs() const noexcept
+    { return pLHS; }
+
+    inline const std::vector<ReacUPDTerm> & upd() const noexcept
+    { return pUPD; }
+
+    /// Combinatorial part of the propensity (number of available reaction
+    /// channels) for the pool counts cnt. Returns 0 as soon as a reactant
+    /// does not have enough molecules.
+    ///
+    inline double h(const uint * cnt) const noexcept
+    {
+        double h_mu = 1.0;
+        for (auto const& t : pLHS)
+        {
+            uint c = cnt[t.lidx];
+            if (c < t.order) return 0.0;
+            switch (t.order)
+            {
+                case 1: h_mu *= reac_h_term<1>(c); break;
+                case 2: h_mu *= reac_h_term<2>(c); break;
+                case 3: h_mu *= reac_h_term<3>(c); break;
+                case 4: h_mu *= reac_h_term<4>(c); break;
+                default: break;
+            }
+        }
+        return h_mu;
+    }
+
+    ////////////////////////////////////////////////////////////////////////
+
+private:
+
+    std::vector<ReacLHSTerm>            pLHS;
+    std::vector<ReacUPDTerm>            pUPD;
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
+
+// STEPS_SOLVER_REACPROGRAM_HPP
+
+// END
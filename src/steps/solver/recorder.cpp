@@ -0,0 +1,437 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+// STL headers.
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+#include "steps/geom/tetmesh.hpp"
+#include "steps/solver/api.hpp"
+#include "steps/solver/recorder.hpp"
+#include "steps/solver/statedef.hpp"
+
+// logging
+#include "easylogging++.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace solver {
+
+////////////////////////////////////////////////////////////////////////////////
+
+Recorder::Recorder(API * solver)
+: pSolver(solver)
+{
+    AssertLog(pSolver != nullptr);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint Recorder::addProbe(Element e, std::vector<index_t> const & indices,
+                        Quantity q, std::string const & name)
+{
+    if (!pTimes.empty() || pStream.is_open())
+    {
+        std::ostringstream os;
+        os << "Cannot add a probe after recording has started.";
+        ArgErrLog(os.str());
+    }
+
+    const Statedef & sd = pSolver->statedef();
+
+    Probe p;
+    p.element = e;
+    p.quantity = q;
+    p.idx = 0;
+    p.indices = indices;
+    p.offset = pNCols;
+
+    // Check the quantity makes sense for the element kind and resolve
+    // the name; the following may throw exceptions if names are unknown.
+    bool valid = false;
+    switch (q)
+    {
+        case COUNT:
+            valid = (e != VERT);
+            if (valid) p.idx = sd.getSpecIdx(name);
+            break;
+        case CONC:
+            valid = (e == COMP || e == TET);
+            if (valid) p.idx = sd.getSpecIdx(name);
+            break;
+        case EXTENT:
+            valid = (e == COMP || e == PATCH);
+            if (e == COMP) p.idx = sd.getReacIdx(name);
+            else if (e == PATCH) p.idx = sd.getSReacIdx(name);
+            break;
+        case V:
+            valid = (e == TET || e == TRI || e == VERT);
+            break;
+    }
+    if (!valid)
+    {
+        std::ostringstream os;
+        os << "Quantity cannot be recorded for this kind of element.";
+        ArgErrLog(os.str());
+    }
+
+    // Check element indices.
+    index_t nelems = 0;
+    if (e == COMP)
+    {
+        nelems = sd.countComps();
+    }
+    else if (e == PATCH)
+    {
+        nelems = sd.countPatches();
+    }
+    else
+    {
+        auto * mesh = dynamic_cast<steps::tetmesh::Tetmesh*>(pSolver->geom());
+        if (mesh == nullptr)
+        {
+            std::ostringstream os;
+            os << "Method not available for this solver.";
+            NotImplErrLog(os.str());
+        }
+        if (e == TET) nelems = static_cast<index_t>(mesh->countTets());
+        else if (e == TRI) nelems = mesh->countTris();
+        else nelems = mesh->countVertices();
+    }
+    for (auto i : indices)
+    {
+        if (i >= nelems)
+        {
+            std::ostringstream os;
+            os << "Element index " << i << " out of range.";
+            ArgErrLog(os.str());
+        }
+    }
+
+    pProbes.push_back(p);
+    pNCols += static_cast<uint>(indices.size());
+    return static_cast<uint>(pProbes.size() - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint Recorder::getProbeOffset(uint p) const
+{
+    if (p >= pProbes.size())
+    {
+        std::ostringstream os;
+        os << "Probe index out of range.";
+        ArgErrLog(os.str());
+    }
+    return pProbes[p].offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::setSampleDT(double dt)
+{
+    if (dt <= 0.0)
+    {
+        std::ostringstream os;
+        os << "Sampling interval must be positive.";
+        ArgErrLog(os.str());
+    }
+    pDT = dt;
+    pStart = pSolver->getTime();
+    pStep = 0;
+    pTPnts.clear();
+    pNextTPnt = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::setSamplePoints(std::vector<double> const & tpnts)
+{
+    if (!std::is_sorted(tpnts.begin(), tpnts.end()))
+    {
+        std::ostringstream os;
+        os << "Sampling time points must be in increasing order.";
+        ArgErrLog(os.str());
+    }
+    pDT = 0.0;
+    pTPnts = tpnts;
+    pNextTPnt = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::openStream(std::string const & file_name)
+{
+    closeStream();
+
+    pStream.open(file_name.c_str(),
+                 std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    if (!pStream.good())
+    {
+        std::ostringstream os;
+        os << "Unable to open recording file " << file_name << ".";
+        ArgErrLog(os.str());
+    }
+
+    const char magic[8] = {'S', 'T', 'E', 'P', 'S', 'R', 'E', 'C'};
+    std::uint32_t version = 1;
+    std::uint64_t ncols = pNCols;
+    pStream.write(magic, sizeof(magic));
+    pStream.write(reinterpret_cast<char*>(&version), sizeof(version));
+    pStream.write(reinterpret_cast<char*>(&ncols), sizeof(ncols));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::closeStream()
+{
+    if (pStream.is_open())
+    {
+        pStream.close();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+double Recorder::_nextSampleTime() const
+{
+    if (pDT > 0.0)
+    {
+        return pStart + static_cast<double>(pStep) * pDT;
+    }
+    if (pNextTPnt < pTPnts.size())
+    {
+        return pTPnts[pNextTPnt];
+    }
+    return std::numeric_limits<double>::infinity();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::_popSampleTime()
+{
+    if (pDT > 0.0)
+    {
+        ++pStep;
+    }
+    else if (pNextTPnt < pTPnts.size())
+    {
+        ++pNextTPnt;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::size_t Recorder::_countSampleTimes(double endtime) const
+{
+    if (pDT > 0.0)
+    {
+        double last = std::floor((endtime - pStart) / pDT);
+        if (last < static_cast<double>(pStep)) return 0;
+        return static_cast<std::size_t>(last) - pStep + 1;
+    }
+    auto b = pTPnts.begin() + static_cast<std::ptrdiff_t>(pNextTPnt);
+    return static_cast<std::size_t>(std::upper_bound(b, pTPnts.end(), endtime) - b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::run(double endtime)
+{
+    if (endtime < pSolver->getTime())
+    {
+        std::ostringstream os;
+        os << "Endtime is before current simulation time";
+        ArgErrLog(os.str());
+    }
+
+    if (!pStream.is_open())
+    {
+        reserve(pTimes.size() + _countSampleTimes(endtime));
+    }
+
+    // Sample points that fall within round-off of endtime are taken at
+    // endtime rather than past it.
+    double tol = 1.0e-12 * std::max(1.0, std::fabs(endtime));
+    for (double t = _nextSampleTime(); t <= endtime + tol; t = _nextSampleTime())
+    {
+        t = std::min(t, endtime);
+        // Skip sample points left behind by a direct call to the solver.
+        if (t >= pSolver->getTime())
+        {
+            if (t > pSolver->getTime()) pSolver->run(t);
+            sample();
+        }
+        _popSampleTime();
+    }
+
+    if (pSolver->getTime() < endtime)
+    {
+        pSolver->run(endtime);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::advance(double adv)
+{
+    if (adv < 0.0)
+    {
+        std::ostringstream os;
+        os << "Time to advance cannot be negative";
+        ArgErrLog(os.str());
+    }
+    run(pSolver->getTime() + adv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::sample()
+{
+    pRow.resize(pNCols);
+    for (auto const & p : pProbes)
+    {
+        _sampleProbe(p, pRow.data() + p.offset);
+    }
+
+    double t = pSolver->getTime();
+    if (pStream.is_open())
+    {
+        pStream.write(reinterpret_cast<const char*>(&t), sizeof(t));
+        pStream.write(reinterpret_cast<const char*>(pRow.data()),
+                      static_cast<std::streamsize>(pRow.size() * sizeof(double)));
+    }
+    else
+    {
+        pTimes.push_back(t);
+        pData.insert(pData.end(), pRow.begin(), pRow.end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::_sampleProbe(Probe const & p, double * out) const
+{
+    const auto n = p.indices.size();
+    switch (p.element)
+    {
+        case COMP:
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                uint cidx = static_cast<uint>(p.indices[i]);
+                if (p.quantity == COUNT) out[i] = pSolver->_getCompCount(cidx, p.idx);
+                else if (p.quantity == CONC) out[i] = pSolver->_getCompConc(cidx, p.idx);
+                else out[i] = static_cast<double>(pSolver->_getCompReacExtent(cidx, p.idx));
+            }
+            break;
+        case PATCH:
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                uint pidx = static_cast<uint>(p.indices[i]);
+                if (p.quantity == COUNT) out[i] = pSolver->_getPatchCount(pidx, p.idx);
+                else out[i] = static_cast<double>(pSolver->_getPatchSReacExtent(pidx, p.idx));
+            }
+            break;
+        case TET:
+            if (p.quantity == COUNT)
+            {
+                pSolver->getBatchTetCountsNP(p.indices.data(), n, p.idx, out, n);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    tetrahedron_id_t tidx(p.indices[i]);
+                    out[i] = (p.quantity == CONC) ? pSolver->_getTetConc(tidx, p.idx)
+                                                  : pSolver->_getTetV(tidx);
+                }
+            }
+            break;
+        case TRI:
+            if (p.quantity == COUNT)
+            {
+                pSolver->getBatchTriCountsNP(p.indices.data(), n, p.idx, out, n);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    out[i] = pSolver->_getTriV(triangle_id_t(p.indices[i]));
+                }
+            }
+            break;
+        case VERT:
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = pSolver->_getVertV(vertex_id_t(p.indices[i]));
+            }
+            break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::getDataNP(double * data, std::size_t output_size) const
+{
+    if (output_size != pData.size())
+    {
+        std::ostringstream os;
+        os << "Output array size should be the number of samples times the number of columns.";
+        ArgErrLog(os.str());
+    }
+    std::copy(pData.begin(), pData.end(), data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::reserve(std::size_t nrows)
+{
+    pTimes.reserve(nrows);
+    pData.reserve(nrows * pNCols);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Recorder::clear()
+{
+    pTimes.clear();
+    pData.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // namespace solver
+} // namespace steps
+
+// END
@@ -0,0 +1,237 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_SOLVER_RECORDER_HPP
+#define STEPS_SOLVER_RECORDER_HPP 1
+
+// STL headers.
+#include <fstream>
+#include <string>
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/geom/fwd.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace solver {
+
+// Forward declarations
+class API;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Time-series recorder driving a solver.
+///
+/// A recorder holds a list of probes, each one a quantity of a species,
+/// reaction or membrane potential over a set of elements. Names are
+/// resolved once when a probe is added, so that sampling only calls the
+/// index based accessors of the solver and, for tet and triangle counts,
+/// its batch getters.
+///
+/// The recorder samples at a fixed interval or at a given list of time
+/// points. Its run() and advance() methods run the solver from one sample
+/// point to the next and append a row, made of every column of every
+/// probe in order, either to a contiguous in-memory buffer or to a binary
+/// stream file.
+///
+/// With a parallel solver every process must drive its own recorder in
+/// the same way, since sampling calls collective getters.
+///
+////////////////////////////////////////////////////////////////////////////////
+
+class Recorder
+{
+
+public:
+
+    /// Kind of element a probe samples.
+    enum Element {
+        COMP = 0,
+        PATCH,
+        TET,
+        TRI,
+        VERT,
+    };
+
+    /// Quantity a probe samples.
+    enum Quantity {
+        COUNT = 0,
+        CONC,
+        EXTENT,
+        V,
+    };
+
+    /// Constructor
+    ///
+    /// \param solver Solver to record from; must outlive the recorder.
+    Recorder(API * solver);
+
+    ////////////////////////////////////////////////////////////////////////
+    // PROBES
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Add a probe and return its index.
+    ///
+    /// \param e Kind of the elements.
+    /// \param indices Global indices of the elements (compartment or patch
+    ///                indices for COMP and PATCH).
+    /// \param q Quantity to sample.
+    /// \param name Species for COUNT and CONC, reaction (COMP) or surface
+    ///             reaction (PATCH) for EXTENT, unused for V.
+    uint addProbe(Element e, std::vector<index_t> const & indices,
+                  Quantity q, std::string const & name = "");
+
+    /// Return the number of probes.
+    inline uint countProbes() const noexcept
+    { return static_cast<uint>(pProbes.size()); }
+
+    /// Return the number of values in a row.
+    inline uint countColumns() const noexcept
+    { return pNCols; }
+
+    /// Return the first column of probe p in a row.
+    uint getProbeOffset(uint p) const;
+
+    ////////////////////////////////////////////////////////////////////////
+    // SAMPLING
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Sample every dt, starting from the current time of the solver.
+    void setSampleDT(double dt);
+
+    /// Sample at the given time points, in increasing order.
+    void setSamplePoints(std::vector<double> const & tpnts);
+
+    /// Write rows to a binary file instead of keeping them in memory.
+    ///
+    /// The file starts with the 8 bytes "STEPSREC", a 32 bit format version
+    /// and the 64 bit number of columns; each row follows as its time and
+    /// its values, all doubles.
+    void openStream(std::string const & file_name);
+
+    /// Flush and close the stream file, if any.
+    void closeStream();
+
+    /// Run the solver until endtime, sampling at every due sample point.
+    void run(double endtime);
+
+    /// Advance the solver by adv, sampling at every due sample point.
+    void advance(double adv);
+
+    /// Record a row at the current time of the solver.
+    void sample();
+
+    ////////////////////////////////////////////////////////////////////////
+    // DATA ACCESS
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Return the number of rows kept in memory.
+    inline std::size_t countSamples() const noexcept
+    { return pTimes.size(); }
+
+    /// Return the times of the rows kept in memory.
+    inline const std::vector<double> & getTimes() const noexcept
+    { return pTimes; }
+
+    /// Return the rows kept in memory, row-major.
+    inline const std::vector<double> & getData() const noexcept
+    { return pData; }
+
+    /// Copy the rows kept in memory to data, row-major.
+    void getDataNP(double * data, std::size_t output_size) const;
+
+    /// Reserve memory for nrows rows.
+    void reserve(std::size_t nrows);
+
+    /// Drop all rows kept in memory.
+    void clear();
+
+    ////////////////////////////////////////////////////////////////////////
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////
+
+    struct Probe
+    {
+        Element                         element;
+        Quantity                        quantity;
+        uint                            idx;
+        std::vector<index_t>            indices;
+        uint                            offset;
+    };
+
+    /// Time of the next sample point, or infinity if there is none.
+    double _nextSampleTime() const;
+
+    /// Move to the sample point after the current one.
+    void _popSampleTime();
+
+    /// Number of sample points in (getTime(), endtime].
+    std::size_t _countSampleTimes(double endtime) const;
+
+    void _sampleProbe(Probe const & p, double * out) const;
+
+    ////////////////////////////////////////////////////////////////////////
+
+    API *                               pSolver;
+
+    std::vector<Probe>                  pProbes;
+    uint                                pNCols{0};
+
+    // Fixed interval sampling: pStart + pStep * pDT.
+    double                              pDT{0.0};
+    double                              pStart{0.0};
+    std::size_t                         pStep{0};
+
+    // Sampling at given time points.
+    std::vector<double>                 pTPnts;
+    std::size_t                         pNextTPnt{0};
+
+    std::vector<double>                 pTimes;
+    std::vector<double>                 pData;
+
+    std::ofstream                       pStream;
+    std::vector<double>                 pRow;
+
+    ////////////////////////////////////////////////////////////////////////
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
+
+// STEPS_SOLVER_RECORDER_HPP
+
+// END
@@ -76,14 +76,14 @@ ssolver::SDiffBoundarydef::~SDiffBoundarydef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::SDiffBoundarydef::checkpoint(std::fstream & /*cp_file*/)
+void ssolver::SDiffBoundarydef::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::SDiffBoundarydef::restore(std::fstream & /*cp_file*/)
+void ssolver::SDiffBoundarydef::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
@@ -71,14 +71,14 @@ ssolver::Specdef::~Specdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Specdef::checkpoint(std::fstream & /*cp_file*/)
+void ssolver::Specdef::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Specdef::restore(std::fstream & /*cp_file*/)
+void ssolver::Specdef::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
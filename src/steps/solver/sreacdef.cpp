@@ -178,14 +178,14 @@ ssolver::SReacdef::~SReacdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::SReacdef::checkpoint(std::fstream & /*cp_file*/)
+void ssolver::SReacdef::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::SReacdef::restore(std::fstream & /*cp_file*/)
+void ssolver::SReacdef::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
@@ -35,6 +35,7 @@
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 // STEPS headers.
 #include "steps/common.h"
@@ -77,6 +78,8 @@ ssolver::Statedef::Statedef(steps::model::Model *m, steps::wm::Geom *g, const rn
     AssertLog(pModel != nullptr);
     AssertLog(pGeom != nullptr);
 
+    // Identifier lookups may already be needed while the defs are set up.
+    _buildIdxMaps();
 
     // Create the def objects.
     // NOTE: The order is very important. For example all objects after SpecDef need
@@ -248,6 +251,66 @@ ssolver::Statedef::Statedef(steps::model::Model *m, steps::wm::Geom *g, const rn
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ssolver::Statedef::_buildIdxMaps()
+{
+    uint nspecs = pModel->_countSpecs();
+    pSpecIdxMap.reserve(nspecs);
+    for (uint sidx = 0; sidx < nspecs; ++sidx)
+        pSpecIdxMap.emplace(pModel->_getSpec(sidx)->getID(), sidx);
+
+    uint ncomps = pGeom->_countComps();
+    pCompIdxMap.reserve(ncomps);
+    for (uint cidx = 0; cidx < ncomps; ++cidx)
+        pCompIdxMap.emplace(pGeom->_getComp(cidx)->getID(), cidx);
+
+    uint npatches = pGeom->_countPatches();
+    pPatchIdxMap.reserve(npatches);
+    for (uint pidx = 0; pidx < npatches; ++pidx)
+        pPatchIdxMap.emplace(pGeom->_getPatch(pidx)->getID(), pidx);
+
+    uint nreacs = pModel->_countReacs();
+    pReacIdxMap.reserve(nreacs);
+    for (uint ridx = 0; ridx < nreacs; ++ridx)
+        pReacIdxMap.emplace(pModel->_getReac(ridx)->getID(), ridx);
+
+    uint nsreacs = pModel->_countSReacs();
+    pSReacIdxMap.reserve(nsreacs);
+    for (uint sridx = 0; sridx < nsreacs; ++sridx)
+        pSReacIdxMap.emplace(pModel->_getSReac(sridx)->getID(), sridx);
+
+    uint nvdiffs = pModel->_countVDiffs();
+    pDiffIdxMap.reserve(nvdiffs);
+    for (uint didx = 0; didx < nvdiffs; ++didx)
+        pDiffIdxMap.emplace(pModel->_getVDiff(didx)->getID(), didx);
+
+    uint nsdiffs = pModel->_countSDiffs();
+    pSurfDiffIdxMap.reserve(nsdiffs);
+    for (uint didx = 0; didx < nsdiffs; ++didx)
+        pSurfDiffIdxMap.emplace(pModel->_getSDiff(didx)->getID(), didx);
+
+    uint nvdtrans = pModel->_countVDepTrans();
+    pVDepTransIdxMap.reserve(nvdtrans);
+    for (uint vdtidx = 0; vdtidx < nvdtrans; ++vdtidx)
+        pVDepTransIdxMap.emplace(pModel->_getVDepTrans(vdtidx)->getID(), vdtidx);
+
+    uint nvdsreacs = pModel->_countVDepSReacs();
+    pVDepSReacIdxMap.reserve(nvdsreacs);
+    for (uint vdsridx = 0; vdsridx < nvdsreacs; ++vdsridx)
+        pVDepSReacIdxMap.emplace(pModel->_getVDepSReac(vdsridx)->getID(), vdsridx);
+
+    uint nohmiccurrs = pModel->_countOhmicCurrs();
+    pOhmicCurrIdxMap.reserve(nohmiccurrs);
+    for (uint ocidx = 0; ocidx < nohmiccurrs; ++ocidx)
+        pOhmicCurrIdxMap.emplace(pModel->_getOhmicCurr(ocidx)->getID(), ocidx);
+
+    uint nghkcurrs = pModel->_countGHKcurrs();
+    pGHKcurrIdxMap.reserve(nghkcurrs);
+    for (uint ghkidx = 0; ghkidx < nghkcurrs; ++ghkidx)
+        pGHKcurrIdxMap.emplace(pModel->_getGHKcurr(ghkidx)->getID(), ghkidx);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ssolver::Statedef::~Statedef()
 {
     CompdefPVecCI c_end = pCompdefs.end();
@@ -296,7 +359,7 @@ ssolver::Statedef::~Statedef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Statedef::checkpoint(std::fstream & cp_file)
+void ssolver::Statedef::checkpoint(std::iostream & cp_file)
 {
 
     SpecdefPVecCI s_end = pSpecdefs.end();
@@ -374,7 +437,7 @@ void ssolver::Statedef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::Statedef::restore(std::fstream & cp_file)
+void ssolver::Statedef::restore(std::iostream & cp_file)
 {
 
     SpecdefPVecCI s_end = pSpecdefs.end();
@@ -463,15 +526,8 @@ ssolver::Compdef * ssolver::Statedef::compdef(uint gidx) const
 
 uint ssolver::Statedef::getCompIdx(std::string const & c) const
 {
-    uint maxcidx = pCompdefs.size();
-    AssertLog(maxcidx > 0);
-    AssertLog(maxcidx == pGeom->_countComps());
-    uint cidx = 0;
-    while(cidx < maxcidx)
-    {
-        if (c == pGeom->_getComp(cidx)->getID()) return cidx;
-        ++cidx;
-    }
+    auto it = pCompIdxMap.find(c);
+    if (it != pCompIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Geometry does not contain comp with string identifier '" << c << "'.";
     ArgErrLog(os.str());
@@ -508,14 +564,8 @@ ssolver::Patchdef * ssolver::Statedef::patchdef(uint gidx) const
 
 uint ssolver::Statedef::getPatchIdx(std::string const & p) const
 {
-    uint maxpidx = pPatchdefs.size();
-    AssertLog(maxpidx == pGeom->_countPatches());
-    uint pidx = 0;
-    while(pidx < maxpidx)
-    {
-        if (p == pGeom->_getPatch(pidx)->getID()) return pidx;
-        ++pidx;
-    }
+    auto it = pPatchIdxMap.find(p);
+    if (it != pPatchIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Geometry does not contain patch with string identifier '" << p << "'.";
     ArgErrLog(os.str());
@@ -550,15 +600,8 @@ ssolver::Specdef * ssolver::Statedef::specdef(uint gidx) const
 
 uint ssolver::Statedef::getSpecIdx(std::string const & s) const
 {
-    uint maxsidx = pSpecdefs.size();
-    AssertLog(maxsidx > 0);
-    AssertLog(maxsidx == pModel->_countSpecs());
-    uint sidx = 0;
-    while(sidx < maxsidx)
-    {
-        if (s == pModel->_getSpec(sidx)->getID()) return sidx;
-        ++sidx;
-    }
+    auto it = pSpecIdxMap.find(s);
+    if (it != pSpecIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain species with string identifier '" << s << "'.";
     ArgErrLog(os.str());
@@ -594,14 +637,8 @@ ssolver::Reacdef * ssolver::Statedef::reacdef(uint gidx) const
 
 uint ssolver::Statedef::getReacIdx(std::string const & r) const
 {
-    uint maxridx = pReacdefs.size();
-    AssertLog(maxridx == pModel->_countReacs());
-    uint ridx = 0;
-    while(ridx < maxridx)
-    {
-        if (r == pModel->_getReac(ridx)->getID()) return ridx;
-        ++ridx;
-    }
+    auto it = pReacIdxMap.find(r);
+    if (it != pReacIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain reac with string identifier '" << r <<"'.";
     ArgErrLog(os.str());
@@ -636,14 +673,8 @@ ssolver::SReacdef * ssolver::Statedef::sreacdef(uint gidx) const
 
 uint ssolver::Statedef::getSReacIdx(std::string const & sr) const
 {
-    uint maxsridx = pSReacdefs.size();
-    AssertLog(maxsridx == pModel->_countSReacs());
-    uint sridx = 0;
-    while(sridx < maxsridx)
-    {
-        if (sr == pModel->_getSReac(sridx)->getID()) return sridx;
-        ++sridx;
-    }
+    auto it = pSReacIdxMap.find(sr);
+    if (it != pSReacIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain sreac with string identifier '" << sr <<"'.";
     ArgErrLog(os.str());
@@ -678,14 +709,8 @@ ssolver::Diffdef * ssolver::Statedef::diffdef(uint gidx) const
 
 uint ssolver::Statedef::getDiffIdx(std::string const & d) const
 {
-    uint maxdidx = pDiffdefs.size();
-    AssertLog(maxdidx == pModel->_countVDiffs());
-    uint didx = 0;
-    while(didx < maxdidx)
-    {
-        if (d == pModel->_getVDiff(didx)->getID()) return didx;
-        ++didx;
-    }
+    auto it = pDiffIdxMap.find(d);
+    if (it != pDiffIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain diff with string identifier '" << d <<"'.";
     ArgErrLog(os.str());
@@ -720,14 +745,8 @@ ssolver::Diffdef * ssolver::Statedef::surfdiffdef(uint gidx) const
 
 uint ssolver::Statedef::getSurfDiffIdx(std::string const & d) const
 {
-    uint maxdidx = pSurfDiffdefs.size();
-    AssertLog(maxdidx == pModel->_countSDiffs());
-    uint didx = 0;
-    while(didx < maxdidx)
-    {
-        if (d == pModel->_getSDiff(didx)->getID()) return didx;
-        ++didx;
-    }
+    auto it = pSurfDiffIdxMap.find(d);
+    if (it != pSurfDiffIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain diff with string identifier '" << d <<"'.";
     ArgErrLog(os.str());
@@ -762,14 +781,8 @@ ssolver::OhmicCurrdef * ssolver::Statedef::ohmiccurrdef(uint gidx) const
 
 uint ssolver::Statedef::getOhmicCurrIdx(std::string const & oc) const
 {
-    uint maxocidx = pOhmicCurrdefs.size();
-    AssertLog(maxocidx == pModel->_countOhmicCurrs());
-    uint ocidx = 0;
-    while(ocidx < maxocidx)
-    {
-        if (oc == pModel->_getOhmicCurr(ocidx)->getID()) return ocidx;
-        ++ocidx;
-    }
+    auto it = pOhmicCurrIdxMap.find(oc);
+    if (it != pOhmicCurrIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain ohmic current with string identifier '" << oc <<"'.";
     ArgErrLog(os.str());
@@ -804,14 +817,8 @@ ssolver::VDepTransdef * ssolver::Statedef::vdeptransdef(uint gidx) const
 
 uint ssolver::Statedef::getVDepTransIdx(std::string const & vdt) const
 {
-    uint maxvdtidx = pVDepTransdefs.size();
-    AssertLog(maxvdtidx == pModel->_countVDepTrans());
-    uint vdtidx = 0;
-    while(vdtidx < maxvdtidx)
-    {
-        if (vdt == pModel->_getVDepTrans(vdtidx)->getID()) return vdtidx;
-        ++vdtidx;
-    }
+    auto it = pVDepTransIdxMap.find(vdt);
+    if (it != pVDepTransIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain voltage-dependent transition with string identifier '" << vdt <<"'.";
     ArgErrLog(os.str());
@@ -846,14 +853,8 @@ ssolver::VDepSReacdef * ssolver::Statedef::vdepsreacdef(uint gidx) const
 
 uint ssolver::Statedef::getVDepSReacIdx(std::string const & vdsr) const
 {
-    uint maxvdsridx = pVDepSReacdefs.size();
-    AssertLog(maxvdsridx == pModel->_countVDepSReacs());
-    uint vdsridx = 0;
-    while(vdsridx < maxvdsridx)
-    {
-        if (vdsr == pModel->_getVDepSReac(vdsridx)->getID()) return vdsridx;
-        ++vdsridx;
-    }
+    auto it = pVDepSReacIdxMap.find(vdsr);
+    if (it != pVDepSReacIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain voltage-dependent reaction with string identifier '" << vdsr <<"'.";
     ArgErrLog(os.str());
@@ -888,14 +889,8 @@ ssolver::GHKcurrdef * ssolver::Statedef::ghkcurrdef(uint gidx) const
 
 uint ssolver::Statedef::getGHKcurrIdx(std::string const & ghk) const
 {
-    uint maxghkidx = pGHKcurrdefs.size();
-    AssertLog(maxghkidx == pModel->_countGHKcurrs());
-    uint ghkidx = 0;
-    while(ghkidx < maxghkidx)
-    {
-        if (ghk == pModel->_getGHKcurr(ghkidx)->getID()) return ghkidx;
-        ++ghkidx;
-    }
+    auto it = pGHKcurrIdxMap.find(ghk);
+    if (it != pGHKcurrIdxMap.end()) return it->second;
     std::ostringstream os;
     os << "Model does not contain ghk current with string identifier '" << ghk <<"'.";
     ArgErrLog(os.str());
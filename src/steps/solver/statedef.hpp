@@ -37,6 +37,7 @@
 
 // STL headers.
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <fstream>
 
@@ -180,10 +181,10 @@ public:
     uint getMembIdx(std::string const & m) const;
 
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file);
+    void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    void restore(std::fstream & cp_file);
+    void restore(std::iostream & cp_file);
 
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS: COMPARTMENTS
@@ -625,6 +626,25 @@ private:
     std::vector<OhmicCurrdef *>         pOhmicCurrdefs;
     std::vector<GHKcurrdef *>           pGHKcurrdefs;
 
+    /// String identifier to global index, built once at construction so
+    /// that the string based lookups do not scan the model or geometry.
+    typedef std::unordered_map<std::string, uint> IdxMap;
+
+    /// Build the identifier to index maps.
+    void _buildIdxMaps();
+
+    IdxMap                              pSpecIdxMap;
+    IdxMap                              pCompIdxMap;
+    IdxMap                              pPatchIdxMap;
+    IdxMap                              pReacIdxMap;
+    IdxMap                              pSReacIdxMap;
+    IdxMap                              pDiffIdxMap;
+    IdxMap                              pSurfDiffIdxMap;
+    IdxMap                              pVDepTransIdxMap;
+    IdxMap                              pVDepSReacIdxMap;
+    IdxMap                              pOhmicCurrIdxMap;
+    IdxMap                              pGHKcurrIdxMap;
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
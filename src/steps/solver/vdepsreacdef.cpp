@@ -197,7 +197,7 @@ ssolver::VDepSReacdef::~VDepSReacdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::VDepSReacdef::checkpoint(std::fstream & cp_file)
+void ssolver::VDepSReacdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pVMin), sizeof(double));
     cp_file.write(reinterpret_cast<char*>(&pVMax), sizeof(double));
@@ -206,7 +206,7 @@ void ssolver::VDepSReacdef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::VDepSReacdef::restore(std::fstream & cp_file)
+void ssolver::VDepSReacdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pVMin), sizeof(double));
     cp_file.read(reinterpret_cast<char*>(&pVMax), sizeof(double));
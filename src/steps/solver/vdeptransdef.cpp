@@ -108,7 +108,7 @@ ssolver::VDepTransdef::~VDepTransdef()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::VDepTransdef::checkpoint(std::fstream & cp_file)
+void ssolver::VDepTransdef::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pVMin), sizeof(double));
     cp_file.write(reinterpret_cast<char*>(&pVMax), sizeof(double));
@@ -117,7 +117,7 @@ void ssolver::VDepTransdef::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void ssolver::VDepTransdef::restore(std::fstream & cp_file)
+void ssolver::VDepTransdef::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pVMin), sizeof(double));
     cp_file.read(reinterpret_cast<char*>(&pVMax), sizeof(double));
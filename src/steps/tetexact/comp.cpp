@@ -64,14 +64,14 @@ stex::Comp::~Comp()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Comp::checkpoint(std::fstream & /*cp_file*/)
+void stex::Comp::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Comp::restore(std::fstream & /*cp_file*/)
+void stex::Comp::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
@@ -56,6 +56,7 @@ pDiffdef(ddef)
 {
     AssertLog(pDiffdef != nullptr);
     AssertLog(pTet != nullptr);
+    type = KP_DIFF;
     std::array<stex::Tet*, 4> next{pTet->nextTet(0),
                                     pTet->nextTet(1),
                                     pTet->nextTet(2),
@@ -114,7 +115,7 @@ stex::Diff::~Diff()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Diff::checkpoint(std::fstream & cp_file)
+void stex::Diff::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -141,7 +142,7 @@ void stex::Diff::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Diff::restore(std::fstream & cp_file)
+void stex::Diff::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -187,7 +188,7 @@ void stex::Diff::setupDeps()
     // kprocs.
 
     // Search for dependencies in the 'source' tetrahedron.
-    std::set<stex::KProc*> local;
+    stex::KProcPSet local;
 
     for (auto const& k: pTet->kprocs()) {
         // Check locally.
@@ -222,7 +223,7 @@ void stex::Diff::setupDeps()
         }
 
         // Copy local dependencies.
-        std::set<stex::KProc*> local2(local.begin(), local.end());
+        stex::KProcPSet local2(local.begin(), local.end());
 
         // Find the ones 'locally' in the next tet.
         for (auto const& k: next->kprocs()) {
@@ -463,7 +464,7 @@ std::vector<stex::KProc*> const & stex::Diff::apply(const rng::RNGptr &rng, doub
 
 
     // Apply local change.
-    auto * local = pTet->pools().data() + lidxTet;
+    auto * local = pTet->pools() + lidxTet;
     bool clamped = pTet->clamped(lidxTet);
 
     if (clamped == false)
@@ -486,8 +487,13 @@ std::vector<stex::KProc*> const & stex::Diff::apply(const rng::RNGptr &rng, doub
     AssertLog(nexttet != nullptr);
     AssertLog(pNeighbCompLidx[iSel] != solver::LIDX_UNDEFINED);
 
-    if (nexttet->clamped(pNeighbCompLidx[iSel]) == false)
-        nexttet->incCount(pNeighbCompLidx[iSel],1);
+    if (nexttet->clamped(pNeighbCompLidx[iSel]) == false) {
+        // The owner of another sub-domain applies the change in turn.
+        if (nexttet->getDomain() != pTet->getDomain())
+            pTet->solver()->registerDomainChange(pTet->getDomain(), nexttet, pNeighbCompLidx[iSel]);
+        else
+            nexttet->incCount(pNeighbCompLidx[iSel],1);
+    }
 
     if (clamped == false)
         pTet->incCount(lidxTet, -1);
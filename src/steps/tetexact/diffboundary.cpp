@@ -57,14 +57,14 @@ stex::DiffBoundary::~DiffBoundary() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::DiffBoundary::checkpoint(std::fstream & /*cp_file*/)
+void stex::DiffBoundary::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::DiffBoundary::restore(std::fstream & /*cp_file*/)
+void stex::DiffBoundary::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
@@ -62,6 +62,7 @@ stex::GHKcurr::GHKcurr(ssolver::GHKcurrdef * ghkdef, stex::Tri * tri)
 {
     AssertLog(pGHKcurrdef != nullptr);
     AssertLog(pTri != nullptr);
+    type = KP_GHK;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -70,7 +71,7 @@ stex::GHKcurr::~GHKcurr() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::GHKcurr::checkpoint(std::fstream & cp_file)
+void stex::GHKcurr::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -84,7 +85,7 @@ void stex::GHKcurr::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::GHKcurr::restore(std::fstream & cp_file)
+void stex::GHKcurr::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -113,7 +114,7 @@ void stex::GHKcurr::reset()
 
 void stex::GHKcurr::setupDeps()
 {
-    std::set<stex::KProc*> updset;
+    stex::KProcPSet updset;
 
     // The only concentration changes for a GHK current event are in the outer
     // and inner volume. The flux can involve movement of ion from either
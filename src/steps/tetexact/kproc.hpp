@@ -32,6 +32,7 @@
 
 
 // STL headers.
+#include <set>
 #include <vector>
 #include <fstream>
 
@@ -39,6 +40,7 @@
 #include "steps/common.h"
 #include "steps/solver/types.hpp"
 #include "steps/rng/rng.hpp"
+#include "steps/util/epoch_dedup.hpp"
 //#include "tetexact.hpp"
 
 // Tetexact CR header
@@ -67,6 +69,10 @@ typedef KProcPVec::const_iterator       KProcPVecCI;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+enum TYPE {KP_REAC, KP_SREAC, KP_DIFF, KP_SDIFF, KP_GHK, KP_VDEPSREAC, KP_VDEPTRANS};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class KProc
 
 {
@@ -83,10 +89,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    virtual void checkpoint(std::fstream & cp_file) = 0;
+    virtual void checkpoint(std::iostream & cp_file) = 0;
 
     /// restore data
-    virtual void restore(std::fstream & cp_file) = 0;
+    virtual void restore(std::iostream & cp_file) = 0;
 
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS
@@ -112,6 +118,22 @@ public:
     void setSchedIDX(uint idx)
     { pSchedIDX = idx; }
 
+    /// Stamp used by steps::util::epoch_dedup when collecting kprocs.
+    steps::util::dedup_epoch_t & dedupEpoch(unsigned /*slot*/) noexcept
+    { return pDedupEpoch; }
+
+    /// Concrete kind of the kproc, used by Tetexact to call rate() and
+    /// apply() without going through the vtable.
+    uint getType() const noexcept
+    { return type; }
+
+    /// Sub-domain the kproc is simulated in; see Tetexact::setNThreads().
+    uint getDomain() const noexcept
+    { return pDomain; }
+
+    void setDomain(uint domain) noexcept
+    { pDomain = domain; }
+
     ////////////////////////////////////////////////////////////////////////
     // VIRTUAL INTERFACE METHODS
     ////////////////////////////////////////////////////////////////////////
@@ -157,6 +179,9 @@ public:
 
     unsigned long long getExtent() const;
     void resetExtent();
+    /// Used to roll a sub-domain back to an earlier state.
+    void setExtent(unsigned long long extent) noexcept
+    { rExtent = extent; }
 
     ////////////////////////////////////////////////////////////////////////
     /*
@@ -183,11 +208,29 @@ protected:
 
     uint                                pSchedIDX{};
 
+    steps::util::dedup_epoch_t          pDedupEpoch{0};
+
+    uint                                pDomain{0};
+
+    uint                                type{KP_REAC};
+
     ////////////////////////////////////////////////////////////////////////
 };
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Orders kprocs by schedule index rather than by address, so that the
+/// dependency lists built from a set are the same in every solver instance.
+struct KProcSchedLess
+{
+    bool operator()(KProc const * a, KProc const * b) const noexcept
+    { return a->schedIDX() < b->schedIDX(); }
+};
+
+typedef std::set<KProcP, KProcSchedLess> KProcPSet;
+
+////////////////////////////////////////////////////////////////////////////////
+
 }
 }
 
@@ -60,14 +60,14 @@ stex::Patch::~Patch() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Patch::checkpoint(std::fstream & /*cp_file*/)
+void stex::Patch::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Patch::restore(std::fstream & /*cp_file*/)
+void stex::Patch::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
@@ -77,6 +77,7 @@ stex::Reac::Reac(ssolver::Reacdef * rdef, stex::WmVol * tet)
 {
     AssertLog(pReacdef != nullptr);
     AssertLog(pTet != nullptr);
+    type = KP_REAC;
 
     uint lridx = pTet->compdef()->reacG2L(pReacdef->gidx());
     double kcst = pTet->compdef()->kcst(lridx);
@@ -91,7 +92,7 @@ stex::Reac::~Reac() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Reac::checkpoint(std::fstream & cp_file)
+void stex::Reac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -107,7 +108,7 @@ void stex::Reac::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Reac::restore(std::fstream & cp_file)
+void stex::Reac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -161,7 +162,7 @@ void stex::Reac::setKcst(double k)
 
 void stex::Reac::setupDeps()
 {
-    std::set<stex::KProc*> updset;
+    stex::KProcPSet updset;
 
     // Search in local tetrahedron.
     for (auto const& k : pTet->kprocs()) {
@@ -212,51 +213,10 @@ double stex::Reac::rate(steps::tetexact::Tetexact * /*solver*/)
 {
     if (inactive()) return 0.0;
 
-    // Prefetch some variables.
+    // Compute combinatorial part from the compiled reactant list.
     ssolver::Compdef * cdef = pTet->compdef();
-    uint nspecs = cdef->countSpecs();
-    uint * lhs_vec = cdef->reac_lhs_bgn(cdef->reacG2L(pReacdef->gidx()));
-    auto const& cnt_vec = pTet->pools();
-
-    // Compute combinatorial part.
-    double h_mu = 1.0;
-    for (uint pool = 0; pool < nspecs; ++pool)
-    {
-        uint lhs = lhs_vec[pool];
-        if (lhs == 0) { continue;
-}
-        uint cnt = cnt_vec[pool];
-        if (lhs > cnt)
-        {
-            h_mu = 0.0;
-            break;
-        }
-        switch (lhs)
-        {
-            case 4:
-            {
-                h_mu *= static_cast<double>(cnt - 3);
-            }
-            case 3:
-            {
-                h_mu *= static_cast<double>(cnt - 2);
-            }
-            case 2:
-            {
-                h_mu *= static_cast<double>(cnt - 1);
-            }
-            case 1:
-            {
-                h_mu *= static_cast<double>(cnt);
-                break;
-            }
-            default:
-            {
-                AssertLog(0);
-                return 0.0;
-            }
-        }
-    }
+    auto const& prog = cdef->reac_prog(cdef->reacG2L(pReacdef->gidx()));
+    double h_mu = prog.h(pTet->pools());
 
     // Multiply with scaled reaction constant.
     return h_mu * pCcst;
@@ -268,16 +228,12 @@ std::vector<stex::KProc*> const & stex::Reac::apply(const rng::RNGptr &/*rng*/,
 {
     auto const& local = pTet->pools();
     ssolver::Compdef * cdef = pTet->compdef();
-    uint l_ridx = cdef->reacG2L(pReacdef->gidx());
-    int * upd_vec = cdef->reac_upd_bgn(l_ridx);
-    uint nspecs = cdef->countSpecs();
-    for (uint i = 0; i < nspecs; ++i)
+    auto const& prog = cdef->reac_prog(cdef->reacG2L(pReacdef->gidx()));
+    for (auto const& t : prog.upd())
     {
-        if (pTet->clamped(i)) continue;
-        int j = upd_vec[i];
-        if (j == 0) continue;
-        int nc = static_cast<int>(local[i]) + j;
-        pTet->setCount(i, static_cast<uint>(nc));
+        if (pTet->clamped(t.lidx)) continue;
+        int nc = static_cast<int>(local[t.lidx]) + t.upd;
+        pTet->setCount(t.lidx, static_cast<uint>(nc));
     }
     rExtent++;
     return pUpdVec;
@@ -62,6 +62,7 @@ stex::SDiff::SDiff(ssolver::Diffdef * sdef, stex::Tri * tri)
 {
     AssertLog(pSDiffdef != nullptr);
     AssertLog(pTri != nullptr);
+    type = KP_SDIFF;
     std::array<stex::Tri *, 3> next{pTri->nextTri(0),
                                     pTri->nextTri(1),
                                     pTri->nextTri(2)
@@ -117,7 +118,7 @@ stex::SDiff::~SDiff()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::SDiff::checkpoint(std::fstream & cp_file)
+void stex::SDiff::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -145,7 +146,7 @@ void stex::SDiff::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::SDiff::restore(std::fstream & cp_file)
+void stex::SDiff::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -190,7 +191,7 @@ void stex::SDiff::setupDeps()
 
 
     // Search for dependencies in the 'source' triangle.
-    std::set<stex::KProc*> local;
+    stex::KProcPSet local;
 
     for (auto const& k :pTri->kprocs()) {
         // Check locally.
@@ -224,7 +225,7 @@ void stex::SDiff::setupDeps()
         }
 
         // Copy local dependencies.
-        std::set<stex::KProc*> local2(local.begin(), local.end());
+        stex::KProcPSet local2(local.begin(), local.end());
 
         // Find the ones 'locally' in the next tri.
         for (auto const& k : next->kprocs()) {
@@ -458,8 +459,13 @@ std::vector<stex::KProc*> const & stex::SDiff::apply(const rng::RNGptr &rng, dou
     AssertLog(nexttri != nullptr);
     AssertLog(pNeighbPatchLidx[iSel] != ssolver::LIDX_UNDEFINED);
 
-    if (nexttri->clamped(pNeighbPatchLidx[iSel]) == false)
-        nexttri->incCount(pNeighbPatchLidx[iSel],1);
+    if (nexttri->clamped(pNeighbPatchLidx[iSel]) == false) {
+        // The owner of another sub-domain applies the change in turn.
+        if (nexttri->getDomain() != pTri->getDomain())
+            pTri->solver()->registerDomainChange(pTri->getDomain(), nexttri, pNeighbPatchLidx[iSel]);
+        else
+            nexttri->incCount(pNeighbPatchLidx[iSel],1);
+    }
 
     if (clamped == false)
         pTri->incCount(lidxTri, -1);
@@ -62,14 +62,14 @@ stex::SDiffBoundary::~SDiffBoundary()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::SDiffBoundary::checkpoint(std::fstream & /*cp_file*/)
+void stex::SDiffBoundary::checkpoint(std::iostream & /*cp_file*/)
 {
     // reserve
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::SDiffBoundary::restore(std::fstream & /*cp_file*/)
+void stex::SDiffBoundary::restore(std::iostream & /*cp_file*/)
 {
     // reserve
 }
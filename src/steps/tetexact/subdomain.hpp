@@ -0,0 +1,162 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_TETEXACT_SUBDOMAIN_HPP
+#define STEPS_TETEXACT_SUBDOMAIN_HPP 1
+
+// STL headers.
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/rng/rng.hpp"
+#include "steps/tetexact/crstruct.hpp"
+#include "steps/tetexact/kproc.hpp"
+#include "steps/util/epoch_dedup.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetexact {
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Forward declarations.
+class WmVol;
+class Tri;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Molecule moved by diffusion into an element of another sub-domain.
+struct DomainChange
+{
+    /// Time of the diffusion event.
+    double                              time;
+    /// Destination, a tet if tet is not null and a triangle otherwise, and
+    /// local index of the species.
+    WmVol                             * tet;
+    Tri                               * tri;
+    uint                                lidx;
+
+    bool operator==(DomainChange const & c) const noexcept
+    { return time == c.time && tet == c.tet && tri == c.tri && lidx == c.lidx; }
+    bool operator!=(DomainChange const & c) const noexcept
+    { return !(*this == c); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Part of the mesh simulated by its own exact SSA in a partitioned run
+/// of Tetexact; see Tetexact::setNThreads().
+///
+/// A sub-domain owns the CR SSA groups of its kprocs and its own random
+/// stream, and keeps the time of its next event between synchronisation
+/// windows. Diffusion into another sub-domain is recorded in changes and
+/// applied by the destination at the time of the event.
+///
+/// Each window starts from a saved state. Whenever the changes received
+/// turn out to differ from the ones the window was simulated with, the
+/// sub-domain goes back to that state and simulates the window again.
+///
+struct SubDomain
+{
+    SubDomain() = default;
+    SubDomain(SubDomain const &) = delete;
+    SubDomain & operator=(SubDomain const &) = delete;
+
+    ~SubDomain()
+    { clearGroups(); }
+
+    void clearGroups()
+    {
+        for (auto& g: nGroups) {
+            g->free_indices();
+            delete g;
+        }
+        nGroups.clear();
+        for (auto& g: pGroups) {
+            g->free_indices();
+            delete g;
+        }
+        pGroups.clear();
+        a0 = 0.0;
+    }
+
+    // Position in the sub-domains of the solver.
+    uint                                index{0};
+    steps::rng::RNGptr                  rng;
+
+    // Elements and kprocs of the sub-domain.
+    std::vector<WmVol*>                 vols;
+    std::vector<Tri*>                   tris;
+    std::vector<KProc*>                 kprocs;
+
+    // CR SSA groups and total propensity of the kprocs of the sub-domain.
+    std::vector<CRGroup*>               nGroups;
+    std::vector<CRGroup*>               pGroups;
+    double                              a0{0.0};
+
+    // Scratch collection of the kprocs to update after a received change.
+    steps::util::epoch_dedup<KProc>     updKProcs;
+
+    // Time of the last event applied and of the next event of the
+    // sub-domain itself, and number of events of the current window.
+    double                              time{0.0};
+    double                              next{0.0};
+    uint                                nsteps{0};
+
+    // Changes of the current window sent to every sub-domain, and changes
+    // received, sorted by time, that the window was last simulated with.
+    std::vector<std::vector<DomainChange> > changes;
+    std::vector<DomainChange>           received;
+
+    // State at the start of the window.
+    struct Saved
+    {
+        std::vector<uint>               counts;
+        std::vector<unsigned long long> extents;
+        std::vector<CRKProcData>        crData;
+        // Negative then positive groups.
+        uint                            nNegGroups{0};
+        std::vector<uint>               groupSizes;
+        std::vector<double>             groupSums;
+        std::vector<KProc*>             groupIndices;
+        std::vector<uint>               rngState;
+        double                          a0{0.0};
+        double                          time{0.0};
+        double                          next{0.0};
+    }                                   saved;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+#endif // STEPS_TETEXACT_SUBDOMAIN_HPP
+
+// END
@@ -108,7 +108,7 @@ Tet::~Tet()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Tet::checkpoint(std::fstream & cp_file)
+void Tet::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(pDiffBndDirection), sizeof(bool) * 4);
     WmVol::checkpoint(cp_file);
@@ -116,7 +116,7 @@ void Tet::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Tet::restore(std::fstream & cp_file)
+void Tet::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(pDiffBndDirection), sizeof(bool) * 4);
     WmVol::restore(cp_file);
@@ -166,6 +166,8 @@ void Tet::setNextTri(uint i, Tri * t)
 
 void Tet::setupKProcs(Tetexact * tex)
 {
+    setSolver(tex);
+
     uint j = 0;
 
     // Create reaction kproc's.
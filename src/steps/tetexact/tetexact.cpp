@@ -33,8 +33,10 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <exception>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <queue>
 #include <sstream>
 #include <vector>
@@ -43,8 +45,10 @@
 #include "steps/common.h"
 #include "steps/error.hpp"
 #include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tetpartition.hpp"
 #include "steps/math/constants.hpp"
 #include "steps/math/point.hpp"
+#include "steps/rng/create.hpp"
 #include "steps/solver/chandef.hpp"
 #include "steps/solver/compdef.hpp"
 #include "steps/solver/diffboundarydef.hpp"
@@ -54,6 +58,7 @@
 #include "steps/solver/patchdef.hpp"
 #include "steps/solver/reacdef.hpp"
 #include "steps/solver/sdiffboundarydef.hpp"
+#include "steps/solver/specdef.hpp"
 #include "steps/solver/sreacdef.hpp"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/types.hpp"
@@ -75,6 +80,7 @@
 #include "steps/tetexact/vdepsreac.hpp"
 #include "steps/tetexact/vdeptrans.hpp"
 #include "steps/tetexact/wmvol.hpp"
+#include "steps/util/checkpoint.hpp"
 #include "steps/util/collections.hpp"
 #include "steps/util/distribute.hpp"
 
@@ -84,6 +90,10 @@
 // logging
 #include "easylogging++.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace ssolver = steps::solver;
@@ -104,6 +114,43 @@ void schedIDXSet_To_Vec(SchedIDXSet const & s, SchedIDXVec & v)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Per-type dispatch of the SSA hot loop: the qualified calls bypass the
+// vtable, and the switch lets the compiler use a jump table.
+inline double kprocRate(KProc * kp, Tetexact * solver)
+{
+    switch (kp->getType()) {
+        case KP_REAC:       return static_cast<Reac*>(kp)->Reac::rate(solver);
+        case KP_SREAC:      return static_cast<SReac*>(kp)->SReac::rate(solver);
+        case KP_DIFF:       return static_cast<Diff*>(kp)->Diff::rate(solver);
+        case KP_SDIFF:      return static_cast<SDiff*>(kp)->SDiff::rate(solver);
+        case KP_GHK:        return static_cast<GHKcurr*>(kp)->GHKcurr::rate(solver);
+        case KP_VDEPSREAC:  return static_cast<VDepSReac*>(kp)->VDepSReac::rate(solver);
+        case KP_VDEPTRANS:  return static_cast<VDepTrans*>(kp)->VDepTrans::rate(solver);
+        default:            return kp->rate(solver);
+    }
+}
+
+inline std::vector<KProc*> const & kprocApply(KProc * kp, const rng::RNGptr & rng,
+                                              double dt, double simtime)
+{
+    switch (kp->getType()) {
+        case KP_REAC:       return static_cast<Reac*>(kp)->Reac::apply(rng, dt, simtime);
+        case KP_SREAC:      return static_cast<SReac*>(kp)->SReac::apply(rng, dt, simtime);
+        case KP_DIFF:       return static_cast<Diff*>(kp)->Diff::apply(rng, dt, simtime);
+        case KP_SDIFF:      return static_cast<SDiff*>(kp)->SDiff::apply(rng, dt, simtime);
+        case KP_GHK:        return static_cast<GHKcurr*>(kp)->GHKcurr::apply(rng, dt, simtime);
+        case KP_VDEPSREAC:  return static_cast<VDepSReac*>(kp)->VDepSReac::apply(rng, dt, simtime);
+        case KP_VDEPTRANS:  return static_cast<VDepTrans*>(kp)->VDepTrans::apply(rng, dt, simtime);
+        default:            return kp->apply(rng, dt, simtime);
+    }
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 Tetexact::Tetexact(steps::model::Model *m, steps::wm::Geom *g, const rng::RNGptr &r,
                    int calcMembPot)
 : API(m, g, r)
@@ -157,10 +204,8 @@ Tetexact::~Tetexact()
 void Tetexact::checkpoint(std::string const & file_name)
 {
     CLOG(INFO, "general_log") << "Checkpoint to " << file_name  << "...";
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    steps::util::CheckpointWriter cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     statedef().checkpoint(cp_file);
 
@@ -253,7 +298,7 @@ void Tetexact::checkpoint(std::string const & file_name)
         }
     }
 
-    cp_file.close();
+    cp.write();
     CLOG(INFO, "general_log") << "complete.\n";
 }
 
@@ -261,12 +306,8 @@ void Tetexact::checkpoint(std::string const & file_name)
 
 void Tetexact::restore(std::string const & file_name)
 {
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                std::fstream::in | std::fstream::binary);
-
-    cp_file.seekg(0);
+    steps::util::CheckpointReader cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     statedef().restore(cp_file);
 
@@ -389,8 +430,7 @@ void Tetexact::restore(std::string const & file_name)
         }
     }
 
-    cp_file.close();
-
+    cp.finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -957,6 +997,8 @@ void Tetexact::_setup()
             _tri(tris[t])->setSDiffBndDirection(tris_direction[t]);
     }
 
+    _setupVoxelStore();
+
     for (auto const& t: pTets)
         if (t) t->setupKProcs(this);
 
@@ -989,7 +1031,10 @@ void Tetexact::_setup()
     }
 
     // Create EField structures if EField is to be calculated
-    if (efflag()) _setupEField();
+    if (efflag()) {
+        _setupEField();
+        _setupVDepKProcs();
+    }
 
     nEntries = pKProcs.size();
 
@@ -999,6 +1044,66 @@ void Tetexact::_setup()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Tetexact::_setupVoxelStore()
+{
+    // Tets are laid out in mesh order, so that neighbouring tets (with a
+    // reasonably ordered mesh) end up close in memory, followed by the
+    // well-mixed volumes and the patch triangles.
+    std::vector<std::size_t> tet_offsets(pTets.size());
+    std::vector<std::size_t> wmvol_offsets(pWmVols.size());
+    std::vector<std::size_t> tri_offsets(pTris.size());
+
+    for (auto t = 0u; t < pTets.size(); ++t) {
+        if (pTets[t] == nullptr) continue;
+        tet_offsets[t] = pVoxelStore.reserve(pTets[t]->compdef()->countSpecs());
+    }
+    for (auto w = 0u; w < pWmVols.size(); ++w) {
+        if (pWmVols[w] == nullptr) continue;
+        wmvol_offsets[w] = pVoxelStore.reserve(pWmVols[w]->compdef()->countSpecs());
+    }
+    for (auto t = 0u; t < pTris.size(); ++t) {
+        if (pTris[t] == nullptr) continue;
+        tri_offsets[t] = pVoxelStore.reserve(pTris[t]->patchdef()->countSpecs());
+    }
+
+    pVoxelStore.allocate();
+
+    for (auto t = 0u; t < pTets.size(); ++t) {
+        if (pTets[t] == nullptr) continue;
+        pTets[t]->setPoolStorage(pVoxelStore.counts(tet_offsets[t]),
+                                 pVoxelStore.flags(tet_offsets[t]));
+    }
+    for (auto w = 0u; w < pWmVols.size(); ++w) {
+        if (pWmVols[w] == nullptr) continue;
+        pWmVols[w]->setPoolStorage(pVoxelStore.counts(wmvol_offsets[w]),
+                                   pVoxelStore.flags(wmvol_offsets[w]));
+    }
+    for (auto t = 0u; t < pTris.size(); ++t) {
+        if (pTris[t] == nullptr) continue;
+        pTris[t]->setPoolStorage(pVoxelStore.counts(tri_offsets[t]),
+                                 pVoxelStore.flags(tri_offsets[t]));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_setupVDepKProcs()
+{
+    pVDepKProcs.clear();
+
+    // Tri::setupKProcs() stores the voltage-dependent kprocs last.
+    for (auto const& t: pTris) {
+        if (!t) continue;
+        ssolver::Patchdef * pdef = t->patchdef();
+        uint nvdep = pdef->countVDepTrans() + pdef->countVDepSReacs() + pdef->countGHKcurrs();
+        auto const& kprocs = t->kprocs();
+        AssertLog(nvdep <= kprocs.size());
+        pVDepKProcs.insert(pVDepKProcs.end(), kprocs.end() - nvdep, kprocs.end());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Tetexact::_setupEField()
 {
     using steps::math::point3d;
@@ -1421,7 +1526,10 @@ void Tetexact::run(double endtime)
             os << "Endtime is before current simulation time";
             ArgErrLog(os.str());
         }
-        while (statedef().time() < endtime)
+        if (!pDomains.empty()) {
+            _runDomains(endtime);
+        }
+        else while (statedef().time() < endtime)
         {
             KProc * kp = _getNext();
             if (kp == nullptr) break;
@@ -1508,8 +1616,8 @@ void Tetexact::run(double endtime)
 
             pEField->advance(ef_dt);
 
-            // TODO: Replace this with something that only resets voltage-dependent things
-            _update();
+            // Only the voltage-dependent rates change with the potential.
+            _update(pVDepKProcs.begin(), pVDepKProcs.end());
         }
     }
 
@@ -2289,21 +2397,31 @@ void Tetexact::_build()
 ////////////////////////////////////////////////////////////////////////////////
 
 steps::tetexact::KProc * Tetexact::_getNext() const
+{
+    return _getNext(pA0, nGroups, pGroups, rng());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+steps::tetexact::KProc * Tetexact::_getNext(double a0,
+                                            std::vector<CRGroup*> const & ngroups,
+                                            std::vector<CRGroup*> const & pgroups,
+                                            const rng::RNGptr & r)
 {
 
-    AssertLog(pA0 >= 0.0);
+    AssertLog(a0 >= 0.0);
     // Quick check to see whether nothing is there.
-    if (pA0 == 0.0) return nullptr;
+    if (a0 == 0.0) return nullptr;
 
-    double selector = pA0 * rng()->getUnfII();
+    double selector = a0 * r->getUnfII();
 
     double partial_sum = 0.0;
 
-    const auto n_neg_groups = nGroups.size();
-    const auto n_pos_groups = pGroups.size();
+    const auto n_neg_groups = ngroups.size();
+    const auto n_pos_groups = pgroups.size();
 
     for (uint i = 0; i < n_neg_groups; i++) {
-        CRGroup* group = nGroups[i];
+        CRGroup* group = ngroups[i];
         if (group->size == 0) continue;
 
         if (selector > partial_sum + group->sum) {
@@ -2313,14 +2431,14 @@ steps::tetexact::KProc * Tetexact::_getNext() const
         }
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * r->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = r->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * r->getUnfII();
+            random_pos = r->get() % group_size;
             random_kp = group->indices[random_pos];
         }
 
@@ -2329,7 +2447,7 @@ steps::tetexact::KProc * Tetexact::_getNext() const
 
 
     for (uint i = 0; i < n_pos_groups; i++) {
-        CRGroup* group = pGroups[i];
+        CRGroup* group = pgroups[i];
         if (group->size == 0) continue;
 
         if (selector > partial_sum + group->sum) {
@@ -2338,15 +2456,15 @@ steps::tetexact::KProc * Tetexact::_getNext() const
         }
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * r->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = r->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * r->getUnfII();
+            random_pos = r->get() % group_size;
             random_kp = group->indices[random_pos];
         }
 
@@ -2356,19 +2474,19 @@ steps::tetexact::KProc * Tetexact::_getNext() const
     // Precision rounding error force clean up
     // Force the search in the last non-empty group
     for (int i = n_pos_groups - 1; i >= 0; i--) {
-        CRGroup* group = pGroups[i];
+        CRGroup* group = pgroups[i];
         if (group->size == 0) continue;
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * r->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = r->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * r->getUnfII();
+            random_pos = r->get() % group_size;
             random_kp = group->indices[random_pos];
 
         }
@@ -2377,20 +2495,20 @@ steps::tetexact::KProc * Tetexact::_getNext() const
     }
 
     for (int i = n_neg_groups - 1; i >= 0; i--) {
-        CRGroup* group = nGroups[i];
+        CRGroup* group = ngroups[i];
         if (group->size == 0) continue;
 
         double g_max = group->max;
-        double random_rate = g_max * rng()->getUnfII();;
+        double random_rate = g_max * r->getUnfII();;
         uint group_size = group->size;
-        uint random_pos = rng()->get() % group_size;
+        uint random_pos = r->get() % group_size;
         KProc* random_kp = group->indices[random_pos];
 
 
 
         while (random_kp->crData.rate <= random_rate) {
-            random_rate = g_max * rng()->getUnfII();
-            random_pos = rng()->get() % group_size;
+            random_rate = g_max * r->getUnfII();
+            random_pos = r->get() % group_size;
             random_kp = group->indices[random_pos];
 
         }
@@ -2402,7 +2520,7 @@ steps::tetexact::KProc * Tetexact::_getNext() const
 
     std::ostringstream os;
     os << "Cannot find any suitable entry.\n";
-    os << "A0: " << std::setprecision (15) << pA0 << "\n";
+    os << "A0: " << std::setprecision (15) << a0 << "\n";
     os << "Selector: " << std::setprecision (15) << selector << "\n";
     os << "Current Partial Sum: " << std::setprecision (15) << partial_sum << "\n";
 
@@ -2410,11 +2528,11 @@ steps::tetexact::KProc * Tetexact::_getNext() const
     os << "Negative groups\n";
 
     for (uint i = 0; i < n_neg_groups; i++) {
-        os << i << ": " << std::setprecision (15) << nGroups[i]->sum << "\n";
+        os << i << ": " << std::setprecision (15) << ngroups[i]->sum << "\n";
     }
     os << "Positive groups\n";
     for (uint i = 0; i < n_pos_groups; i++) {
-        os << i << ": " << std::setprecision (15) << pGroups[i]->sum << "\n";
+        os << i << ": " << std::setprecision (15) << pgroups[i]->sum << "\n";
     }
 
     ProgErrLog(os.str());
@@ -2431,7 +2549,7 @@ void Tetexact::_reset()
 
 void Tetexact::_executeStep(steps::tetexact::KProc * kp, double dt)
 {
-    std::vector<KProc*> const & upd = kp->apply(rng(), dt, statedef().time());
+    std::vector<KProc*> const & upd = kprocApply(kp, rng(), dt, statedef().time());
     _update(upd.begin(), upd.end());
     statedef().incTime(dt);
     statedef().incNSteps(1);
@@ -2441,22 +2559,22 @@ void Tetexact::_executeStep(steps::tetexact::KProc * kp, double dt)
 
 void Tetexact::_updateSpec(steps::tetexact::WmVol * tet)
 {
-    std::set<KProc*> updset;
+    pUpdKProcs.clear();
 
     // Loop over tet.
-    for (auto const& kproc: tet->kprocs()) updset.insert(kproc);
+    for (auto const& kproc: tet->kprocs()) pUpdKProcs.insert(kproc);
 
     for (auto const&tri: tet->nexttris()) {
         if (!tri) {
             continue;
         }
         for (auto const &kproc: tri->kprocs()) {
-            updset.insert(kproc);
+            pUpdKProcs.insert(kproc);
         }
     }
 
     // Send the list of kprocs that need to be updated to the schedule.
-    _update(updset.begin(), updset.end());
+    _update(pUpdKProcs.begin(), pUpdKProcs.end());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4268,10 +4386,11 @@ void Tetexact::_setMembVolRes(uint midx, double ro)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void Tetexact::_updateElement(KProc* kp)
+void Tetexact::_updateElement(KProc* kp, std::vector<CRGroup*> & ngroups,
+                              std::vector<CRGroup*> & pgroups)
 {
 
-    double new_rate = kp->rate(this);
+    double new_rate = kprocRate(kp, this);
 
     CRKProcData & data = kp->crData;
     double old_rate = data.rate;
@@ -4291,7 +4410,7 @@ void Tetexact::_updateElement(KProc* kp)
 
         if (old_pow == new_pow && data.recorded) {
 
-            CRGroup* old_group = _getGroup(old_pow);
+            CRGroup* old_group = _getGroup(ngroups, pgroups, old_pow);
 
             old_group->sum += (new_rate - old_rate);
         }
@@ -4303,7 +4422,7 @@ void Tetexact::_updateElement(KProc* kp)
             if (data.recorded) {
 
                 // remove old
-                CRGroup* old_group = _getGroup(old_pow);
+                CRGroup* old_group = _getGroup(ngroups, pgroups, old_pow);
                 (old_group->size) --;
 
                 if (old_group->size == 0) old_group->sum = 0.0;
@@ -4317,11 +4436,11 @@ void Tetexact::_updateElement(KProc* kp)
             }
 
             // add new
-            if (static_cast<int>(pGroups.size()) <= new_pow) {
-                _extendPGroups(new_pow + 1);
+            if (static_cast<int>(pgroups.size()) <= new_pow) {
+                _extendPGroups(pgroups, new_pow + 1);
             }
 
-            CRGroup* new_group = pGroups[new_pow];
+            CRGroup* new_group = pgroups[new_pow];
 
             AssertLog(new_group != nullptr);
             if (new_group->size == new_group->capacity) _extendGroup(new_group);
@@ -4343,7 +4462,7 @@ void Tetexact::_updateElement(KProc* kp)
 
         if (old_pow == new_pow && data.recorded) {
 
-            CRGroup* old_group = _getGroup(old_pow);
+            CRGroup* old_group = _getGroup(ngroups, pgroups, old_pow);
 
             old_group->sum += (new_rate - old_rate);
         }
@@ -4352,7 +4471,7 @@ void Tetexact::_updateElement(KProc* kp)
             data.pow = new_pow;
 
             if (data.recorded) {
-                CRGroup* old_group = _getGroup(old_pow);
+                CRGroup* old_group = _getGroup(ngroups, pgroups, old_pow);
                 (old_group->size) --;
 
                 if (old_group->size == 0) old_group->sum = 0.0;
@@ -4367,9 +4486,9 @@ void Tetexact::_updateElement(KProc* kp)
 
             // add new
 
-            if (static_cast<int>(nGroups.size()) <= -new_pow) _extendNGroups(-new_pow + 1);
+            if (static_cast<int>(ngroups.size()) <= -new_pow) _extendNGroups(ngroups, -new_pow + 1);
 
-            CRGroup* new_group = nGroups[-new_pow];
+            CRGroup* new_group = ngroups[-new_pow];
 
             if (new_group->size == new_group->capacity) _extendGroup(new_group);
             uint pos = new_group->size;
@@ -4386,7 +4505,7 @@ void Tetexact::_updateElement(KProc* kp)
 
         if (data.recorded) {
 
-            CRGroup* old_group = _getGroup(data.pow);
+            CRGroup* old_group = _getGroup(ngroups, pgroups, data.pow);
 
             // remove old
             old_group->size --;
@@ -4407,6 +4526,571 @@ void Tetexact::_updateElement(KProc* kp)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Tetexact::setNThreads(uint nthreads, uint ndomains)
+{
+    if (nthreads == 0) {
+        ArgErrLog("Number of threads must be positive.");
+    }
+    if (ndomains == 0) ndomains = nthreads;
+    if (ndomains > 1 && efflag()) {
+        ArgErrLog("Sub-domains are not available with EField calculation.");
+    }
+
+    #ifndef _OPENMP
+    if (nthreads > 1) {
+        CLOG(WARNING, "general_log") << "STEPS was built without OpenMP: sub-domains run on a single thread.\n";
+    }
+    #endif
+
+    pNThreads = nthreads;
+    if (ndomains == getNDomains()) return;
+
+    pDomains.clear();
+    if (ndomains > 1) {
+        for (uint d = 0; d < ndomains; d++) {
+            pDomains.emplace_back(new SubDomain);
+        }
+    }
+    _setupDomains();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_setupDomains()
+{
+    const uint ndomains = pDomains.size();
+    const uint ntets = pTets.size();
+
+    // Sub-domain of every tet.
+    std::vector<uint> tet_domain(ntets, 0);
+    if (ndomains > 1) {
+        auto weights = steps::tetmesh::kprocTetWeights(*pMesh, model());
+        for (uint t = 0; t < ntets; t++) {
+            weights[t] = pTets[t] != nullptr ? 1.0 + weights[t] : 0.0;
+        }
+        auto partition = steps::tetmesh::partitionMesh(*pMesh, ndomains, steps::tetmesh::PARTITION_GRAPH, weights);
+        tet_domain.swap(partition.tet_hosts);
+
+        // The partition keeps the tets on both sides of a patch triangle
+        // together, so that surface reactions stay within a sub-domain.
+        // Triangles next to a well-mixed volume, and the tets connected to
+        // them through triangles, go to sub-domain 0 with the volume; node
+        // ntets stands for the well-mixed volumes.
+        std::vector<uint> root(ntets + 1);
+        std::iota(root.begin(), root.end(), 0);
+        auto find = [&root](uint v) {
+            while (root[v] != v) {
+                root[v] = root[root[v]];
+                v = root[v];
+            }
+            return v;
+        };
+        for (auto& tri : pTris) {
+            if (tri == nullptr) continue;
+            uint sides[2];
+            uint nsides = 0;
+            for (WmVol * v : {tri->iTet(), tri->oTet()}) {
+                if (v == nullptr) continue;
+                uint t = v->idx().get();
+                sides[nsides++] = (t < ntets && pTets[t] == v) ? t : ntets;
+            }
+            if (nsides == 2) root[find(sides[0])] = find(sides[1]);
+        }
+        uint wm_root = find(ntets);
+        for (uint t = 0; t < ntets; t++) {
+            if (find(t) == wm_root) tet_domain[t] = 0;
+        }
+    }
+
+    for (uint d = 0; d < ndomains; d++) {
+        SubDomain & dom = *pDomains[d];
+        dom.index = d;
+        dom.clearGroups();
+        dom.vols.clear();
+        dom.tris.clear();
+        dom.kprocs.clear();
+        dom.changes.assign(ndomains, std::vector<DomainChange>());
+        dom.received.clear();
+        dom.rng = steps::rng::create_mt19937(512);
+        dom.rng->initialize(rng()->get());
+    }
+
+    auto assign = [this](std::vector<KProc*> const & kprocs, uint d) {
+        for (auto& kp : kprocs) {
+            kp->setDomain(d);
+            if (!pDomains.empty()) pDomains[d]->kprocs.push_back(kp);
+        }
+    };
+    for (auto& tet : pTets) {
+        if (tet == nullptr) continue;
+        uint d = tet_domain[tet->idx().get()];
+        tet->setDomain(d);
+        assign(tet->kprocs(), d);
+        if (!pDomains.empty()) pDomains[d]->vols.push_back(tet);
+    }
+    for (auto& wmv : pWmVols) {
+        if (wmv == nullptr) continue;
+        wmv->setDomain(0);
+        assign(wmv->kprocs(), 0);
+        if (!pDomains.empty()) pDomains[0]->vols.push_back(wmv);
+    }
+    for (auto& tri : pTris) {
+        if (tri == nullptr) continue;
+        WmVol * v = tri->iTet() != nullptr ? tri->iTet() : tri->oTet();
+        uint d = v != nullptr ? v->getDomain() : 0;
+        tri->setDomain(d);
+        assign(tri->kprocs(), d);
+        if (!pDomains.empty()) pDomains[d]->tris.push_back(tri);
+    }
+    pWindowEvents = 1000.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template <typename F>
+void Tetexact::_forEachDomain(std::vector<SubDomain*> const & doms, F && f)
+{
+    const int ndoms = doms.size();
+    if (ndoms == 1 || pNThreads == 1) {
+        for (auto& dom : doms) f(*dom);
+        return;
+    }
+
+    // Exceptions may not leave the parallel region.
+    std::exception_ptr error;
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(pNThreads)
+    for (int d = 0; d < ndoms; d++) {
+        try {
+            f(*doms[d]);
+        }
+        catch (...) {
+            #pragma omp critical(steps_tetexact_domain_error)
+            {
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) std::rethrow_exception(error);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::registerDomainChange(uint src, steps::tetexact::WmVol * tet, uint lidx)
+{
+    if (!pInDomains) {
+        // A single step: the caller updates the kprocs of both sides.
+        tet->incCount(lidx, 1);
+        return;
+    }
+    SubDomain & dom = *pDomains[src];
+    dom.changes[tet->getDomain()].push_back({dom.time, tet, nullptr, lidx});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::registerDomainChange(uint src, steps::tetexact::Tri * tri, uint lidx)
+{
+    if (!pInDomains) {
+        tri->incCount(lidx, 1);
+        return;
+    }
+    SubDomain & dom = *pDomains[src];
+    dom.changes[tri->getDomain()].push_back({dom.time, nullptr, tri, lidx});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_runDomains(double endtime)
+{
+    _enterDomains();
+
+    double time = statedef().time();
+    while (time < endtime) {
+        double max_a0 = 0.0;
+        for (auto& dom : pDomains) max_a0 = std::max(max_a0, dom->a0);
+        double wend = endtime;
+        if (max_a0 > 0.0) {
+            wend = time + pWindowEvents / max_a0;
+            if (wend > endtime || wend <= time) wend = endtime;
+        }
+
+        uint npasses = _runWindow(wend);
+
+        // Every pass simulates the window again, while longer windows
+        // spread the cost of saving the state over more events.
+        if (npasses > 4) pWindowEvents = std::max(0.5 * pWindowEvents, 1.0);
+        else if (npasses <= 2) pWindowEvents = std::min(1.5 * pWindowEvents, 1.0e6);
+        time = wend;
+    }
+
+    _leaveDomains();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_enterDomains()
+{
+    for (auto const& group : nGroups) {
+        free(group->indices);
+        delete group;
+    }
+    nGroups.clear();
+    for (auto const& group : pGroups) {
+        free(group->indices);
+        delete group;
+    }
+    pGroups.clear();
+    pA0 = 0.0;
+
+    std::vector<SubDomain*> doms;
+    for (auto& dom : pDomains) doms.push_back(dom.get());
+
+    double time = statedef().time();
+    pInDomains = true;
+    _forEachDomain(doms, [&](SubDomain & dom) {
+        dom.clearGroups();
+        for (auto& kp : dom.kprocs) {
+            kp->crData = CRKProcData();
+            _updateElement(dom, kp);
+        }
+        _updateSum(dom);
+        dom.time = time;
+        _scheduleNext(dom);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_leaveDomains()
+{
+    pInDomains = false;
+    for (auto& dom : pDomains) dom->clearGroups();
+    for (auto& kp : pKProcs) kp->crData = CRKProcData();
+    _update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+uint Tetexact::_runWindow(double wend)
+{
+    std::vector<SubDomain*> todo;
+    for (auto& dom : pDomains) {
+        dom->received.clear();
+        todo.push_back(dom.get());
+    }
+
+    uint npasses = 0;
+    std::vector<DomainChange> received;
+    while (!todo.empty()) {
+        bool first = npasses == 0;
+        _forEachDomain(todo, [&](SubDomain & dom) {
+            if (first) _saveDomain(dom);
+            else _restoreDomain(dom);
+            _runDomainWindow(dom, wend);
+        });
+        npasses++;
+
+        // Sub-domains that were sent other changes than the ones they were
+        // simulated with go back to the start of the window. The earliest
+        // difference is later after every pass, as it is the consequence
+        // of an earlier one.
+        todo.clear();
+        for (auto& dom : pDomains) {
+            received.clear();
+            for (auto& src : pDomains) {
+                auto const & changes = src->changes[dom->index];
+                received.insert(received.end(), changes.begin(), changes.end());
+            }
+            std::stable_sort(received.begin(), received.end(),
+                             [](DomainChange const & a, DomainChange const & b) { return a.time < b.time; });
+            if (received != dom->received) {
+                dom->received.swap(received);
+                todo.push_back(dom.get());
+            }
+        }
+    }
+
+    uint nsteps = 0;
+    for (auto& dom : pDomains) nsteps += dom->nsteps;
+    statedef().incNSteps(nsteps);
+    statedef().setTime(wend);
+    return npasses;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_runDomainWindow(SubDomain & dom, double wend)
+{
+    for (auto& changes : dom.changes) changes.clear();
+    dom.nsteps = 0;
+
+    auto change = dom.received.cbegin();
+    auto changes_end = dom.received.cend();
+    while (true) {
+        // A molecule from another sub-domain changes the propensities, and
+        // so the time of the next event.
+        if (change != changes_end && change->time < dom.next) {
+            dom.time = change->time;
+            _applyDomainChange(dom, *change++);
+            _scheduleNext(dom);
+            continue;
+        }
+        // Changes all come before wend.
+        if (dom.next >= wend) break;
+
+        KProc * kp = _getNext(dom.a0, dom.nGroups, dom.pGroups, dom.rng);
+        AssertLog(kp != nullptr);
+        double dt = dom.next - dom.time;
+        double time = dom.time;
+        dom.time = dom.next;
+
+        // Kprocs of other sub-domains are updated with the changes sent.
+        std::vector<KProc*> const & upd = kprocApply(kp, dom.rng, dt, time);
+        for (auto& ukp : upd) {
+            if (ukp->getDomain() == dom.index) _updateElement(dom, ukp);
+        }
+        _updateSum(dom);
+        dom.nsteps++;
+        _scheduleNext(dom);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_applyDomainChange(SubDomain & dom, DomainChange const & change)
+{
+    dom.updKProcs.clear();
+    if (change.tet != nullptr) {
+        change.tet->incCount(change.lidx, 1);
+        dom.updKProcs.insert(change.tet->kprocBegin(), change.tet->kprocEnd());
+        for (auto& tri : change.tet->nexttris()) {
+            if (tri != nullptr) dom.updKProcs.insert(tri->kprocBegin(), tri->kprocEnd());
+        }
+    }
+    else {
+        change.tri->incCount(change.lidx, 1);
+        dom.updKProcs.insert(change.tri->kprocBegin(), change.tri->kprocEnd());
+    }
+
+    for (auto& kp : dom.updKProcs) {
+        AssertLog(kp->getDomain() == dom.index);
+        _updateElement(dom, kp);
+    }
+    _updateSum(dom);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_scheduleNext(SubDomain & dom)
+{
+    if (dom.a0 > 0.0) dom.next = dom.time + dom.rng->getExp(dom.a0);
+    else dom.next = std::numeric_limits<double>::infinity();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_saveDomain(SubDomain & dom)
+{
+    auto & saved = dom.saved;
+
+    saved.counts.clear();
+    for (auto& vol : dom.vols) {
+        saved.counts.insert(saved.counts.end(), vol->pools(), vol->pools() + vol->compdef()->countSpecs());
+    }
+    for (auto& tri : dom.tris) {
+        saved.counts.insert(saved.counts.end(), tri->pools(), tri->pools() + tri->patchdef()->countSpecs());
+    }
+
+    const auto nkprocs = dom.kprocs.size();
+    saved.extents.resize(nkprocs);
+    saved.crData.resize(nkprocs);
+    for (uint k = 0; k < nkprocs; k++) {
+        saved.extents[k] = dom.kprocs[k]->getExtent();
+        saved.crData[k] = dom.kprocs[k]->crData;
+    }
+
+    saved.nNegGroups = dom.nGroups.size();
+    saved.groupSizes.clear();
+    saved.groupSums.clear();
+    saved.groupIndices.clear();
+    for (auto const* groups : {&dom.nGroups, &dom.pGroups}) {
+        for (auto& group : *groups) {
+            saved.groupSizes.push_back(group->size);
+            saved.groupSums.push_back(group->sum);
+            saved.groupIndices.insert(saved.groupIndices.end(), group->indices, group->indices + group->size);
+        }
+    }
+
+    dom.rng->saveState(saved.rngState);
+    saved.a0 = dom.a0;
+    saved.time = dom.time;
+    saved.next = dom.next;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_restoreDomain(SubDomain & dom)
+{
+    auto const & saved = dom.saved;
+
+    auto count = saved.counts.cbegin();
+    for (auto& vol : dom.vols) {
+        uint nspecs = vol->compdef()->countSpecs();
+        std::copy(count, count + nspecs, vol->pools());
+        count += nspecs;
+    }
+    for (auto& tri : dom.tris) {
+        uint nspecs = tri->patchdef()->countSpecs();
+        std::copy(count, count + nspecs, tri->pools());
+        count += nspecs;
+    }
+
+    const auto nkprocs = dom.kprocs.size();
+    for (uint k = 0; k < nkprocs; k++) {
+        dom.kprocs[k]->setExtent(saved.extents[k]);
+        dom.kprocs[k]->crData = saved.crData[k];
+    }
+
+    // Groups only ever get added, and their capacity only grows; groups
+    // added during the window are empty at its start.
+    uint g = 0;
+    auto index = saved.groupIndices.cbegin();
+    auto restore = [&](std::vector<CRGroup*> & groups, uint nsaved) {
+        for (uint i = 0; i < groups.size(); i++) {
+            CRGroup * group = groups[i];
+            if (i < nsaved) {
+                group->size = saved.groupSizes[g];
+                group->sum = saved.groupSums[g];
+                std::copy(index, index + group->size, group->indices);
+                index += group->size;
+                g++;
+            }
+            else {
+                group->size = 0;
+                group->sum = 0.0;
+            }
+        }
+    };
+    restore(dom.nGroups, saved.nNegGroups);
+    restore(dom.pGroups, saved.groupSizes.size() - saved.nNegGroups);
+
+    dom.rng->restoreState(saved.rngState);
+    dom.a0 = saved.a0;
+    dom.time = saved.time;
+    dom.next = saved.next;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_setBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                               uint oidx, const double *values)
+{
+    if (q != BatchQuantity::TET_V && q != BatchQuantity::TRI_V && q != BatchQuantity::VERT_V)
+    {
+        API::_setBatchValues(q, indices, n, oidx, values);
+        return;
+    }
+
+    if (!efflag())
+    {
+        std::ostringstream os;
+        os << "Method not available: EField calculation not included in simulation.";
+        ArgErrLog(os.str());
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        if (q == BatchQuantity::TET_V)
+        {
+            const auto loctidx = pEFTet_GtoL[idx];
+            if (loctidx == UNKNOWN_TET)
+            {
+                std::ostringstream os;
+                os << "Tetrahedron index " << idx << " not assigned to a conduction volume.";
+                ArgErrLog(os.str());
+            }
+            pEField->setTetV(loctidx, values[i]);
+        }
+        else if (q == BatchQuantity::TRI_V)
+        {
+            const auto loctidx = pEFTri_GtoL[idx];
+            if (loctidx == UNKNOWN_TRI)
+            {
+                std::ostringstream os;
+                os << "Triangle index " << idx << " not assigned to a membrane.";
+                ArgErrLog(os.str());
+            }
+            pEField->setTriV(loctidx, values[i]);
+        }
+        else
+        {
+            const auto locvidx = pEFVert_GtoL[idx];
+            if (locvidx == UNKNOWN_VER)
+            {
+                std::ostringstream os;
+                os << "Vertex index " << idx << " not assigned to a conduction volume or membrane.";
+                ArgErrLog(os.str());
+            }
+            pEField->setVertV(locvidx, values[i]);
+        }
+    }
+
+    // Voltage-dependent rates may have changed, once for the batch
+    _update();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::_getBatchExtents(BatchQuantity q, const index_t *indices, size_t n,
+                                uint ridx, unsigned long long *extents) const
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        index_t idx = indices[i];
+        if (q == BatchQuantity::TET_REAC_EXTENT)
+        {
+            Tet * tet = pTets[idx];
+            if (tet == nullptr)
+            {
+                std::ostringstream os;
+                os << "Tetrahedron " << idx << " has not been assigned to a compartment.\n";
+                ArgErrLog(os.str());
+            }
+            uint lridx = tet->compdef()->reacG2L(ridx);
+            if (lridx == ssolver::LIDX_UNDEFINED)
+            {
+                std::ostringstream os;
+                os << "Reaction undefined in tetrahedron.\n";
+                ArgErrLog(os.str());
+            }
+            extents[i] = tet->reac(lridx)->getExtent();
+        }
+        else
+        {
+            Tri * tri = pTris[idx];
+            if (tri == nullptr)
+            {
+                std::ostringstream os;
+                os << "Triangle " << idx << " has not been assigned to a patch.\n";
+                ArgErrLog(os.str());
+            }
+            uint lsridx = tri->patchdef()->sreacG2L(ridx);
+            if (lsridx == ssolver::LIDX_UNDEFINED)
+            {
+                std::ostringstream os;
+                os << "Surface reaction undefined in triangle.\n";
+                ArgErrLog(os.str());
+            }
+            extents[i] = tri->sreac(lsridx)->getExtent();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 ////////////////////////////////////////////////////////////////////////
 // ROI Data Access
 ////////////////////////////////////////////////////////////////////////
@@ -4527,6 +5211,20 @@ void Tetexact::getBatchTetCountsNP(const index_t *indices,
                                    std::string const &s,
                                    double *counts,
                                    size_t output_size) const
+{
+    // the following may throw exception if string is unknown
+    uint sidx = statedef().getSpecIdx(s);
+
+    Tetexact::getBatchTetCountsNP(indices, input_size, sidx, counts, output_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::getBatchTetCountsNP(const index_t *indices,
+                                   size_t input_size,
+                                   uint sgidx,
+                                   double *counts,
+                                   size_t output_size) const
 {
     if (input_size != output_size)
     {
@@ -4540,7 +5238,12 @@ void Tetexact::getBatchTetCountsNP(const index_t *indices,
     std::ostringstream tet_not_assign;
     std::ostringstream spec_undefined;
 
-    uint sgidx = statedef().getSpecIdx(s);
+    if (sgidx >= statedef().countSpecs())
+    {
+        std::ostringstream os;
+        os << "Species index out of range.";
+        ArgErrLog(os.str());
+    }
 
     for (uint t = 0; t < input_size; t++) {
         const auto tidx = indices[t];
@@ -4577,7 +5280,7 @@ void Tetexact::getBatchTetCountsNP(const index_t *indices,
     }
 
     if (has_spec_warning) {
-        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following tetrahedrons, fill in zeros at target positions:\n";
+        CLOG(WARNING, "general_log") << "Species " << statedef().specdef(sgidx)->name() << " has not been defined in the following tetrahedrons, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
 }
@@ -4589,6 +5292,20 @@ void Tetexact::getBatchTriCountsNP(const index_t *indices,
                                    std::string const &s,
                                    double *counts,
                                    size_t output_size) const
+{
+    // the following may throw exception if string is unknown
+    uint sidx = statedef().getSpecIdx(s);
+
+    Tetexact::getBatchTriCountsNP(indices, input_size, sidx, counts, output_size);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tetexact::getBatchTriCountsNP(const index_t *indices,
+                                   size_t input_size,
+                                   uint sgidx,
+                                   double *counts,
+                                   size_t output_size) const
 {
     if (input_size != output_size)
     {
@@ -4603,7 +5320,12 @@ void Tetexact::getBatchTriCountsNP(const index_t *indices,
     std::ostringstream spec_undefined;
 
 
-    uint sgidx = statedef().getSpecIdx(s);
+    if (sgidx >= statedef().countSpecs())
+    {
+        std::ostringstream os;
+        os << "Species index out of range.";
+        ArgErrLog(os.str());
+    }
 
     for (uint t = 0; t < input_size; t++) {
         const auto tidx = indices[t];
@@ -4640,7 +5362,7 @@ void Tetexact::getBatchTriCountsNP(const index_t *indices,
     }
 
     if (has_spec_warning) {
-        CLOG(WARNING, "general_log") << "Species " << s << " has not been defined in the following triangles, fill in zeros at target positions:\n";
+        CLOG(WARNING, "general_log") << "Species " << statedef().specdef(sgidx)->name() << " has not been defined in the following triangles, fill in zeros at target positions:\n";
         CLOG(WARNING, "general_log") << spec_undefined.str() << "\n";
     }
 }
@@ -53,6 +53,9 @@
 #include "steps/tetexact/diffboundary.hpp"
 #include "steps/tetexact/sdiffboundary.hpp"
 #include "steps/tetexact/crstruct.hpp"
+#include "steps/tetexact/subdomain.hpp"
+#include "steps/tetexact/voxelstore.hpp"
+#include "steps/util/epoch_dedup.hpp"
 #include "steps/solver/efield/efield.hpp"
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -131,6 +134,30 @@ public:
     // save the optimal vertex indexing
     void saveMembOpt(std::string const & opt_file_name);
 
+    ////////////////////////////////////////////////////////////////////////
+    // SUB-DOMAINS
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Split the mesh into ndomains sub-domains (by default one per thread)
+    /// and simulate them on nthreads OpenMP threads during run(). Every
+    /// sub-domain has its own exact SSA and random stream, seeded from the
+    /// solver RNG; diffusion between sub-domains takes effect at the time
+    /// of the event, so that the statistics are those of the serial solver.
+    /// Results depend on the number of sub-domains but not on the number
+    /// of threads. A single sub-domain, the default, is the serial solver.
+    /// Not available with the EField calculation.
+    void setNThreads(uint nthreads, uint ndomains = 0);
+
+    inline uint getNThreads() const noexcept
+    { return pNThreads; }
+    inline uint getNDomains() const noexcept
+    { return pDomains.empty() ? 1 : pDomains.size(); }
+
+    /// A molecule of species lidx moved by diffusion from sub-domain src
+    /// into tet or tri, which belongs to another sub-domain.
+    void registerDomainChange(uint src, steps::tetexact::WmVol * tet, uint lidx);
+    void registerDomainChange(uint src, steps::tetexact::Tri * tri, uint lidx);
+
     ////////////////////////////////////////////////////////////////////////
 
     ////////////////////////////////////////////////////////////////////////
@@ -174,6 +201,18 @@ public:
                               double *counts,
                               size_t output_size) const override;
 
+     void getBatchTetCountsNP(const index_t *indices,
+                              size_t input_size,
+                              uint sidx,
+                              double *counts,
+                              size_t output_size) const override;
+
+     void getBatchTriCountsNP(const index_t *indices,
+                              size_t input_size,
+                              uint sidx,
+                              double *counts,
+                              size_t output_size) const override;
+
      ////////////////////////////////////////////////////////////////////////
      // ROI Data Access
      ////////////////////////////////////////////////////////////////////////
@@ -433,6 +472,15 @@ public:
     double _getVertIClamp(vertex_id_t tidx) const override;
     void _setVertIClamp(vertex_id_t tidx, double cur) override;
 
+    ////////////////////////////////////////////////////////////////////////
+    // BATCH DATA ACCESS
+    ////////////////////////////////////////////////////////////////////////
+
+    void _setBatchValues(BatchQuantity q, const index_t *indices, size_t n,
+                         uint oidx, const double *values) override;
+    void _getBatchExtents(BatchQuantity q, const index_t *indices, size_t n,
+                          uint ridx, unsigned long long *extents) const override;
+
     ////////////////////////////////////////////////////////////////////////
     // SOLVER CONTROL:
     //      MEMBRANE AND VOLUME CONDUCTOR
@@ -565,6 +613,10 @@ public:
     // by constructor
     void _setup();
 
+    // Lay out the pools of all tets, wmvols and tris contiguously in
+    // pVoxelStore, called once all elements have been created
+    void _setupVoxelStore();
+
 
     //void _build();
 
@@ -573,6 +625,13 @@ public:
 
     steps::tetexact::KProc * _getNext() const;
 
+    /// CR selection of the next kproc among the groups ngroups and pgroups
+    /// of total propensity a0.
+    static steps::tetexact::KProc * _getNext(double a0,
+                                             std::vector<CRGroup*> const & ngroups,
+                                             std::vector<CRGroup*> const & pgroups,
+                                             const rng::RNGptr & r);
+
     //void _reset();
 
     void _executeStep(steps::tetexact::KProc * kp, double dt);
@@ -604,6 +663,9 @@ public:
 
     void _setupEField();
 
+    /// Collect the kprocs whose rates depend on the membrane potential.
+    void _setupVDepKProcs();
+
     inline uint neftets() const
     { return pEFNTets; }
 
@@ -654,6 +716,9 @@ private:
     // Now stored as base pointer
     std::vector<steps::tetexact::Tet *>        pTets;
 
+    // Contiguous molecule counts and pool flags of all tets, wmvols and tris
+    VoxelStore                                 pVoxelStore;
+
     ////////////////////////////////////////////////////////////////////////
     // CR SSA Kernel Data and Methods
     ////////////////////////////////////////////////////////////////////////
@@ -664,6 +729,9 @@ private:
 
     std::vector<KProc*>                         pKProcs;
 
+    // Scratch collection of the kprocs to update after a pool change.
+    steps::util::epoch_dedup<KProc>             pUpdKProcs;
+
     std::vector<CRGroup*>                       nGroups;
     std::vector<CRGroup*>                       pGroups;
 
@@ -683,7 +751,8 @@ private:
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline CRGroup* _getGroup(int pow) {
+    static inline CRGroup* _getGroup(std::vector<CRGroup*> const & ngroups,
+                                     std::vector<CRGroup*> const & pgroups, int pow) {
         #ifdef SSA_DEBUG
         CLOG(INFO, "general_log") << "SSA: get group with power " << pow << "\n";
         #endif
@@ -692,13 +761,13 @@ private:
             #ifdef SSA_DEBUG
             CLOG(INFO, "general_log") << "positive group" << pow << "\n";
             #endif
-            return pGroups[pow];
+            return pgroups[pow];
         }
         else {
             #ifdef SSA_DEBUG
             CLOG(INFO, "general_log") << "negative group" << -pow << "\n";
             #endif
-            return nGroups[-pow];
+            return ngroups[-pow];
         }
         #ifdef SSA_DEBUG
         CLOG(INFO, "general_log") << "--------------------------------------------------------\n";
@@ -707,8 +776,8 @@ private:
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline void _extendPGroups(uint new_size) {
-        uint curr_size = pGroups.size();
+    static inline void _extendPGroups(std::vector<CRGroup*> & pgroups, uint new_size) {
+        uint curr_size = pgroups.size();
 
         #ifdef SSA_DEBUG
         CLOG(INFO, "general_log") << "SSA: extending positive group size to " << new_size;
@@ -717,16 +786,16 @@ private:
         #endif
 
         while (curr_size < new_size) {
-            pGroups.push_back(new CRGroup(curr_size));
+            pgroups.push_back(new CRGroup(curr_size));
             curr_size ++;
         }
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline void _extendNGroups(uint new_size) {
+    static inline void _extendNGroups(std::vector<CRGroup*> & ngroups, uint new_size) {
 
-        uint curr_size = nGroups.size();
+        uint curr_size = ngroups.size();
 
         #ifdef SSA_DEBUG
         CLOG(INFO, "general_log") << "SSA: extending negative group size to " << new_size;
@@ -736,14 +805,14 @@ private:
 
         while (curr_size < new_size) {
 
-            nGroups.push_back(new CRGroup(-curr_size));
+            ngroups.push_back(new CRGroup(-curr_size));
             curr_size ++;
         }
     }
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    inline void _extendGroup(CRGroup* group, uint size = 1024) {
+    static inline void _extendGroup(CRGroup* group, uint size = 1024) {
         #ifdef SSA_DEBUG
         CLOG(INFO, "general_log") << "SSA: extending group storage\n";
         CLOG(INFO, "general_log") << "current capacity: " << group->capacity << "\n";
@@ -763,7 +832,76 @@ private:
 
     ////////////////////////////////////////////////////////////////////////////////
 
-    void _updateElement(KProc* kp);
+    inline void _updateElement(KProc* kp) {
+        _updateElement(kp, nGroups, pGroups);
+    }
+
+    /// Update the CR groups of kp, held in ngroups and pgroups.
+    void _updateElement(KProc* kp, std::vector<CRGroup*> & ngroups,
+                        std::vector<CRGroup*> & pgroups);
+
+    ////////////////////////////////////////////////////////////////////////////////
+    // Sub-domains
+    ////////////////////////////////////////////////////////////////////////////////
+
+    /// Assign the elements and their kprocs to pDomains.size() sub-domains,
+    /// or all to sub-domain 0 without sub-domains, and set up the random
+    /// streams of the sub-domains.
+    void _setupDomains();
+
+    /// Call f(dom) for every sub-domain of doms, on pNThreads threads. The
+    /// first exception thrown by f is rethrown once all of them are done.
+    template <typename F>
+    void _forEachDomain(std::vector<SubDomain*> const & doms, F && f);
+
+    /// Run the sub-domains until endtime, window by window.
+    void _runDomains(double endtime);
+
+    /// Move the kprocs from the solver CR groups to those of their
+    /// sub-domains, and back.
+    void _enterDomains();
+    void _leaveDomains();
+
+    /// Simulate every sub-domain until wend, again until the changes they
+    /// send each other no longer change. Returns the number of passes.
+    uint _runWindow(double wend);
+
+    /// Simulate dom from the start of the window until wend, with the
+    /// changes in dom.received.
+    void _runDomainWindow(SubDomain & dom, double wend);
+
+    /// Save the state of dom at the start of a window, and go back to it.
+    void _saveDomain(SubDomain & dom);
+    void _restoreDomain(SubDomain & dom);
+
+    /// Apply a change sent to dom by another sub-domain.
+    void _applyDomainChange(SubDomain & dom, DomainChange const & change);
+
+    /// Draw the time of the next event of dom after dom.time.
+    void _scheduleNext(SubDomain & dom);
+
+    inline void _updateElement(SubDomain & dom, KProc* kp) {
+        _updateElement(kp, dom.nGroups, dom.pGroups);
+    }
+
+    inline void _updateSum(SubDomain & dom) {
+        dom.a0 = 0.0;
+        for (const auto& neg_grp: dom.nGroups) {
+          dom.a0 += neg_grp->sum;
+        }
+        for (const auto& pos_grp: dom.pGroups) {
+          dom.a0 += pos_grp->sum;
+        }
+    }
+
+    std::vector<std::unique_ptr<SubDomain> >    pDomains;
+    uint                                        pNThreads{1};
+    // True while run() simulates the sub-domains.
+    bool                                        pInDomains{false};
+    // Mean number of events of the busiest sub-domain per window.
+    double                                      pWindowEvents{1000.0};
+
+    ////////////////////////////////////////////////////////////////////////////////
 
     inline void _updateSum() {
         #ifdef SSA_DEBUG
@@ -815,6 +953,11 @@ private:
 
     std::vector<steps::tetexact::Tri *>        pEFTris_vec;
 
+    // Voltage-dependent transitions, voltage-dependent surface reactions
+    // and GHK currents of all triangles: the only kprocs whose rates change
+    // when the potential is updated.
+    std::vector<KProc*>                         pVDepKProcs;
+
     // The number of tetrahedrons
     uint                                        pEFNTets{0};
     // Array of tetrahedrons
@@ -108,11 +108,7 @@ stex::Tri::Tri(triangle_id_t idx, steps::solver::Patchdef * patchdef, double are
     pDist[1] = d1;
     pDist[2] = d2;
 
-    uint nspecs = pPatchdef->countSpecs();
-    pPoolCount = new uint[nspecs];
-    pPoolFlags = new uint[nspecs];
-    std::fill_n(pPoolCount, nspecs, 0);
-    std::fill_n(pPoolFlags, nspecs, 0);
+    // Pools are attached later to the solver's VoxelStore.
 
     uint nghkcurrs = pPatchdef->countGHKcurrs();
     pECharge = new int[nghkcurrs];
@@ -137,8 +133,6 @@ stex::Tri::Tri(triangle_id_t idx, steps::solver::Patchdef * patchdef, double are
 
 stex::Tri::~Tri()
 {
-    delete[] pPoolCount;
-    delete[] pPoolFlags;
     delete[] pECharge;
     delete[] pECharge_last;
     delete[] pECharge_accum;
@@ -152,7 +146,7 @@ stex::Tri::~Tri()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Tri::checkpoint(std::fstream & cp_file)
+void stex::Tri::checkpoint(std::iostream & cp_file)
 {
     uint nspecs = patchdef()->countSpecs();
     cp_file.write(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
@@ -175,7 +169,7 @@ void stex::Tri::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::Tri::restore(std::fstream & cp_file)
+void stex::Tri::restore(std::iostream & cp_file)
 {
     uint nspecs = patchdef()->countSpecs();
     cp_file.read(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
@@ -230,8 +224,19 @@ void stex::Tri::setNextTri(uint i, stex::Tri * t)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void stex::Tri::setPoolStorage(uint * counts, uint * flags)
+{
+    AssertLog(counts != nullptr && flags != nullptr);
+    pPoolCount = counts;
+    pPoolFlags = flags;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void stex::Tri::setupKProcs(stex::Tetexact * tex, bool efield)
 {
+    setSolver(tex);
+
     uint kprocvecsize = pPatchdef->countSReacs()+pPatchdef->countSurfDiffs();
     if (efield) {
         kprocvecsize += (pPatchdef->countVDepTrans() + pPatchdef->countVDepSReacs() + pPatchdef->countGHKcurrs());
@@ -92,10 +92,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    void checkpoint(std::fstream & cp_file);
+    void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    void restore(std::fstream & cp_file);
+    void restore(std::iostream & cp_file);
 
     ////////////////////////////////////////////////////////////////////////
     // SETUP
@@ -112,6 +112,10 @@ public:
     /// Set pointer to the next neighbouring triangle.
     void setNextTri(uint i, stex::Tri * t);
 
+    /// Attach the molecule counts and pool flags of this triangle to their
+    /// block in the solver's contiguous VoxelStore.
+    void setPoolStorage(uint * counts, uint * flags);
+
 
     /// Create the kinetic processes -- to be called when all tetrahedrons
     /// and triangles have been fully declared and connected.
@@ -243,6 +247,14 @@ public:
 
     ////////////////////////////////////////////////////////////////////////
 
+    /// Sub-domain the triangle belongs to; see Tetexact::setNThreads().
+    inline uint getDomain() const noexcept { return pDomain; }
+    inline void setDomain(uint domain) noexcept { pDomain = domain; }
+    void setSolver(stex::Tetexact * solver) noexcept { pSol = solver; }
+    inline stex::Tetexact * solver() const noexcept { return pSol; }
+
+    ////////////////////////////////////////////////////////////////////////
+
 private:
 
     ////////////////////////////////////////////////////////////////////////
@@ -274,7 +286,8 @@ private:
 
     bool                                pSDiffBndDirection[3];
 
-    /// Numbers of molecules -- stored as machine word integers.
+    /// Numbers of molecules -- stored as machine word integers in the
+    /// solver VoxelStore.
     uint                              * pPoolCount{nullptr};
     /// Flags on these pools -- stored as machine word flags.
     uint                              * pPoolFlags{nullptr};
@@ -282,6 +295,9 @@ private:
     /// The kinetic processes.
     std::vector<stex::KProc *>          pKProcs;
 
+    uint                                pDomain{0};
+    stex::Tetexact                    * pSol{nullptr};
+
     /// For the EFIELD calculation. An integer storing the amount of
     /// elementary charge from inner tet to outer tet (positive if
     /// net flux is positive, negative if net flux is negative) for
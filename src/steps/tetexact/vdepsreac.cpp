@@ -57,6 +57,7 @@ stex::VDepSReac::VDepSReac(ssolver::VDepSReacdef * vdsrdef, stex::Tri * tri)
 {
     AssertLog(pVDepSReacdef != nullptr);
     AssertLog(pTri != nullptr);
+    type = KP_VDEPSREAC;
 
     if (pVDepSReacdef->surf_surf() == false)
     {
@@ -97,7 +98,7 @@ stex::VDepSReac::~VDepSReac()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::VDepSReac::checkpoint(std::fstream & cp_file)
+void stex::VDepSReac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -112,7 +113,7 @@ void stex::VDepSReac::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::VDepSReac::restore(std::fstream & cp_file)
+void stex::VDepSReac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -164,7 +165,7 @@ void stex::VDepSReac::setupDeps()
     WmVol * itet = pTri->iTet();
     WmVol * otet = pTri->oTet();
 
-    std::set<stex::KProc*> updset;
+    stex::KProcPSet updset;
 
     for (auto const& k : pTri->kprocs()) {
         for (auto const& spec : pVDepSReacdef->updcoll_S()) {
@@ -267,128 +268,16 @@ double stex::VDepSReac::rate(steps::tetexact::Tetexact * solver)
         ssolver::Patchdef * pdef = pTri->patchdef();
         uint lidx = pdef->vdepsreacG2L(pVDepSReacdef->gidx());
 
-        double h_mu = 1.0;
-
-        uint * lhs_s_vec = pdef->vdepsreac_lhs_S_bgn(lidx);
-        uint * cnt_s_vec = pTri->pools();
-        uint nspecs_s = pdef->countSpecs();
-        for (uint s = 0; s < nspecs_s; ++s)
-        {
-            uint lhs = lhs_s_vec[s];
-            if (lhs == 0) { continue;
-}
-            uint cnt = cnt_s_vec[s];
-            if (lhs > cnt)
-            {
-                return 0.0;
-            }
-            switch (lhs)
-            {
-                case 4:
-                {
-                    h_mu *= static_cast<double>(cnt - 3);
-                }
-                case 3:
-                {
-                    h_mu *= static_cast<double>(cnt - 2);
-                }
-                case 2:
-                {
-                    h_mu *= static_cast<double>(cnt - 1);
-                }
-                case 1:
-                {
-                    h_mu *= static_cast<double>(cnt);
-                    break;
-                }
-                default:
-                {
-                    AssertLog(false);
-                }
-            }
-        }
+        double h_mu = pdef->vdepsreac_prog_S(lidx).h(pTri->pools());
+        if (h_mu == 0.0) return 0.0;
 
         if (pVDepSReacdef->inside())
         {
-            uint * lhs_i_vec = pdef->vdepsreac_lhs_I_bgn(lidx);
-            auto const& cnt_i_vec = pTri->iTet()->pools();
-            uint nspecs_i = pdef->countSpecs_I();
-            for (uint s = 0; s < nspecs_i; ++s)
-            {
-                uint lhs = lhs_i_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_i_vec[s];
-                if (lhs > cnt)
-                {
-                    return 0.0;
-                }
-                switch (lhs)
-                {
-                    case 4:
-                    {
-                        h_mu *= static_cast<double>(cnt - 3);
-                    }
-                    case 3:
-                    {
-                        h_mu *= static_cast<double>(cnt - 2);
-                    }
-                    case 2:
-                    {
-                        h_mu *= static_cast<double>(cnt - 1);
-                    }
-                    case 1:
-                    {
-                        h_mu *= static_cast<double>(cnt);
-                        break;
-                    }
-                    default:
-                    {
-                        AssertLog(false);
-                    }
-                }
-            }
+            h_mu *= pdef->vdepsreac_prog_I(lidx).h(pTri->iTet()->pools());
         }
         else if (pVDepSReacdef->outside())
         {
-            uint * lhs_o_vec = pdef->vdepsreac_lhs_O_bgn(lidx);
-            auto const& cnt_o_vec = pTri->oTet()->pools();
-            uint nspecs_o = pdef->countSpecs_O();
-            for (uint s = 0; s < nspecs_o; ++s)
-            {
-                uint lhs = lhs_o_vec[s];
-                if (lhs == 0) { continue;
-}
-                uint cnt = cnt_o_vec[s];
-                if (lhs > cnt)
-                {
-                    return 0.0;
-                }
-                switch (lhs)
-                {
-                    case 4:
-                    {
-                        h_mu *= static_cast<double>(cnt - 3);
-                    }
-                    case 3:
-                    {
-                        h_mu *= static_cast<double>(cnt - 2);
-                    }
-                    case 2:
-                    {
-                        h_mu *= static_cast<double>(cnt - 1);
-                    }
-                    case 1:
-                    {
-                        h_mu *= static_cast<double>(cnt);
-                        break;
-                    }
-                    default:
-                    {
-                        AssertLog(false);
-                    }
-                }
-            }
+            h_mu *= pdef->vdepsreac_prog_O(lidx).h(pTri->oTet()->pools());
         }
 
         double v = solver->getTriV(pTri->idx());
@@ -429,32 +318,25 @@ std::vector<stex::KProc*> const & stex::VDepSReac::apply(const rng::RNGptr &/*rn
     }
 
     // Update triangle pools.
-    uint nspecs_s = pdef->countSpecs();
-    for (uint s = 0; s < nspecs_s; ++s)
+    for (auto const& t : pdef->vdepsreac_prog_S(lidx).upd())
     {
-        if (pTri->clamped(s)) continue;
-        int upd = upd_s_vec[s];
-        if (upd == 0) continue;
-        int nc = static_cast<int>(cnt_s_vec[s]) + upd;
+        if (pTri->clamped(t.lidx)) continue;
+        int nc = static_cast<int>(cnt_s_vec[t.lidx]) + t.upd;
         AssertLog(nc >= 0);
-        pTri->setCount(s, static_cast<uint>(nc));
+        pTri->setCount(t.lidx, static_cast<uint>(nc));
     }
 
     // Update inner tet pools.
     stex::WmVol * itet = pTri->iTet();
     if (itet != nullptr)
     {
-        int * upd_i_vec = pdef->vdepsreac_upd_I_bgn(lidx);
         auto const& cnt_i_vec = itet->pools();
-        uint nspecs_i = pdef->countSpecs_I();
-        for (uint s = 0; s < nspecs_i; ++s)
+        for (auto const& t : pdef->vdepsreac_prog_I(lidx).upd())
         {
-            if (itet->clamped(s)) continue;
-            int upd = upd_i_vec[s];
-            if (upd == 0) continue;
-            int nc = static_cast<int>(cnt_i_vec[s]) + upd;
+            if (itet->clamped(t.lidx)) continue;
+            int nc = static_cast<int>(cnt_i_vec[t.lidx]) + t.upd;
             AssertLog(nc >= 0);
-            itet->setCount(s, static_cast<uint>(nc));
+            itet->setCount(t.lidx, static_cast<uint>(nc));
         }
     }
 
@@ -462,17 +344,13 @@ std::vector<stex::KProc*> const & stex::VDepSReac::apply(const rng::RNGptr &/*rn
     stex::WmVol * otet = pTri->oTet();
     if (otet != nullptr)
     {
-        int * upd_o_vec = pdef->vdepsreac_upd_O_bgn(lidx);
         auto const& cnt_o_vec = otet->pools();
-        uint nspecs_o = pdef->countSpecs_O();
-        for (uint s = 0; s < nspecs_o; ++s)
+        for (auto const& t : pdef->vdepsreac_prog_O(lidx).upd())
         {
-            if (otet->clamped(s)) continue;
-            int upd = upd_o_vec[s];
-            if (upd == 0) continue;
-            int nc = static_cast<int>(cnt_o_vec[s]) + upd;
+            if (otet->clamped(t.lidx)) continue;
+            int nc = static_cast<int>(cnt_o_vec[t.lidx]) + t.upd;
             AssertLog(nc >= 0);
-            otet->setCount(s, static_cast<uint>(nc));
+            otet->setCount(t.lidx, static_cast<uint>(nc));
         }
     }
 
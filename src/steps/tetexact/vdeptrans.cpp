@@ -55,6 +55,7 @@ stex::VDepTrans::VDepTrans(ssolver::VDepTransdef * vdtdef, stex::Tri * tri)
 {
     AssertLog(pVDepTransdef != nullptr);
     AssertLog(pTri != nullptr);
+    type = KP_VDEPTRANS;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -64,7 +65,7 @@ stex::VDepTrans::~VDepTrans()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::VDepTrans::checkpoint(std::fstream & cp_file)
+void stex::VDepTrans::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.write(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -77,7 +78,7 @@ void stex::VDepTrans::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::VDepTrans::restore(std::fstream & cp_file)
+void stex::VDepTrans::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&rExtent), sizeof(unsigned long long));
     cp_file.read(reinterpret_cast<char*>(&pFlags), sizeof(uint));
@@ -104,7 +105,7 @@ void stex::VDepTrans::reset()
 
 void stex::VDepTrans::setupDeps()
 {
-    std::set<stex::KProc*> updset;
+    stex::KProcPSet updset;
 
     for (auto const& k : pTri->kprocs()) {
         if (k->depSpecTri(pVDepTransdef->srcchanstate(), pTri)) {
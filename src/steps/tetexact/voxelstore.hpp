@@ -0,0 +1,141 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#ifndef STEPS_TETEXACT_VOXELSTORE_HPP
+#define STEPS_TETEXACT_VOXELSTORE_HPP 1
+
+// STL headers.
+#include <cstddef>
+#include <vector>
+
+// STEPS headers.
+#include "steps/common.h"
+#include "steps/error.hpp"
+
+// logging
+#include <easylogging++.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace steps {
+namespace tetexact {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Contiguous structure-of-arrays storage for the molecule counts and pool
+/// flags of all tetrahedrons, well-mixed volumes and triangles of a Tetexact
+/// solver.
+///
+/// Every element reserves a block of (number of local species) entries while
+/// the solver is being set up. Once all blocks are known the store is
+/// allocated in one go, and elements keep plain pointers into the two flat
+/// arrays, so that entries of neighbouring tets share cache lines.
+///
+/// Only the pools live here: neighbour and kinetic process tables are still
+/// held by the elements themselves.
+///
+class VoxelStore
+{
+
+public:
+
+    VoxelStore() = default;
+
+    VoxelStore(const VoxelStore&) = delete;
+    VoxelStore& operator=(const VoxelStore&) = delete;
+
+    ////////////////////////////////////////////////////////////////////////
+    // SETUP
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Reserve a block of nspecs pools and return its offset in the store.
+    /// Must be called before allocate().
+    ///
+    inline std::size_t reserve(uint nspecs)
+    {
+        AssertLog(!pAllocated);
+        std::size_t offset = pSize;
+        pSize += nspecs;
+        return offset;
+    }
+
+    /// Allocate the flat count and flag arrays, zero-initialised.
+    ///
+    inline void allocate()
+    {
+        AssertLog(!pAllocated);
+        pCounts.assign(pSize, 0);
+        pFlags.assign(pSize, 0);
+        pAllocated = true;
+    }
+
+    inline bool allocated() const noexcept
+    { return pAllocated; }
+
+    ////////////////////////////////////////////////////////////////////////
+    // DATA ACCESS
+    ////////////////////////////////////////////////////////////////////////
+
+    /// Total number of pools over all elements.
+    inline std::size_t size() const noexcept
+    { return pSize; }
+
+    inline uint * counts(std::size_t offset) noexcept
+    { return pCounts.data() + offset; }
+
+    inline uint * flags(std::size_t offset) noexcept
+    { return pFlags.data() + offset; }
+
+    ////////////////////////////////////////////////////////////////////////
+
+private:
+
+    ////////////////////////////////////////////////////////////////////////
+
+    std::size_t                         pSize{0};
+    bool                                pAllocated{false};
+
+    /// Numbers of molecules, indexed by (element offset + local species).
+    std::vector<uint>                   pCounts;
+    /// Flags on these pools -- stored as machine word flags.
+    std::vector<uint>                   pFlags;
+
+    ////////////////////////////////////////////////////////////////////////
+
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif
+
+// STEPS_TETEXACT_VOXELSTORE_HPP
+
+// END
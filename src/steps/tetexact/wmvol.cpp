@@ -69,9 +69,7 @@ stex::WmVol::WmVol
     AssertLog(pVol > 0.0);
 
     // Based on compartment definition, build other structures.
-    auto nspecs = compdef()->countSpecs();
-    pPoolCount.resize(nspecs, 0);
-    pPoolFlags.resize(nspecs, 0);
+    // Pools are attached later to the solver's VoxelStore.
     pKProcs.resize(compdef()->countReacs());
 
 }
@@ -88,19 +86,20 @@ stex::WmVol::~WmVol()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::WmVol::checkpoint(std::fstream & cp_file)
+void stex::WmVol::checkpoint(std::iostream & cp_file)
 {
-    steps::checkpoint(cp_file, pPoolCount, false /* with_size */);
-    steps::checkpoint(cp_file, pPoolFlags, false /* with_size */);
+    const auto nspecs = compdef()->countSpecs();
+    cp_file.write(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
+    cp_file.write(reinterpret_cast<char*>(pPoolFlags), sizeof(uint) * nspecs);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stex::WmVol::restore(std::fstream & cp_file)
+void stex::WmVol::restore(std::iostream & cp_file)
 {
     const auto nspecs = compdef()->countSpecs();
-    steps::restore(cp_file, nspecs, pPoolCount);
-    steps::restore(cp_file, nspecs, pPoolFlags);
+    cp_file.read(reinterpret_cast<char*>(pPoolCount), sizeof(uint) * nspecs);
+    cp_file.read(reinterpret_cast<char*>(pPoolFlags), sizeof(uint) * nspecs);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,8 +111,18 @@ void stex::WmVol::setNextTri(stex::Tri * t)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void stex::WmVol::setPoolStorage(uint * counts, uint * flags)
+{
+    AssertLog(counts != nullptr && flags != nullptr);
+    pPoolCount = counts;
+    pPoolFlags = flags;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void stex::WmVol::setupKProcs(stex::Tetexact * tex)
 {
+    setSolver(tex);
 
     uint j = 0;
 
@@ -135,8 +144,9 @@ void stex::WmVol::setupKProcs(stex::Tetexact * tex)
 
 void stex::WmVol::reset()
 {
-    std::fill(pPoolCount.begin(), pPoolCount.end(), 0);
-    std::fill(pPoolFlags.begin(), pPoolFlags.end(), 0);
+    const auto nspecs = compdef()->countSpecs();
+    std::fill_n(pPoolCount, nspecs, 0);
+    std::fill_n(pPoolFlags, nspecs, 0);
     for (auto kproc: pKProcs) {
         kproc->reset();
     }
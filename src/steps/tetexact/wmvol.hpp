@@ -89,10 +89,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    virtual void checkpoint(std::fstream & cp_file);
+    virtual void checkpoint(std::iostream & cp_file);
 
     /// restore data
-    virtual void restore(std::fstream & cp_file);
+    virtual void restore(std::iostream & cp_file);
 
     ////////////////////////////////////////////////////////////////////////
     // SETUP
@@ -105,6 +105,10 @@ public:
 
     virtual void setNextTri(stex::Tri *t);
 
+    /// Attach the molecule counts and pool flags of this volume to their
+    /// block in the solver's contiguous VoxelStore.
+    void setPoolStorage(uint * counts, uint * flags);
+
     ////////////////////////////////////////////////////////////////////////
 
     virtual void reset();
@@ -130,7 +134,7 @@ public:
 
     ////////////////////////////////////////////////////////////////////////
 
-    inline const std::vector<uint>& pools() const noexcept
+    inline uint * pools() const noexcept
     { return pPoolCount; }
     void setCount(uint lidx, uint count);
     void incCount(uint lidx, int inc);
@@ -169,6 +173,14 @@ public:
 
     ////////////////////////////////////////////////////////////////////////
 
+    /// Sub-domain the volume belongs to; see Tetexact::setNThreads().
+    inline uint getDomain() const noexcept { return pDomain; }
+    inline void setDomain(uint domain) noexcept { pDomain = domain; }
+    void setSolver(stex::Tetexact * solver) noexcept { pSol = solver; }
+    inline stex::Tetexact * solver() const noexcept { return pSol; }
+
+    ////////////////////////////////////////////////////////////////////////
+
 protected:
 
     /// The kinetic processes.
@@ -189,10 +201,13 @@ private:
 
     double                              pVol;
 
-    /// Numbers of molecules -- stored as uint.
-    std::vector<uint>                   pPoolCount;
+    /// Numbers of molecules -- stored as uint in the solver VoxelStore.
+    uint                              * pPoolCount{nullptr};
     /// Flags on these pools -- stored as machine word flags.
-    std::vector<uint>                   pPoolFlags;
+    uint                              * pPoolFlags{nullptr};
+
+    uint                                pDomain{0};
+    stex::Tetexact                    * pSol{nullptr};
 
     ////////////////////////////////////////////////////////////////////////
 
@@ -57,14 +57,14 @@ stode::Comp::~Comp()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Comp::checkpoint(std::fstream & cp_file)
+void stode::Comp::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pVol), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Comp::restore(std::fstream & cp_file)
+void stode::Comp::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pVol), sizeof(double));
 }
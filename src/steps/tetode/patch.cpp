@@ -61,14 +61,14 @@ stode::Patch::~Patch()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Patch::checkpoint(std::fstream & cp_file)
+void stode::Patch::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*> (&pArea), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Patch::restore(std::fstream & cp_file)
+void stode::Patch::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pArea), sizeof(double));
 }
@@ -135,13 +135,13 @@ void stode::Tet::setNextTri(uint i, stode::Tri * t)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Tet::checkpoint(std::fstream & /*cp_file*/)
+void stode::Tet::checkpoint(std::iostream & /*cp_file*/)
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Tet::restore(std::fstream & /*cp_file*/)
+void stode::Tet::restore(std::iostream & /*cp_file*/)
 {
 }
 
@@ -25,13 +25,19 @@
  */
 
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <memory>
 #include <sstream>
+#include <vector>
 
 #include <cvode/cvode.h>                 /* prototypes for CVODE fcts., consts. */
 #include <cvode/cvode_dense.h>          /* prototype for CVDense */
+#include <cvode/cvode_spbcgs.h>         /* prototypes for the Krylov solvers */
+#include <cvode/cvode_spgmr.h>
+#include <cvode/cvode_spils.h>
+#include <cvode/cvode_sptfqmr.h>
 #include <nvector/nvector_serial.h>      /* serial N_Vector types, fcts., macros */
 #include <sundials/sundials_dense.h>     /* definitions DlsMat DENSE_ELEM */
 #include <sundials/sundials_nvector.h>
@@ -54,6 +60,7 @@
 #include "steps/solver/reacdef.hpp"
 #include "steps/solver/sreacdef.hpp"
 #include "steps/solver/vdepsreacdef.hpp"
+#include "steps/util/checkpoint.hpp"
 
 #include "steps/geom/tetmesh.hpp"
 
@@ -114,6 +121,58 @@ static int f_cvode(realtype /*t*/, N_Vector y, N_Vector ydot, void */*user_data*
   return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+static inline double spec_pow(double val, uint order)
+{
+  if (order == 0) return 1.0;
+  if (order == 1) return val;
+  return pow(val, order);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Call fn(spec_idx, d) for every reactant of the reaction term r, where d is
+// the derivative of the term with respect to the reactant in the state y.
+
+template <typename Fn>
+static void reac_partials(steps::tetode::structA const& r, const realtype * y, Fn fn)
+{
+  for (auto const& p: r.players) {
+    for (auto const& q: p.info) {
+      double d = r.upd * r.ccst * q.order * spec_pow(y[q.spec_idx], q.order - 1);
+      for (auto const& p2: r.players) {
+        for (auto const& q2: p2.info) {
+          if (&q2 != &q) d *= spec_pow(y[q2.spec_idx], q2.order);
+        }
+      }
+      fn(q.spec_idx, d);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Product of the Jacobian of f_cvode with v, for the Newton iteration
+
+static int jtv_cvode(N_Vector v, N_Vector Jv, realtype /*t*/, N_Vector y,
+                     N_Vector /*fy*/, void */*user_data*/, N_Vector /*tmp*/)
+{
+  const realtype * yd = NV_DATA_S(y);
+  const realtype * vd = NV_DATA_S(v);
+  uint i = 0;
+  for (auto const& sp: pSpec_matrixsub) {
+    double jv = 0.0;
+    for (auto const& r: sp) {
+      reac_partials(r, yd, [&jv, vd](uint k, double d) { jv += d * vd[k]; });
+    }
+    Ith(Jv, i) = jv;
+    ++i;
+  }
+
+  return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
  namespace steps {
@@ -134,9 +193,34 @@ static int f_cvode(realtype /*t*/, N_Vector y, N_Vector ydot, void */*user_data*
    // Memory block for CVODE
    void     * cvode_mem_cvode;
 
+   // Krylov methods of the stiff mode
+   enum LinSolver {SPGMR, SPBCG, SPTFQMR};
+
+   // BDF and Newton iteration instead of Adams and functional iteration
+   bool stiff{false};
+   LinSolver linsolver{SPGMR};
+
+   // Steps taken by run()
+   unsigned long long nsteps{0};
+
+   // Diagonal blocks of the preconditioner: the species of block b are
+   // block_bgn[b] to block_bgn[b+1]-1, and its matrices, stored by
+   // column, start at block_mat[b] in jac and prec.
+   std::vector<uint> block_bgn;
+   std::vector<uint> block_mat;
+   // Jacobian blocks, and their LU factorisation for I - gamma * J
+   std::vector<realtype> jac;
+   std::vector<realtype> prec;
+   std::vector<realtype *> prec_cols;
+   std::vector<int> prec_piv;
+
    CVodeState(uint N_, uint maxn, double atol, double rtol);
    ~CVodeState();
 
+   void create();
+   void setStiff(bool stiff_, LinSolver ls);
+   void setBlocks(std::vector<uint> const & sizes);
+
    void setTolerances(double atol, double rtol);
    void setMaxNumSteps(uint maxn);
    int  initialise();
@@ -144,8 +228,12 @@ static int f_cvode(realtype /*t*/, N_Vector y, N_Vector ydot, void */*user_data*
 
    int  run(realtype endtime);
 
-   void checkpoint(std::fstream &);
-   void restore(std::fstream &);
+   void evalJacBlocks(N_Vector y);
+   int  factorPrec(realtype gamma);
+   void solvePrec(N_Vector r, N_Vector z);
+
+   void checkpoint(std::iostream &);
+   void restore(std::iostream &);
  };
 
 void check_flag(void *flagvalue, const char *funcname, int opt)
@@ -195,23 +283,33 @@ CVodeState::CVodeState(uint N_, uint maxn, realtype atol, realtype rtol) {
         Ith(abstol_cvode, i) = atol;
     }
 
-    // Call CVodeCreate to create the solver memory and specify the
-    // Backward Differentiation Formula and the use of a Newton iteration
-    //cvode_mem_cvode = CVodeCreate(CV_BDF, CV_NEWTON);
-    // NO- the above choice eats up memory like you wouldn't believe
-    // and causes segmentation faults
-
-    // ADAMS and FUNCTIONAL are a much much better choice
-    cvode_mem_cvode = CVodeCreate(CV_ADAMS, CV_FUNCTIONAL) ;
-
-    check_flag(cvode_mem_cvode, "CVodeCreate", 0);
-
     // Initialise y:
     for (uint i=0; i<N; ++i)
     {
         Ith(y_cvode, i) = 0.0;
     }
 
+    cvode_mem_cvode = nullptr;
+    create();
+}
+
+void CVodeState::create() {
+    if (cvode_mem_cvode != nullptr) {
+        CVodeFree(&cvode_mem_cvode);
+    }
+
+    // Call CVodeCreate to create the solver memory.
+    // ADAMS and FUNCTIONAL are the default choice: BDF and NEWTON with the
+    // dense linear solver eat up memory like you wouldn't believe, so the
+    // stiff mode relies on a preconditioned Krylov solver instead.
+    if (stiff) {
+        cvode_mem_cvode = CVodeCreate(CV_BDF, CV_NEWTON);
+    } else {
+        cvode_mem_cvode = CVodeCreate(CV_ADAMS, CV_FUNCTIONAL);
+    }
+
+    check_flag(cvode_mem_cvode, "CVodeCreate", 0);
+
     // Call CVodeInit to initialize the integrator memory and specify the
     // user's right hand side function in y'=f(t,y), the initial time T0, and
     // the initial dependent variable vector y.
@@ -221,6 +319,9 @@ CVodeState::CVodeState(uint N_, uint maxn, realtype atol, realtype rtol) {
     // creating and freeing memory, copying structures etc and could be quite tricky
     int flag = CVodeInit(cvode_mem_cvode, f_cvode, 0.0, y_cvode);
     check_flag(&flag, "CVodeInit", 1);
+
+    flag = CVodeSetUserData(cvode_mem_cvode, this);
+    check_flag(&flag, "CVodeSetUserData", 1);
 }
 
 CVodeState::~CVodeState() {
@@ -233,7 +334,7 @@ CVodeState::~CVodeState() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void CVodeState::checkpoint(std::fstream &cp_file) {
+void CVodeState::checkpoint(std::iostream &cp_file) {
     cp_file.write(reinterpret_cast<char*>(&Nmax_cvode), sizeof(uint));
     cp_file.write(reinterpret_cast<char*>(&reltol_cvode), sizeof(realtype));
     {
@@ -249,7 +350,7 @@ void CVodeState::checkpoint(std::fstream &cp_file) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void CVodeState::restore(std::fstream &cp_file) {
+void CVodeState::restore(std::iostream &cp_file) {
     cp_file.read(reinterpret_cast<char*>(&Nmax_cvode), sizeof(uint));
     cp_file.read(reinterpret_cast<char*>(&reltol_cvode), sizeof(realtype));
     {
@@ -294,6 +395,127 @@ void CVodeState::setMaxNumSteps(uint maxn) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CVodeState::setStiff(bool stiff_, LinSolver ls) {
+    stiff = stiff_;
+    linsolver = ls;
+
+    // The method and the iteration are fixed when the memory is created
+    create();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CVodeState::setBlocks(std::vector<uint> const & sizes) {
+    block_bgn.assign(1, 0);
+    block_mat.assign(1, 0);
+    for (auto n: sizes) {
+        if (n == 0) continue;
+        block_bgn.push_back(block_bgn.back() + n);
+        block_mat.push_back(block_mat.back() + n * n);
+    }
+    AssertLog(block_bgn.back() == N);
+
+    jac.assign(block_mat.back(), 0.0);
+    prec.assign(block_mat.back(), 0.0);
+    prec_piv.assign(N, 0);
+
+    // Column pointers of the blocks, as expected by denseGETRF
+    prec_cols.resize(N);
+    for (uint b = 0; b + 1 < block_bgn.size(); ++b) {
+        uint n = block_bgn[b + 1] - block_bgn[b];
+        for (uint j = 0; j < n; ++j) {
+            prec_cols[block_bgn[b] + j] = prec.data() + block_mat[b] + j * n;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CVodeState::evalJacBlocks(N_Vector y) {
+    const realtype * yd = NV_DATA_S(y);
+    std::fill(jac.begin(), jac.end(), 0.0);
+
+    for (uint b = 0; b + 1 < block_bgn.size(); ++b) {
+        uint bgn = block_bgn[b];
+        uint end = block_bgn[b + 1];
+        uint n = end - bgn;
+        realtype * block = jac.data() + block_mat[b];
+        for (uint i = bgn; i < end; ++i) {
+            for (auto const& r: pSpec_matrixsub[i]) {
+                // Dependencies on other blocks, i.e. diffusion from the
+                // neighbours and surface reactions, are left out
+                reac_partials(r, yd, [=](uint k, double d) {
+                    if (k >= bgn && k < end) block[(k - bgn) * n + (i - bgn)] += d;
+                });
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int CVodeState::factorPrec(realtype gamma) {
+    for (std::size_t e = 0; e < jac.size(); ++e) {
+        prec[e] = -gamma * jac[e];
+    }
+
+    for (uint b = 0; b + 1 < block_bgn.size(); ++b) {
+        uint bgn = block_bgn[b];
+        int n = static_cast<int>(block_bgn[b + 1] - bgn);
+        realtype ** cols = prec_cols.data() + bgn;
+        for (int j = 0; j < n; ++j) {
+            cols[j][j] += 1.0;
+        }
+        // A singular block is recoverable: CVODE retries with a smaller step
+        if (denseGETRF(cols, n, n, prec_piv.data() + bgn) != 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CVodeState::solvePrec(N_Vector r, N_Vector z) {
+    N_VScale(1.0, r, z);
+    realtype * zd = NV_DATA_S(z);
+
+    for (uint b = 0; b + 1 < block_bgn.size(); ++b) {
+        uint bgn = block_bgn[b];
+        int n = static_cast<int>(block_bgn[b + 1] - bgn);
+        denseGETRS(prec_cols.data() + bgn, n, prec_piv.data() + bgn, zd + bgn);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static int psetup_cvode(realtype /*t*/, N_Vector y, N_Vector /*fy*/,
+                        booleantype jok, booleantype *jcurPtr,
+                        realtype gamma, void *user_data,
+                        N_Vector /*tmp1*/, N_Vector /*tmp2*/, N_Vector /*tmp3*/)
+{
+    auto state = static_cast<CVodeState *>(user_data);
+    if (jok) {
+        *jcurPtr = FALSE;
+    } else {
+        state->evalJacBlocks(y);
+        *jcurPtr = TRUE;
+    }
+    return state->factorPrec(gamma);
+}
+
+static int psolve_cvode(realtype /*t*/, N_Vector /*y*/, N_Vector /*fy*/,
+                        N_Vector r, N_Vector z,
+                        realtype /*gamma*/, realtype /*delta*/,
+                        int /*lr*/, void *user_data, N_Vector /*tmp*/)
+{
+    static_cast<CVodeState *>(user_data)->solvePrec(r, z);
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 int CVodeState::initialise() {
     int flag;
 
@@ -309,6 +531,30 @@ int CVodeState::initialise() {
     //flag = CVDense(cvode_mem_cvode, pSpecs_tot);
     //check_flag(&flag, "CVDense", 1);
 
+    if (stiff) {
+        // Krylov solver preconditioned on the left, default subspace size
+        switch (linsolver) {
+            case SPGMR:
+                flag = CVSpgmr(cvode_mem_cvode, PREC_LEFT, 0);
+                check_flag(&flag, "CVSpgmr", 1);
+                break;
+            case SPBCG:
+                flag = CVSpbcg(cvode_mem_cvode, PREC_LEFT, 0);
+                check_flag(&flag, "CVSpbcg", 1);
+                break;
+            case SPTFQMR:
+                flag = CVSptfqmr(cvode_mem_cvode, PREC_LEFT, 0);
+                check_flag(&flag, "CVSptfqmr", 1);
+                break;
+        }
+
+        flag = CVSpilsSetJacTimesVecFn(cvode_mem_cvode, jtv_cvode);
+        check_flag(&flag, "CVSpilsSetJacTimesVecFn", 1);
+
+        flag = CVSpilsSetPreconditioner(cvode_mem_cvode, psetup_cvode, psolve_cvode);
+        check_flag(&flag, "CVSpilsSetPreconditioner", 1);
+    }
+
     return flag;
 }
 
@@ -321,7 +567,13 @@ int CVodeState::reinit(realtype starttime) {
 
 int CVodeState::run(realtype endtime) {
     realtype t;
-    return CVode(cvode_mem_cvode, endtime, y_cvode, &t, CV_NORMAL);
+    long int nst_bgn = 0;
+    long int nst_end = 0;
+    CVodeGetNumSteps(cvode_mem_cvode, &nst_bgn);
+    int flag = CVode(cvode_mem_cvode, endtime, y_cvode, &t, CV_NORMAL);
+    CVodeGetNumSteps(cvode_mem_cvode, &nst_end);
+    nsteps += nst_end - nst_bgn;
+    return flag;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -395,10 +647,8 @@ std::string TetODE::getSolverEmail() const
 
 void TetODE::checkpoint(std::string const & file_name)
 {
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                 std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    steps::util::CheckpointWriter cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     statedef().checkpoint(cp_file);
 
@@ -426,19 +676,15 @@ void TetODE::checkpoint(std::string const & file_name)
         pEField->checkpoint(cp_file);
     }
 
-    cp_file.close();
+    cp.write();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void TetODE::restore(std::string const & file_name)
 {
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                 std::fstream::in | std::fstream::binary);
-
-    cp_file.seekg(0);
+    steps::util::CheckpointReader cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     statedef().restore(cp_file);
 
@@ -466,7 +712,7 @@ void TetODE::restore(std::string const & file_name)
         pEField->restore(cp_file);
     }
 
-    cp_file.close();
+    cp.finish();
 
     pTolsset = true;
 }
@@ -489,6 +735,38 @@ void TetODE::setMaxNumSteps(uint maxn)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void TetODE::setStiff(bool stiff, std::string const & linsolver)
+{
+    CVodeState::LinSolver ls = CVodeState::SPGMR;
+    if (linsolver == "spgmr") {
+        ls = CVodeState::SPGMR;
+    } else if (linsolver == "spbcg") {
+        ls = CVodeState::SPBCG;
+    } else if (linsolver == "sptfqmr") {
+        ls = CVodeState::SPTFQMR;
+    } else {
+        std::ostringstream os;
+        os << "Unknown linear solver '" << linsolver << "': expected ";
+        os << "'spgmr', 'spbcg' or 'sptfqmr'.\n";
+        ArgErrLog(os.str());
+    }
+
+    pCVodeState->setStiff(stiff, ls);
+
+    // The new CVODE memory needs its options and the current state
+    pInitialised = false;
+    pReinit = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+unsigned long long TetODE::getNumSteps() const
+{
+    return pCVodeState->nsteps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 double TetODE::getTime() const
 {
     return statedef().time();
@@ -1404,6 +1682,19 @@ void TetODE::_setup()
 
     pCVodeState = new CVodeState(pSpecs_tot, 10000, 1.0e-3, 1.0e-3);
 
+    // The species of each tet, then of each tri, are contiguous: they make
+    // the diagonal blocks of the preconditioner in stiff mode
+    std::vector<uint> blocks;
+    for (uint i=0; i< Comps_N; ++i)
+    {
+        blocks.insert(blocks.end(), pComps[i]->countTets(), statedef().compdef(i)->countSpecs());
+    }
+    for (uint i=0; i< Patches_N; ++i)
+    {
+        blocks.insert(blocks.end(), pPatches[i]->countTris(), statedef().patchdef(i)->countSpecs());
+    }
+    pCVodeState->setBlocks(blocks);
+
     if (efflag()) _setupEField();
 
 }
@@ -404,6 +404,21 @@ public:
 
     void setMaxNumSteps(uint maxn);
 
+    /// Select the integration scheme of CVODE.
+    ///
+    /// \param stiff Use the BDF method with Newton iteration instead of the
+    ///        default Adams method with functional iteration.
+    /// \param linsolver Krylov method solving the Newton systems in stiff
+    ///        mode: "spgmr", "spbcg" or "sptfqmr".
+    ///
+    /// In stiff mode the Jacobian is applied analytically, and the Krylov
+    /// method is preconditioned by the Jacobian blocks coupling the species
+    /// of each tetrahedron and of each triangle.
+    void setStiff(bool stiff, std::string const & linsolver = "spgmr");
+
+    /// Number of internal CVODE steps taken since the solver was created.
+    unsigned long long getNumSteps() const;
+
     ////////////////////////// ADDED FOR EFIELD ////////////////////////////
 
     /// Check the EField flag
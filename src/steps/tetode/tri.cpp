@@ -129,13 +129,13 @@ void stode::Tri::setNextTri(uint i, stode::Tri * t)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Tri::checkpoint(std::fstream & /*cp_file*/)
+void stode::Tri::checkpoint(std::iostream & /*cp_file*/)
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void stode::Tri::restore(std::fstream & /*cp_file*/)
+void stode::Tri::restore(std::iostream & /*cp_file*/)
 {
 }
 
@@ -0,0 +1,427 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+// POSIX headers.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <easylogging++.h>
+
+#include "steps/error.hpp"
+#include "steps/util/checkpoint.hpp"
+
+namespace steps {
+namespace util {
+
+namespace {
+
+const char CHECKPOINT_FILE_MAGIC[8] = {'S', 'T', 'E', 'P', 'S', 'C', 'K', 'P'};
+const std::uint32_t CHECKPOINT_FILE_VERSION = 1;
+const std::uint32_t CHECKPOINT_FILE_ENDIAN = 0x01020304;
+
+struct CheckpointFileHeader {
+    char            magic[8];
+    std::uint32_t   version;
+    std::uint32_t   endian;
+    // Name of the solver, zero-terminated.
+    char            solver[32];
+    std::uint64_t   state_bytes;
+    std::uint64_t   checksum;
+};
+
+static_assert(sizeof(CheckpointFileHeader) % 8 == 0, "Unexpected padding in checkpoint file header");
+
+// Size of the chunks the state is written in; a multiple of 8 so that the
+// checksum of successive chunks is the checksum of the whole state.
+const std::size_t CHECKPOINT_CHUNK_BYTES = 4u << 20;
+
+const std::uint64_t FNV_OFFSET = 0xcbf29ce484222325ull;
+const std::uint64_t FNV_PRIME = 0x100000001b3ull;
+
+// FNV-1a over 64-bit words, then over the trailing bytes.
+std::uint64_t fnv1aWords(std::uint64_t h, const char * data, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= n; i += sizeof(std::uint64_t)) {
+        std::uint64_t w;
+        std::memcpy(&w, data + i, sizeof(w));
+        h = (h ^ w) * FNV_PRIME;
+    }
+    for (; i < n; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * FNV_PRIME;
+    }
+    return h;
+}
+
+std::string solverName(const char (&name)[32]) {
+    return std::string(name, std::find(name, name + sizeof(name), '\0'));
+}
+
+CheckpointFileHeader makeHeader(std::string const & solver, std::uint64_t state_bytes, std::uint64_t checksum) {
+    CheckpointFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CHECKPOINT_FILE_MAGIC, sizeof(header.magic));
+    header.version = CHECKPOINT_FILE_VERSION;
+    header.endian = CHECKPOINT_FILE_ENDIAN;
+    solver.copy(header.solver, sizeof(header.solver) - 1);
+    header.state_bytes = state_bytes;
+    header.checksum = checksum;
+    return header;
+}
+
+bool writeAll(int fd, const char * data, std::size_t n) {
+    while (n != 0) {
+        ssize_t w = ::write(fd, data, n);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += w;
+        n -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+// Body of the background thread of a CheckpointQueue. All chunks but the
+// last one are full, so the checksum is computed chunk by chunk.
+void writeCaptured(int fd, std::string solver, std::vector<impl::checkpoint_chunk> chunks, bool * failed) {
+    std::uint64_t state_bytes = 0;
+    std::uint64_t checksum = FNV_OFFSET;
+    for (auto const & c: chunks) {
+        checksum = fnv1aWords(checksum, c.data.get(), c.size);
+        state_bytes += c.size;
+    }
+    CheckpointFileHeader header = makeHeader(solver, state_bytes, checksum);
+    bool ok = writeAll(fd, reinterpret_cast<const char *>(&header), sizeof(header));
+    for (auto & c: chunks) {
+        ok = ok && writeAll(fd, c.data.get(), c.size);
+        c.data.reset();
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+    *failed = !ok;
+}
+
+void corrupted(std::string const & file_name) {
+    std::ostringstream os;
+    os << "Checkpoint file " << file_name << " is truncated or corrupted.";
+    ArgErrLog(os.str());
+}
+
+} // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace impl {
+
+checkpoint_outbuf::checkpoint_outbuf()
+: checksum_(FNV_OFFSET)
+{
+    _newChunk();
+}
+
+void checkpoint_outbuf::_newChunk() {
+    // Left uninitialised: every chunk is filled before it is used.
+    chunk_.reset(new char[CHECKPOINT_CHUNK_BYTES]);
+    setp(chunk_.get(), chunk_.get() + CHECKPOINT_CHUNK_BYTES);
+}
+
+bool checkpoint_outbuf::flush() {
+    std::size_t n = static_cast<std::size_t>(pptr() - pbase());
+    size_ += n;
+    if (os_ == nullptr) {
+        if (n != 0) {
+            chunks_.push_back(checkpoint_chunk{std::move(chunk_), n});
+            _newChunk();
+        }
+        return true;
+    }
+    checksum_ = fnv1aWords(checksum_, pbase(), n);
+    setp(chunk_.get(), chunk_.get() + CHECKPOINT_CHUNK_BYTES);
+    os_->write(chunk_.get(), static_cast<std::streamsize>(n));
+    return static_cast<bool>(*os_);
+}
+
+std::vector<checkpoint_chunk> checkpoint_outbuf::takeChunks() {
+    std::vector<checkpoint_chunk> chunks;
+    chunks.swap(chunks_);
+    return chunks;
+}
+
+checkpoint_outbuf::int_type checkpoint_outbuf::overflow(int_type c) {
+    if (!flush()) return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+std::streamsize checkpoint_outbuf::xsputn(const char * s, std::streamsize n) {
+    std::streamsize done = 0;
+    while (done < n) {
+        if (pptr() == epptr() && !flush()) break;
+        std::streamsize m = std::min<std::streamsize>(n - done, epptr() - pptr());
+        std::memcpy(pptr(), s + done, static_cast<std::size_t>(m));
+        pbump(static_cast<int>(m));
+        done += m;
+    }
+    return done;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void checkpoint_inbuf::setInput(const char * b, const char * e) {
+    // The get area is only read from.
+    char * gb = const_cast<char *>(b);
+    setg(gb, gb, const_cast<char *>(e));
+}
+
+checkpoint_inbuf::pos_type checkpoint_inbuf::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                     std::ios_base::openmode which) {
+    if (!(which & std::ios_base::in)) return pos_type(off_type(-1));
+
+    off_type base = 0;
+    if (dir == std::ios_base::cur) base = gptr() - eback();
+    else if (dir == std::ios_base::end) base = egptr() - eback();
+    off_type pos = base + off;
+    if (pos < 0 || pos > egptr() - eback()) return pos_type(off_type(-1));
+    setg(eback(), eback() + pos, egptr());
+    return pos_type(pos);
+}
+
+checkpoint_inbuf::pos_type checkpoint_inbuf::seekpos(pos_type pos, std::ios_base::openmode which) {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+} // namespace impl
+
+////////////////////////////////////////////////////////////////////////////////
+
+CheckpointQueue::~CheckpointQueue() {
+    if (!worker_.joinable()) return;
+    worker_.join();
+    if (failed_) {
+        CLOG(ERROR, "general_log") << "Error while writing checkpoint file " << file_name_ << ".\n";
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CheckpointQueue::wait() {
+    if (!worker_.joinable()) return;
+    worker_.join();
+    if (failed_) {
+        failed_ = false;
+        std::ostringstream os;
+        os << "Error while writing checkpoint file " << file_name_ << ".";
+        ArgErrLog(os.str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CheckpointQueue::_submit(std::string const & file_name, std::string const & solver,
+                              int fd, std::vector<impl::checkpoint_chunk> && chunks) {
+    AssertLog(!worker_.joinable());
+    file_name_ = file_name;
+    failed_ = false;
+    worker_ = std::thread(writeCaptured, fd, solver, std::move(chunks), &failed_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CheckpointWriter::CheckpointWriter(std::string const & file_name, std::string const & solver,
+                                   CheckpointQueue * queue)
+: file_name_(file_name)
+, solver_(solver)
+, queue_(queue)
+, stream_(&buffer_)
+{
+    // In asynchronous mode the state is kept in memory until write().
+    if (queue_ != nullptr && queue_->async()) return;
+
+    if (queue_ != nullptr) queue_->wait();
+    file_.open(file_name_, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        std::ostringstream os;
+        os << "Unable to open checkpoint file " << file_name_ << " for writing.";
+        ArgErrLog(os.str());
+    }
+    // The header is written last, once the state is known.
+    CheckpointFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    buffer_.open(&file_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CheckpointWriter::write() {
+    bool ok = static_cast<bool>(stream_) && buffer_.flush();
+
+    if (ok && !file_.is_open()) {
+        std::vector<impl::checkpoint_chunk> chunks = buffer_.takeChunks();
+        queue_->wait();
+        int fd = ::open(file_name_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0) {
+            std::ostringstream os;
+            os << "Unable to open checkpoint file " << file_name_ << " for writing.";
+            ArgErrLog(os.str());
+        }
+        queue_->_submit(file_name_, solver_, fd, std::move(chunks));
+        return;
+    }
+
+    if (ok) {
+        CheckpointFileHeader header = makeHeader(solver_, buffer_.size(), buffer_.checksum());
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file_.close();
+    }
+    if (!ok || !file_) {
+        std::ostringstream os;
+        os << "Error while writing checkpoint file " << file_name_ << ".";
+        ArgErrLog(os.str());
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CheckpointReader::CheckpointReader(std::string const & file_name, std::string const & solver,
+                                   CheckpointQueue * queue)
+: file_name_(file_name)
+, stream_(&buffer_)
+{
+    if (queue != nullptr) queue->wait();
+
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::ostringstream os;
+        os << "Unable to open checkpoint file " << file_name << ".";
+        ArgErrLog(os.str());
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        std::ostringstream os;
+        os << "Unable to stat checkpoint file " << file_name << ".";
+        ArgErrLog(os.str());
+    }
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ != 0) {
+        void * addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            std::ostringstream os;
+            os << "Unable to map checkpoint file " << file_name << " in memory.";
+            ArgErrLog(os.str());
+        }
+        data_ = static_cast<const char *>(addr);
+#ifdef MADV_SEQUENTIAL
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+#endif
+    }
+    ::close(fd);
+
+    try {
+        _checkHeader(solver);
+    }
+    catch (...) {
+        if (data_ != nullptr) ::munmap(const_cast<char *>(data_), size_);
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CheckpointReader::_checkHeader(std::string const & solver) {
+    CheckpointFileHeader header;
+    if (size_ < sizeof(header) || !std::equal(CHECKPOINT_FILE_MAGIC, CHECKPOINT_FILE_MAGIC + sizeof(header.magic), data_)) {
+        CLOG(WARNING, "general_log") << "Checkpoint file " << file_name_
+                                     << " has no header: it is restored without integrity check.\n";
+        buffer_.setInput(data_, data_ + size_);
+        return;
+    }
+    std::memcpy(&header, data_, sizeof(header));
+    version_ = header.version;
+
+    if (header.version > CHECKPOINT_FILE_VERSION) {
+        std::ostringstream os;
+        os << "Checkpoint file " << file_name_ << " uses format version " << header.version
+           << ", more recent than the supported version " << CHECKPOINT_FILE_VERSION << ".";
+        ArgErrLog(os.str());
+    }
+    if (header.endian != CHECKPOINT_FILE_ENDIAN) {
+        std::ostringstream os;
+        os << "Checkpoint file " << file_name_ << " was written on a machine of different byte order.";
+        ArgErrLog(os.str());
+    }
+    std::string cp_solver = solverName(header.solver);
+    if (cp_solver != solver.substr(0, sizeof(header.solver) - 1)) {
+        std::ostringstream os;
+        os << "Checkpoint file " << file_name_ << " was written by solver " << cp_solver
+           << ", it cannot be restored by solver " << solver << ".";
+        ArgErrLog(os.str());
+    }
+
+    const char * state = data_ + sizeof(header);
+    if (header.state_bytes != size_ - sizeof(header)
+        || fnv1aWords(FNV_OFFSET, state, size_ - sizeof(header)) != header.checksum) {
+        corrupted(file_name_);
+    }
+    buffer_.setInput(state, data_ + size_);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+CheckpointReader::~CheckpointReader() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char *>(data_), size_);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CheckpointReader::finish() {
+    if (!stream_ || (version_ > 0 && buffer_.remaining() != 0)) {
+        std::ostringstream os;
+        os << "Checkpoint file " << file_name_ << " does not match the model and geometry of the solver.";
+        ArgErrLog(os.str());
+    }
+}
+
+} // namespace util
+} // namespace steps
+
+// END
@@ -0,0 +1,273 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_UTIL_CHECKPOINT_HPP
+#define STEPS_UTIL_CHECKPOINT_HPP 1
+
+/** \file Versioned container of solver checkpoints.
+ *
+ * A checkpoint file is a fixed-size header followed by the state of the
+ * solver, as serialised by its checkpoint() members. The header holds the
+ * format version, the byte order of the writing machine, the name of the
+ * solver, and the size and a checksum of the state.
+ *
+ * CheckpointWriter streams the state to the file in large chunks, and
+ * CheckpointReader maps the file in memory and checks the header and the
+ * checksum before any state is restored. Files written before the header
+ * was introduced (format version 0) are still restored, without any check.
+ *
+ * With an asynchronous CheckpointQueue, CheckpointWriter instead copies the
+ * state in memory and the file is written by a background thread, so that
+ * the solver can go on while the file is written.
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace steps {
+namespace util {
+
+namespace impl {
+
+/** Chunk of a state kept in memory. */
+struct checkpoint_chunk {
+    std::unique_ptr<char[]>             data;
+    std::size_t                         size;
+};
+
+/** Stream buffer writing a checkpoint file in chunks and computing the
+ * checksum of the bytes written.
+ *
+ * Until open() is called, the chunks are kept in memory instead; they are
+ * then released by takeChunks() and no checksum is computed.
+ */
+class checkpoint_outbuf: public std::streambuf {
+public:
+    checkpoint_outbuf();
+
+    /** Write the chunks to os, starting at its current position. */
+    void open(std::ostream * os) noexcept { os_ = os; }
+
+    /** Write or keep the pending bytes; return false if writing failed. */
+    bool flush();
+
+    /** Chunks kept in memory, in order. */
+    std::vector<checkpoint_chunk> takeChunks();
+
+    std::uint64_t size() const noexcept { return size_ + static_cast<std::uint64_t>(pptr() - pbase()); }
+    std::uint64_t checksum() const noexcept { return checksum_; }
+
+protected:
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char * s, std::streamsize n) override;
+
+private:
+    void _newChunk();
+
+    std::unique_ptr<char[]>             chunk_;
+    std::vector<checkpoint_chunk>       chunks_;
+    std::ostream                      * os_{nullptr};
+    std::uint64_t                       size_{0};
+    std::uint64_t                       checksum_;
+};
+
+/** Stream buffer reading from bytes in memory. */
+class checkpoint_inbuf: public std::streambuf {
+public:
+    void setInput(const char * b, const char * e);
+
+    /** Number of bytes left to read. */
+    std::size_t remaining() const noexcept { return static_cast<std::size_t>(egptr() - gptr()); }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
+
+} // namespace impl
+
+/** Checkpoint files of a solver being written in the background.
+ *
+ * In asynchronous mode, CheckpointWriter hands the state it captured to
+ * the queue, which writes the file and synchronises it to disk on a
+ * separate thread. At most one file is pending: a new one is only handed
+ * over once the previous one is written, which bounds the memory used by
+ * the captured states.
+ *
+ * An error while writing the pending file is reported by the next call to
+ * wait(), either directly or through the next CheckpointWriter or
+ * CheckpointReader using the queue.
+ */
+class CheckpointQueue {
+public:
+    CheckpointQueue() = default;
+
+    CheckpointQueue(CheckpointQueue const &) = delete;
+    CheckpointQueue & operator=(CheckpointQueue const &) = delete;
+
+    /** Wait for the pending file; errors are logged. */
+    ~CheckpointQueue();
+
+    /** Set whether checkpoint files are written in the background. */
+    void setAsync(bool async) noexcept { async_ = async; }
+    bool async() const noexcept { return async_; }
+
+    /** True if a file is being written. */
+    bool pending() const noexcept { return worker_.joinable(); }
+
+    /** Wait until the pending file, if any, is written and synchronised
+     * to disk.
+     *
+     * Throws steps::ArgErr if it could not be written.
+     */
+    void wait();
+
+private:
+    friend class CheckpointWriter;
+
+    /** Write the header and the state chunks to the open file descriptor
+     * fd on a new thread, synchronise it to disk and close it.
+     *
+     * No file may be pending.
+     */
+    void _submit(std::string const & file_name, std::string const & solver,
+                 int fd, std::vector<impl::checkpoint_chunk> && chunks);
+
+    bool                                async_{false};
+    std::thread                         worker_;
+    std::string                         file_name_;
+    bool                                failed_{false};
+};
+
+/** Write a solver checkpoint.
+ *
+ * The state is serialised to stream(), and the file is completed by
+ * write().
+ */
+class CheckpointWriter {
+public:
+    /** Open the checkpoint file_name.
+     *
+     * \param file_name  Checkpoint file.
+     * \param solver     Name of the solver, as given by getSolverName().
+     * \param queue      Background checkpoints of the solver, if any.
+     *
+     * If queue is asynchronous, the state is only copied in memory and the
+     * file is opened and handed to the queue by write(). Otherwise the
+     * pending file of queue is waited for first.
+     *
+     * Throws steps::ArgErr if the file cannot be opened.
+     */
+    CheckpointWriter(std::string const & file_name, std::string const & solver,
+                     CheckpointQueue * queue = nullptr);
+
+    CheckpointWriter(CheckpointWriter const &) = delete;
+    CheckpointWriter & operator=(CheckpointWriter const &) = delete;
+
+    /** Stream the state of the solver is serialised to. */
+    std::iostream & stream() noexcept { return stream_; }
+
+    /** Write the rest of the state and the header, or hand the state
+     * over to the asynchronous queue.
+     *
+     * Throws steps::ArgErr if the file could not be written or opened, or
+     * if the previous file of the queue could not be written. In the
+     * latter case the captured state is dropped.
+     */
+    void write();
+
+private:
+    std::string                         file_name_;
+    std::string                         solver_;
+    CheckpointQueue                   * queue_{nullptr};
+    std::ofstream                       file_;
+    impl::checkpoint_outbuf             buffer_;
+    std::iostream                       stream_;
+};
+
+/** Read a solver checkpoint.
+ *
+ * The file is mapped in memory for the lifetime of the reader; the state
+ * is restored from stream().
+ */
+class CheckpointReader {
+public:
+    /** Map and check the checkpoint file_name.
+     *
+     * \param file_name  Checkpoint file.
+     * \param solver     Name of the restoring solver, as given by
+     *                   getSolverName().
+     * \param queue      Background checkpoints of the solver, if any: the
+     *                   pending file is waited for first.
+     *
+     * Throws steps::ArgErr if the file cannot be read, was written by
+     * another solver, by a more recent version of the format or on a
+     * machine of different byte order, or if it is truncated or corrupted.
+     */
+    CheckpointReader(std::string const & file_name, std::string const & solver,
+                     CheckpointQueue * queue = nullptr);
+
+    CheckpointReader(CheckpointReader const &) = delete;
+    CheckpointReader & operator=(CheckpointReader const &) = delete;
+
+    ~CheckpointReader();
+
+    /** Stream the state of the solver is restored from. */
+    std::iostream & stream() noexcept { return stream_; }
+
+    /** Format version of the file, 0 if it has no header. */
+    std::uint32_t version() const noexcept { return version_; }
+
+    /** Check that the state was restored entirely.
+     *
+     * Throws steps::ArgErr if reading failed, or if data is left over in
+     * a file with a header: the checkpoint was then written for another
+     * model or geometry.
+     */
+    void finish();
+
+private:
+    /** Check the header of the mapped file and set up stream(). */
+    void _checkHeader(std::string const & solver);
+
+    std::string                         file_name_;
+    const char                        * data_{nullptr};
+    std::size_t                         size_{0};
+    std::uint32_t                       version_{0};
+    impl::checkpoint_inbuf              buffer_;
+    std::iostream                       stream_;
+};
+
+} // namespace util
+} // namespace steps
+
+#endif // ndef STEPS_UTIL_CHECKPOINT_HPP
@@ -0,0 +1,113 @@
+/*
+ #################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+
+ */
+
+
+#ifndef STEPS_UTIL_EPOCH_DEDUP_HPP
+#define STEPS_UTIL_EPOCH_DEDUP_HPP 1
+
+/** \file Allocation-free collection of unique items using epoch stamps.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace steps {
+namespace util {
+
+/** Type of the stamp an item carries to take part in an epoch_dedup. */
+typedef std::uint64_t dedup_epoch_t;
+
+/** Collect unique item pointers without a node-based set.
+ *
+ * \tparam T     Type of items. T must provide a member function
+ *               `dedup_epoch_t & dedupEpoch(unsigned slot)` returning, for
+ *               each slot, a stamp that is zero-initialised and otherwise
+ *               only touched by epoch_dedup.
+ * \tparam Slot  Stamp of the items used by this collection.
+ *
+ * Every call to clear() draws a fresh epoch, shared by no other epoch_dedup
+ * instance. An item is new to the collection if its stamp differs from the
+ * current epoch; inserting it stamps it and appends it to a scratch vector
+ * that keeps its capacity between uses. Iteration follows insertion order.
+ *
+ * Two collections using the same slot must not be filled at the same time
+ * with shared items: the second insertion overwrites the stamp left by the
+ * first one. Collections that are live together use different slots.
+ */
+
+template <typename T, unsigned Slot = 0>
+class epoch_dedup {
+public:
+    typedef typename std::vector<T *>::const_iterator const_iterator;
+
+    epoch_dedup(): epoch_(next_epoch()) {}
+
+    /** Empty the collection and start a new epoch. Keeps capacity. */
+    void clear() noexcept {
+        items_.clear();
+        epoch_ = next_epoch();
+    }
+
+    /** Insert x if not already collected; return true if it was new. */
+    bool insert(T *x) {
+        dedup_epoch_t &stamp = x->dedupEpoch(Slot);
+        if (stamp == epoch_) return false;
+        stamp = epoch_;
+        items_.push_back(x);
+        return true;
+    }
+
+    /** Insert items given by iterator range [b,e). */
+    template <typename In>
+    void insert(In b, In e) { while (b != e) insert(*b++); }
+
+    /** Reserve scratch space for n items. */
+    void reserve(std::size_t n) { items_.reserve(n); }
+
+    const_iterator begin() const noexcept { return items_.begin(); }
+    const_iterator end() const noexcept { return items_.end(); }
+    std::size_t size() const noexcept { return items_.size(); }
+    bool empty() const noexcept { return items_.empty(); }
+
+    /** Collected items, in insertion order. */
+    const std::vector<T *> &items() const noexcept { return items_; }
+
+private:
+    static dedup_epoch_t next_epoch() noexcept {
+        // Epoch 0 is never handed out: it is the initial stamp of an item.
+        static std::atomic<dedup_epoch_t> counter{0};
+        return ++counter;
+    }
+
+    std::vector<T *> items_;
+    dedup_epoch_t epoch_;
+};
+
+} // namespace util
+} // namespace steps
+
+#endif // ndef STEPS_UTIL_EPOCH_DEDUP_HPP
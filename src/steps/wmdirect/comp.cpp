@@ -66,7 +66,7 @@ swmd::Comp::~Comp()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::Comp::checkpoint(std::fstream & cp_file)
+void swmd::Comp::checkpoint(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->checkpoint(cp_file);
@@ -75,7 +75,7 @@ void swmd::Comp::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::Comp::restore(std::fstream & cp_file)
+void swmd::Comp::restore(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->restore(cp_file);
@@ -74,10 +74,10 @@ public:
     // CHECKPOINTING
     ////////////////////////////////////////////////////////////////////////
     /// checkpoint data
-    virtual void checkpoint(std::fstream & cp_file) = 0;
+    virtual void checkpoint(std::iostream & cp_file) = 0;
 
     /// restore data
-    virtual void restore(std::fstream & cp_file) = 0;
+    virtual void restore(std::iostream & cp_file) = 0;
 
     ////////////////////////////////////////////////////////////////////////
     // DATA ACCESS
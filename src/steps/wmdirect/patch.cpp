@@ -71,7 +71,7 @@ swmd::Patch::~Patch()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::Patch::checkpoint(std::fstream & cp_file)
+void swmd::Patch::checkpoint(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->checkpoint(cp_file);
@@ -80,7 +80,7 @@ void swmd::Patch::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::Patch::restore(std::fstream & cp_file)
+void swmd::Patch::restore(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->restore(cp_file);
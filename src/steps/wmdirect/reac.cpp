@@ -79,14 +79,14 @@ swmd::Reac::~Reac() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::Reac::checkpoint(std::fstream & cp_file)
+void swmd::Reac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::Reac::restore(std::fstream & cp_file)
+void swmd::Reac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
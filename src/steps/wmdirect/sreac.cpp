@@ -113,14 +113,14 @@ swmd::SReac::~SReac() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::SReac::checkpoint(std::fstream & cp_file)
+void swmd::SReac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmd::SReac::restore(std::fstream & cp_file)
+void swmd::SReac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
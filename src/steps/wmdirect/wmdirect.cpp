@@ -45,6 +45,7 @@
 #include "steps/solver/sreacdef.hpp"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/types.hpp"
+#include "steps/util/checkpoint.hpp"
 #include "steps/wmdirect/comp.hpp"
 #include "steps/wmdirect/kproc.hpp"
 #include "steps/wmdirect/patch.hpp"
@@ -150,10 +151,8 @@ swmd::Wmdirect::~Wmdirect()
 
 void swmd::Wmdirect::checkpoint(std::string const & file_name)
 {
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                 std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    steps::util::CheckpointWriter cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     for (auto const& c : pComps) {
       c->checkpoint(cp_file);
@@ -164,19 +163,15 @@ void swmd::Wmdirect::checkpoint(std::string const & file_name)
 
     statedef().checkpoint(cp_file);
 
-    cp_file.close();
+    cp.write();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void swmd::Wmdirect::restore(std::string const & file_name)
 {
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                std::fstream::in | std::fstream::binary);
-
-    cp_file.seekg(0);
+    steps::util::CheckpointReader cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     for (auto const& c : pComps) {
       c->restore(cp_file);
@@ -187,11 +182,7 @@ void swmd::Wmdirect::restore(std::string const & file_name)
 
     statedef().restore(cp_file);
 
-    if (cp_file.fail()) {
-        ArgErrLog("Checkpoint restoration failed.");
-    }
-
-    cp_file.close();
+    cp.finish();
 
     _reset();
 }
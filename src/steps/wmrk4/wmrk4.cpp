@@ -45,6 +45,7 @@
 #include "steps/solver/sreacdef.hpp"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/types.hpp"
+#include "steps/util/checkpoint.hpp"
 #include "steps/wmrk4/wmrk4.hpp"
 
 // logging
@@ -194,10 +195,9 @@ double swmrk4::Wmrk4::getTime() const
 
 void swmrk4::Wmrk4::checkpoint(std::string const & file_name)
 {
-    std::fstream cp_file;
+    steps::util::CheckpointWriter cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
-    cp_file.open(file_name.c_str(),
-                std::fstream::out | std::fstream::binary | std::fstream::trunc);
     double state_buffer[3];
     state_buffer[0] = static_cast<double>(pSpecs_tot);
     state_buffer[1] = static_cast<double>(pReacs_tot);
@@ -221,19 +221,16 @@ void swmrk4::Wmrk4::checkpoint(std::string const & file_name)
 
     statedef().checkpoint(cp_file);
 
-    cp_file.close();
+    cp.write();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void swmrk4::Wmrk4::restore(std::string const & file_name)
 {
-    std::fstream cp_file;
+    steps::util::CheckpointReader cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
-    cp_file.open(file_name.c_str(),
-                std::fstream::in | std::fstream::binary);
-
-    cp_file.seekg(0);
     double state_buffer[3];
     cp_file.read(reinterpret_cast<char*>(&state_buffer), sizeof(double) * 3);
 
@@ -267,7 +264,7 @@ void swmrk4::Wmrk4::restore(std::string const & file_name)
 
     statedef().restore(cp_file);
 
-    cp_file.close();
+    cp.finish();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -72,7 +72,7 @@ swmrssa::Comp::~Comp()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::Comp::checkpoint(std::fstream & cp_file)
+void swmrssa::Comp::checkpoint(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->checkpoint(cp_file);
@@ -81,7 +81,7 @@ void swmrssa::Comp::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::Comp::restore(std::fstream & cp_file)
+void swmrssa::Comp::restore(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->restore(cp_file);
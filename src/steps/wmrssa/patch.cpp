@@ -76,7 +76,7 @@ swmrssa::Patch::~Patch()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::Patch::checkpoint(std::fstream & cp_file)
+void swmrssa::Patch::checkpoint(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->checkpoint(cp_file);
@@ -85,7 +85,7 @@ void swmrssa::Patch::checkpoint(std::fstream & cp_file)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::Patch::restore(std::fstream & cp_file)
+void swmrssa::Patch::restore(std::iostream & cp_file)
 {
     for (auto const& k : pKProcs) {
         k->restore(cp_file);
@@ -82,14 +82,14 @@ swmrssa::Reac::~Reac() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::Reac::checkpoint(std::fstream & cp_file)
+void swmrssa::Reac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::Reac::restore(std::fstream & cp_file)
+void swmrssa::Reac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
@@ -112,14 +112,14 @@ swmrssa::SReac::~SReac() = default;
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::SReac::checkpoint(std::fstream & cp_file)
+void swmrssa::SReac::checkpoint(std::iostream & cp_file)
 {
     cp_file.write(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void swmrssa::SReac::restore(std::fstream & cp_file)
+void swmrssa::SReac::restore(std::iostream & cp_file)
 {
     cp_file.read(reinterpret_cast<char*>(&pCcst), sizeof(double));
 }
@@ -44,6 +44,7 @@
 #include "steps/solver/sreacdef.hpp"
 #include "steps/solver/statedef.hpp"
 #include "steps/solver/types.hpp"
+#include "steps/util/checkpoint.hpp"
 #include "steps/wmrssa/comp.hpp"
 #include "steps/wmrssa/kproc.hpp"
 #include "steps/wmrssa/patch.hpp"
@@ -134,10 +135,8 @@ swmrssa::Wmrssa::~Wmrssa()
 
 void swmrssa::Wmrssa::checkpoint(std::string const & file_name)
 {
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                std::fstream::out | std::fstream::binary | std::fstream::trunc);
+    steps::util::CheckpointWriter cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     CompPVecCI comp_e = pComps.end();
     for (CompPVecCI c = pComps.begin(); c != comp_e; ++c) (*c)->checkpoint(cp_file);
@@ -146,19 +145,15 @@ void swmrssa::Wmrssa::checkpoint(std::string const & file_name)
 
     statedef().checkpoint(cp_file);
 
-    cp_file.close();
+    cp.write();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void swmrssa::Wmrssa::restore(std::string const & file_name)
 {
-    std::fstream cp_file;
-
-    cp_file.open(file_name.c_str(),
-                std::fstream::in | std::fstream::binary);
-
-    cp_file.seekg(0);
+    steps::util::CheckpointReader cp(file_name, getSolverName(), checkpointQueue());
+    std::iostream & cp_file = cp.stream();
 
     CompPVecCI comp_e = pComps.end();
     for (CompPVecCI c = pComps.begin(); c != comp_e; ++c) (*c)->restore(cp_file);
@@ -167,7 +162,7 @@ void swmrssa::Wmrssa::restore(std::string const & file_name)
 
     statedef().restore(cp_file);
 
-    cp_file.close();
+    cp.finish();
 
     _reset();
 }
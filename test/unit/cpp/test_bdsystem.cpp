@@ -161,3 +161,58 @@ TYPED_TEST(LinSystemImplTest,Bw7) {
         EXPECT_NEAR(x0[i],x.get(i),std::abs(x[i])*relerr);
     }
 }
+
+TYPED_TEST(LinSystemImplTest,Resolve) {
+    typedef TypeParam Impl;
+    typedef typename Impl::matrix_type matrix_type;
+    typedef typename Impl::vector_type vector_type;
+
+    constexpr size_t n=6;
+    constexpr int h=1; // half-bandwidth
+    double A_full[n][n]={
+        {   4,  -1,   0,   0,   0,   0},
+        {  -2,   5,  .5,   0,   0,   0},
+        {   0,  -1,   3,  -1,   0,   0},
+        {   0,   0,  .3,   6, -.7,   0},
+        {   0,   0,   0,  -1,   2,  .1},
+        {   0,   0,   0,   0, -.4,   3}
+    };
+
+    double x0[2][n]={{ 1, 2, 3, 4, 5, 6 }, { -3, .5, 0, 7, -2, 1 }};
+
+    Impl B(n,h);
+
+    matrix_type &A=B.A();
+    for (int i=0;i<n;++i) {
+        int jmin=std::max(0,i-h);
+        int jmax=std::min((int)n-1,i+h);
+
+        for (int j=jmin;j<=jmax;++j)
+            A.set(i,j,A_full[i][j]);
+    }
+
+    double k=estimate_condition((const double *)A_full,n);
+    double eta=std::numeric_limits<double>::epsilon()*k;
+    ASSERT_LT(eta,0.25);
+    double relerr=1/(1-eta*4)-1;
+
+    // the first right-hand side is factored and solved, the second one
+    // reuses the LU decomposition.
+    for (int r=0;r<2;++r) {
+        vector_type &b=B.b();
+        for (int i=0;i<n;++i) {
+            double y=0;
+            for (size_t j=0;j<n;++j)
+                y+=A_full[i][j]*x0[r][j];
+            b.set(i,y);
+        }
+
+        if (r==0) B.solve();
+        else B.resolve();
+
+        const vector_type &x=B.x();
+        for (int i=0;i<n;++i) {
+            EXPECT_NEAR(x0[r][i],x.get(i),std::max(std::abs(x0[r][i]),1.0)*relerr);
+        }
+    }
+}
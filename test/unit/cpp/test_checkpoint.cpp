@@ -0,0 +1,162 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "steps/error.hpp"
+#include "steps/init.hpp"
+#include "steps/util/checkpoint.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace steps::util;
+
+namespace {
+
+const std::string cp_file = "test_checkpoint.cp";
+
+// State larger than a write chunk, with a size that is not a multiple of 8.
+std::vector<std::uint32_t> make_state() {
+    std::vector<std::uint32_t> state((5u << 20) / sizeof(std::uint32_t) + 3);
+    for (std::size_t i = 0; i < state.size(); ++i) state[i] = static_cast<std::uint32_t>(i * 2654435761u);
+    return state;
+}
+
+void write_checkpoint(std::vector<std::uint32_t> const & state, std::string const & solver,
+                      CheckpointQueue * queue = nullptr) {
+    CheckpointWriter cp(cp_file, solver, queue);
+    double t = 1.5;
+    cp.stream().write(reinterpret_cast<const char *>(&t), sizeof(t));
+    cp.stream().write(reinterpret_cast<const char *>(state.data()), state.size() * sizeof(std::uint32_t));
+    cp.stream().put('x');
+    cp.write();
+}
+
+std::vector<char> file_bytes() {
+    std::ifstream in(cp_file, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void set_file_bytes(std::vector<char> const & bytes) {
+    std::ofstream out(cp_file, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size());
+}
+
+} // namespace
+
+TEST(Checkpoint,roundTrip) {
+    auto state = make_state();
+    write_checkpoint(state, "tetexact");
+
+    CheckpointReader cp(cp_file, "tetexact");
+    ASSERT_EQ(cp.version(), 1u);
+    double t = 0;
+    std::vector<std::uint32_t> restored(state.size());
+    cp.stream().read(reinterpret_cast<char *>(&t), sizeof(t));
+    cp.stream().read(reinterpret_cast<char *>(restored.data()), restored.size() * sizeof(std::uint32_t));
+    ASSERT_EQ(cp.stream().get(), 'x');
+    EXPECT_NO_THROW(cp.finish());
+    ASSERT_EQ(t, 1.5);
+    ASSERT_EQ(state, restored);
+    std::remove(cp_file.c_str());
+}
+
+TEST(Checkpoint,async) {
+    auto state = make_state();
+    auto other = state;
+    other[0] += 1;
+
+    CheckpointQueue queue;
+    queue.setAsync(true);
+    write_checkpoint(state, "tetexact", &queue);
+    // The second state is only handed over once the first file is written.
+    write_checkpoint(other, "tetexact", &queue);
+    queue.wait();
+    ASSERT_FALSE(queue.pending());
+
+    auto bytes = file_bytes();
+    queue.setAsync(false);
+    write_checkpoint(other, "tetexact", &queue);
+    ASSERT_EQ(bytes, file_bytes());
+
+    // The reader waits for the pending file.
+    queue.setAsync(true);
+    write_checkpoint(state, "tetexact", &queue);
+    {
+        CheckpointReader cp(cp_file, "tetexact", &queue);
+        ASSERT_FALSE(queue.pending());
+        std::vector<std::uint32_t> restored(state.size());
+        cp.stream().seekg(sizeof(double));
+        cp.stream().read(reinterpret_cast<char *>(restored.data()), restored.size() * sizeof(std::uint32_t));
+        ASSERT_EQ(state, restored);
+    }
+
+    // Files that cannot be written are reported when handed over.
+    CheckpointWriter cp("no_such_dir/test_checkpoint.cp", "tetexact", &queue);
+    cp.stream().put('x');
+    ASSERT_THROW(cp.write(), steps::ArgErr);
+    std::remove(cp_file.c_str());
+}
+
+TEST(Checkpoint,mismatch) {
+    auto state = make_state();
+    write_checkpoint(state, "tetexact");
+
+    // Another solver.
+    ASSERT_THROW(CheckpointReader(cp_file, "wmdirect"), steps::ArgErr);
+
+    // State left over, or read past the end.
+    {
+        CheckpointReader cp(cp_file, "tetexact");
+        double t = 0;
+        cp.stream().read(reinterpret_cast<char *>(&t), sizeof(t));
+        ASSERT_THROW(cp.finish(), steps::ArgErr);
+    }
+    {
+        CheckpointReader cp(cp_file, "tetexact");
+        std::vector<char> all(state.size() * sizeof(std::uint32_t) + 16);
+        cp.stream().read(all.data(), all.size());
+        ASSERT_THROW(cp.finish(), steps::ArgErr);
+    }
+    std::remove(cp_file.c_str());
+}
+
+TEST(Checkpoint,corrupted) {
+    write_checkpoint(make_state(), "tetexact");
+    auto bytes = file_bytes();
+
+    auto flipped = bytes;
+    flipped[flipped.size() / 2] ^= 0x10;
+    set_file_bytes(flipped);
+    ASSERT_THROW(CheckpointReader(cp_file, "tetexact"), steps::ArgErr);
+
+    auto truncated = bytes;
+    truncated.resize(truncated.size() - 1);
+    set_file_bytes(truncated);
+    ASSERT_THROW(CheckpointReader(cp_file, "tetexact"), steps::ArgErr);
+
+    ASSERT_THROW(CheckpointReader("no_such_dir/test_checkpoint.cp", "tetexact"), steps::ArgErr);
+    std::remove(cp_file.c_str());
+}
+
+TEST(Checkpoint,noHeader) {
+    steps::init();
+
+    // Checkpoints written before the header was introduced.
+    std::vector<char> bytes(100);
+    for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<char>(i);
+    set_file_bytes(bytes);
+
+    CheckpointReader cp(cp_file, "tetexact");
+    ASSERT_EQ(cp.version(), 0u);
+    std::vector<char> restored(bytes.size());
+    cp.stream().read(restored.data(), restored.size());
+    ASSERT_EQ(bytes, restored);
+    EXPECT_NO_THROW(cp.finish());
+
+    // Seeking is only relative to the state.
+    cp.stream().seekg(10);
+    ASSERT_EQ(cp.stream().get(), 10);
+    std::remove(cp_file.c_str());
+}
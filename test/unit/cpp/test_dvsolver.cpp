@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "steps/solver/efield/dVsolver.hpp"
+#include "steps/solver/efield/efield.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace steps::solver::efield;
+using steps::vertex_id_t;
+using steps::triangle_id_t;
+
+namespace {
+
+// n x n x n cubes of side h (in microns), six tets per cube, with the
+// boundary triangles as membrane.
+struct BoxMesh {
+    std::vector<double> verts;
+    std::vector<vertex_id_t> tris;
+    std::vector<vertex_id_t> tets;
+
+    BoxMesh(uint n, double h) {
+        for (uint k = 0; k <= n; ++k)
+            for (uint j = 0; j <= n; ++j)
+                for (uint i = 0; i <= n; ++i) {
+                    verts.push_back(i * h);
+                    verts.push_back(j * h);
+                    verts.push_back(k * h);
+                }
+        auto vidx = [n](uint i, uint j, uint k) { return (k * (n + 1) + j) * (n + 1) + i; };
+        const uint perms[6][3] = {{0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0}};
+        std::map<std::array<uint, 3>, std::pair<std::array<uint, 3>, int>> faces;
+        for (uint k = 0; k < n; ++k)
+            for (uint j = 0; j < n; ++j)
+                for (uint i = 0; i < n; ++i)
+                    for (auto const &p: perms) {
+                        uint c[3] = {i, j, k};
+                        std::array<uint, 4> t;
+                        t[0] = vidx(c[0], c[1], c[2]);
+                        for (uint d = 0; d < 3; ++d) {
+                            ++c[p[d]];
+                            t[d + 1] = vidx(c[0], c[1], c[2]);
+                        }
+                        for (auto v: t) tets.emplace_back(v);
+                        for (uint f = 0; f < 4; ++f) {
+                            std::array<uint, 3> tri{{t[f], t[(f + 1) % 4], t[(f + 2) % 4]}};
+                            std::array<uint, 3> key = tri;
+                            std::sort(key.begin(), key.end());
+                            auto &face = faces[key];
+                            face.first = tri;
+                            ++face.second;
+                        }
+                    }
+        for (auto const &f: faces) {
+            if (f.second.second != 1) continue;
+            for (auto v: f.second.first) tris.emplace_back(v);
+        }
+    }
+
+    uint nverts() const { return verts.size() / 3; }
+    uint ntris() const { return tris.size() / 3; }
+    uint ntets() const { return tets.size() / 4; }
+
+    void init(EField &ef) {
+        ef.initMesh(nverts(), verts.data(), ntris(), tris.data(), ntets(), tets.data());
+    }
+};
+
+} // namespace
+
+// The banded solver keeps its LU factorization between steps with the same
+// dt and clamps; it must give the same potentials as refactoring every step.
+TEST(dVSolver,BandedFactorizationReuse) {
+    BoxMesh mesh(3, 1.0);
+
+    EField reused(std::unique_ptr<EFieldSolver>(new dVSolverBanded()));
+    std::unique_ptr<EFieldSolver> solver(new dVSolverBanded());
+    EFieldSolver *fresh_solver = solver.get();
+    EField fresh(std::move(solver));
+    mesh.init(reused);
+    mesh.init(fresh);
+
+    const double dt = 1.0e-6;
+    for (uint step = 0; step < 20; ++step) {
+        for (uint t = 0; t < mesh.ntris(); ++t) {
+            double cur = (t % 3 == 0 ? 1.0e-12 : -0.5e-12) * (1 + step % 4);
+            reused.setTriI(triangle_id_t(t), cur);
+            fresh.setTriI(triangle_id_t(t), cur);
+        }
+        // Clamps change the matrix, and so force a new factorization.
+        if (step == 5 || step == 12) {
+            bool cl = step == 5;
+            reused.setVertVClamped(vertex_id_t(0u), cl);
+            fresh.setVertVClamped(vertex_id_t(0u), cl);
+        }
+        // A different time step too.
+        double step_dt = step >= 15 ? 2 * dt : dt;
+
+        fresh_solver->invalidateMatrix();
+        reused.advance(step_dt);
+        fresh.advance(step_dt);
+
+        for (uint v = 0; v < mesh.nverts(); ++v) {
+            ASSERT_DOUBLE_EQ(fresh.getVertV(vertex_id_t(v)), reused.getVertV(vertex_id_t(v)));
+        }
+    }
+    // The currents did change the potential.
+    ASSERT_NE(reused.getVertV(vertex_id_t(1u)), -65.0e-3);
+}
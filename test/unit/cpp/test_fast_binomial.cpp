@@ -0,0 +1,95 @@
+#include <vector>
+#include <cmath>
+#include <random>
+#include <iostream>
+#include "steps/rng/fast_binomial.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace steps::rng;
+
+// Exact binomial probability mass function.
+static double binom_pmf(int t, double p, int k) {
+    double lc = std::lgamma(t + 1.0) - std::lgamma(k + 1.0) - std::lgamma(t - k + 1.0);
+    return std::exp(lc + k * std::log(p) + (t - k) * std::log1p(-p));
+}
+
+// - - - One-Sample Chi-Squared Goodness of Fit - - -
+// Bins with an expected count below 5 are merged into their neighbours.
+// Significance level for rejecting H0: alpha = 0.001
+static void chi_squared_check(int t, double p) {
+    constexpr int n_samples = 100000;
+
+    std::mt19937 gen(7);
+    fast_binomial_distribution<uint> X(t, p);
+    std::vector<int> counts_obs(t + 1, 0);
+    for (int i = 0; i < n_samples; ++i) {
+        uint x = X(gen);
+        ASSERT_LE(x, static_cast<uint>(t));
+        ++counts_obs[x];
+    }
+
+    double chi2 = 0.0;
+    int dof = -1;
+    double obs = 0.0, exa = 0.0;
+    for (int k = 0; k <= t; ++k) {
+        obs += counts_obs[k];
+        exa += n_samples * binom_pmf(t, p, k);
+        if (exa >= 5.0 || k == t) {
+            chi2 += (obs - exa) * (obs - exa) / std::max(exa, 1e-300);
+            ++dof;
+            obs = 0.0;
+            exa = 0.0;
+        }
+    }
+    ASSERT_GT(dof, 0);
+    // Wilson-Hilferty approximation of the 0.999 quantile of chi2(dof).
+    double h = 2.0 / (9.0 * dof);
+    double chi2_critical = dof * std::pow(1.0 - h + 3.090 * std::sqrt(h), 3);
+    ASSERT_LT(chi2, chi2_critical) << "t = " << t << ", p = " << p;
+}
+
+TEST(FastBinomial, ChiSquaredInversion) {
+    chi_squared_check(25, 0.3);
+    chi_squared_check(1000, 0.01);
+    chi_squared_check(40, 0.9);
+}
+
+TEST(FastBinomial, ChiSquaredBTPE) {
+    chi_squared_check(200, 0.4);
+    chi_squared_check(5000, 0.02);
+    chi_squared_check(300, 0.75);
+}
+
+TEST(FastBinomial, Moments) {
+    constexpr int n_samples = 200000;
+    constexpr uint t = 1000000;
+    constexpr double p = 0.3;
+
+    std::mt19937 gen(11);
+    fast_binomial_distribution<uint> X(t, p);
+    double sum = 0.0, sum2 = 0.0;
+    for (int i = 0; i < n_samples; ++i) {
+        double x = X(gen);
+        sum += x;
+        sum2 += x * x;
+    }
+    double mean = sum / n_samples;
+    double var = sum2 / n_samples - mean * mean;
+    double var_exa = t * p * (1.0 - p);
+    // mean within 5 standard errors, variance within 2%
+    ASSERT_NEAR(mean, t * p, 5.0 * std::sqrt(var_exa / n_samples));
+    ASSERT_NEAR(var / var_exa, 1.0, 0.02);
+}
+
+TEST(FastBinomial, Limits) {
+    std::mt19937 gen(3);
+    fast_binomial_distribution<uint> zero(100, 0.0);
+    fast_binomial_distribution<uint> one(100, 1.0);
+    fast_binomial_distribution<uint> none(0, 0.5);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(zero(gen), 0u);
+        ASSERT_EQ(one(gen), 100u);
+        ASSERT_EQ(none(gen), 0u);
+    }
+}
@@ -0,0 +1,95 @@
+#include <cstdint>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "steps/mpi/tetopsplit/molchange.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace steps::mpi::tetopsplit;
+
+TEST(MolChange,varint) {
+    const uint values[] = {0u, 1u, 127u, 128u, 300u, 16383u, 16384u, 0xffffffffu};
+    for (uint v: values) {
+        std::uint8_t buf[MOLCHANGE_MAX_VARINT];
+        std::uint8_t *end = putVarint(buf, v);
+        ASSERT_LE(end - buf, MOLCHANGE_MAX_VARINT);
+
+        uint w = 0;
+        ASSERT_EQ(getVarint(buf, end, w), end);
+        ASSERT_EQ(v, w);
+    }
+
+    std::uint8_t truncated[] = {0x80, 0x80};
+    uint w = 0;
+    ASSERT_THROW(getVarint(truncated, truncated + 2, w), steps::ProgErr);
+}
+
+TEST(MolChange,roundTrip) {
+    const std::vector<uint> nspecs = {3, 1, 7, 2, 5};
+    MolChangeBuffer buffer;
+    buffer.setup(nspecs);
+
+    std::mt19937 g(11);
+    for (int iter = 0; iter < 3; ++iter) {
+        std::map<std::pair<uint, uint>, uint> expected;
+        for (int c = 0; c < 40; ++c) {
+            uint slot = g() % nspecs.size();
+            uint lidx = g() % nspecs[slot];
+            uint change = 1 + g() % (iter == 2 ? 1000000u : 10u);
+            buffer.add(buffer.base(slot) + lidx, change);
+            expected[{slot, lidx}] += change;
+        }
+        buffer.encode();
+        ASSERT_LE(buffer.size(), buffer.capacity());
+        ASSERT_EQ(buffer.records(), expected.size());
+
+        std::map<std::pair<uint, uint>, uint> decoded;
+        decodeMolChanges(buffer.data(), buffer.size(), [&](uint slot, uint lidx, uint count) {
+            ASSERT_EQ(decoded.count({slot, lidx}), 0u);
+            decoded[{slot, lidx}] = count;
+        });
+        ASSERT_EQ(expected, decoded);
+    }
+
+    // Nothing accumulated since the last encode.
+    buffer.encode();
+    ASSERT_EQ(buffer.size(), 0u);
+    ASSERT_EQ(buffer.records(), 0u);
+}
+
+TEST(MolChange,capacity) {
+    const std::vector<uint> nspecs = {4, 4};
+    MolChangeBuffer buffer;
+    buffer.setup(nspecs);
+    for (uint loc = 0; loc < 8; ++loc) buffer.add(loc, 0xffffffffu);
+    buffer.encode();
+    ASSERT_EQ(buffer.records(), 8u);
+    ASSERT_LE(buffer.size(), buffer.capacity());
+}
+
+TEST(MolChange,absorb) {
+    const std::vector<uint> nspecs = {2, 3, 1};
+    MolChangeBuffer buffer, other;
+    buffer.setup(nspecs);
+    other.setup(nspecs);
+
+    buffer.add(buffer.base(1) + 2, 5);
+    other.add(other.base(1) + 2, 3);
+    other.add(other.base(2), 7);
+    buffer.absorb(other);
+
+    std::map<std::pair<uint, uint>, uint> decoded;
+    buffer.encode();
+    decodeMolChanges(buffer.data(), buffer.size(), [&](uint slot, uint lidx, uint count) {
+        decoded[{slot, lidx}] = count;
+    });
+    std::map<std::pair<uint, uint>, uint> expected = {{{1, 2}, 8}, {{2, 0}, 7}};
+    ASSERT_EQ(expected, decoded);
+
+    // The changes moved out of other.
+    other.encode();
+    ASSERT_EQ(other.size(), 0u);
+}
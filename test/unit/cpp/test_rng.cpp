@@ -5,8 +5,10 @@
 #include <iostream>
 #include <iterator>
 #include <algorithm>
+#include <numeric>
 
 #include "steps/rng/create.hpp"
+#include "steps/rng/r123.hpp"
 #include "steps/error.hpp"
 #include "steps/math/tools.hpp"
 
@@ -168,3 +170,97 @@ TEST(rng, kendall_r123) {
     kendall_rank_correlation_check("r123", 1000, 0.95, 1, 2);
 }
 
+void save_restore_check(const std::string& str) {
+    // Small buffer so that the replay crosses refills.
+    auto rng = create(str, 10);
+    rng->initialize(23);
+    for (uint i = 0; i < 7; ++i) rng->get();
+
+    std::vector<uint> state;
+    rng->saveState(state);
+    std::vector<uint> first(45);
+    for (auto& x: first) x = rng->get();
+
+    rng->restoreState(state);
+    for (auto x: first) ASSERT_EQ(x, rng->get());
+}
+
+TEST(rng, save_restore_mt) {
+    save_restore_check("mt19937");
+}
+
+TEST(rng, save_restore_r123) {
+    save_restore_check("r123");
+}
+
+void bulk_fill_check(const std::string& str) {
+    // Small buffer so that the bulk draws cross refills.
+    auto rng1 = create(str, 10);
+    auto rng2 = create(str, 10);
+    rng1->initialize(31);
+    rng2->initialize(31);
+
+    std::vector<double> u(37);
+    rng1->fillUnfII(u.data(), u.data() + u.size());
+    for (auto x: u) ASSERT_EQ(x, rng2->getUnfII());
+    rng1->fillUnfIE(u.data(), u.data() + u.size());
+    for (auto x: u) ASSERT_EQ(x, rng2->getUnfIE());
+    rng1->fillUnfEE(u.data(), u.data() + u.size());
+    for (auto x: u) ASSERT_EQ(x, rng2->getUnfEE());
+
+    std::vector<uint> n(23);
+    rng1->fillBinom(12, 0.3, n.data(), n.data() + n.size());
+    for (auto x: n) ASSERT_EQ(x, rng2->getBinom(12, 0.3));
+    rng1->fillBinom(1000, 0.4, n.data(), n.data() + n.size());
+    for (auto x: n) ASSERT_EQ(x, rng2->getBinom(1000, 0.4));
+}
+
+void bulk_moments_check(const std::string& str) {
+    auto rng = create(str, 1000);
+    rng->initialize(47);
+
+    // Odd size to exercise the unpaired normal.
+    const uint n_sample = 100001;
+    std::vector<double> x(n_sample);
+
+    rng->fillExp(4.0, x.data(), x.data() + n_sample);
+    double mean = std::accumulate(x.begin(), x.end(), 0.0) / n_sample;
+    ASSERT_NEAR(mean, 0.25, 0.005);
+    ASSERT_GT(*std::min_element(x.begin(), x.end()), 0.0);
+
+    rng->fillStdNrm(x.data(), x.data() + n_sample);
+    mean = std::accumulate(x.begin(), x.end(), 0.0) / n_sample;
+    double var = std::inner_product(x.begin(), x.end(), x.begin(), 0.0) / n_sample - mean * mean;
+    ASSERT_NEAR(mean, 0.0, 0.02);
+    ASSERT_NEAR(var, 1.0, 0.02);
+}
+
+TEST(rng, bulk_fill_mt) {
+    bulk_fill_check("mt19937");
+    bulk_moments_check("mt19937");
+}
+
+TEST(rng, bulk_fill_r123) {
+    bulk_fill_check("r123");
+    bulk_moments_check("r123");
+}
+
+TEST(rng, r123_philox_stream) {
+    // The buffer is filled several Philox blocks at a time; check the
+    // stream against the blocks of consecutive counters.
+    const ulong seed = 0x123456789abcdefUL;
+    auto rng = create("r123", 100);
+    rng->initialize(seed);
+
+    R123::r123_type philox;
+    R123::r123_type::key_type key = {{}};
+    R123::r123_type::ctr_type ctr = {{0, 0, static_cast<uint>(seed),
+                                      static_cast<uint>(seed >> 32)}};
+    for (uint refill = 0; refill < 3; ++refill) {
+        for (uint blk = 0; blk < 25; ++blk) {
+            ctr[0] = refill * 25 + blk;
+            auto rn = philox(ctr, key);
+            for (uint i = 0; i < 4; ++i) ASSERT_EQ(rn[i], rng->get());
+        }
+    }
+}
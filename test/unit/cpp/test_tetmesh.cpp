@@ -2,8 +2,10 @@
 #include <memory>
 #include <limits>
 #include <cmath>
+#include <cstdio>
 
 #include "steps/geom/tetmesh.hpp"
+#include "steps/geom/tmcomp.hpp"
 
 #include "gtest/gtest.h"
 
@@ -425,4 +427,171 @@ TEST_F(TetmeshTest,intersectDeterministic_notFirstNeighbor) {
     for (const auto& r: res)
         sum += r.second;
     ASSERT_DOUBLE_EQ(sum, 1.0);
-}
\ No newline at end of file
+}
+TEST_F(TetmeshTest,findTetByPoint_barycenters) {
+    size_t tetN = mesh->countTets();
+
+    std::vector<double> points;
+    for (index_t i = 0u; i < tetN; ++i) {
+        const auto& b = mesh->_getTetBarycenter(i);
+        ASSERT_EQ(mesh->findTetByPoint(b), steps::tetrahedron_id_t(i));
+        points.insert(points.end(), {b[0], b[1], b[2]});
+    }
+
+    // A point far outside the bounding box.
+    auto bmax = mesh->getBoundMax();
+    points.insert(points.end(), {2.0 * bmax[0] + 1.0, bmax[1], bmax[2]});
+
+    std::vector<index_t> tets(tetN + 1);
+    mesh->findTetsByPointsNP(points.data(), static_cast<int>(tetN + 1),
+                             tets.data(), static_cast<int>(tets.size()));
+    for (index_t i = 0u; i < tetN; ++i)
+        ASSERT_EQ(tets[i], i);
+    ASSERT_EQ(tets[tetN], steps::UNKNOWN_TET.get());
+}
+
+TEST_F(TetmeshTest,intersectIndependentSegments_matchesSingle) {
+    point3d p0(mesh->_getTetBarycenter(0u)),
+            p1(mesh->_getTetBarycenter(1u));
+
+    std::vector<double> segments {p0[0], p0[1], p0[2], p1[0], p1[1], p1[2],
+                                  p1[0], p1[1], p1[2], p0[0], p0[1], p0[2]};
+    auto res = mesh->intersectIndependentSegments(segments.data(), 2);
+    ASSERT_EQ(res.size(), 2ul);
+
+    auto ref0 = mesh->intersectDeterministic(p0, p1);
+    auto ref1 = mesh->intersectDeterministic(p1, p0);
+    ASSERT_EQ(res[0].size(), ref0.size());
+    ASSERT_EQ(res[1].size(), ref1.size());
+    for (size_t i = 0; i < ref0.size(); ++i) {
+        ASSERT_EQ(res[0][i].first, ref0[i].first);
+        ASSERT_DOUBLE_EQ(res[0][i].second, ref0[i].second);
+    }
+    for (size_t i = 0; i < ref1.size(); ++i) {
+        ASSERT_EQ(res[1][i].first, ref1[i].first);
+        ASSERT_DOUBLE_EQ(res[1][i].second, ref1[i].second);
+    }
+}
+
+TEST_F(TetmeshTest,binary_roundtrip) {
+    size_t tetN = mesh->countTets();
+    std::vector<index_t> tets;
+    for (index_t i = 0u; i < tetN; ++i)
+        tets.push_back(i);
+    auto comp = new steps::tetmesh::TmComp("comp", mesh.get(), tets);
+    comp->addVolsys("vsys");
+    mesh->addROI("first", steps::tetmesh::ELEM_TET, {0u});
+
+    const std::string path = "test_tetmesh_binary_roundtrip.stepsmesh";
+    mesh->saveBinary(path);
+    std::unique_ptr<Tetmesh> loaded(Tetmesh::loadBinary(path));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(loaded->countVertices(), mesh->countVertices());
+    ASSERT_EQ(loaded->countBars(), mesh->countBars());
+    ASSERT_EQ(loaded->countTris(), mesh->countTris());
+    ASSERT_EQ(loaded->countTets(), mesh->countTets());
+    ASSERT_EQ(loaded->getBoundMin(), mesh->getBoundMin());
+    ASSERT_EQ(loaded->getBoundMax(), mesh->getBoundMax());
+
+    for (index_t i = 0u; i < mesh->countVertices(); ++i)
+        ASSERT_EQ(loaded->getVertex(i), mesh->getVertex(i));
+    for (index_t i = 0u; i < mesh->countTris(); ++i) {
+        ASSERT_EQ(loaded->getTri(i), mesh->getTri(i));
+        ASSERT_EQ(loaded->getTriBars(i), mesh->getTriBars(i));
+        ASSERT_EQ(loaded->getTriTetNeighb(i), mesh->getTriTetNeighb(i));
+        ASSERT_EQ(loaded->getTriArea(i), mesh->getTriArea(i));
+        ASSERT_EQ(loaded->getTriNorm(i), mesh->getTriNorm(i));
+    }
+    for (index_t i = 0u; i < tetN; ++i) {
+        ASSERT_EQ(loaded->getTet(i), mesh->getTet(i));
+        ASSERT_EQ(loaded->getTetVol(i), mesh->getTetVol(i));
+        ASSERT_EQ(loaded->getTetTriNeighb(i), mesh->getTetTriNeighb(i));
+        ASSERT_EQ(loaded->getTetTetNeighb(i), mesh->getTetTetNeighb(i));
+        ASSERT_EQ(loaded->getTetComp(i)->getID(), "comp");
+    }
+
+    auto lcomp = loaded->getComp("comp");
+    ASSERT_EQ(lcomp->getVolsys(), comp->getVolsys());
+    ASSERT_TRUE(loaded->rois.tets_roi == mesh->rois.tets_roi);
+    ASSERT_EQ(loaded->findTetByPoint(mesh->_getTetBarycenter(0u)), steps::tetrahedron_id_t(0u));
+}
+
+// Box of n x n x n cubes, each cut into six tetrahedrons around its diagonal.
+static std::unique_ptr<Tetmesh> makeBoxMesh(unsigned n) {
+    std::vector<double> verts;
+    for (unsigned k = 0; k <= n; ++k)
+        for (unsigned j = 0; j <= n; ++j)
+            for (unsigned i = 0; i <= n; ++i) {
+                verts.push_back(i);
+                verts.push_back(j);
+                verts.push_back(k);
+            }
+    auto vidx = [n](unsigned i, unsigned j, unsigned k) { return (k * (n + 1) + j) * (n + 1) + i; };
+
+    const unsigned perms[6][3] = {{0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0}};
+    std::vector<steps::vertex_id_t::value_type> tets;
+    for (unsigned k = 0; k < n; ++k)
+        for (unsigned j = 0; j < n; ++j)
+            for (unsigned i = 0; i < n; ++i)
+                for (auto const &p: perms) {
+                    unsigned c[3] = {i, j, k};
+                    tets.push_back(vidx(c[0], c[1], c[2]));
+                    for (unsigned d = 0; d < 3; ++d) {
+                        ++c[p[d]];
+                        tets.push_back(vidx(c[0], c[1], c[2]));
+                    }
+                }
+    return std::unique_ptr<Tetmesh>(new Tetmesh(verts, tets));
+}
+
+TEST(TetmeshPartition,graph_and_sfc) {
+    auto box = makeBoxMesh(8);
+    const index_t tetN = box->countTets();
+
+    std::vector<index_t> inner, outer;
+    for (index_t t = 0u; t < tetN; ++t)
+        (box->_getTetBarycenter(t)[0] < 4.0 ? inner : outer).push_back(t);
+    auto icomp = new steps::tetmesh::TmComp("inner", box.get(), inner);
+    new steps::tetmesh::TmComp("outer", box.get(), outer);
+
+    std::vector<index_t> memb;
+    for (index_t tri = 0u; tri < box->countTris(); ++tri) {
+        auto tets = box->_getTriTetNeighb(tri);
+        if (tets[0] != steps::UNKNOWN_TET && tets[1] != steps::UNKNOWN_TET &&
+            box->getTetComp(tets[0]) != box->getTetComp(tets[1]))
+            memb.push_back(tri);
+    }
+    ASSERT_EQ(memb.size(), 2u * 8u * 8u);
+    new steps::tetmesh::TmPatch("memb", box.get(), memb, icomp);
+
+    for (auto method: {steps::tetmesh::PARTITION_GRAPH, steps::tetmesh::PARTITION_SFC}) {
+        const unsigned nparts = 5;
+        auto part = box->partition(nparts, method);
+
+        ASSERT_EQ(part.tet_hosts.size(), tetN);
+        for (auto h: part.tet_hosts)
+            ASSERT_LT(h, nparts);
+        ASSERT_EQ(part.host_loads.size(), nparts);
+        for (auto l: part.host_loads)
+            ASSERT_GT(l, 0.0);
+        ASSERT_LT(part.imbalance, 1.1);
+        ASSERT_GT(part.cut_area, 0.0);
+
+        // Membrane triangles live with both of their tets.
+        ASSERT_EQ(part.tri_hosts.size(), memb.size());
+        for (auto tri: memb) {
+            auto tets = box->_getTriTetNeighb(tri);
+            auto host = part.tri_hosts.at(steps::triangle_id_t(tri));
+            ASSERT_EQ(part.tet_hosts[tets[0].get()], host);
+            ASSERT_EQ(part.tet_hosts[tets[1].get()], host);
+        }
+
+        // Same arguments, same partition.
+        ASSERT_EQ(box->partition(nparts, method).tet_hosts, part.tet_hosts);
+    }
+
+    // A graph partition of the box should not cut more than cutting it in
+    // slabs along one axis would (4 planes of 64 unit squares).
+    ASSERT_LE(box->partition(5).cut_area, 4.0 * 64.0);
+}
@@ -0,0 +1,181 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+
+
+
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import unittest
+
+import numpy as np
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.solver as solv
+
+from steps.API_1.geom import INDEX_DTYPE
+
+class BatchSetGetTestCase(unittest.TestCase):
+    """ Test cases for the index based batch accessors of the solvers. """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec('A', self.model)
+        B = smodel.Spec('B', self.model)
+        S = smodel.Spec('S', self.model)
+
+        vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('reac', vsys, lhs = [A], rhs = [B], kcst = 1e3)
+        smodel.Diff('diffA', vsys, A, 1e-10)
+
+        ssys = smodel.Surfsys('ssys', self.model)
+        smodel.SReac('sreac', ssys, ilhs = [A], srhs = [S], kcst = 1e8)
+        smodel.Diff('diffS', ssys, S, 1e-12)
+
+        vertCoos = [0.0, 0.0, 0.0, \
+                    1.0e-6, 0.0, 0.0, \
+                    0.0, 1.0e-6, 0.0, \
+                    0.0, 0.0, 1.0e-6, \
+                    1.0e-6, 1.0e-6, 1.0e-6 ]
+        vertIds = [0, 1, 2, 3, \
+                   1, 2, 3, 4  ]
+        self.mesh = sgeom.Tetmesh(vertCoos, vertIds)
+        comp = sgeom.TmComp('comp', self.mesh, range(self.mesh.countTets()))
+        comp.addVolsys('vsys')
+        patch = sgeom.TmPatch('patch', self.mesh, self.mesh.getSurfTris(), icomp = comp)
+        patch.addSurfsys('ssys')
+
+        rng = srng.create('mt19937', 512)
+        rng.initialize(2903)
+        self.sim = solv.Tetexact(self.model, self.mesh, rng)
+
+        self.tets = np.array(range(self.mesh.countTets()), dtype = INDEX_DTYPE)
+        self.tris = np.array(self.mesh.getSurfTris(), dtype = INDEX_DTYPE)
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+        self.sim = None
+
+    def testIndices(self):
+        self.assertEqual(self.sim.getReacIdx('reac'), 0)
+        self.assertEqual(self.sim.getSReacIdx('sreac'), 0)
+        self.assertEqual(self.sim.getDiffIdx('diffA'), 0)
+        self.assertEqual(self.sim.getSurfDiffIdx('diffS'), 0)
+
+    def testTetSpecies(self):
+        sidx = self.sim.getSpecIdx('A')
+        counts = np.array([10.0, 20.0])
+        self.sim.setBatchTetCountsIdxNP(self.tets, sidx, counts)
+        for i, t in enumerate(self.tets):
+            self.assertEqual(self.sim.getTetCount(t, 'A'), counts[i])
+
+        values = np.zeros(len(self.tets))
+        self.sim.getBatchTetAmountsIdxNP(self.tets, sidx, values)
+        for i, t in enumerate(self.tets):
+            self.assertAlmostEqual(values[i], self.sim.getTetAmount(t, 'A'))
+
+        concs = np.array([1.0e-3, 2.0e-3])
+        self.sim.setBatchTetConcsIdxNP(self.tets, sidx, concs)
+        self.sim.getBatchTetConcsIdxNP(self.tets, sidx, values)
+        for i, t in enumerate(self.tets):
+            self.assertAlmostEqual(values[i], self.sim.getTetConc(t, 'A'))
+
+        clamped = np.array([1, 0], dtype = np.uint8)
+        self.sim.setBatchTetClampedIdxNP(self.tets, sidx, clamped)
+        self.assertTrue(self.sim.getTetClamped(self.tets[0], 'A'))
+        self.assertFalse(self.sim.getTetClamped(self.tets[1], 'A'))
+        flags = np.zeros(len(self.tets), dtype = np.uint8)
+        self.sim.getBatchTetClampedIdxNP(self.tets, sidx, flags)
+        self.assertEqual(list(flags), [1, 0])
+
+    def testTetRates(self):
+        ridx = self.sim.getReacIdx('reac')
+        kfs = np.array([1.0e2, 2.0e2])
+        self.sim.setBatchTetReacKsIdxNP(self.tets, ridx, kfs)
+        values = np.zeros(len(self.tets))
+        self.sim.getBatchTetReacKsIdxNP(self.tets, ridx, values)
+        for i, t in enumerate(self.tets):
+            self.assertAlmostEqual(self.sim.getTetReacK(t, 'reac'), kfs[i])
+            self.assertAlmostEqual(values[i], kfs[i])
+
+        didx = self.sim.getDiffIdx('diffA')
+        dcsts = np.array([1.0e-11, 2.0e-11])
+        self.sim.setBatchTetDiffDsIdxNP(self.tets, didx, dcsts)
+        self.sim.getBatchTetDiffDsIdxNP(self.tets, didx, values)
+        for i, t in enumerate(self.tets):
+            self.assertAlmostEqual(self.sim.getTetDiffD(t, 'diffA'), dcsts[i])
+            self.assertAlmostEqual(values[i], dcsts[i])
+
+    def testTriQuantities(self):
+        sidx = self.sim.getSpecIdx('S')
+        counts = np.full(len(self.tris), 5.0)
+        self.sim.setBatchTriCountsIdxNP(self.tris, sidx, counts)
+        values = np.zeros(len(self.tris))
+        self.sim.getBatchTriCountsIdxNP(self.tris, sidx, values)
+        self.assertEqual(list(values), list(counts))
+
+        ridx = self.sim.getSReacIdx('sreac')
+        kfs = np.full(len(self.tris), 3.0e7)
+        self.sim.setBatchTriSReacKsIdxNP(self.tris, ridx, kfs)
+        self.sim.getBatchTriSReacKsIdxNP(self.tris, ridx, values)
+        for i, t in enumerate(self.tris):
+            self.assertAlmostEqual(self.sim.getTriSReacK(t, 'sreac'), kfs[i])
+            self.assertAlmostEqual(values[i], kfs[i])
+
+        didx = self.sim.getSurfDiffIdx('diffS')
+        self.sim.getBatchTriSDiffDsIdxNP(self.tris, didx, values)
+        for v in values:
+            self.assertAlmostEqual(v, 1e-12)
+
+    def testExtents(self):
+        self.sim.setCompCount('comp', 'A', 1000)
+        self.sim.run(1e-3)
+        extents = np.zeros(len(self.tets), dtype = np.uint64)
+        self.sim.getBatchTetReacExtentsIdxNP(self.tets, self.sim.getReacIdx('reac'), extents)
+        self.assertEqual(sum(extents), self.sim.getCompReacExtent('comp', 'reac'))
+        sextents = np.zeros(len(self.tris), dtype = np.uint64)
+        self.sim.getBatchTriSReacExtentsIdxNP(self.tris, self.sim.getSReacIdx('sreac'), sextents)
+        self.assertEqual(sum(sextents), self.sim.getPatchSReacExtent('patch', 'sreac'))
+
+    def testErrors(self):
+        sidx = self.sim.getSpecIdx('A')
+        with self.assertRaises(Exception):
+            self.sim.setBatchTetCountsIdxNP(self.tets, sidx, np.array([1.0, -1.0]))
+        with self.assertRaises(Exception):
+            self.sim.getBatchTetConcsIdxNP(self.tets, sidx, np.zeros(3))
+        with self.assertRaises(Exception):
+            self.sim.getBatchTetConcsIdxNP(np.array([0, 10], dtype = INDEX_DTYPE), sidx, np.zeros(2))
+        with self.assertRaises(Exception):
+            self.sim.getBatchTetReacKsIdxNP(self.tets, 10, np.zeros(2))
+
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(BatchSetGetTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
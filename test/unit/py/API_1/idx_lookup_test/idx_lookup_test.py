@@ -0,0 +1,105 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.solver as ssolver
+
+class idxLookupTestCase(unittest.TestCase):
+    """
+    Test that the index based accessors agree with the string based ones.
+    """
+    def setUp(self):
+        mdl = smodel.Model()
+
+        S1 = smodel.Spec('S1', mdl)
+        S2 = smodel.Spec('S2', mdl)
+        S3 = smodel.Spec('S3', mdl)
+
+        vsys = smodel.Volsys('vsys', mdl)
+        ssys = smodel.Surfsys('ssys', mdl)
+
+        smodel.Reac('reac', vsys, lhs=[S1], rhs=[S2], kcst=1.0)
+        smodel.SReac('sreac', ssys, ilhs=[S1], srhs=[S3], kcst=1.0)
+
+        geom = sgeom.Geom()
+
+        comp1 = sgeom.Comp('comp1', geom)
+        comp1.setVol(1e-18)
+        comp1.addVolsys('vsys')
+
+        comp2 = sgeom.Comp('comp2', geom)
+        comp2.setVol(1e-18)
+
+        patch = sgeom.Patch('patch', geom, comp1, comp2)
+        patch.addSurfsys('ssys')
+        patch.setArea(1e-12)
+
+        rng = srng.create('mt19937', 512)
+        rng.initialize(1234)
+
+        self.sim = ssolver.Wmdirect(mdl, geom, rng)
+        self.sim.reset()
+
+    def testIdx(self):
+        specs = ['S1', 'S2', 'S3']
+        sidx = [self.sim.getSpecIdx(s) for s in specs]
+        self.assertEqual(sorted(sidx), [0, 1, 2])
+        self.assertNotEqual(self.sim.getCompIdx('comp1'), self.sim.getCompIdx('comp2'))
+        self.assertEqual(self.sim.getPatchIdx('patch'), 0)
+
+        with self.assertRaises(Exception):
+            self.sim.getSpecIdx('unknown')
+        with self.assertRaises(Exception):
+            self.sim.getCompIdx('unknown')
+
+    def testCounts(self):
+        self.sim.setCompCount('comp1', 'S1', 100)
+        self.sim.setCompCount('comp1', 'S2', 20)
+        self.sim.setPatchCount('patch', 'S3', 7)
+
+        cidx = self.sim.getCompIdx('comp1')
+        pidx = self.sim.getPatchIdx('patch')
+        for s in ['S1', 'S2']:
+            self.assertEqual(
+                self.sim.getCompCountIdx(cidx, self.sim.getSpecIdx(s)),
+                self.sim.getCompCount('comp1', s)
+            )
+        self.assertEqual(self.sim.getPatchCountIdx(pidx, self.sim.getSpecIdx('S3')), 7)
+
+        with self.assertRaises(Exception):
+            self.sim.getCompCountIdx(cidx, 3)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(idxLookupTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
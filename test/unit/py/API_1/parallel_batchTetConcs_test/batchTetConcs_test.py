@@ -163,6 +163,42 @@ class batchTetConcs(unittest.TestCase):
         tetConcsBatch = np.zeros((len(tetConcs)+1,), dtype=float)
         self.sim.getBatchTetConcsNP(tetIds, 'A', tetConcsBatch)
 
+    def testBatchTetIdxNP(self):
+        self.sim.reset()
+        tetIds = np.array([0, 1], dtype=INDEX_DTYPE)
+        sidx = self.sim.getSpecIdx('A')
+        didx = self.sim.getDiffIdx('diff_A')
+
+        # set
+        self.sim.setBatchTetCountsIdxNP(tetIds, sidx, np.array([10.0, 20.0]))
+        self.sim.setBatchTetDiffDsIdxNP(tetIds, didx, np.array([1.0e-12, 2.0e-12]))
+
+        # get
+        amounts = np.zeros((len(tetIds),), dtype=float)
+        self.sim.getBatchTetAmountsIdxNP(tetIds, sidx, amounts)
+        dcsts = np.zeros((len(tetIds),), dtype=float)
+        self.sim.getBatchTetDiffDsIdxNP(tetIds, didx, dcsts)
+
+        # check
+        for i in range(0, len(tetIds)):
+            self.assertAlmostEqual(amounts[i], self.sim.getTetAmount(tetIds[i], 'A'))
+            self.assertAlmostEqual(dcsts[i], self.sim.getTetDiffD(tetIds[i], 'diff_A'))
+        self.assertEqual(self.sim.getTetCount(tetIds[1], 'A'), 20)
+
+    def testSetBatchTetCountsIdxNPAtomic(self):
+        self.sim.reset()
+        tetIds = np.array([0, 1], dtype=INDEX_DTYPE)
+        sidx = self.sim.getSpecIdx('A')
+        self.sim.setBatchTetCountsIdxNP(tetIds, sidx, np.array([10.0, 20.0]))
+
+        # the second count is too large, so neither is set
+        with self.assertRaises(Exception):
+            self.sim.setBatchTetCountsIdxNP(tetIds, sidx, np.array([30.0, 1.0e10]))
+
+        # check
+        self.assertEqual(self.sim.getTetCount(0, 'A'), 10)
+        self.assertEqual(self.sim.getTetCount(1, 'A'), 20)
+
 def suite():
     all_tests = []
     all_tests.append(unittest.makeSuite(batchTetConcs, "test"))
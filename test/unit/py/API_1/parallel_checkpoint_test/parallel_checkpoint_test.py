@@ -0,0 +1,119 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+
+
+
+
+import os
+import tempfile
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+class ParallelCheckpointTestCase(unittest.TestCase):
+    """ Test cases for checkpointing the parallel OpSplit solver. """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec("A", self.model)
+        B = smodel.Spec("B", self.model)
+        C = smodel.Spec("C", self.model)
+
+        vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('fwd', vsys, lhs = [A, B], rhs = [C], kcst = 1e8)
+        smodel.Reac('bwd', vsys, lhs = [C], rhs = [A, B], kcst = 1e2)
+        smodel.Diff('diffA', vsys, A, 1e-10)
+        smodel.Diff('diffB', vsys, B, 1e-10)
+        smodel.Diff('diffC', vsys, C, 1e-10)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.loadMesh('../getROIArea_bugfix_test/meshes/cyl_len10_diam1')[0]
+        else:
+            self.mesh = meshio.loadMesh('getROIArea_bugfix_test/meshes/cyl_len10_diam1')[0]
+
+        self.comp = sgeom.TmComp('comp', self.mesh, list(range(self.mesh.countTets())))
+        self.comp.addVolsys('vsys')
+
+        # Every process has to use the same file name.
+        self.cpfile = os.path.join(tempfile.gettempdir(), 'steps_parallel_checkpoint_test')
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+        self.comp = None
+
+    def _solver(self, partition):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000)
+        tet_hosts = gd.linearPartition(self.mesh, partition)
+        return solv.TetOpSplit(self.model, self.mesh, rng, solv.EF_NONE, tet_hosts)
+
+    def _counts(self, sim):
+        tets = list(range(self.mesh.countTets()))
+        return [list(sim.getBatchTetCounts(tets, s)) for s in ['A', 'B', 'C']]
+
+    def testRestoreContinues(self):
+        """ A restored solver continues exactly as the checkpointed one. """
+        sim = self._solver([steps.mpi.nhosts, 1, 1])
+        sim.setTetCount(0, 'A', 2000)
+        sim.setCompCount('comp', 'B', 3000)
+        sim.run(0.005)
+        sim.checkpoint(self.cpfile)
+        sim.run(0.01)
+
+        sim2 = self._solver([steps.mpi.nhosts, 1, 1])
+        sim2.restore(self.cpfile)
+        self.assertAlmostEqual(sim2.getTime(), 0.005)
+        sim2.run(0.01)
+        self.assertEqual(self._counts(sim), self._counts(sim2))
+        self.assertEqual(sim.getNSteps(), sim2.getNSteps())
+
+    def testRestoreRepartitioned(self):
+        """ A checkpoint can be restored with a different partition. """
+        sim = self._solver([steps.mpi.nhosts, 1, 1])
+        sim.setTetCount(0, 'A', 2000)
+        sim.setCompCount('comp', 'B', 3000)
+        sim.run(0.005)
+        sim.checkpoint(self.cpfile)
+
+        sim2 = self._solver([1, 1, steps.mpi.nhosts])
+        sim2.restore(self.cpfile)
+        self.assertEqual(self._counts(sim), self._counts(sim2))
+        sim2.run(0.01)
+        self.assertEqual(sim2.getCompCount('comp', 'A') + sim2.getCompCount('comp', 'C'), 2000)
+        self.assertEqual(sim2.getCompCount('comp', 'B') + sim2.getCompCount('comp', 'C'), 3000)
+
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(ParallelCheckpointTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
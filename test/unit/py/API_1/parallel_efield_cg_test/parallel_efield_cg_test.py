@@ -0,0 +1,95 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+
+
+
+
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.mpi
+import steps.mpi.solver as solv
+from steps.utilities import meshio
+import steps.utilities.geom_decompose as gd
+
+class ParallelEfieldCGTestCase(unittest.TestCase):
+    """ Test the distributed CG E-field solver of the parallel OpSplit solver. """
+    def setUp(self):
+        self.model = smodel.Model()
+        L = smodel.Chan('L', self.model)
+        Leak = smodel.ChanState('Leak', self.model, L)
+        ssys = smodel.Surfsys('ssys', self.model)
+        smodel.OhmicCurr('OC_L', ssys, chanstate = Leak, erev = -0.05, g = 1e-14)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.loadMesh('../getROIArea_bugfix_test/meshes/cyl_len10_diam1')[0]
+        else:
+            self.mesh = meshio.loadMesh('getROIArea_bugfix_test/meshes/cyl_len10_diam1')[0]
+
+        self.comp = sgeom.TmComp('comp', self.mesh, list(range(self.mesh.countTets())))
+        self.tris = list(self.mesh.getSurfTris())
+        self.patch = sgeom.TmPatch('patch', self.mesh, self.tris, self.comp)
+        self.patch.addSurfsys('ssys')
+        self.memb = sgeom.Memb('memb', self.mesh, [self.patch])
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+        self.comp = None
+        self.patch = None
+        self.memb = None
+
+    def _potentials(self, ef_solver):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000)
+        tet_hosts = gd.linearPartition(self.mesh, [1, 1, steps.mpi.nhosts])
+        tri_hosts = gd.partitionTris(self.mesh, tet_hosts, self.tris)
+        sim = solv.TetOpSplit(self.model, self.mesh, rng, ef_solver, tet_hosts, tri_hosts)
+        sim.setEfieldDT(1e-6)
+        sim.setMembPotential('memb', -0.065)
+        sim.setPatchCount('patch', 'Leak', len(self.tris))
+        # An injection at one end of the cylinder.
+        sim.setTriIClamp(self.tris[0], 2e-12)
+        sim.run(1e-4)
+        return [sim.getTetV(t) for t in range(self.mesh.countTets())]
+
+    def testSameAsBanded(self):
+        """ EF_DV_CG gives the potentials of the banded solver. """
+        v_bd = self._potentials(solv.EF_DV_BDSYS)
+        v_cg = self._potentials(solv.EF_DV_CG)
+        # The clamp and the leak did move the potentials.
+        self.assertNotAlmostEqual(max(v_bd), -0.065, delta = 1e-5)
+        for vb, vc in zip(v_bd, v_cg):
+            self.assertAlmostEqual(vb, vc, delta = 1e-9)
+
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(ParallelEfieldCGTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
@@ -89,6 +89,47 @@ class ParallelSetGetCountCase(unittest.TestCase):
             get_count = solver.getTriCount(tri, 'A')
             self.assertEqual(get_count, tri)
 
+    def testBatchedQueries(self):
+        tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        tri_hosts = gd.partitionTris(self.mesh, tet_hosts, self.surf_tris)
+        solver = solv.TetOpSplit(self.model, self.mesh, self.rng, solv.EF_NONE, tet_hosts, tri_hosts)
+        tris = self.surf_tris[:10]
+        for tet in range(10):
+            solver.queueQuery(solver.QUERY_SET_TET_COUNT, tet, 'A', tet)
+        for tri in tris:
+            solver.queueQuery(solver.QUERY_SET_TRI_COUNT, tri, 'A', tri)
+        get_tets = [solver.queueQuery(solver.QUERY_GET_TET_COUNT, tet, 'A') for tet in range(10)]
+        get_tris = [solver.queueQuery(solver.QUERY_GET_TRI_COUNT, tri, 'A') for tri in tris]
+        self.assertEqual(solver.countQueries(), 40)
+        results = solver.runQueries()
+        self.assertEqual(solver.countQueries(), 0)
+        for tet, q in zip(range(10), get_tets):
+            self.assertEqual(results[q], tet)
+            self.assertEqual(solver.getTetCount(tet, 'A'), tet)
+        for tri, q in zip(tris, get_tris):
+            self.assertEqual(results[q], tri)
+
+    def testRebalance(self):
+        tet_hosts = gd.binTetsByAxis(self.mesh, steps.mpi.nhosts)
+        tri_hosts = gd.partitionTris(self.mesh, tet_hosts, self.surf_tris)
+        solver = solv.TetOpSplit(self.model, self.mesh, self.rng, solv.EF_NONE, tet_hosts, tri_hosts)
+        solver.setTetCount(0, 'A', 100000)
+        solver.setTriCount(self.surf_tris[0], 'A', 1000)
+        solver.run(1e-5)
+
+        tet_counts = [solver.getTetCount(tet, 'A') for tet in range(self.mesh.ntets)]
+        tri_counts = [solver.getTriCount(tri, 'A') for tri in self.surf_tris]
+        extent = solver.getDiffExtent()
+        solver.rebalance(1.0)
+        self.assertGreaterEqual(solver.getLoadImbalance(), 1.0)
+        self.assertEqual([solver.getTetCount(tet, 'A') for tet in range(self.mesh.ntets)], tet_counts)
+        self.assertEqual([solver.getTriCount(tri, 'A') for tri in self.surf_tris], tri_counts)
+        self.assertEqual(solver.getDiffExtent(), extent)
+
+        solver.setRebalancing(1e-5, 1.0)
+        solver.run(1e-4)
+        self.assertEqual(solver.getCompCount('comp', 'A') + solver.getPatchCount('patch', 'A'), 101000)
+
 def suite():
     all_tests = []
     all_tests.append(unittest.makeSuite(ParallelSetGetCountCase, "test"))
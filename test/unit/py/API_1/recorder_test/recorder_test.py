@@ -0,0 +1,135 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import os
+import struct
+import tempfile
+import unittest
+
+import numpy as np
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.solver as ssolver
+
+class recorderTestCase(unittest.TestCase):
+    """
+    Test the native time-series recorder.
+    """
+    def setUp(self):
+        mdl = smodel.Model()
+
+        S1 = smodel.Spec('S1', mdl)
+        S2 = smodel.Spec('S2', mdl)
+
+        vsys = smodel.Volsys('vsys', mdl)
+        smodel.Reac('reac', vsys, lhs=[S1], rhs=[S2], kcst=10.0)
+
+        geom = sgeom.Geom()
+
+        comp = sgeom.Comp('comp', geom)
+        comp.setVol(1e-18)
+        comp.addVolsys('vsys')
+
+        rng = srng.create('mt19937', 512)
+        rng.initialize(1234)
+
+        self.sim = ssolver.Wmdirect(mdl, geom, rng)
+        self.sim.reset()
+        self.sim.setCompCount('comp', 'S1', 100)
+
+        cidx = self.sim.getCompIdx('comp')
+        self.rec = ssolver.Recorder(self.sim)
+        self.rec.addProbe(ssolver.Recorder.COMP, [cidx], ssolver.Recorder.COUNT, 'S1')
+        self.rec.addProbe(ssolver.Recorder.COMP, [cidx], ssolver.Recorder.COUNT, 'S2')
+        self.rec.addProbe(ssolver.Recorder.COMP, [cidx], ssolver.Recorder.EXTENT, 'reac')
+
+    def testSampleDT(self):
+        self.rec.setSampleDT(0.1)
+        self.rec.run(1.0)
+
+        self.assertEqual(self.rec.countColumns(), 3)
+        self.assertEqual(self.rec.countSamples(), 11)
+        self.assertAlmostEqual(self.sim.getTime(), 1.0)
+        np.testing.assert_allclose(self.rec.getTimes(), np.linspace(0.0, 1.0, 11))
+
+        data = np.zeros((self.rec.countSamples(), self.rec.countColumns()))
+        self.rec.getDataNP(data)
+        np.testing.assert_array_equal(data[:, 0] + data[:, 1], 100)
+        np.testing.assert_array_equal(data[:, 1], data[:, 2])
+        self.assertEqual(data[0, 0], 100)
+        self.assertEqual(data[-1, 0], self.sim.getCompCount('comp', 'S1'))
+
+        # Sampling carries on from where the last run stopped.
+        self.rec.advance(0.5)
+        self.assertEqual(self.rec.countSamples(), 16)
+
+    def testSamplePoints(self):
+        self.rec.setSamplePoints([0.05, 0.2, 0.7])
+        self.rec.run(0.5)
+        self.assertEqual(self.rec.countSamples(), 2)
+        self.assertAlmostEqual(self.sim.getTime(), 0.5)
+        self.rec.run(1.0)
+        np.testing.assert_allclose(self.rec.getTimes(), [0.05, 0.2, 0.7])
+
+    def testStream(self):
+        fd, path = tempfile.mkstemp()
+        os.close(fd)
+        try:
+            self.rec.setSampleDT(0.25)
+            self.rec.openStream(path)
+            self.rec.run(1.0)
+            self.rec.closeStream()
+            self.assertEqual(self.rec.countSamples(), 0)
+
+            with open(path, 'rb') as f:
+                self.assertEqual(f.read(8), b'STEPSREC')
+                version, ncols = struct.unpack('=IQ', f.read(12))
+                rows = np.fromfile(f, dtype=np.float64).reshape(-1, ncols + 1)
+            self.assertEqual(version, 1)
+            self.assertEqual(ncols, 3)
+            self.assertEqual(rows.shape[0], 5)
+            np.testing.assert_allclose(rows[:, 0], [0.0, 0.25, 0.5, 0.75, 1.0])
+            np.testing.assert_array_equal(rows[:, 1] + rows[:, 2], 100)
+        finally:
+            os.remove(path)
+
+    def testInvalidProbe(self):
+        with self.assertRaises(Exception):
+            self.rec.addProbe(ssolver.Recorder.COMP, [0], ssolver.Recorder.COUNT, 'unknown')
+        with self.assertRaises(Exception):
+            self.rec.addProbe(ssolver.Recorder.COMP, [1], ssolver.Recorder.COUNT, 'S1')
+        with self.assertRaises(Exception):
+            self.rec.addProbe(ssolver.Recorder.COMP, [0], ssolver.Recorder.V)
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(recorderTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
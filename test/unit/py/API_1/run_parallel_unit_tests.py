@@ -31,11 +31,16 @@ import parallel_std_string_bugfix_test
 import parallel_missing_solver_methods_test
 import parallel_opsplit_test
 import parallel_batchTetConcs_test
+import parallel_checkpoint_test
+import parallel_efield_cg_test
+import parallel_threaded_opsplit_test
 
 def suite():
     all_tests = [ parallel_diff_sel_test.suite(), parallel_setget_count_test.suite(), 
         parallel_std_string_bugfix_test.suite(), parallel_missing_solver_methods_test.suite(),
         parallel_opsplit_test.suite(), parallel_batchTetConcs_test.suite(),
+        parallel_checkpoint_test.suite(), parallel_efield_cg_test.suite(),
+        parallel_threaded_opsplit_test.suite(),
     ]
     return unittest.TestSuite(all_tests)
 
@@ -38,6 +38,12 @@ import genPointsInTets_bugfix_test
 import missing_solver_methods_test
 import utilities_meshctrl_test
 import tetODE_setPatchSReacK_bugfix_test
+import idx_lookup_test
+import recorder_test
+import threaded_opsplit_test
+import threaded_tetexact_test
+import batch_setget_test
+import tetODE_stiff_test
 
 def suite():
     all_tests = [
@@ -47,6 +53,12 @@ def suite():
         genPointsInTets_bugfix_test.suite(), missing_solver_methods_test.suite(),
         utilities_meshctrl_test.suite(),
         tetODE_setPatchSReacK_bugfix_test.suite(),
+        idx_lookup_test.suite(),
+        recorder_test.suite(),
+        threaded_opsplit_test.suite(),
+        threaded_tetexact_test.suite(),
+        batch_setget_test.suite(),
+        tetODE_stiff_test.suite(),
     ]
     return unittest.TestSuite(all_tests)
 
@@ -0,0 +1,106 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+###
+
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.solver as solv
+
+class TetODEStiffTestCase(unittest.TestCase):
+    """ Test the BDF / Krylov integration of TetODE on a stiff buffer model. """
+    def setUp(self):
+        self.model = smodel.Model()
+        Ca = smodel.Spec('Ca', self.model)
+        B = smodel.Spec('B', self.model)
+        CaB = smodel.Spec('CaB', self.model)
+        P = smodel.Spec('P', self.model)
+        PCa = smodel.Spec('PCa', self.model)
+
+        vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('bind', vsys, lhs = [Ca, B], rhs = [CaB], kcst = 1e9)
+        smodel.Reac('unbind', vsys, lhs = [CaB], rhs = [Ca, B], kcst = 1e4)
+        smodel.Diff('diffCa', vsys, Ca, 2e-10)
+
+        ssys = smodel.Surfsys('ssys', self.model)
+        smodel.SReac('pump', ssys, ilhs = [Ca], slhs = [P], srhs = [PCa], kcst = 1e7)
+        smodel.SReac('release', ssys, slhs = [PCa], srhs = [P], kcst = 1e2)
+
+        vertCoos = [0.0, 0.0, 0.0, \
+                    1.0e-6, 0.0, 0.0, \
+                    0.0, 1.0e-6, 0.0, \
+                    0.0, 0.0, 1.0e-6, \
+                    1.0e-6, 1.0e-6, 1.0e-6 ]
+        vertIds = [0, 1, 2, 3, \
+                   1, 2, 3, 4  ]
+        self.mesh = sgeom.Tetmesh(vertCoos, vertIds)
+        comp = sgeom.TmComp('comp', self.mesh, range(self.mesh.countTets()))
+        comp.addVolsys('vsys')
+        patch = sgeom.TmPatch('patch', self.mesh, self.mesh.getSurfTris(), icomp = comp)
+        patch.addSurfsys('ssys')
+
+        self.rng = srng.create('mt19937', 512)
+        self.rng.initialize(2903)
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+        self.rng = None
+
+    def _run(self, stiff, linsolver = 'spgmr'):
+        sim = solv.TetODE(self.model, self.mesh, self.rng)
+        sim.setTolerances(1e-6, 1e-7)
+        sim.setMaxNumSteps(1000000)
+        if stiff:
+            sim.setStiff(True, linsolver)
+        sim.setCompConc('comp', 'B', 100e-6)
+        sim.setPatchCount('patch', 'P', 100)
+        sim.setTetConc(0, 'Ca', 10e-6)
+        sim.run(0.01)
+        res = [sim.getTetCount(t, s) for t in range(self.mesh.countTets()) for s in ['Ca', 'CaB']]
+        res.append(sim.getPatchCount('patch', 'PCa'))
+        return res, sim.getNumSteps()
+
+    def testStiffMatchesAdams(self):
+        ref, ref_steps = self._run(False)
+        for linsolver in ['spgmr', 'spbcg', 'sptfqmr']:
+            res, steps = self._run(True, linsolver)
+            for r, v in zip(ref, res):
+                self.assertAlmostEqual(v, r, delta = 1e-3 * (abs(r) + 1))
+            self.assertLess(steps, ref_steps)
+
+    def testUnknownLinSolver(self):
+        sim = solv.TetODE(self.model, self.mesh, self.rng)
+        with self.assertRaises(Exception):
+            sim.setStiff(True, 'lu')
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(TetODEStiffTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
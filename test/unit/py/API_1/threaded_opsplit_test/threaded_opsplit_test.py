@@ -0,0 +1,105 @@
+####################################################################################
+#
+#    STEPS - STochastic Engine for Pathway Simulation
+#    Copyright (C) 2007-2021 Okinawa Institute of Science and Technology, Japan.
+#    Copyright (C) 2003-2006 University of Antwerp, Belgium.
+#    
+#    See the file AUTHORS for details.
+#    This file is part of STEPS.
+#    
+#    STEPS is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License version 2,
+#    as published by the Free Software Foundation.
+#    
+#    STEPS is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#    GNU General Public License for more details.
+#    
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+#################################################################################   
+###
+
+
+
+
+# # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # # #
+
+import unittest
+
+import steps.model as smodel
+import steps.geom as sgeom
+import steps.rng as srng
+import steps.solver as solv
+from steps.utilities import meshio
+
+@unittest.skipUnless(hasattr(solv, 'TetOpSplit'), 'MPI build: TetOpSplit is tested by the parallel tests')
+class ThreadedOpSplitTestCase(unittest.TestCase):
+    """ Test cases for the OpSplit solver on threads, without MPI. """
+    def setUp(self):
+        self.model = smodel.Model()
+        A = smodel.Spec("A", self.model)
+        B = smodel.Spec("B", self.model)
+        C = smodel.Spec("C", self.model)
+
+        vsys = smodel.Volsys('vsys', self.model)
+        smodel.Reac('reac', vsys, lhs = [A, B], rhs = [C], kcst = 1e8)
+        smodel.Diff('diffA', vsys, A, 1e-10)
+        smodel.Diff('diffB', vsys, B, 1e-10)
+        smodel.Diff('diffC', vsys, C, 1e-10)
+
+        if __name__ == "__main__":
+            self.mesh = meshio.loadMesh('../getROIArea_bugfix_test/meshes/cyl_len10_diam1')[0]
+        else:
+            self.mesh = meshio.loadMesh('getROIArea_bugfix_test/meshes/cyl_len10_diam1')[0]
+
+        self.comp = sgeom.TmComp('comp', self.mesh, list(range(self.mesh.countTets())))
+        self.comp.addVolsys('vsys')
+
+    def tearDown(self):
+        self.model = None
+        self.mesh = None
+        self.comp = None
+
+    def _run(self, nthreads, ndomains):
+        rng = srng.create('r123', 512)
+        rng.initialize(1000)
+        sim = solv.TetOpSplit(self.model, self.mesh, rng)
+        if nthreads > 0:
+            sim.setNThreads(nthreads, ndomains)
+        sim.setTetCount(0, 'A', 2000)
+        sim.setCompCount('comp', 'B', 3000)
+        sim.run(0.01)
+        counts = [sim.getBatchTetCounts(list(range(self.mesh.countTets())), s) for s in ['A', 'B', 'C']]
+        return sim, counts
+
+    def testDomains(self):
+        sim, counts = self._run(1, 4)
+        self.assertEqual(sim.getNThreads(), 1)
+        self.assertEqual(sim.getNDomains(), 4)
+        self.assertEqual(sim.getCompCount('comp', 'A') + sim.getCompCount('comp', 'C'), 2000)
+        self.assertEqual(sim.getCompCount('comp', 'B') + sim.getCompCount('comp', 'C'), 3000)
+        self.assertGreater(sim.getCompCount('comp', 'C'), 0)
+
+    def testThreadCountIndependence(self):
+        """ Results depend on the sub-domains, not on the threads running them. """
+        _, counts1 = self._run(1, 4)
+        _, counts2 = self._run(2, 4)
+        self.assertEqual(counts1, counts2)
+
+    def testSingleDomain(self):
+        """ A single sub-domain reproduces the run without threads. """
+        _, counts0 = self._run(0, 0)
+        _, counts1 = self._run(3, 1)
+        self.assertEqual(counts0, counts1)
+
+
+def suite():
+    all_tests = []
+    all_tests.append(unittest.makeSuite(ThreadedOpSplitTestCase, "test"))
+    return unittest.TestSuite(all_tests)
+
+if __name__ == "__main__":
+    unittest.TextTestRunner(verbosity=2).run(suite())
@@ -191,6 +191,43 @@ class WmCheckpoints(test_model.TestModelFramework):
         if MPI._shouldWrite:
             os.remove(cpPath)
         
+    def testAsyncCheckpoints(self):
+        tmpDir = tempfile.gettempdir()
+        prefix = f'{self.__class__.__name__}async'
+        pathPrefix = os.path.join(tmpDir, prefix)
+
+        self.newSim.autoCheckpoint(self.cpTime, pathPrefix, asynchronous=True)
+        self.assertTrue(self.newSim.stepsSolver.getAsyncCheckpoint())
+
+        self.newSim.newRun()
+        self.init_API2_sim(self.newSim)
+        self.newSim.run(self.endTime)
+        self.newSim.waitCheckpoint()
+
+        cpfiles = []
+        for name in os.listdir(tmpDir):
+            if name.startswith(prefix):
+                run, time, solver, cp = name[(len(prefix)+1):].split('_')
+                cpfiles.append((float(time), name))
+        cpfiles.sort()
+
+        self.assertEqual(len(cpfiles), self.endTime / self.cpTime + 1)
+
+        for time, name in cpfiles:
+            cpPath = os.path.join(tmpDir, name)
+
+            self.newSim.newRun()
+
+            self.newSim.restore(cpPath)
+
+            self.assertAlmostEqual(self.newSim.Time, time)
+
+            if MPI._shouldWrite:
+                os.remove(cpPath)
+
+        self.newSim.autoCheckpoint(None)
+        self.assertFalse(self.newSim.stepsSolver.getAsyncCheckpoint())
+
     def testStopAutoCheckpointing(self):
         tmpDir = tempfile.gettempdir()
         prefix = f'{self.__class__.__name__}stopAutoChkpt'